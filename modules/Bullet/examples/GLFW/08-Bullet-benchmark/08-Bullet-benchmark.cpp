@@ -0,0 +1,951 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+//---------------------------------------------------------------------------
+#include <GLFW/glfw3.h>
+//---------------------------------------------------------------------------
+#include <thread>
+//---------------------------------------------------------------------------
+using namespace chai3d;
+using namespace std;
+//---------------------------------------------------------------------------
+#include "CBullet.h"
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// GENERAL SETTINGS
+//---------------------------------------------------------------------------
+
+// stereo Mode
+/*
+    C_STEREO_DISABLED:            Stereo is disabled 
+    C_STEREO_ACTIVE:              Active stereo for OpenGL NVDIA QUADRO cards
+    C_STEREO_PASSIVE_LEFT_RIGHT:  Passive stereo where L/R images are rendered next to each other
+    C_STEREO_PASSIVE_TOP_BOTTOM:  Passive stereo where L/R images are rendered above each other
+*/
+cStereoMode stereoMode = C_STEREO_DISABLED;
+
+// fullscreen mode
+bool fullscreen = false;
+
+// mirrored display
+bool mirroredDisplay = false;
+
+
+//---------------------------------------------------------------------------
+// CHAI3D VARIABLES
+//---------------------------------------------------------------------------
+
+// a camera to render the world in the window display
+cCamera* camera;
+
+// a viewport to display the scene viewed by the camera
+cViewport* viewport = nullptr;
+
+// a light source to illuminate the objects in the world
+cSpotLight *light;
+
+// a haptic device handler
+cHapticDeviceHandler* handler;
+
+// a pointer to the current haptic device
+shared_ptr<cGenericHapticDevice> hapticDevice;
+
+// a virtual tool representing the haptic device in the scene
+cGenericTool* tool;
+
+// a label to display the rates [Hz] at which the simulation is running
+cLabel* labelRates;
+
+// a label to display the time spent stepping the simulation
+cLabel* labelStepTime;
+
+
+//---------------------------------------------------------------------------
+// BULLET MODULE VARIABLES
+//---------------------------------------------------------------------------
+
+// bullet world
+cBulletWorld* bulletWorld;
+
+// number of towers and number of boxes per tower
+const int NUM_TOWERS = 8;
+const int NUM_BOXES_PER_TOWER = 40;
+
+// size of boxes
+const double BOX_SIZE = 0.04;
+
+// bullet boxes
+vector<cBulletBox*> bulletBoxes;
+
+// bullet static walls and ground
+cBulletStaticPlane* bulletInvisibleWall1;
+cBulletStaticPlane* bulletInvisibleWall2;
+cBulletStaticPlane* bulletInvisibleWall3;
+cBulletStaticPlane* bulletInvisibleWall4;
+cBulletStaticPlane* bulletInvisibleWall5;
+cBulletStaticPlane* bulletGround;
+
+
+//---------------------------------------------------------------------------
+// GENERAL VARIABLES
+//---------------------------------------------------------------------------
+
+// flag to indicate if the haptic simulation currently running
+bool simulationRunning = false;
+
+// flag to indicate if the haptic simulation has terminated
+bool simulationFinished = true;
+
+// a frequency counter to measure the simulation graphic rate
+cFrequencyCounter freqCounterGraphics;
+
+// a frequency counter to measure the simulation haptic rate
+cFrequencyCounter freqCounterHaptics;
+
+// haptic thread
+cThread* hapticsThread;
+
+// number of solver threads requested by the user
+unsigned int numSolverThreadsRequested = 1;
+
+// if true, then towers are rebuilt by the haptic thread
+bool resetRequested = false;
+
+// average time spent stepping the simulation [ms]
+double stepTime = 0.0;
+
+// a handle to window display context
+GLFWwindow* window = nullptr;
+
+// current size of GLFW window
+int windowW = 0;
+int windowH = 0;
+
+// current size of GLFW framebuffer
+int framebufferW = 0;
+int framebufferH = 0;
+
+// swap interval for the display context (vertical synchronization)
+int swapInterval = 1;
+
+
+//---------------------------------------------------------------------------
+// DECLARED FUNCTIONS
+//---------------------------------------------------------------------------
+
+// callback when the window is resized
+void onWindowSizeCallback(GLFWwindow* a_window, int a_width, int a_height);
+
+// callback when the window framebuffer is resized
+void onFrameBufferSizeCallback(GLFWwindow* a_window, int a_width, int a_height);
+
+// callback when an error GLFW occurs
+void onErrorCallback(int a_error, const char* a_description);
+
+// callback when a key is pressed
+void onKeyCallback(GLFWwindow* a_window, int a_key, int a_scancode, int a_action, int a_mods);
+
+// callback when window content scaling is modified
+void onWindowContentScaleCallback(GLFWwindow* a_window, float a_xscale, float a_yscale);
+
+// this function renders the scene
+void renderGraphics(void);
+
+// this function contains the main haptics simulation loop
+void renderHaptics(void);
+
+// this function closes the application
+void close(void);
+
+// this function places all boxes in their initial tower configuration
+void resetTowers(void);
+
+
+//===========================================================================
+/*
+    DEMO:    08-Bullet-benchmark.cpp
+
+    This example measures the time required to step a Bullet world 
+    composed of several independent towers of boxes. The number of threads
+    used by the constraint solver can be changed at runtime to compare
+    step times between the single and multithreaded solvers.
+ */
+//===========================================================================
+
+int main(int argc, char* argv[])
+{
+    //-----------------------------------------------------------------------
+    // INITIALIZATION
+    //-----------------------------------------------------------------------
+
+    cout << endl;
+    cout << "-----------------------------------" << endl;
+    cout << "CHAI3D" << endl;
+    cout << "Demo: 08-Bullet-benchmark" << endl;
+    cout << "Copyright 2003-2024" << endl;
+    cout << "-----------------------------------" << endl << endl << endl;
+    cout << "Keyboard Options:" << endl << endl;
+    cout << "[1-8] - Select number of solver threads" << endl;
+    cout << "[t] - Use all hardware threads" << endl;
+    cout << "[r] - Reset towers" << endl;
+    cout << "[g] - Enable/Disable gravity" << endl;
+    cout << "[f] - Enable/Disable full screen mode" << endl;
+    cout << "[m] - Enable/Disable vertical mirroring" << endl;
+    cout << "[q] - Exit application" << endl;
+    cout << endl << endl;
+
+
+    //--------------------------------------------------------------------------
+    // OPEN GL - WINDOW DISPLAY
+    //--------------------------------------------------------------------------
+
+    // initialize GLFW library
+    if (!glfwInit())
+    {
+        cout << "failed initialization" << endl;
+        cSleepMs(1000);
+        return 1;
+    }
+
+    // set GLFW error callback
+    glfwSetErrorCallback(onErrorCallback);
+
+    // compute desired size of window
+    const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    windowW = 0.8 * mode->height;
+    windowH = 0.5 * mode->height;
+    int x = 0.5 * (mode->width - windowW);
+    int y = 0.5 * (mode->height - windowH);
+
+    // set OpenGL version
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+
+    // enable double buffering
+    glfwWindowHint(GLFW_DOUBLEBUFFER, GLFW_TRUE);
+
+    // set the desired number of samples to use for multisampling
+    glfwWindowHint(GLFW_SAMPLES, 4);
+
+    // specify that window should be resized based on monitor content scale
+    glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
+
+    // set active stereo mode
+    if (stereoMode == C_STEREO_ACTIVE)
+    {
+        glfwWindowHint(GLFW_STEREO, GL_TRUE);
+    }
+    else
+    {
+        glfwWindowHint(GLFW_STEREO, GL_FALSE);
+    }
+
+    // create display context
+    window = glfwCreateWindow(windowW, windowH, "CHAI3D", NULL, NULL);
+    if (!window)
+    {
+        cout << "failed to create window" << endl;
+        cSleepMs(1000);
+        glfwTerminate();
+        return 1;
+    }
+
+    // set GLFW key callback
+    glfwSetKeyCallback(window, onKeyCallback);
+
+    // set GLFW window size callback
+    glfwSetWindowSizeCallback(window, onWindowSizeCallback);
+
+    // set GLFW framebuffer size callback
+    glfwSetFramebufferSizeCallback(window, onFrameBufferSizeCallback);
+
+    // set GLFW window content scaling callback
+    glfwSetWindowContentScaleCallback(window, onWindowContentScaleCallback);
+
+    // get width and height of window
+    glfwGetFramebufferSize(window, &framebufferW, &framebufferH);
+
+    // set position of window
+    glfwSetWindowPos(window, x, y);
+
+    // set window size
+    glfwSetWindowSize(window, windowW, windowH);
+
+    // set GLFW current display context
+    glfwMakeContextCurrent(window);
+
+    // set GLFW swap interval for the current display context
+    glfwSwapInterval(swapInterval);
+
+
+    // initialize GLEW library
+#ifdef GLEW_VERSION
+    if (glewInit() != GLEW_OK)
+    {
+        cout << "failed to initialize GLEW library" << endl;
+        glfwTerminate();
+        return 1;
+    }
+#endif
+
+
+    //-----------------------------------------------------------------------
+    // WORLD - CAMERA - LIGHTING
+    //-----------------------------------------------------------------------
+
+    // create a dynamic world.
+    bulletWorld = new cBulletWorld();
+
+    // set the background color of the environment
+    bulletWorld->m_backgroundColor.setWhite();
+
+    // create a camera and insert it into the virtual world
+    camera = new cCamera(bulletWorld);
+    bulletWorld->addChild(camera);
+
+    // position and orient the camera
+    camera->set(cVector3d (3.0, 0.0, 0.5),    // camera position (eye)
+                cVector3d (0.0, 0.0,-0.2),    // lookat position (target)
+                cVector3d (0.0, 0.0, 1.0));   // direction of the "up" vector
+
+    // set the near and far clipping planes of the camera
+    camera->setClippingPlanes(0.01, 10.0);
+
+    // set stereo mode
+    camera->setStereoMode(stereoMode);
+
+    // set stereo eye separation and focal length (applies only if stereo is enabled)
+    camera->setStereoEyeSeparation(0.02);
+    camera->setStereoFocalLength(2.0);
+
+    // set vertical mirrored display mode
+    camera->setMirrorVertical(mirroredDisplay);
+
+    // create a light source
+    light = new cSpotLight(bulletWorld);
+
+    // attach light to camera
+    bulletWorld->addChild(light);
+
+    // enable light source
+    light->setEnabled(true);
+
+    // position the light source
+    light->setLocalPos(0.0, 0.0, 1.2);
+
+    // define the direction of the light beam
+    light->setDir(0.0, 0.0,-1.0);
+
+    // set uniform concentration level of light 
+    light->setSpotExponent(0.0);
+
+    // enable this light source to generate shadows
+    light->setShadowMapEnabled(true);
+
+    // set the resolution of the shadow map
+    light->m_shadowMap->setQualityLow();
+    //light->m_shadowMap->setQualityMedium();
+
+    // set light cone half angle
+    light->setCutOffAngleDeg(45);
+
+
+    //-----------------------------------------------------------------------
+    // HAPTIC DEVICES / TOOLS
+    //-----------------------------------------------------------------------
+
+    // create a haptic device handler
+    handler = new cHapticDeviceHandler();
+
+    // get access to the first available haptic device found
+    handler->getDevice(hapticDevice, 0);
+
+    // retrieve information about the current haptic device
+    cHapticDeviceInfo hapticDeviceInfo = hapticDevice->getSpecifications();
+
+    // create a tool (gripper or pointer)
+    if (hapticDeviceInfo.m_actuatedGripper)
+    {
+        tool = new cToolGripper(bulletWorld);
+    }
+    else
+    {
+        tool = new cToolCursor(bulletWorld);
+    }
+
+    // insert tool into world
+    bulletWorld->addChild(tool);
+
+    // connect the haptic device to the virtual tool
+    tool->setHapticDevice(hapticDevice);
+
+    // map the physical workspace of the haptic device to a larger virtual workspace.
+    tool->setWorkspaceRadius(1.3);
+
+    // define a radius for the virtual tool contact points (sphere)
+    double toolRadius = 0.06;
+    tool->setRadius(toolRadius, toolRadius);
+
+    // enable if objects in the scene are going to rotate of translate
+    // or possibly collide against the tool. If the environment
+    // is entirely static, you can set this parameter to "false"
+    tool->enableDynamicObjects(true);
+
+    // haptic forces are enabled only if small forces are first sent to the device;
+    // this mode avoids the force spike that occurs when the application starts when 
+    // the tool is located inside an object for instance. 
+    tool->setWaitForSmallForce(true);
+
+    // start the haptic tool
+    tool->start();
+
+
+    //--------------------------------------------------------------------------
+    // WIDGETS
+    //--------------------------------------------------------------------------
+
+    // create a font
+    cFontPtr font = NEW_CFONT_CALIBRI_20();
+
+    // create a label to display the haptic and graphic rate of the simulation
+    labelRates = new cLabel(font);
+    labelRates->m_fontColor.setBlack();
+    camera->m_frontLayer->addChild(labelRates);
+
+    // create a label to display the simulation step time
+    labelStepTime = new cLabel(font);
+    labelStepTime->m_fontColor.setBlack();
+    camera->m_frontLayer->addChild(labelStepTime);
+
+
+    //-----------------------------------------------------------------------
+    // SETUP BULLET WORLD AND OBJECTS
+    //-----------------------------------------------------------------------
+
+    //////////////////////////////////////////////////////////////////////////
+    // BULLET WORLD
+    //////////////////////////////////////////////////////////////////////////
+
+    // read the scale factor between the physical workspace of the haptic
+    // device and the virtual workspace defined for the tool
+    double workspaceScaleFactor = tool->getWorkspaceScaleFactor();
+
+    // stiffness properties
+    double maxStiffness	= hapticDeviceInfo.m_maxLinearStiffness / workspaceScaleFactor;
+
+    // set some gravity
+    bulletWorld->setGravity(0.0, 0.0,-9.8);
+
+
+    //////////////////////////////////////////////////////////////////////////
+    // TOWERS OF BULLET BOXES
+    //////////////////////////////////////////////////////////////////////////
+
+    // each tower forms an independent simulation island which can be solved in parallel
+    for (int i=0; i<NUM_TOWERS * NUM_BOXES_PER_TOWER; i++)
+    {
+        cBulletBox* box = new cBulletBox(bulletWorld, BOX_SIZE, BOX_SIZE, BOX_SIZE);
+        bulletWorld->addChild(box);
+
+        // define some material properties
+        cMaterial mat;
+        cColorf color(0.3f + 0.7f * (float)(i % NUM_TOWERS) / (float)NUM_TOWERS, 0.4f, 0.8f);
+        mat.setColor(color);
+        mat.setStiffness(0.3 * maxStiffness);
+        mat.setDynamicFriction(0.6);
+        mat.setStaticFriction(0.6);
+        box->setMaterial(mat);
+
+        // define mass properties
+        box->setMass(0.05);
+        box->estimateInertia();
+
+        // create dynamic model
+        box->buildDynamicModel();
+
+        // create collision detector for haptic interaction
+        box->createAABBCollisionDetector(toolRadius);
+
+        // set friction values
+        box->setSurfaceFriction(0.4);
+
+        bulletBoxes.push_back(box);
+    }
+
+    // place boxes
+    resetTowers();
+
+
+    //////////////////////////////////////////////////////////////////////////
+    // INVISIBLE WALLS
+    //////////////////////////////////////////////////////////////////////////
+
+    // we create 5 static walls to contain the dynamic objects within a limited workspace
+    double planeWidth = 1.0;
+    bulletInvisibleWall1 = new cBulletStaticPlane(bulletWorld, cVector3d(0.0, 0.0, -1.0), -2.0 * planeWidth);
+    bulletInvisibleWall2 = new cBulletStaticPlane(bulletWorld, cVector3d(0.0, -1.0, 0.0), -planeWidth);
+    bulletInvisibleWall3 = new cBulletStaticPlane(bulletWorld, cVector3d(0.0, 1.0, 0.0), -planeWidth);
+    bulletInvisibleWall4 = new cBulletStaticPlane(bulletWorld, cVector3d(-1.0, 0.0, 0.0), -planeWidth);
+    bulletInvisibleWall5 = new cBulletStaticPlane(bulletWorld, cVector3d(1.0, 0.0, 0.0), -0.8 * planeWidth);
+
+
+    //////////////////////////////////////////////////////////////////////////
+    // GROUND
+    //////////////////////////////////////////////////////////////////////////
+
+    // create ground plane
+    bulletGround = new cBulletStaticPlane(bulletWorld, cVector3d(0.0, 0.0, 1.0), -planeWidth);
+
+    // add plane to world as we will want to make it visibe
+    bulletWorld->addChild(bulletGround);
+
+    // create a mesh plane where the static plane is located
+    cCreatePlane(bulletGround, 3.0, 3.0, bulletGround->getPlaneConstant() * bulletGround->getPlaneNormal());
+
+    // define some material properties and apply to mesh
+    cMaterial matGround;
+    matGround.setStiffness(0.3 * maxStiffness);
+    matGround.setDynamicFriction(0.2);
+    matGround.setStaticFriction(0.0);
+    matGround.setWhite();
+    matGround.m_emission.setGrayLevel(0.3);
+    bulletGround->setMaterial(matGround);
+
+    // setup collision detector for haptic interaction
+    bulletGround->createAABBCollisionDetector(toolRadius);
+
+    // set friction values
+    bulletGround->setSurfaceFriction(0.4);
+
+
+    //--------------------------------------------------------------------------
+    // VIEWPORT DISPLAY
+    //--------------------------------------------------------------------------
+
+    // get content scale factor
+    float contentScaleW, contentScaleH;
+    glfwGetWindowContentScale(window, &contentScaleW, &contentScaleH);
+
+    // create a viewport to display the scene.
+    viewport = new cViewport(camera, contentScaleW, contentScaleH);
+
+
+    //-----------------------------------------------------------------------
+    // START HAPTIC SIMULATION THREAD
+    //-----------------------------------------------------------------------
+
+    // create a thread which starts the main haptics rendering loop
+    hapticsThread = new cThread();
+    hapticsThread->start(renderHaptics, CTHREAD_PRIORITY_HAPTICS);
+
+    // setup callback when application exits
+    atexit(close);
+
+
+    //--------------------------------------------------------------------------
+    // MAIN GRAPHIC LOOP
+    //--------------------------------------------------------------------------
+
+    // main graphic loop
+    while (!glfwWindowShouldClose(window))
+    {
+        // render graphics
+        renderGraphics();
+
+        // process events
+        glfwPollEvents();
+    }
+
+    // close window
+    glfwDestroyWindow(window);
+
+    // terminate GLFW library
+    glfwTerminate();
+
+    // exit
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+
+void onWindowSizeCallback(GLFWwindow* a_window, int a_width, int a_height)
+{
+    // update window size
+    windowW = a_width;
+    windowH = a_height;
+
+    // render scene
+    renderGraphics();
+}
+
+//------------------------------------------------------------------------------
+
+void onFrameBufferSizeCallback(GLFWwindow* a_window, int a_width, int a_height)
+{
+    // update frame buffer size
+    framebufferW = a_width;
+    framebufferH = a_height;
+}
+
+//------------------------------------------------------------------------------
+
+void onWindowContentScaleCallback(GLFWwindow* a_window, float a_xscale, float a_yscale)
+{
+    // update window content scale factor
+    viewport->setContentScale(a_xscale, a_yscale);
+}
+
+//------------------------------------------------------------------------------
+
+void onErrorCallback(int a_error, const char* a_description)
+{
+    cout << "Error: " << a_description << endl;
+}
+
+//---------------------------------------------------------------------------
+
+void onKeyCallback(GLFWwindow* a_window, int a_key, int a_scancode, int a_action, int a_mods)
+{
+    // filter calls that only include a key press
+    if ((a_action != GLFW_PRESS) && (a_action != GLFW_REPEAT))
+    {
+        return;
+    }
+
+    // option - exit
+    else if ((a_key == GLFW_KEY_ESCAPE) || (a_key == GLFW_KEY_Q))
+    {
+        glfwSetWindowShouldClose(a_window, GLFW_TRUE);
+    }
+
+    // option - select number of solver threads
+    else if ((a_key >= GLFW_KEY_1) && (a_key <= GLFW_KEY_8))
+    {
+        numSolverThreadsRequested = (unsigned int)(a_key - GLFW_KEY_1 + 1);
+        cout << "> Solver threads: " << numSolverThreadsRequested << "                            \r";
+    }
+
+    // option - use all hardware threads
+    else if (a_key == GLFW_KEY_T)
+    {
+        numSolverThreadsRequested = cMax(std::thread::hardware_concurrency(), 1u);
+        cout << "> Solver threads: " << numSolverThreadsRequested << "                            \r";
+    }
+
+    // option - reset towers
+    else if (a_key == GLFW_KEY_R)
+    {
+        resetRequested = true;
+    }
+
+    // option - enable/disable gravity
+    else if (a_key == GLFW_KEY_G)
+    {
+        if (bulletWorld->getGravity().length() > 0.0)
+        {
+            bulletWorld->setGravity(0.0, 0.0, 0.0);
+        }
+        else
+        {
+            bulletWorld->setGravity(0.0, 0.0,-9.8);
+        }
+    }
+
+    // option - toggle fullscreen
+    else if (a_key == GLFW_KEY_F)
+    {
+        // toggle state variable
+        fullscreen = !fullscreen;
+
+        // get handle to monitor
+        GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+
+        // get information about monitor
+        const GLFWvidmode* mode = glfwGetVideoMode(monitor);
+
+        // set fullscreen or window mode
+        if (fullscreen)
+        {
+            glfwSetWindowMonitor(window, monitor, 0, 0, mode->width, mode->height, mode->refreshRate);
+        }
+        else
+        {
+            int w = 0.8 * mode->height;
+            int h = 0.5 * mode->height;
+            int x = 0.5 * (mode->width - w);
+            int y = 0.5 * (mode->height - h);
+            glfwSetWindowMonitor(window, NULL, x, y, w, h, mode->refreshRate);
+        }
+
+        // set the desired swap interval and number of samples to use for multisampling
+        glfwSwapInterval(swapInterval);
+        glfwWindowHint(GLFW_SAMPLES, 4);
+    }
+
+    // option - toggle vertical mirroring
+    else if (a_key == GLFW_KEY_M)
+    {
+        mirroredDisplay = !mirroredDisplay;
+        camera->setMirrorVertical(mirroredDisplay);
+    }
+}
+
+//---------------------------------------------------------------------------
+
+void close(void)
+{
+    // stop the simulation
+    simulationRunning = false;
+
+    // wait for graphics and haptics loops to terminate
+    while (!simulationFinished) { cSleepMs(100); }
+
+    // close haptic device
+    tool->stop();
+
+    // delete resources
+    delete hapticsThread;
+    delete bulletWorld;
+    delete handler;
+}
+
+//---------------------------------------------------------------------------
+
+void renderGraphics(void)
+{
+    // sanity check
+    if (viewport == nullptr) { return; }
+
+    /////////////////////////////////////////////////////////////////////
+    // UPDATE WIDGETS
+    /////////////////////////////////////////////////////////////////////
+
+    // get width and height of CHAI3D internal rendering buffer
+    int displayW = viewport->getDisplayWidth();
+    int displayH = viewport->getDisplayHeight();
+
+    // update haptic and graphic rate data
+    labelRates->setText(cStr(freqCounterGraphics.getFrequency(), 0) + " Hz / " +
+        cStr(freqCounterHaptics.getFrequency(), 0) + " Hz");
+
+    // update position of label
+    labelRates->setLocalPos((int)(0.5 * (displayW - labelRates->getWidth())), 15);
+
+    // update step time data
+    labelStepTime->setText(cStr((int)bulletBoxes.size()) + " bodies - " + 
+        cStr(bulletWorld->getNumSolverThreads()) + " solver thread(s) - step: " + 
+        cStr(stepTime, 3) + " ms");
+
+    // update position of label
+    labelStepTime->setLocalPos((int)(0.5 * (displayW - labelStepTime->getWidth())), displayH - 40);
+
+
+    /////////////////////////////////////////////////////////////////////
+    // RENDER SCENE
+    /////////////////////////////////////////////////////////////////////
+
+    // update shadow maps (if any)
+    bulletWorld->updateShadowMaps(false, mirroredDisplay);
+
+    // render world
+    viewport->renderView(framebufferW, framebufferH);
+
+    // wait until all GL commands are completed
+    glFinish();
+
+    // check for any OpenGL errors
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) printf("Error:  %s\n", gluErrorString(error));
+
+    // swap buffers
+    glfwSwapBuffers(window);
+
+    // signal frequency counter
+    freqCounterGraphics.signal(1);
+}
+
+//---------------------------------------------------------------------------
+
+void renderHaptics(void)
+{
+    // simulation in now running
+    simulationRunning  = true;
+    simulationFinished = false;
+
+    // reset clock
+    cPrecisionClock clock;
+    clock.reset();
+
+    // clock measuring the time spent stepping the simulation
+    cPrecisionClock stepClock;
+
+    // main haptic simulation loop
+    while(simulationRunning)
+    {
+        /////////////////////////////////////////////////////////////////////
+        // SIMULATION TIME    
+        /////////////////////////////////////////////////////////////////////
+
+        // stop the simulation clock
+        clock.stop();
+
+        // read the time increment in seconds
+        double timeInterval = cClamp(clock.getCurrentTimeSeconds(), 0.0001, 0.001);
+
+        // restart the simulation clock
+        clock.reset();
+        clock.start();
+
+        // signal frequency counter
+        freqCounterHaptics.signal(1);
+
+
+        /////////////////////////////////////////////////////////////////////
+        // HAPTIC FORCE COMPUTATION
+        /////////////////////////////////////////////////////////////////////
+
+        // compute global reference frames for each object
+        bulletWorld->computeGlobalPositions(true);
+
+        // update position and orientation of tool
+        tool->updateFromDevice();
+
+        // compute interaction forces
+        tool->computeInteractionForces();
+
+        // send forces to haptic device
+        tool->applyToDevice();
+
+
+        /////////////////////////////////////////////////////////////////////
+        // DYNAMIC SIMULATION
+        /////////////////////////////////////////////////////////////////////
+
+        // apply settings requested by the user
+        if (bulletWorld->getNumSolverThreads() != numSolverThreadsRequested)
+        {
+            bulletWorld->setNumSolverThreads(numSolverThreadsRequested);
+        }
+
+        if (resetRequested)
+        {
+            resetTowers();
+            resetRequested = false;
+        }
+
+        // for each interaction point of the tool we look for any contact events
+        // with the environment and apply forces accordingly
+        int numInteractionPoints = tool->getNumHapticPoints();
+        for (int i=0; i<numInteractionPoints; i++)
+        {
+            // get pointer to next interaction point of tool
+            cHapticPoint* interactionPoint = tool->getHapticPoint(i);
+
+            // check all contact points
+            int numContacts = interactionPoint->getNumCollisionEvents();
+            for (int k=0; k<numContacts; k++)
+            {
+                cCollisionEvent* collisionEvent = interactionPoint->getCollisionEvent(k);
+
+                // given the mesh object we may be touching, we search for its owner which
+                // could be the mesh itself or a multi-mesh object. Once the owner found, we
+                // look for the parent that will point to the Bullet object itself.
+                cGenericObject* object = collisionEvent->m_object->getOwner()->getOwner();
+
+                // cast to Bullet object
+                cBulletGenericObject* bulletobject = dynamic_cast<cBulletGenericObject*>(object);
+
+                // if Bullet object, we apply interaction forces
+                if (bulletobject != NULL)
+                {
+                    bulletobject->addExternalForceAtPoint(-interactionPoint->getLastComputedForce(),
+                                                           collisionEvent->m_globalPos - object->getLocalPos());
+                }
+            }
+        }
+
+        // update simulation and measure step time
+        stepClock.reset();
+        stepClock.start();
+
+        bulletWorld->updateDynamics(timeInterval);
+
+        stepTime = 0.99 * stepTime + 0.01 * (1000.0 * stepClock.getCurrentTimeSeconds());
+    }
+
+    // exit haptics thread
+    simulationFinished = true;
+}
+
+//---------------------------------------------------------------------------
+
+void resetTowers(void)
+{
+    int index = 0;
+    for (int i=0; i<NUM_TOWERS; i++)
+    {
+        // towers are placed on a circle, far enough apart not to touch each other
+        double angle = C_TWO_PI * (double)i / (double)NUM_TOWERS;
+        double x = 0.5 * cos(angle);
+        double y = 0.5 * sin(angle);
+
+        for (int j=0; j<NUM_BOXES_PER_TOWER; j++)
+        {
+            cBulletBox* box = bulletBoxes[index];
+            box->setLocalPos(x, y, -1.0 + (j + 0.5) * BOX_SIZE);
+            box->setLocalRot(cIdentity3d());
+            if (box->m_bulletRigidBody)
+            {
+                box->m_bulletRigidBody->setLinearVelocity(btVector3(0, 0, 0));
+                box->m_bulletRigidBody->setAngularVelocity(btVector3(0, 0, 0));
+                box->m_bulletRigidBody->activate();
+            }
+            index++;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
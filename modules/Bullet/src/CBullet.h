@@ -75,12 +75,18 @@
 #define BT_USE_DOUBLE_PRECISION
 #endif
 
+#ifndef BT_NO_PROFILE
+#define BT_NO_PROFILE
+#endif
+
 #include "CBulletWorld.h"
 #include "CBulletGenericObject.h"
 #include "CBulletBox.h"
 #include "CBulletCylinder.h"
 #include "CBulletMesh.h"
 #include "CBulletMultiMesh.h"
+#include "CBulletParallelDynamicsWorld.h"
+#include "CBulletShapeCache.h"
 #include "CBulletSphere.h"
 #include "CBulletStaticPlane.h"
 #include "CBulletVehicle.h"
@@ -51,6 +51,21 @@
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//==============================================================================
+/*!
+    Atomically adds a value to a double precision variable.
+
+    \param  a_value      Variable to update.
+    \param  a_increment  Value to add.
+*/
+//==============================================================================
+static inline void cAtomicAdd(std::atomic<double>& a_value, const double a_increment)
+{
+    double current = a_value.load();
+    while (!a_value.compare_exchange_weak(current, current + a_increment)) {}
+}
+
+
 //==============================================================================
 /*!
     This method initializes the Bullet dynamic model.
@@ -68,15 +83,24 @@ void cBulletGenericObject::initialize(cBulletWorld* a_world)
     m_inertia.zero();
     m_mass = 0;
     m_static = true;
+    m_sleepingEnabled = false;
+    m_sleepingLinearThreshold = 0.8;
+    m_sleepingAngularThreshold = 1.0;
+    m_collisionShapeRequest = NULL;
+    for (int i=0; i<3; i++)
+    {
+        m_queuedForce[i] = 0.0;
+        m_queuedTorque[i] = 0.0;
+    }
 
     // store reference to bullet world
     m_dynamicWorld = a_world;
 
     // add body to world
-    m_dynamicWorld->m_bodies.push_back(this);
+    m_dynamicWorld->addBody(this);
 
     // create motion state
-    m_bulletMotionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(0, 0, 0)));
+    m_bulletMotionState = new cBulletMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(0, 0, 0)));
 }
 
 
@@ -87,13 +111,19 @@ void cBulletGenericObject::initialize(cBulletWorld* a_world)
 //==============================================================================
 cBulletGenericObject::~cBulletGenericObject()
 {
+    discardCollisionShapeRequest();
+
     if (m_bulletRigidBody)
     {
         delete m_bulletRigidBody;
     }
     if (m_bulletCollisionShape)
     {
-        delete m_bulletCollisionShape;
+        // shapes shared through the shape cache are only released
+        if (!cBulletShapeCache::releaseShape(m_bulletCollisionShape))
+        {
+            delete m_bulletCollisionShape;
+        }
     }
     if (m_bulletMotionState)
     {
@@ -184,6 +214,179 @@ void cBulletGenericObject::setStatic(bool a_static)
 }
 
 
+//==============================================================================
+/*!
+    This method enables or disables sleeping for this object. A sleeping 
+    object is no longer integrated by Bullet and its position is no longer 
+    synchronized with its CHAI3D representation until it is woken up by a 
+    contact or an external force. By default, objects never sleep.
+
+    \param  a_enabled           If __true__ then the object may sleep.
+    \param  a_linearThreshold   Linear velocity below which the object may sleep.
+    \param  a_angularThreshold  Angular velocity below which the object may sleep.
+*/
+//==============================================================================
+void cBulletGenericObject::setSleepingEnabled(const bool a_enabled, 
+                                              const double a_linearThreshold, 
+                                              const double a_angularThreshold)
+{
+    m_sleepingEnabled = a_enabled;
+    m_sleepingLinearThreshold = a_linearThreshold;
+    m_sleepingAngularThreshold = a_angularThreshold;
+
+    if (m_bulletRigidBody)
+    {
+        if (m_sleepingEnabled)
+        {
+            m_bulletRigidBody->forceActivationState(ACTIVE_TAG);
+            m_bulletRigidBody->setSleepingThresholds(m_sleepingLinearThreshold, m_sleepingAngularThreshold);
+        }
+        else
+        {
+            m_bulletRigidBody->forceActivationState(DISABLE_DEACTIVATION);
+            m_bulletRigidBody->setSleepingThresholds(0, 0);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if the transform of the object has been 
+    updated by the Bullet dynamics engine since the last call. Static and 
+    sleeping objects are not updated by Bullet.
+
+    \return __true__ if the object has moved, __false__ otherwise.
+*/
+//==============================================================================
+bool cBulletGenericObject::checkUpdatedFromDynamics()
+{
+    if ((m_bulletRigidBody == NULL) || (m_bulletMotionState == NULL))
+    {
+        return (false);
+    }
+
+    return (m_bulletMotionState->m_updated.exchange(false));
+}
+
+
+//==============================================================================
+/*!
+    This method replaces the collision shape of this object. If the dynamic 
+    model has already been built, the rigid body is removed from and added 
+    back to the Bullet world so that its contacts are recomputed with the 
+    new shape, and its inertia is recomputed from the new shape. The previous
+    shape is released. This method must not be called while the world is 
+    being simulated.
+
+    \param  a_shape  New collision shape.
+*/
+//==============================================================================
+void cBulletGenericObject::setCollisionShape(btCollisionShape* a_shape)
+{
+    btCollisionShape* previousShape = m_bulletCollisionShape;
+    m_bulletCollisionShape = a_shape;
+
+    if (m_bulletRigidBody)
+    {
+        m_dynamicWorld->m_bulletWorld->removeRigidBody(m_bulletRigidBody);
+        m_bulletRigidBody->setCollisionShape(m_bulletCollisionShape);
+
+        // update inertia to match the new shape
+        if (m_bulletCollisionShape)
+        {
+            estimateInertia();
+            btVector3 inertia(m_inertia(0), m_inertia(1), m_inertia(2));
+            m_bulletRigidBody->setMassProps(m_mass, inertia);
+            m_bulletRigidBody->updateInertiaTensor();
+        }
+
+        m_dynamicWorld->m_bulletWorld->addRigidBody(m_bulletRigidBody);
+        m_bulletRigidBody->activate();
+    }
+
+    if ((previousShape != NULL) && (previousShape != a_shape))
+    {
+        // shapes shared through the shape cache are only released
+        if (!cBulletShapeCache::releaseShape(previousShape))
+        {
+            delete previousShape;
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method requests a collision shape to be built in the background from
+    a mesh. The shape is assigned to this object by the Bullet world, between 
+    two simulation steps, once available.
+
+    \param  a_mesh      Mesh.
+    \param  a_type      Type of collision shape.
+    \param  a_margin    Collision margin.
+    \param  a_settings  Settings used by convex decompositions.
+*/
+//==============================================================================
+void cBulletGenericObject::requestCollisionShape(cMesh* a_mesh, 
+                                                 const cBulletShapeType a_type, 
+                                                 const double a_margin,
+                                                 const cBulletDecompositionSettings& a_settings)
+{
+    discardCollisionShapeRequest();
+
+    m_collisionShapeRequest = cBulletShapeCache::requestShape(a_mesh, a_type, a_margin, a_settings);
+    m_dynamicWorld->m_numCollisionShapeRequests++;
+}
+
+
+//==============================================================================
+/*!
+    This method discards a pending collision shape request.
+*/
+//==============================================================================
+void cBulletGenericObject::discardCollisionShapeRequest()
+{
+    if (m_collisionShapeRequest != NULL)
+    {
+        cBulletShapeCache::discardRequest(m_collisionShapeRequest);
+        m_collisionShapeRequest = NULL;
+        m_dynamicWorld->m_numCollisionShapeRequests--;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method assigns the collision shape built in the background to this
+    object once it is available.
+
+    \return __true__ if a new collision shape was assigned, __false__ otherwise.
+*/
+//==============================================================================
+bool cBulletGenericObject::applyRequestedCollisionShape()
+{
+    if ((m_collisionShapeRequest == NULL) || (!m_collisionShapeRequest->m_completed))
+    {
+        return (false);
+    }
+
+    btCollisionShape* shape = m_collisionShapeRequest->m_shape;
+    delete m_collisionShapeRequest;
+    m_collisionShapeRequest = NULL;
+    m_dynamicWorld->m_numCollisionShapeRequests--;
+
+    if (shape == NULL)
+    {
+        return (false);
+    }
+
+    setCollisionShape(shape);
+
+    return (true);
+}
+
+
 //==============================================================================
 /*!
     This method builds a dynamic representation of the object in the Bullet
@@ -201,8 +404,7 @@ void cBulletGenericObject::buildDynamicModel()
     m_bulletRigidBody = new btRigidBody(rigidBodyCI);
 
     // by default deactivate sleeping mode
-    m_bulletRigidBody->setActivationState(DISABLE_DEACTIVATION);
-    m_bulletRigidBody->setSleepingThresholds(0, 0);
+    setSleepingEnabled(m_sleepingEnabled, m_sleepingLinearThreshold, m_sleepingAngularThreshold);
 
     // add bullet rigid body to bullet world
     m_dynamicWorld->m_bulletWorld->addRigidBody(m_bulletRigidBody);
@@ -221,6 +423,17 @@ void cBulletGenericObject::buildDynamicModel()
 void cBulletGenericObject::addExternalForceAtPoint(const cVector3d& a_force,
                                                    const cVector3d& a_relativePos)
 {
+    if (m_dynamicWorld->getSimulationThreadRunning())
+    {
+        cVector3d torque = cCross(a_relativePos, a_force);
+        for (int i=0; i<3; i++)
+        {
+            cAtomicAdd(m_queuedForce[i], a_force(i));
+            cAtomicAdd(m_queuedTorque[i], torque(i));
+        }
+        return;
+    }
+
     if (m_bulletRigidBody)
     {
         m_bulletRigidBody->applyForce(btVector3(a_force(0), a_force(1), a_force(2)),  btVector3(a_relativePos(0), a_relativePos(1), a_relativePos(2)));
@@ -237,6 +450,15 @@ void cBulletGenericObject::addExternalForceAtPoint(const cVector3d& a_force,
 //==============================================================================
 void cBulletGenericObject::addExternalForce(const cVector3d& a_force)
 {
+    if (m_dynamicWorld->getSimulationThreadRunning())
+    {
+        for (int i=0; i<3; i++)
+        {
+            cAtomicAdd(m_queuedForce[i], a_force(i));
+        }
+        return;
+    }
+
     if (m_bulletRigidBody)
     {
          m_bulletRigidBody->applyCentralForce(btVector3(a_force(0), a_force(1), a_force(2)));
@@ -253,6 +475,15 @@ void cBulletGenericObject::addExternalForce(const cVector3d& a_force)
 //==============================================================================
 void cBulletGenericObject::addExternalTorque(const cVector3d& a_torque)
 {
+    if (m_dynamicWorld->getSimulationThreadRunning())
+    {
+        for (int i=0; i<3; i++)
+        {
+            cAtomicAdd(m_queuedTorque[i], a_torque(i));
+        }
+        return;
+    }
+
     if (m_bulletRigidBody)
     {
         m_bulletRigidBody->applyTorque(btVector3(a_torque(0), a_torque(1), a_torque(2)));
@@ -260,6 +491,37 @@ void cBulletGenericObject::addExternalTorque(const cVector3d& a_torque)
 }
 
 
+//==============================================================================
+/*!
+    This method applies the external forces and torques that were queued by
+    other threads while the simulation thread is running, then clears the 
+    queue. This method is called by the simulation thread before each step.
+
+    \param  a_scale  Scale factor applied to the accumulated forces and torques.
+*/
+//==============================================================================
+void cBulletGenericObject::applyQueuedForces(const double a_scale)
+{
+    btVector3 force, torque;
+    for (int i=0; i<3; i++)
+    {
+        force[i]  = (btScalar)(a_scale * m_queuedForce[i].exchange(0.0));
+        torque[i] = (btScalar)(a_scale * m_queuedTorque[i].exchange(0.0));
+    }
+
+    if (m_bulletRigidBody == NULL) { return; }
+
+    if (!force.isZero())
+    {
+        m_bulletRigidBody->applyCentralForce(force);
+    }
+    if (!torque.isZero())
+    {
+        m_bulletRigidBody->applyTorque(torque);
+    }
+}
+
+
 //==============================================================================
 /*!
     This method assigns a linear and angular damping term to the object.
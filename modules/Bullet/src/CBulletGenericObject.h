@@ -48,6 +48,9 @@
 #include "chai3d.h"
 //------------------------------------------------------------------------------
 #include "btBulletDynamicsCommon.h"
+#include "CBulletShapeCache.h"
+//------------------------------------------------------------------------------
+#include <atomic>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -78,6 +81,36 @@ enum cBulletDynamicModelType
 };
 //------------------------------------------------------------------------------
 
+//==============================================================================
+/*!
+    \class      cBulletMotionState
+    \ingroup    Bullet
+
+    \brief
+    This class implements a Bullet motion state which records when its 
+    transform has been updated.
+
+    \details
+    Bullet only updates the motion states of bodies which are active. The
+    flag raised by this motion state lets the Bullet world synchronize the
+    CHAI3D representation of bodies that have moved, and skip those which are
+    static or sleeping.
+*/
+//==============================================================================
+class cBulletMotionState : public btDefaultMotionState
+{
+public:
+
+    //! Constructor of cBulletMotionState.
+    cBulletMotionState(const btTransform& a_transform) : btDefaultMotionState(a_transform), m_updated(true) {}
+
+    //! This method is called by Bullet to assign a new transform to the body.
+    virtual void setWorldTransform(const btTransform& a_transform) { btDefaultMotionState::setWorldTransform(a_transform); m_updated = true; }
+
+    //! If __true__ then the transform has changed since it was last read by the CHAI3D world.
+    std::atomic<bool> m_updated;
+};
+
 //==============================================================================
 /*!
     \class      cBulletGenericObjectH
@@ -142,6 +175,12 @@ public:
     //! This method enables of disables the object to be static in the world.
     virtual void setStatic(bool a_static);
 
+    //! This method enables or disables sleeping when the object comes to rest.
+    void setSleepingEnabled(const bool a_enabled, const double a_linearThreshold = 0.8, const double a_angularThreshold = 1.0);
+
+    //! This method returns __true__ if the object is allowed to sleep, __false__ otherwise.
+    bool getSleepingEnabled() const { return (m_sleepingEnabled); }
+
     //! This method returns __true__ if the object is static, __false__ otherwise.
     virtual bool getStatic() const { return (m_static); } 
 
@@ -151,6 +190,31 @@ public:
     //! This method updates the CHAI3D position representation from the Bullet dynamics engine.
     virtual void updatePositionFromDynamics() {}
 
+    //! This method returns __true__ if the Bullet dynamics engine has moved the object since the last call, and clears the flag.
+    bool checkUpdatedFromDynamics();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - COLLISION SHAPE:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method replaces the collision shape of this object.
+    void setCollisionShape(btCollisionShape* a_shape);
+
+    //! This method returns __true__ if a collision shape is being built in the background for this object.
+    bool getCollisionShapePending() const { return (m_collisionShapeRequest != NULL); }
+
+    //! This method assigns the collision shape built in the background once it is available.
+    bool applyRequestedCollisionShape();
+
+    //! This method discards a pending collision shape request.
+    void discardCollisionShapeRequest();
+
+    //! This method assigns a position and orientation computed by the simulation thread to the CHAI3D representation.
+    virtual void setPositionFromDynamics(const cVector3d& a_pos, const cMatrix3d& a_rot) {}
+
 
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - FRICTION PROPERTIES:
@@ -181,6 +245,9 @@ public:
     void addExternalForceAtPoint(const cVector3d& a_force,
                                  const cVector3d& a_relativePos);
 
+    //! This method applies the forces queued while the simulation thread is running and clears the queue.
+    void applyQueuedForces(const double a_scale);
+
 
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - DAMPING:
@@ -214,7 +281,7 @@ public:
     btCollisionShape* m_bulletCollisionShape;
 
     //! Bullet motion state.
-    btDefaultMotionState* m_bulletMotionState;
+    cBulletMotionState* m_bulletMotionState;
 
 
     //--------------------------------------------------------------------------
@@ -226,6 +293,13 @@ protected:
     //! This method initializes the Bullet object.
     virtual void initialize(cBulletWorld* a_world);
 
+    //! This method requests a collision shape to be built in the background from a mesh.
+    void requestCollisionShape(cMesh* a_mesh, 
+                               const cBulletShapeType a_type, 
+                               const double a_margin,
+                               const cBulletDecompositionSettings& a_settings);
+
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
@@ -241,6 +315,24 @@ protected:
 
     //! Inertia properties.
     cVector3d m_inertia;
+
+    //! If __true__ then the object may sleep when it comes to rest.
+    bool m_sleepingEnabled;
+
+    //! Linear velocity below which the object may sleep.
+    double m_sleepingLinearThreshold;
+
+    //! Angular velocity below which the object may sleep.
+    double m_sleepingAngularThreshold;
+
+    //! Collision shape being built in the background.
+    cBulletShapeRequest* m_collisionShapeRequest;
+
+    //! External force accumulated from other threads while the simulation thread is running.
+    std::atomic<double> m_queuedForce[3];
+
+    //! External torque accumulated from other threads while the simulation thread is running.
+    std::atomic<double> m_queuedTorque[3];
 };
 
 //------------------------------------------------------------------------------
@@ -67,6 +67,7 @@ namespace chai3d {
 void cBulletMesh::setLocalPos(const cVector3d& a_position)
 {
     m_localPos = a_position;
+    invalidateGlobalPositions();
 
     // get transformation matrix of object
     btTransform trans;
@@ -107,6 +108,7 @@ void cBulletMesh::setLocalPos(const cVector3d& a_position)
 void cBulletMesh::setLocalRot(const cMatrix3d& a_rotation)
 {
     m_localRot = a_rotation;
+    invalidateGlobalPositions();
 
     // get transformation matrix of object
     btTransform trans;
@@ -163,96 +165,124 @@ void cBulletMesh::updatePositionFromDynamics()
 
         // orthogonalize frame
         m_localRot.orthogonalize();
+        invalidateGlobalPositions();
     }
 }
 
 
 //==============================================================================
 /*!
-    This method creates a Bullet collision model for this object.
+    This method assigns a position and orientation computed by the simulation 
+    thread of the Bullet world to the CHAI3D representation.
+
+    \param  a_pos  Position of the body.
+    \param  a_rot  Orientation of the body.
 */
 //==============================================================================
-void cBulletMesh::buildContactTriangles(const double a_margin)
+void cBulletMesh::setPositionFromDynamics(const cVector3d& a_pos, const cMatrix3d& a_rot)
 {
-    // bullet mesh
-    btTriangleMesh* mesh = new btTriangleMesh();
-
-    // read number of triangles of the object
-    unsigned int numTriangles = m_triangles->getNumElements();
- 
-    // add all triangles to Bullet model
-    for (unsigned int i=0; i<numTriangles; i++)
-    {
-        unsigned int vertexIndex0 = m_triangles->getVertexIndex0(i);
-        unsigned int vertexIndex1 = m_triangles->getVertexIndex1(i);
-        unsigned int vertexIndex2 = m_triangles->getVertexIndex2(i);
+    m_localPos = a_pos;
+    m_localRot = a_rot;
+    invalidateGlobalPositions();
+}
 
-        cVector3d vertex0 = m_vertices->getLocalPos(vertexIndex0);
-        cVector3d vertex1 = m_vertices->getLocalPos(vertexIndex1);
-        cVector3d vertex2 = m_vertices->getLocalPos(vertexIndex2);
 
-        mesh->addTriangle(btVector3(vertex0(0), vertex0(1), vertex0(2)), 
-                          btVector3(vertex1(0), vertex1(1), vertex1(2)), 
-                          btVector3(vertex2(0), vertex2(1), vertex2(2)));
-    }
-
-    // create mesh collision model
-    m_bulletCollisionShape = new btGImpactMeshShape(mesh);
+//==============================================================================
+/*!
+    This method creates a Bullet collision model for this object. The model
+    is a concave triangle mesh which can be used for dynamic objects. 
+    Objects with identical geometry share the same collision model.
 
-    m_bulletCollisionShape->setMargin(a_margin);
-    ((btGImpactMeshShape*)(m_bulletCollisionShape))->updateBound();
+    \param  a_margin  Collision margin.
+*/
+//==============================================================================
+void cBulletMesh::buildContactTriangles(const double a_margin)
+{
+    m_bulletCollisionShape = cBulletShapeCache::acquireShape(this, BULLET_SHAPE_TRIANGLES, a_margin);
 }
 
 
 //==============================================================================
 /*!
-    This method creates a Bullet collision model for this object.
+    This method creates a Bullet collision model for this object. The model
+    is the convex hull of all triangles. Objects with identical geometry 
+    share the same collision model.
+
+    \param  a_margin  Collision margin.
 */
 //==============================================================================
 void cBulletMesh::buildContactConvexTriangles(const double a_margin)
 {
-    // bullet mesh
-    btTriangleMesh* mesh = new btTriangleMesh();
-
-    // read number of triangles of the object
-    unsigned int numTriangles = m_triangles->getNumElements();
- 
-    // add all triangles to Bullet model
-    for (unsigned int i=0; i<numTriangles; i++)
-    {
-        unsigned int vertexIndex0 = m_triangles->getVertexIndex0(i);
-        unsigned int vertexIndex1 = m_triangles->getVertexIndex1(i);
-        unsigned int vertexIndex2 = m_triangles->getVertexIndex2(i);
+    m_bulletCollisionShape = cBulletShapeCache::acquireShape(this, BULLET_SHAPE_CONVEX_TRIANGLES, a_margin);
+}
 
-        cVector3d vertex0 = m_vertices->getLocalPos(vertexIndex0);
-        cVector3d vertex1 = m_vertices->getLocalPos(vertexIndex1);
-        cVector3d vertex2 = m_vertices->getLocalPos(vertexIndex2);
 
-        mesh->addTriangle(btVector3(vertex0(0), vertex0(1), vertex0(2)), 
-                          btVector3(vertex1(0), vertex1(1), vertex1(2)), 
-                          btVector3(vertex2(0), vertex2(1), vertex2(2)));
-    }
+//==============================================================================
+/*!
+    This method creates a Bullet collision model for this object. The model
+    is the convex hull of all vertices. Objects with identical geometry 
+    share the same collision model, and the hull is stored in the disk cache
+    of \ref cBulletShapeCache if enabled.
+
+    \param  a_margin  Collision margin.
+*/
+//==============================================================================
+void cBulletMesh::buildContactHull(const double a_margin)
+{
+    m_bulletCollisionShape = cBulletShapeCache::acquireShape(this, BULLET_SHAPE_HULL, a_margin);
+}
 
-    // create mesh collision model
-    m_bulletCollisionShape = new btConvexTriangleMeshShape(mesh);
 
-    // set margin
-    m_bulletCollisionShape->setMargin(a_margin);
+//==============================================================================
+/*!
+    This method creates a Bullet collision model for this object. The model
+    is a concave triangle mesh organized in a bounding volume hierarchy, 
+    which is the most efficient representation for large meshes but can 
+    only be used by static objects (zero mass). Objects with identical 
+    geometry share the same collision model, and the hierarchy is stored in 
+    the disk cache of \ref cBulletShapeCache if enabled.
+
+    \param  a_margin  Collision margin.
+*/
+//==============================================================================
+void cBulletMesh::buildContactStaticTriangles(const double a_margin)
+{
+    m_bulletCollisionShape = cBulletShapeCache::acquireShape(this, BULLET_SHAPE_STATIC_TRIANGLES, a_margin);
 }
 
 
 //==============================================================================
 /*!
-    This method creates a Bullet collision model for this object.
+    This method creates a Bullet collision model composed of convex pieces 
+    which approximate this object. This model is well suited to concave 
+    dynamic objects, which it simulates much faster and more robustly than
+    a triangle mesh. Objects with identical geometry and settings share the 
+    same collision model, and the convex pieces are stored in the disk cache
+    of \ref cBulletShapeCache if enabled.
+
+    Computing the decomposition of a large mesh can take several seconds. If
+    __a_buildInBackground__ is __true__, the convex hull of the object is used
+    until the decomposition, computed by a background thread, is assigned by 
+    the Bullet world between two simulation steps.
+
+    \param  a_margin             Collision margin.
+    \param  a_buildInBackground  If __true__ then the decomposition is computed by a background thread.
+    \param  a_settings           Settings of the convex decomposition.
 */
 //==============================================================================
-void cBulletMesh::buildContactHull(const double a_margin)
+void cBulletMesh::buildContactConvexDecomposition(const double a_margin, 
+                                                  const bool a_buildInBackground,
+                                                  const cBulletDecompositionSettings& a_settings)
 {
-    // create convex hull
-    m_bulletCollisionShape = new btConvexHullShape((double*)(&m_vertices->m_localPos[0]), m_vertices->getNumElements(), sizeof(cVector3d));
-    
-    // set margin
-    m_bulletCollisionShape->setMargin(a_margin);
+    if (a_buildInBackground)
+    {
+        m_bulletCollisionShape = cBulletShapeCache::acquireShape(this, BULLET_SHAPE_HULL, a_margin);
+        requestCollisionShape(this, BULLET_SHAPE_CONVEX_DECOMPOSITION, a_margin, a_settings);
+    }
+    else
+    {
+        m_bulletCollisionShape = cBulletShapeCache::acquireShape(this, BULLET_SHAPE_CONVEX_DECOMPOSITION, a_margin, a_settings);
+    }
 }
 
 
@@ -116,6 +116,9 @@ public:
     //! This method update the CHAI3D position representation from the Bullet dynamics engine.
     virtual void updatePositionFromDynamics();
 
+    //! This method assigns a position and orientation computed by the simulation thread to the CHAI3D representation.
+    virtual void setPositionFromDynamics(const cVector3d& a_pos, const cMatrix3d& a_rot);
+
 
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - CONTACT MODEL:
@@ -131,6 +134,14 @@ public:
 
     //! This method creates a Bullet collision model for this object.
     virtual void buildContactHull(const double a_margin = 0.01);
+
+    //! This method creates a Bullet collision model for this static object.
+    virtual void buildContactStaticTriangles(const double a_margin = 0.01);
+
+    //! This method creates a Bullet collision model composed of convex pieces approximating this object.
+    virtual void buildContactConvexDecomposition(const double a_margin = 0.01, 
+                                                 const bool a_buildInBackground = true,
+                                                 const cBulletDecompositionSettings& a_settings = cBulletDecompositionSettings());
 };
 
 //------------------------------------------------------------------------------
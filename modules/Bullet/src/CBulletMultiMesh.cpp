@@ -67,6 +67,7 @@ namespace chai3d {
 void cBulletMultiMesh::setLocalPos(const cVector3d& a_position)
 {
     m_localPos = a_position;
+    invalidateGlobalPositions();
 
     // get transformation matrix of object
     btTransform trans;
@@ -107,6 +108,7 @@ void cBulletMultiMesh::setLocalPos(const cVector3d& a_position)
 void cBulletMultiMesh::setLocalRot(const cMatrix3d& a_rotation)
 {
     m_localRot = a_rotation;
+    invalidateGlobalPositions();
 
     // get transformation matrix of object
     btTransform trans;
@@ -163,10 +165,28 @@ void cBulletMultiMesh::updatePositionFromDynamics()
 
         // orthogonalize frame
         m_localRot.orthogonalize();
+        invalidateGlobalPositions();
     }
 }
 
 
+//==============================================================================
+/*!
+    This method assigns a position and orientation computed by the simulation 
+    thread of the Bullet world to the CHAI3D representation.
+
+    \param  a_pos  Position of the body.
+    \param  a_rot  Orientation of the body.
+*/
+//==============================================================================
+void cBulletMultiMesh::setPositionFromDynamics(const cVector3d& a_pos, const cMatrix3d& a_rot)
+{
+    m_localPos = a_pos;
+    m_localRot = a_rot;
+    invalidateGlobalPositions();
+}
+
+
 //==============================================================================
 /*!
     This method creates a Bullet collision model for this object.
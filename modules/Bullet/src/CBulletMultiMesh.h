@@ -116,6 +116,9 @@ public:
     //! This method update the CHAI3D position representation from the Bullet dynamics engine.
     virtual void updatePositionFromDynamics();
 
+    //! This method assigns a position and orientation computed by the simulation thread to the CHAI3D representation.
+    virtual void setPositionFromDynamics(const cVector3d& a_pos, const cMatrix3d& a_rot);
+
 
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - CONTACT MODEL:
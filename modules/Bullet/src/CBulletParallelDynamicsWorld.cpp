@@ -0,0 +1,351 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   1.0.0
+*/
+//==============================================================================
+
+
+//------------------------------------------------------------------------------
+#include "CBulletParallelDynamicsWorld.h"
+//------------------------------------------------------------------------------
+#include <algorithm>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    This function returns the island to which a constraint belongs.
+
+    \param  a_constraint  Constraint.
+
+    \return Island identifier.
+*/
+//==============================================================================
+static inline int cGetConstraintIslandId(const btTypedConstraint* a_constraint)
+{
+    const btCollisionObject& body0 = a_constraint->getRigidBodyA();
+    const btCollisionObject& body1 = a_constraint->getRigidBodyB();
+    return ((body0.getIslandTag() >= 0) ? body0.getIslandTag() : body1.getIslandTag());
+}
+
+
+//------------------------------------------------------------------------------
+// Sorting predicate ordering constraints by island.
+struct cConstraintIslandPredicate
+{
+    bool operator()(const btTypedConstraint* a_lhs, const btTypedConstraint* a_rhs) const
+    {
+        return (cGetConstraintIslandId(a_lhs) < cGetConstraintIslandId(a_rhs));
+    }
+};
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    Constructor of cBulletParallelDynamicsWorld.
+
+    \param  a_dispatcher              Collision dispatcher.
+    \param  a_broadphase              Broad phase collision detection algorithm.
+    \param  a_solver                  Constraint solver used when running on a single thread.
+    \param  a_collisionConfiguration  Collision configuration.
+*/
+//==============================================================================
+cBulletParallelDynamicsWorld::cBulletParallelDynamicsWorld(btDispatcher* a_dispatcher,
+                                                           btBroadphaseInterface* a_broadphase,
+                                                           btConstraintSolver* a_solver,
+                                                           btCollisionConfiguration* a_collisionConfiguration) :
+    btDiscreteDynamicsWorld(a_dispatcher, a_broadphase, a_solver, a_collisionConfiguration)
+{
+    m_numThreads = 1;
+    m_solverInfo = NULL;
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cBulletParallelDynamicsWorld.
+*/
+//==============================================================================
+cBulletParallelDynamicsWorld::~cBulletParallelDynamicsWorld()
+{
+    // stop worker threads before releasing their solvers
+    m_threadPool.setNumThreads(1);
+
+    for (unsigned int i=0; i<m_solvers.size(); i++)
+    {
+        delete m_solvers[i];
+    }
+    m_solvers.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method sets the number of threads used to solve constraints, 
+    including the thread that steps the simulation. A value of 1 disables 
+    multithreading. This method must not be called during a simulation step.
+
+    \param  a_numThreads  Number of threads.
+*/
+//==============================================================================
+void cBulletParallelDynamicsWorld::setNumThreads(const unsigned int a_numThreads)
+{
+    unsigned int numThreads = cMax(a_numThreads, 1u);
+    if (numThreads == m_numThreads)
+    {
+        return;
+    }
+
+    // one solver per thread
+    while (m_solvers.size() < numThreads)
+    {
+        m_solvers.push_back(new btSequentialImpulseConstraintSolver());
+    }
+    while (m_solvers.size() > numThreads)
+    {
+        delete m_solvers.back();
+        m_solvers.pop_back();
+    }
+
+    m_numThreads = numThreads;
+    m_threadIslands.resize(m_numThreads);
+
+    m_threadPool.setNumThreads(m_numThreads);
+}
+
+
+//==============================================================================
+/*!
+    This method solves all constraints of the world. Islands are first 
+    collected, then distributed between threads and solved in parallel.
+
+    \param  a_solverInfo  Solver settings.
+*/
+//==============================================================================
+void cBulletParallelDynamicsWorld::solveConstraints(btContactSolverInfo& a_solverInfo)
+{
+    // fall back to the serial solver when islands cannot be solved independently
+    if ((m_numThreads <= 1) || 
+        (!getSimulationIslandManager()->getSplitIslands()) ||
+        (m_constraintSolver->getSolverType() != BT_SEQUENTIAL_IMPULSE_SOLVER))
+    {
+        btDiscreteDynamicsWorld::solveConstraints(a_solverInfo);
+        return;
+    }
+
+    BT_PROFILE("solveConstraints");
+
+    // sort constraints by island
+    m_islandConstraints.resize(0);
+    for (int i=0; i<getNumConstraints(); i++)
+    {
+        m_islandConstraints.push_back(m_constraints[i]);
+    }
+    m_islandConstraints.quickSort(cConstraintIslandPredicate());
+
+    // collect islands
+    m_islands.clear();
+    m_islandBodies.resize(0);
+    m_islandManifolds.resize(0);
+
+    cIslandCollector collector;
+    collector.m_world = this;
+    getSimulationIslandManager()->buildAndProcessIslands(getCollisionWorld()->getDispatcher(), getCollisionWorld(), &collector);
+
+    // distribute islands by decreasing cost to the least loaded thread
+    vector<pair<int, int> > order;
+    for (unsigned int i=0; i<m_islands.size(); i++)
+    {
+        const cIsland& island = m_islands[i];
+        if (!island.m_serial)
+        {
+            order.push_back(make_pair(island.m_numBodies + island.m_numManifolds + island.m_numConstraints, (int)i));
+        }
+    }
+    sort(order.begin(), order.end(), greater<pair<int, int> >());
+
+    vector<int> load(m_numThreads, 0);
+    for (unsigned int i=0; i<m_numThreads; i++)
+    {
+        m_threadIslands[i].clear();
+    }
+    for (unsigned int i=0; i<order.size(); i++)
+    {
+        unsigned int thread = (unsigned int)(min_element(load.begin(), load.end()) - load.begin());
+        m_threadIslands[thread].push_back(order[i].second);
+        load[thread] += order[i].first;
+    }
+
+    // solve islands
+    m_solverInfo = &a_solverInfo;
+    for (unsigned int i=0; i<m_numThreads; i++)
+    {
+        m_solvers[i]->prepareSolve(getCollisionWorld()->getNumCollisionObjects(), getCollisionWorld()->getDispatcher()->getNumManifolds());
+    }
+
+    if (order.size() > 1)
+    {
+        // each thread of the pool solves its share of islands
+        m_threadPool.run([this](unsigned int a_thread) { solveIslands(a_thread); });
+    }
+    else
+    {
+        // a single island is assigned to the calling thread
+        solveIslands(0);
+    }
+
+    // solve islands in contact with kinematic bodies
+    m_threadIslands[0].clear();
+    for (unsigned int i=0; i<m_islands.size(); i++)
+    {
+        if (m_islands[i].m_serial)
+        {
+            m_threadIslands[0].push_back(i);
+        }
+    }
+    solveIslands(0);
+
+    for (unsigned int i=0; i<m_numThreads; i++)
+    {
+        m_solvers[i]->allSolved(a_solverInfo, m_debugDrawer);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method solves the islands assigned to a thread.
+
+    \param  a_thread  Thread index.
+*/
+//==============================================================================
+void cBulletParallelDynamicsWorld::solveIslands(const unsigned int a_thread)
+{
+    btSequentialImpulseConstraintSolver* solver = m_solvers[a_thread];
+    const vector<int>& islands = m_threadIslands[a_thread];
+
+    for (unsigned int i=0; i<islands.size(); i++)
+    {
+        const cIsland& island = m_islands[islands[i]];
+
+        btCollisionObject** bodies = (island.m_numBodies > 0) ? &m_islandBodies[island.m_firstBody] : NULL;
+        btPersistentManifold** manifolds = (island.m_numManifolds > 0) ? &m_islandManifolds[island.m_firstManifold] : NULL;
+        btTypedConstraint** constraints = (island.m_numConstraints > 0) ? &m_islandConstraints[island.m_firstConstraint] : NULL;
+
+        solver->solveGroup(bodies, island.m_numBodies, 
+                           manifolds, island.m_numManifolds, 
+                           constraints, island.m_numConstraints, 
+                           *m_solverInfo, m_debugDrawer, m_dispatcher1);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method stores an island reported by the island manager. Islands 
+    touching a kinematic body are flagged to be solved serially.
+
+    \param  a_bodies        Bodies of island.
+    \param  a_numBodies     Number of bodies.
+    \param  a_manifolds     Contact manifolds of island.
+    \param  a_numManifolds  Number of contact manifolds.
+    \param  a_islandId      Island identifier.
+*/
+//==============================================================================
+void cBulletParallelDynamicsWorld::cIslandCollector::processIsland(btCollisionObject** a_bodies, int a_numBodies, 
+                                                                   btPersistentManifold** a_manifolds, int a_numManifolds, 
+                                                                   int a_islandId)
+{
+    cIsland island;
+    island.m_serial = false;
+
+    // bodies
+    island.m_firstBody = m_world->m_islandBodies.size();
+    island.m_numBodies = a_numBodies;
+    for (int i=0; i<a_numBodies; i++)
+    {
+        m_world->m_islandBodies.push_back(a_bodies[i]);
+    }
+
+    // contact manifolds
+    island.m_firstManifold = m_world->m_islandManifolds.size();
+    island.m_numManifolds = a_numManifolds;
+    for (int i=0; i<a_numManifolds; i++)
+    {
+        m_world->m_islandManifolds.push_back(a_manifolds[i]);
+        if (a_manifolds[i]->getBody0()->isKinematicObject() || a_manifolds[i]->getBody1()->isKinematicObject())
+        {
+            island.m_serial = true;
+        }
+    }
+
+    // constraints (sorted by island, binary search for first one)
+    btAlignedObjectArray<btTypedConstraint*>& constraints = m_world->m_islandConstraints;
+    int lo = 0;
+    int hi = constraints.size();
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (cGetConstraintIslandId(constraints[mid]) < a_islandId) { lo = mid + 1; } else { hi = mid; }
+    }
+    island.m_firstConstraint = lo;
+    island.m_numConstraints = 0;
+    while ((lo < constraints.size()) && (cGetConstraintIslandId(constraints[lo]) == a_islandId))
+    {
+        if (constraints[lo]->getRigidBodyA().isKinematicObject() || constraints[lo]->getRigidBodyB().isKinematicObject())
+        {
+            island.m_serial = true;
+        }
+        island.m_numConstraints++;
+        lo++;
+    }
+
+    m_world->m_islands.push_back(island);
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
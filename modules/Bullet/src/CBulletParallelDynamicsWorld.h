@@ -0,0 +1,220 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   1.0.0
+*/
+//==============================================================================
+
+
+//------------------------------------------------------------------------------
+#ifndef CBulletParallelDynamicsWorldH
+#define CBulletParallelDynamicsWorldH
+//------------------------------------------------------------------------------
+#include "chai3d.h"
+//------------------------------------------------------------------------------
+#include "btBulletDynamicsCommon.h"
+#include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CBulletParallelDynamicsWorld.h
+
+    \brief
+    <b> Bullet Module </b> \n 
+    Bullet dynamics world with a multithreaded constraint solver.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cBulletParallelDynamicsWorld
+    \ingroup    Bullet
+
+    \brief
+    This class implements a Bullet dynamics world which solves simulation 
+    islands in parallel.
+
+    \details
+    cBulletParallelDynamicsWorld extends btDiscreteDynamicsWorld by solving 
+    the constraints of independent simulation islands on a pool of worker 
+    threads. Each thread owns a sequential impulse solver; islands are 
+    distributed between threads by decreasing cost so that the load is 
+    balanced. Islands in contact with kinematic bodies are solved serially, 
+    since the solver writes to kinematic bodies shared between islands. \n\n
+
+    With a single thread, or when the world uses a solver other than 
+    btSequentialImpulseConstraintSolver, or when islands are not split,
+    constraints are solved exactly as by btDiscreteDynamicsWorld.
+*/
+//==============================================================================
+class cBulletParallelDynamicsWorld : public btDiscreteDynamicsWorld
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cBulletParallelDynamicsWorld.
+    cBulletParallelDynamicsWorld(btDispatcher* a_dispatcher,
+                                 btBroadphaseInterface* a_broadphase,
+                                 btConstraintSolver* a_solver,
+                                 btCollisionConfiguration* a_collisionConfiguration);
+
+    //! Destructor of cBulletParallelDynamicsWorld.
+    virtual ~cBulletParallelDynamicsWorld();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method sets the number of threads used to solve constraints.
+    void setNumThreads(const unsigned int a_numThreads);
+
+    //! This method returns the number of threads used to solve constraints.
+    unsigned int getNumThreads() const { return (m_numThreads); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED TYPES:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Simulation island collected before solving.
+    struct cIsland
+    {
+        //! Index of first body in body list.
+        int m_firstBody;
+
+        //! Number of bodies.
+        int m_numBodies;
+
+        //! Index of first manifold in manifold list.
+        int m_firstManifold;
+
+        //! Number of contact manifolds.
+        int m_numManifolds;
+
+        //! Index of first constraint in sorted constraint list.
+        int m_firstConstraint;
+
+        //! Number of constraints.
+        int m_numConstraints;
+
+        //! If __true__ then the island must be solved by the calling thread.
+        bool m_serial;
+    };
+
+    //! Island callback which collects islands instead of solving them.
+    struct cIslandCollector : public btSimulationIslandManager::IslandCallback
+    {
+        //! World collecting the islands.
+        cBulletParallelDynamicsWorld* m_world;
+
+        //! This method stores an island.
+        virtual void processIsland(btCollisionObject** a_bodies, int a_numBodies, 
+                                   btPersistentManifold** a_manifolds, int a_numManifolds, 
+                                   int a_islandId);
+    };
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method solves all constraints of the world.
+    virtual void solveConstraints(btContactSolverInfo& a_solverInfo);
+
+    //! This method solves the islands assigned to a thread.
+    void solveIslands(const unsigned int a_thread);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Number of threads (including the calling thread).
+    unsigned int m_numThreads;
+
+    //! Constraint solver of each thread.
+    std::vector<btSequentialImpulseConstraintSolver*> m_solvers;
+
+    //! Islands collected during the current step.
+    std::vector<cIsland> m_islands;
+
+    //! Islands assigned to each thread.
+    std::vector<std::vector<int> > m_threadIslands;
+
+    //! Bodies of all collected islands.
+    btAlignedObjectArray<btCollisionObject*> m_islandBodies;
+
+    //! Contact manifolds of all collected islands.
+    btAlignedObjectArray<btPersistentManifold*> m_islandManifolds;
+
+    //! Constraints sorted by island.
+    btAlignedObjectArray<btTypedConstraint*> m_islandConstraints;
+
+    //! Solver settings of the current step.
+    btContactSolverInfo* m_solverInfo;
+
+    //! Pool of threads solving islands in parallel.
+    cThreadPool m_threadPool;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -0,0 +1,1103 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   1.0.0
+*/
+//==============================================================================
+
+
+//------------------------------------------------------------------------------
+#include "CBulletShapeCache.h"
+//------------------------------------------------------------------------------
+#include "BulletCollision/Gimpact/btGImpactShape.h"
+#include "LinearMath/btConvexHullComputer.h"
+#include "../externals/bullet/Extras/HACD/hacdHACD.h"
+//------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+std::vector<cBulletShapeCache::cBulletShapeEntry> cBulletShapeCache::s_entries;
+std::string cBulletShapeCache::s_cacheDirectory;
+cMutex cBulletShapeCache::s_mutex;
+std::list<cBulletShapeRequest*> cBulletShapeCache::s_requests;
+cBulletShapeRequest* cBulletShapeCache::s_currentRequest = NULL;
+bool cBulletShapeCache::s_requestThreadRunning = false;
+cThread* cBulletShapeCache::s_requestThread = NULL;
+cMutex cBulletShapeCache::s_requestMutex;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// identifier and version of cache files
+static const char C_BULLET_SHAPE_CACHE_MAGIC[4] = { 'C', 'B', 'S', 'C' };
+static const unsigned int C_BULLET_SHAPE_CACHE_VERSION = 2;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    This function accumulates a block of memory into a 64-bit FNV-1a hash.
+
+    \param  a_hash  Current hash value.
+    \param  a_data  Pointer to data.
+    \param  a_size  Size of data in bytes.
+
+    \return Updated hash value.
+*/
+//==============================================================================
+static inline unsigned long long cHashBytes(unsigned long long a_hash, const void* a_data, size_t a_size)
+{
+    const unsigned char* data = (const unsigned char*)a_data;
+    for (size_t i=0; i<a_size; i++)
+    {
+        a_hash ^= data[i];
+        a_hash *= 1099511628211ULL;
+    }
+    return (a_hash);
+}
+
+
+//==============================================================================
+/*!
+    This method computes a hash that identifies the geometry of a mesh, 
+    i.e. the local position of its vertices and the indices of its triangles.
+
+    \param  a_mesh  Mesh.
+
+    \return Hash of the mesh geometry.
+*/
+//==============================================================================
+unsigned long long cBulletShapeCache::computeMeshHash(cMesh* a_mesh)
+{
+    unsigned int numVertices = a_mesh->m_vertices->getNumElements();
+    unsigned int numTriangles = a_mesh->m_triangles->getNumElements();
+
+    return (computeMeshHash((numVertices > 0) ? &(a_mesh->m_vertices->m_localPos[0]) : NULL, 
+                            numVertices,
+                            (numTriangles > 0) ? &(a_mesh->m_triangles->m_indices[0]) : NULL, 
+                            numTriangles));
+}
+
+
+//==============================================================================
+/*!
+    This method computes a hash that identifies a geometry described by the
+    local position of its vertices and the indices of its triangles.
+
+    \param  a_vertices      Local positions of the vertices.
+    \param  a_numVertices   Number of vertices.
+    \param  a_indices       Vertex indices of the triangles.
+    \param  a_numTriangles  Number of triangles.
+
+    \return Hash of the geometry.
+*/
+//==============================================================================
+unsigned long long cBulletShapeCache::computeMeshHash(const cVector3d* a_vertices, 
+                                                      const unsigned int a_numVertices,
+                                                      const unsigned int* a_indices,
+                                                      const unsigned int a_numTriangles)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+
+    hash = cHashBytes(hash, &a_numVertices, sizeof(a_numVertices));
+    hash = cHashBytes(hash, &a_numTriangles, sizeof(a_numTriangles));
+
+    if (a_numVertices > 0)
+    {
+        hash = cHashBytes(hash, a_vertices, a_numVertices * sizeof(cVector3d));
+    }
+    if (a_numTriangles > 0)
+    {
+        hash = cHashBytes(hash, a_indices, 3 * a_numTriangles * sizeof(unsigned int));
+    }
+
+    return (hash);
+}
+
+
+//==============================================================================
+/*!
+    This method returns a collision shape of the requested type for a mesh.
+    If a shape was already built for a mesh with identical geometry, type and
+    settings, the same shape is returned and its reference count is 
+    incremented. Otherwise a new shape is built. Every shape returned by this
+    method must be released with \ref releaseShape().
+
+    Because shapes are shared, modifying the properties of a returned shape
+    (for instance its local scaling) affects all objects that use it.
+
+    \param  a_mesh      Mesh.
+    \param  a_type      Type of collision shape.
+    \param  a_margin    Collision margin.
+    \param  a_settings  Settings used by convex decompositions.
+
+    \return Collision shape, or __NULL__ if the mesh is empty.
+*/
+//==============================================================================
+btCollisionShape* cBulletShapeCache::acquireShape(cMesh* a_mesh, 
+                                                  const cBulletShapeType a_type, 
+                                                  const double a_margin,
+                                                  const cBulletDecompositionSettings& a_settings)
+{
+    // sanity check
+    if (a_mesh == NULL)
+    {
+        return (NULL);
+    }
+
+    cBulletMeshData data;
+    data.m_numVertices = a_mesh->m_vertices->getNumElements();
+    data.m_numTriangles = a_mesh->m_triangles->getNumElements();
+    data.m_vertices = (data.m_numVertices > 0) ? &(a_mesh->m_vertices->m_localPos[0]) : NULL;
+    data.m_indices = (data.m_numTriangles > 0) ? &(a_mesh->m_triangles->m_indices[0]) : NULL;
+
+    return (acquireShape(data, a_type, a_margin, a_settings));
+}
+
+
+//==============================================================================
+/*!
+    This method returns a collision shape of the requested type for a 
+    geometry. The cache is not locked while a new shape is being built, so
+    that a long build does not block other threads.
+
+    \param  a_data      Geometry.
+    \param  a_type      Type of collision shape.
+    \param  a_margin    Collision margin.
+    \param  a_settings  Settings used by convex decompositions.
+
+    \return Collision shape, or __NULL__ if the geometry is empty.
+*/
+//==============================================================================
+btCollisionShape* cBulletShapeCache::acquireShape(const cBulletMeshData& a_data, 
+                                                  const cBulletShapeType a_type, 
+                                                  const double a_margin,
+                                                  const cBulletDecompositionSettings& a_settings)
+{
+    // sanity check
+    if (a_data.m_numVertices == 0)
+    {
+        return (NULL);
+    }
+
+    // identify geometry, and settings in the case of convex decompositions
+    unsigned long long hash = computeMeshHash(a_data.m_vertices, a_data.m_numVertices, a_data.m_indices, a_data.m_numTriangles);
+    if (a_type == BULLET_SHAPE_CONVEX_DECOMPOSITION)
+    {
+        hash = cHashBytes(hash, &a_settings.m_concavity, sizeof(a_settings.m_concavity));
+        hash = cHashBytes(hash, &a_settings.m_minNumHulls, sizeof(a_settings.m_minNumHulls));
+        hash = cHashBytes(hash, &a_settings.m_maxNumVerticesPerHull, sizeof(a_settings.m_maxNumVerticesPerHull));
+    }
+
+    cBulletShapeEntry entry;
+    entry.m_hash = hash;
+    entry.m_type = a_type;
+    entry.m_margin = a_margin;
+    entry.m_refCount = 1;
+    entry.m_shape = NULL;
+    entry.m_mesh = NULL;
+    entry.m_bvhBuffer = NULL;
+
+    // search for an existing shape
+    s_mutex.acquire();
+    for (unsigned int i=0; i<s_entries.size(); i++)
+    {
+        cBulletShapeEntry& item = s_entries[i];
+        if ((item.m_hash == hash) && (item.m_type == a_type) && (item.m_margin == a_margin))
+        {
+            item.m_refCount++;
+            btCollisionShape* shape = item.m_shape;
+            s_mutex.release();
+            return (shape);
+        }
+    }
+    s_mutex.release();
+
+    // build new shape
+    buildShape(a_data, entry, a_settings);
+    if (entry.m_shape == NULL)
+    {
+        return (NULL);
+    }
+
+    // store new shape, unless an identical shape was built in the meantime
+    s_mutex.acquire();
+    for (unsigned int i=0; i<s_entries.size(); i++)
+    {
+        cBulletShapeEntry& item = s_entries[i];
+        if ((item.m_hash == hash) && (item.m_type == a_type) && (item.m_margin == a_margin))
+        {
+            item.m_refCount++;
+            btCollisionShape* shape = item.m_shape;
+            s_mutex.release();
+            deleteShape(entry);
+            return (shape);
+        }
+    }
+    s_entries.push_back(entry);
+    s_mutex.release();
+
+    return (entry.m_shape);
+}
+
+
+//==============================================================================
+/*!
+    This method releases a shape returned by \ref acquireShape(). The shape 
+    and its resources are deleted when it is no longer used by any object.
+
+    \param  a_shape  Collision shape.
+
+    \return __true__ if the shape is managed by the cache, __false__ otherwise.
+*/
+//==============================================================================
+bool cBulletShapeCache::releaseShape(btCollisionShape* a_shape)
+{
+    s_mutex.acquire();
+
+    for (unsigned int i=0; i<s_entries.size(); i++)
+    {
+        cBulletShapeEntry& entry = s_entries[i];
+        if (entry.m_shape == a_shape)
+        {
+            entry.m_refCount--;
+            if (entry.m_refCount <= 0)
+            {
+                deleteShape(entry);
+                s_entries.erase(s_entries.begin() + i);
+            }
+
+            s_mutex.release();
+            return (true);
+        }
+    }
+
+    s_mutex.release();
+    return (false);
+}
+
+
+//==============================================================================
+/*!
+    This method deletes a shape and the resources it references.
+
+    \param  a_entry  Cache entry of the shape.
+*/
+//==============================================================================
+void cBulletShapeCache::deleteShape(cBulletShapeEntry& a_entry)
+{
+    delete a_entry.m_shape;
+    a_entry.m_shape = NULL;
+
+    for (unsigned int i=0; i<a_entry.m_children.size(); i++)
+    {
+        delete a_entry.m_children[i];
+    }
+    a_entry.m_children.clear();
+
+    if (a_entry.m_mesh)
+    {
+        delete a_entry.m_mesh;
+        a_entry.m_mesh = NULL;
+    }
+
+    if (a_entry.m_bvhBuffer)
+    {
+        btAlignedFree(a_entry.m_bvhBuffer);
+        a_entry.m_bvhBuffer = NULL;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method requests a collision shape to be built by a background 
+    thread. The geometry of the mesh is copied, so the mesh may be modified 
+    or deleted after this call. Requests are processed in order, so that 
+    several requests for identical geometry only build the shape once.
+
+    Once \ref cBulletShapeRequest::m_completed is __true__, the caller takes
+    ownership of \ref cBulletShapeRequest::m_shape, which must be released 
+    with \ref releaseShape(), and deletes the request. A request that is no 
+    longer needed must be passed to \ref discardRequest().
+
+    \param  a_mesh      Mesh.
+    \param  a_type      Type of collision shape.
+    \param  a_margin    Collision margin.
+    \param  a_settings  Settings used by convex decompositions.
+
+    \return Request.
+*/
+//==============================================================================
+cBulletShapeRequest* cBulletShapeCache::requestShape(cMesh* a_mesh, 
+                                                     const cBulletShapeType a_type, 
+                                                     const double a_margin,
+                                                     const cBulletDecompositionSettings& a_settings)
+{
+    cBulletShapeRequest* request = new cBulletShapeRequest();
+    request->m_vertices = a_mesh->m_vertices->m_localPos;
+    request->m_indices = a_mesh->m_triangles->m_indices;
+    request->m_vertices.resize(a_mesh->m_vertices->getNumElements());
+    request->m_indices.resize(3 * a_mesh->m_triangles->getNumElements());
+    request->m_type = a_type;
+    request->m_margin = a_margin;
+    request->m_settings = a_settings;
+    request->m_shape = NULL;
+    request->m_completed = false;
+    request->m_discarded = false;
+
+    s_requestMutex.acquire();
+
+    s_requests.push_back(request);
+
+    // start thread if not already processing requests
+    if (!s_requestThreadRunning)
+    {
+        // the previous thread has processed all requests and is terminating
+        if (s_requestThread != NULL)
+        {
+            s_requestThread->join();
+            delete s_requestThread;
+        }
+        s_requestThreadRunning = true;
+        s_requestThread = new cThread();
+        s_requestThread->start(requestThread, CTHREAD_PRIORITY_GRAPHICS, NULL);
+    }
+
+    s_requestMutex.release();
+
+    return (request);
+}
+
+
+//==============================================================================
+/*!
+    This method discards a request. If the request is being processed, it is
+    deleted by the background thread once completed.
+
+    \param  a_request  Request.
+*/
+//==============================================================================
+void cBulletShapeCache::discardRequest(cBulletShapeRequest* a_request)
+{
+    if (a_request == NULL)
+    {
+        return;
+    }
+
+    s_requestMutex.acquire();
+
+    // request is being processed
+    if (a_request == s_currentRequest)
+    {
+        a_request->m_discarded = true;
+        s_requestMutex.release();
+        return;
+    }
+
+    // request is waiting to be processed
+    s_requests.remove(a_request);
+
+    s_requestMutex.release();
+
+    // release shape if the request was already completed
+    if (a_request->m_shape != NULL)
+    {
+        releaseShape(a_request->m_shape);
+    }
+
+    delete a_request;
+}
+
+
+//==============================================================================
+/*!
+    This method waits for all pending requests to complete and for the 
+    background thread to terminate. Worlds only discard the requests of their 
+    own bodies, so this method should be called once at module teardown, 
+    before the application exits while requests may still be pending.
+*/
+//==============================================================================
+void cBulletShapeCache::shutdown()
+{
+    s_requestMutex.acquire();
+    cThread* thread = s_requestThread;
+    s_requestThread = NULL;
+    s_requestMutex.release();
+
+    // the thread terminates once the list of requests is empty
+    if (thread != NULL)
+    {
+        thread->join();
+        delete thread;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method implements the background thread which processes requests.
+    The thread terminates when no more requests are pending.
+
+    \param  a_arg  Unused.
+*/
+//==============================================================================
+void cBulletShapeCache::requestThread(void* a_arg)
+{
+    while (true)
+    {
+        // get next request
+        s_requestMutex.acquire();
+        if (s_requests.empty())
+        {
+            s_requestThreadRunning = false;
+            s_requestMutex.release();
+            return;
+        }
+        cBulletShapeRequest* request = s_requests.front();
+        s_requests.pop_front();
+        s_currentRequest = request;
+        s_requestMutex.release();
+
+        // build shape
+        cBulletMeshData data;
+        data.m_numVertices = (unsigned int)(request->m_vertices.size());
+        data.m_numTriangles = (unsigned int)(request->m_indices.size() / 3);
+        data.m_vertices = (data.m_numVertices > 0) ? &(request->m_vertices[0]) : NULL;
+        data.m_indices = (data.m_numTriangles > 0) ? &(request->m_indices[0]) : NULL;
+
+        btCollisionShape* shape = acquireShape(data, request->m_type, request->m_margin, request->m_settings);
+
+        // complete request
+        s_requestMutex.acquire();
+        s_currentRequest = NULL;
+        bool discarded = request->m_discarded;
+        if (!discarded)
+        {
+            request->m_shape = shape;
+            request->m_completed = true;
+        }
+        s_requestMutex.release();
+
+        if (discarded)
+        {
+            if (shape != NULL)
+            {
+                releaseShape(shape);
+            }
+            delete request;
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of shapes currently held by the cache.
+
+    \return Number of shapes.
+*/
+//==============================================================================
+unsigned int cBulletShapeCache::getNumShapes()
+{
+    s_mutex.acquire();
+    unsigned int numShapes = (unsigned int)(s_entries.size());
+    s_mutex.release();
+
+    return (numShapes);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the directory where preprocessed shapes are stored. The
+    directory must already exist. An empty string (default) disables the
+    disk cache.
+
+    \param  a_directory  Directory of the disk cache.
+*/
+//==============================================================================
+void cBulletShapeCache::setCacheDirectory(const std::string& a_directory)
+{
+    s_mutex.acquire();
+    s_cacheDirectory = a_directory;
+    s_mutex.release();
+}
+
+
+//==============================================================================
+/*!
+    This method returns the directory where preprocessed shapes are stored.
+
+    \return Directory of the disk cache.
+*/
+//==============================================================================
+std::string cBulletShapeCache::getCacheDirectory()
+{
+    s_mutex.acquire();
+    string directory = s_cacheDirectory;
+    s_mutex.release();
+
+    return (directory);
+}
+
+
+//==============================================================================
+/*!
+    This method builds a new collision shape and the resources it references.
+
+    \param  a_data      Geometry.
+    \param  a_entry     Cache entry in which the shape is stored.
+    \param  a_settings  Settings used by convex decompositions.
+*/
+//==============================================================================
+void cBulletShapeCache::buildShape(const cBulletMeshData& a_data, 
+                                   cBulletShapeEntry& a_entry, 
+                                   const cBulletDecompositionSettings& a_settings)
+{
+    switch (a_entry.m_type)
+    {
+        case BULLET_SHAPE_TRIANGLES:
+        {
+            a_entry.m_mesh = buildTriangleMesh(a_data);
+            btGImpactMeshShape* shape = new btGImpactMeshShape(a_entry.m_mesh);
+            shape->setMargin(a_entry.m_margin);
+            shape->updateBound();
+            a_entry.m_shape = shape;
+        }
+        break;
+
+        case BULLET_SHAPE_CONVEX_TRIANGLES:
+        {
+            a_entry.m_mesh = buildTriangleMesh(a_data);
+            a_entry.m_shape = new btConvexTriangleMeshShape(a_entry.m_mesh);
+            a_entry.m_shape->setMargin(a_entry.m_margin);
+        }
+        break;
+
+        case BULLET_SHAPE_HULL:
+        {
+            buildHull(a_data, a_entry);
+        }
+        break;
+
+        case BULLET_SHAPE_STATIC_TRIANGLES:
+        {
+            buildStaticTriangles(a_data, a_entry);
+        }
+        break;
+
+        case BULLET_SHAPE_CONVEX_DECOMPOSITION:
+        {
+            buildConvexDecomposition(a_data, a_entry, a_settings);
+        }
+        break;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method builds an indexed Bullet triangle mesh from a geometry. 
+    Vertices are shared between triangles as in the original geometry.
+
+    \param  a_data  Geometry.
+
+    \return Bullet triangle mesh.
+*/
+//==============================================================================
+btTriangleMesh* cBulletShapeCache::buildTriangleMesh(const cBulletMeshData& a_data)
+{
+    btTriangleMesh* mesh = new btTriangleMesh();
+
+    mesh->preallocateVertices(a_data.m_numVertices);
+    mesh->preallocateIndices(3 * a_data.m_numTriangles);
+
+    // add all vertices
+    for (unsigned int i=0; i<a_data.m_numVertices; i++)
+    {
+        const cVector3d& vertex = a_data.m_vertices[i];
+        mesh->findOrAddVertex(btVector3(vertex(0), vertex(1), vertex(2)), false);
+    }
+
+    // add all triangles
+    for (unsigned int i=0; i<a_data.m_numTriangles; i++)
+    {
+        mesh->addTriangleIndices(a_data.m_indices[3*i+0],
+                                 a_data.m_indices[3*i+1],
+                                 a_data.m_indices[3*i+2]);
+    }
+
+    return (mesh);
+}
+
+
+//==============================================================================
+/*!
+    This method builds a bounding volume hierarchy triangle mesh shape. The
+    hierarchy is loaded from the disk cache if available, otherwise it is 
+    built and stored in the disk cache.
+
+    \param  a_data   Geometry.
+    \param  a_entry  Cache entry in which the shape is stored.
+*/
+//==============================================================================
+void cBulletShapeCache::buildStaticTriangles(const cBulletMeshData& a_data, cBulletShapeEntry& a_entry)
+{
+    a_entry.m_mesh = buildTriangleMesh(a_data);
+
+    // try loading hierarchy from disk cache
+    vector<unsigned char> data;
+    if (readCacheFile(a_entry, data))
+    {
+        void* buffer = btAlignedAlloc(data.size(), 16);
+        memcpy(buffer, &data[0], data.size());
+
+        btOptimizedBvh* bvh = (btOptimizedBvh*)btOptimizedBvh::deSerializeInPlace(buffer, (unsigned int)data.size(), false);
+        if (bvh != NULL)
+        {
+            btBvhTriangleMeshShape* shape = new btBvhTriangleMeshShape(a_entry.m_mesh, true, false);
+            shape->setOptimizedBvh(bvh);
+            shape->setMargin(a_entry.m_margin);
+            a_entry.m_shape = shape;
+            a_entry.m_bvhBuffer = buffer;
+            return;
+        }
+
+        btAlignedFree(buffer);
+    }
+
+    // build hierarchy
+    btBvhTriangleMeshShape* shape = new btBvhTriangleMeshShape(a_entry.m_mesh, true, true);
+    shape->setMargin(a_entry.m_margin);
+    a_entry.m_shape = shape;
+
+    // store hierarchy in disk cache
+    if (getCacheFilename(a_entry) != "")
+    {
+        btOptimizedBvh* bvh = shape->getOptimizedBvh();
+        unsigned int size = bvh->calculateSerializeBufferSize();
+        void* buffer = btAlignedAlloc(size, 16);
+        if (bvh->serializeInPlace(buffer, size, false))
+        {
+            writeCacheFile(a_entry, buffer, size);
+        }
+        btAlignedFree(buffer);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method builds a convex hull shape. Only the vertices located on the
+    hull are kept, which also reduces the cost of collision queries. These
+    vertices are loaded from the disk cache if available, otherwise they are
+    computed and stored in the disk cache.
+
+    \param  a_data   Geometry.
+    \param  a_entry  Cache entry in which the shape is stored.
+*/
+//==============================================================================
+void cBulletShapeCache::buildHull(const cBulletMeshData& a_data, cBulletShapeEntry& a_entry)
+{
+    vector<unsigned char> data;
+    vector<double> points;
+
+    // try loading hull vertices from disk cache
+    if (readCacheFile(a_entry, data) && (data.size() % (3 * sizeof(double)) == 0))
+    {
+        points.resize(data.size() / sizeof(double));
+        memcpy(&points[0], &data[0], data.size());
+    }
+
+    // compute hull vertices
+    else
+    {
+        computeHullPoints((const double*)(a_data.m_vertices), a_data.m_numVertices, points);
+        writeCacheFile(a_entry, &points[0], (unsigned int)(points.size() * sizeof(double)));
+    }
+
+    a_entry.m_shape = new btConvexHullShape(&points[0], (int)(points.size() / 3), 3 * sizeof(double));
+    a_entry.m_shape->setMargin(a_entry.m_margin);
+}
+
+
+//==============================================================================
+/*!
+    This method builds a compound shape composed of convex hulls which 
+    approximate a concave geometry, using the hierarchical approximate convex 
+    decomposition (HACD) library distributed with Bullet. A compound of 
+    convex pieces is far less expensive to simulate than a concave triangle 
+    mesh. The convex pieces are loaded from the disk cache if available, 
+    otherwise they are computed and stored in the disk cache.
+
+    \param  a_data      Geometry.
+    \param  a_entry     Cache entry in which the shape is stored.
+    \param  a_settings  Settings of the convex decomposition.
+*/
+//==============================================================================
+void cBulletShapeCache::buildConvexDecomposition(const cBulletMeshData& a_data, 
+                                                 cBulletShapeEntry& a_entry, 
+                                                 const cBulletDecompositionSettings& a_settings)
+{
+    vector<vector<double> > hulls;
+
+    // try loading convex pieces from disk cache, stored as a number of
+    // hulls followed by the number of vertices and the vertices of each hull
+    vector<unsigned char> data;
+    if (readCacheFile(a_entry, data) && (data.size() >= sizeof(unsigned int)))
+    {
+        const unsigned char* ptr = &data[0];
+        const unsigned char* end = ptr + data.size();
+
+        unsigned int numHulls;
+        memcpy(&numHulls, ptr, sizeof(unsigned int)); ptr += sizeof(unsigned int);
+
+        for (unsigned int i=0; (i<numHulls) && (ptr + sizeof(unsigned int) <= end); i++)
+        {
+            unsigned int numPoints;
+            memcpy(&numPoints, ptr, sizeof(unsigned int)); ptr += sizeof(unsigned int);
+            if (ptr + 3 * numPoints * sizeof(double) > end)
+            {
+                break;
+            }
+
+            vector<double> points(3 * numPoints);
+            memcpy(&points[0], ptr, 3 * numPoints * sizeof(double)); ptr += 3 * numPoints * sizeof(double);
+            hulls.push_back(points);
+        }
+
+        if ((hulls.size() != numHulls) || (ptr != end))
+        {
+            hulls.clear();
+        }
+    }
+
+    // compute decomposition
+    if (hulls.empty())
+    {
+        if (a_data.m_numTriangles > 0)
+        {
+            vector<HACD::Vec3<HACD::Real> > points(a_data.m_numVertices);
+            for (unsigned int i=0; i<a_data.m_numVertices; i++)
+            {
+                points[i] = HACD::Vec3<HACD::Real>(a_data.m_vertices[i](0), a_data.m_vertices[i](1), a_data.m_vertices[i](2));
+            }
+
+            vector<HACD::Vec3<long> > triangles(a_data.m_numTriangles);
+            for (unsigned int i=0; i<a_data.m_numTriangles; i++)
+            {
+                triangles[i] = HACD::Vec3<long>(a_data.m_indices[3*i+0], a_data.m_indices[3*i+1], a_data.m_indices[3*i+2]);
+            }
+
+            HACD::HACD hacd;
+            hacd.SetPoints(&points[0]);
+            hacd.SetNPoints(points.size());
+            hacd.SetTriangles(&triangles[0]);
+            hacd.SetNTriangles(triangles.size());
+            hacd.SetCompacityWeight(0.1);
+            hacd.SetVolumeWeight(0.0);
+            hacd.SetNClusters(cMax(a_settings.m_minNumHulls, 1u));
+            hacd.SetNVerticesPerCH(cMax(a_settings.m_maxNumVerticesPerHull, 4u));
+            hacd.SetAddExtraDistPoints(false);
+            hacd.SetAddNeighboursDistPoints(false);
+            hacd.SetAddFacesPoints(false);
+
+            // the mesh is normalized by HACD so that its diagonal equals twice the scale factor
+            hacd.SetConcavity(a_settings.m_concavity * 2.0 * hacd.GetScaleFactor());
+
+            if (hacd.Compute())
+            {
+                for (size_t c=0; c<hacd.GetNClusters(); c++)
+                {
+                    size_t numPoints = hacd.GetNPointsCH(c);
+                    size_t numTriangles = hacd.GetNTrianglesCH(c);
+                    if (numPoints < 4)
+                    {
+                        continue;
+                    }
+
+                    vector<HACD::Vec3<HACD::Real> > hullPoints(numPoints);
+                    vector<HACD::Vec3<long> > hullTriangles(numTriangles);
+                    hacd.GetCH(c, &hullPoints[0], &hullTriangles[0]);
+
+                    vector<double> hull(3 * numPoints);
+                    for (size_t i=0; i<numPoints; i++)
+                    {
+                        hull[3*i+0] = hullPoints[i].X();
+                        hull[3*i+1] = hullPoints[i].Y();
+                        hull[3*i+2] = hullPoints[i].Z();
+                    }
+                    hulls.push_back(hull);
+                }
+            }
+        }
+
+        // use a single hull if the decomposition failed
+        if (hulls.empty())
+        {
+            vector<double> hull;
+            computeHullPoints((const double*)(a_data.m_vertices), a_data.m_numVertices, hull);
+            hulls.push_back(hull);
+        }
+
+        // store convex pieces in disk cache
+        if (getCacheFilename(a_entry) != "")
+        {
+            vector<unsigned char> buffer;
+            unsigned int numHulls = (unsigned int)(hulls.size());
+            buffer.insert(buffer.end(), (unsigned char*)&numHulls, (unsigned char*)&numHulls + sizeof(unsigned int));
+            for (unsigned int i=0; i<numHulls; i++)
+            {
+                unsigned int numPoints = (unsigned int)(hulls[i].size() / 3);
+                buffer.insert(buffer.end(), (unsigned char*)&numPoints, (unsigned char*)&numPoints + sizeof(unsigned int));
+                buffer.insert(buffer.end(), (unsigned char*)&hulls[i][0], (unsigned char*)&hulls[i][0] + hulls[i].size() * sizeof(double));
+            }
+            writeCacheFile(a_entry, &buffer[0], (unsigned int)(buffer.size()));
+        }
+    }
+
+    // build compound shape
+    btCompoundShape* compound = new btCompoundShape();
+    btTransform identity;
+    identity.setIdentity();
+
+    for (unsigned int i=0; i<hulls.size(); i++)
+    {
+        btConvexHullShape* hull = new btConvexHullShape(&hulls[i][0], (int)(hulls[i].size() / 3), 3 * sizeof(double));
+        hull->setMargin(a_entry.m_margin);
+        compound->addChildShape(identity, hull);
+        a_entry.m_children.push_back(hull);
+    }
+
+    a_entry.m_shape = compound;
+}
+
+
+//==============================================================================
+/*!
+    This method computes the vertices located on the convex hull of a set of
+    points. If the hull is degenerate, all points are returned.
+
+    \param  a_points      Coordinates of the points.
+    \param  a_numPoints   Number of points.
+    \param  a_hullPoints  Coordinates of the vertices of the hull.
+*/
+//==============================================================================
+void cBulletShapeCache::computeHullPoints(const double* a_points, 
+                                          const unsigned int a_numPoints, 
+                                          std::vector<double>& a_hullPoints)
+{
+    btConvexHullComputer hull;
+    hull.compute(a_points, 3 * sizeof(double), a_numPoints, 0.0, 0.0);
+
+    int numPoints = hull.vertices.size();
+    if (numPoints < 4)
+    {
+        a_hullPoints.assign(a_points, a_points + 3 * a_numPoints);
+        return;
+    }
+
+    a_hullPoints.resize(3 * numPoints);
+    for (int i=0; i<numPoints; i++)
+    {
+        a_hullPoints[3*i+0] = hull.vertices[i].x();
+        a_hullPoints[3*i+1] = hull.vertices[i].y();
+        a_hullPoints[3*i+2] = hull.vertices[i].z();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the filename of a cached shape.
+
+    \param  a_entry  Cache entry.
+
+    \return Filename, or an empty string if the disk cache is disabled.
+*/
+//==============================================================================
+std::string cBulletShapeCache::getCacheFilename(const cBulletShapeEntry& a_entry)
+{
+    // the directory may be changed by another thread
+    string directory = getCacheDirectory();
+    if (directory == "")
+    {
+        return ("");
+    }
+
+    char name[64];
+    sprintf(name, "%016llx-%d.bsc", a_entry.m_hash, (int)(a_entry.m_type));
+
+    char last = directory[directory.length()-1];
+    if ((last != '/') && (last != '\\'))
+    {
+        directory = directory + "/";
+    }
+
+    return (directory + name);
+}
+
+
+//==============================================================================
+/*!
+    This method reads the data of a cached shape from disk. The file is 
+    rejected if it was written by an incompatible build.
+
+    \param  a_entry  Cache entry.
+    \param  a_data   Data read from disk.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cBulletShapeCache::readCacheFile(const cBulletShapeEntry& a_entry, std::vector<unsigned char>& a_data)
+{
+    string filename = getCacheFilename(a_entry);
+    if (filename == "")
+    {
+        return (C_ERROR);
+    }
+
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (file == NULL)
+    {
+        return (C_ERROR);
+    }
+
+    // read and check header
+    char magic[4];
+    unsigned int version = 0;
+    unsigned int scalarSize = 0;
+    unsigned int type = 0;
+    unsigned long long hash = 0;
+    unsigned int size = 0;
+
+    bool valid = (fread(magic, sizeof(magic), 1, file) == 1) &&
+                 (fread(&version, sizeof(version), 1, file) == 1) &&
+                 (fread(&scalarSize, sizeof(scalarSize), 1, file) == 1) &&
+                 (fread(&type, sizeof(type), 1, file) == 1) &&
+                 (fread(&hash, sizeof(hash), 1, file) == 1) &&
+                 (fread(&size, sizeof(size), 1, file) == 1);
+
+    valid = valid &&
+            (memcmp(magic, C_BULLET_SHAPE_CACHE_MAGIC, sizeof(magic)) == 0) &&
+            (version == C_BULLET_SHAPE_CACHE_VERSION) &&
+            (scalarSize == sizeof(btScalar)) &&
+            (type == (unsigned int)(a_entry.m_type)) &&
+            (hash == a_entry.m_hash) &&
+            (size > 0);
+
+    // read data
+    if (valid)
+    {
+        a_data.resize(size);
+        valid = (fread(&a_data[0], size, 1, file) == 1);
+    }
+
+    fclose(file);
+
+    if (!valid)
+    {
+        a_data.clear();
+        return (C_ERROR);
+    }
+
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method writes the data of a cached shape to disk.
+
+    \param  a_entry  Cache entry.
+    \param  a_data   Data to be written.
+    \param  a_size   Size of data in bytes.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cBulletShapeCache::writeCacheFile(const cBulletShapeEntry& a_entry, const void* a_data, const unsigned int a_size)
+{
+    string filename = getCacheFilename(a_entry);
+    if (filename == "")
+    {
+        return (C_ERROR);
+    }
+
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (file == NULL)
+    {
+        return (C_ERROR);
+    }
+
+    unsigned int version = C_BULLET_SHAPE_CACHE_VERSION;
+    unsigned int scalarSize = sizeof(btScalar);
+    unsigned int type = (unsigned int)(a_entry.m_type);
+    unsigned long long hash = a_entry.m_hash;
+    unsigned int size = a_size;
+
+    bool valid = (fwrite(C_BULLET_SHAPE_CACHE_MAGIC, sizeof(C_BULLET_SHAPE_CACHE_MAGIC), 1, file) == 1) &&
+                 (fwrite(&version, sizeof(version), 1, file) == 1) &&
+                 (fwrite(&scalarSize, sizeof(scalarSize), 1, file) == 1) &&
+                 (fwrite(&type, sizeof(type), 1, file) == 1) &&
+                 (fwrite(&hash, sizeof(hash), 1, file) == 1) &&
+                 (fwrite(&size, sizeof(size), 1, file) == 1) &&
+                 (fwrite(a_data, a_size, 1, file) == 1);
+
+    fclose(file);
+
+    if (!valid)
+    {
+        remove(filename.c_str());
+        return (C_ERROR);
+    }
+
+    return (C_SUCCESS);
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,352 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   1.0.0
+*/
+//==============================================================================
+
+
+//------------------------------------------------------------------------------
+#ifndef CBulletShapeCacheH
+#define CBulletShapeCacheH
+//------------------------------------------------------------------------------
+#include "chai3d.h"
+//------------------------------------------------------------------------------
+#include "btBulletDynamicsCommon.h"
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <list>
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CBulletShapeCache.h
+
+    \brief
+    <b> Bullet Module </b> \n 
+    Cache of Bullet collision shapes built from meshes.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Bullet collision shapes that can be built from a mesh.
+enum cBulletShapeType
+{
+    BULLET_SHAPE_TRIANGLES,
+    BULLET_SHAPE_CONVEX_TRIANGLES,
+    BULLET_SHAPE_HULL,
+    BULLET_SHAPE_STATIC_TRIANGLES,
+    BULLET_SHAPE_CONVEX_DECOMPOSITION
+};
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \struct     cBulletDecompositionSettings
+    \ingroup    Bullet
+
+    \brief
+    This structure holds the settings of an approximate convex decomposition.
+*/
+//==============================================================================
+struct cBulletDecompositionSettings
+{
+    //! Constructor of cBulletDecompositionSettings.
+    cBulletDecompositionSettings() : m_concavity(0.05), m_minNumHulls(2), m_maxNumVerticesPerHull(32) {}
+
+    //! Maximum concavity allowed in a convex piece, expressed as a fraction of the diagonal of the mesh bounding box.
+    double m_concavity;
+
+    //! Minimum number of convex pieces.
+    unsigned int m_minNumHulls;
+
+    //! Maximum number of vertices of each convex piece.
+    unsigned int m_maxNumVerticesPerHull;
+};
+
+//==============================================================================
+/*!
+    \struct     cBulletShapeRequest
+    \ingroup    Bullet
+
+    \brief
+    This structure holds a request for a shape built in the background by
+    \ref cBulletShapeCache.
+*/
+//==============================================================================
+struct cBulletShapeRequest
+{
+    //! Local positions of the mesh vertices.
+    std::vector<cVector3d> m_vertices;
+
+    //! Vertex indices of the mesh triangles.
+    std::vector<unsigned int> m_indices;
+
+    //! Type of shape.
+    cBulletShapeType m_type;
+
+    //! Collision margin.
+    double m_margin;
+
+    //! Settings of the convex decomposition.
+    cBulletDecompositionSettings m_settings;
+
+    //! Resulting shape, valid once the request is completed.
+    btCollisionShape* m_shape;
+
+    //! If __true__ then the shape has been built.
+    std::atomic<bool> m_completed;
+
+    //! If __true__ then the request has been discarded while being processed.
+    bool m_discarded;
+};
+
+//==============================================================================
+/*!
+    \class      cBulletShapeCache
+    \ingroup    Bullet
+
+    \brief
+    This class implements a cache of Bullet collision shapes built from meshes.
+
+    \details
+    Building a Bullet collision shape from a mesh can be expensive for large
+    models. cBulletShapeCache identifies the geometry of a mesh by a hash of
+    its vertices and triangles, and returns the same collision shape to all 
+    objects that share identical geometry, shape type and margin. Shapes are 
+    reference counted and deleted when the last object releases them.
+
+    When a cache directory is defined, shapes that require a costly 
+    preprocessing step are also stored on disk so that subsequent launches of 
+    the application can load them directly. The bounding volume hierarchy of 
+    static triangle meshes, the vertices of convex hulls and the pieces of
+    convex decompositions are cached in this way.
+
+    Shapes can also be requested with \ref requestShape(), in which case they
+    are built in order by a background thread.
+*/
+//==============================================================================
+class cBulletShapeCache
+{
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns a collision shape for a mesh, building it if not already available.
+    static btCollisionShape* acquireShape(cMesh* a_mesh, 
+                                          const cBulletShapeType a_type, 
+                                          const double a_margin,
+                                          const cBulletDecompositionSettings& a_settings = cBulletDecompositionSettings());
+
+    //! This method requests a collision shape for a mesh to be built by a background thread.
+    static cBulletShapeRequest* requestShape(cMesh* a_mesh, 
+                                             const cBulletShapeType a_type, 
+                                             const double a_margin,
+                                             const cBulletDecompositionSettings& a_settings = cBulletDecompositionSettings());
+
+    //! This method discards a request. Its shape, if already built, is released.
+    static void discardRequest(cBulletShapeRequest* a_request);
+
+    //! This method waits for pending requests to complete and for the request thread to terminate.
+    static void shutdown();
+
+    //! This method releases a shape returned by \ref acquireShape(). It returns __false__ if the shape is not managed by the cache.
+    static bool releaseShape(btCollisionShape* a_shape);
+
+    //! This method returns the number of shapes currently held by the cache.
+    static unsigned int getNumShapes();
+
+    //! This method sets the directory where preprocessed shapes are stored. An empty string disables the disk cache.
+    static void setCacheDirectory(const std::string& a_directory);
+
+    //! This method returns the directory where preprocessed shapes are stored.
+    static std::string getCacheDirectory();
+
+    //! This method computes a hash identifying the geometry of a mesh.
+    static unsigned long long computeMeshHash(cMesh* a_mesh);
+
+    //! This method computes a hash identifying a geometry.
+    static unsigned long long computeMeshHash(const cVector3d* a_vertices, 
+                                              const unsigned int a_numVertices,
+                                              const unsigned int* a_indices,
+                                              const unsigned int a_numTriangles);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED TYPES:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Geometry from which a shape is built.
+    struct cBulletMeshData
+    {
+        //! Local positions of the vertices.
+        const cVector3d* m_vertices;
+
+        //! Number of vertices.
+        unsigned int m_numVertices;
+
+        //! Vertex indices of the triangles.
+        const unsigned int* m_indices;
+
+        //! Number of triangles.
+        unsigned int m_numTriangles;
+    };
+
+    //! Shape held by the cache.
+    struct cBulletShapeEntry
+    {
+        //! Hash of the mesh geometry.
+        unsigned long long m_hash;
+
+        //! Type of shape.
+        cBulletShapeType m_type;
+
+        //! Collision margin.
+        double m_margin;
+
+        //! Number of objects using the shape.
+        int m_refCount;
+
+        //! Collision shape.
+        btCollisionShape* m_shape;
+
+        //! Triangle mesh referenced by the shape, if any.
+        btTriangleMesh* m_mesh;
+
+        //! Aligned buffer holding a deserialized bounding volume hierarchy, if any.
+        void* m_bvhBuffer;
+
+        //! Child shapes of a compound shape, if any.
+        std::vector<btCollisionShape*> m_children;
+    };
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method returns a collision shape for a geometry, building it if not already available.
+    static btCollisionShape* acquireShape(const cBulletMeshData& a_data, 
+                                          const cBulletShapeType a_type, 
+                                          const double a_margin,
+                                          const cBulletDecompositionSettings& a_settings);
+
+    //! This method deletes a shape and its resources.
+    static void deleteShape(cBulletShapeEntry& a_entry);
+
+    //! This method builds a new shape and its resources.
+    static void buildShape(const cBulletMeshData& a_data, cBulletShapeEntry& a_entry, const cBulletDecompositionSettings& a_settings);
+
+    //! This method builds a Bullet triangle mesh from a geometry.
+    static btTriangleMesh* buildTriangleMesh(const cBulletMeshData& a_data);
+
+    //! This method builds a bounding volume hierarchy triangle mesh shape, loading its hierarchy from the disk cache if available.
+    static void buildStaticTriangles(const cBulletMeshData& a_data, cBulletShapeEntry& a_entry);
+
+    //! This method builds a convex hull shape, loading its vertices from the disk cache if available.
+    static void buildHull(const cBulletMeshData& a_data, cBulletShapeEntry& a_entry);
+
+    //! This method builds a compound of convex hulls approximating a geometry, loading the hulls from the disk cache if available.
+    static void buildConvexDecomposition(const cBulletMeshData& a_data, cBulletShapeEntry& a_entry, const cBulletDecompositionSettings& a_settings);
+
+    //! This method computes the vertices located on the convex hull of a set of points.
+    static void computeHullPoints(const double* a_points, const unsigned int a_numPoints, std::vector<double>& a_hullPoints);
+
+    //! This method implements the entry point of the thread which processes requests.
+    static void requestThread(void* a_arg);
+
+    //! This method returns the filename of a cached shape, or an empty string if the disk cache is disabled.
+    static std::string getCacheFilename(const cBulletShapeEntry& a_entry);
+
+    //! This method reads the data of a cached shape from disk.
+    static bool readCacheFile(const cBulletShapeEntry& a_entry, std::vector<unsigned char>& a_data);
+
+    //! This method writes the data of a cached shape to disk.
+    static bool writeCacheFile(const cBulletShapeEntry& a_entry, const void* a_data, const unsigned int a_size);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Shapes held by the cache.
+    static std::vector<cBulletShapeEntry> s_entries;
+
+    //! Directory of the disk cache.
+    static std::string s_cacheDirectory;
+
+    //! Mutex protecting the cache.
+    static cMutex s_mutex;
+
+    //! Requests waiting to be processed.
+    static std::list<cBulletShapeRequest*> s_requests;
+
+    //! Request being processed.
+    static cBulletShapeRequest* s_currentRequest;
+
+    //! If __true__ then the request thread is running.
+    static bool s_requestThreadRunning;
+
+    //! Thread which processes requests.
+    static cThread* s_requestThread;
+
+    //! Mutex protecting the requests.
+    static cMutex s_requestMutex;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -176,6 +176,7 @@ void cBulletVehicle::updatePositionFromDynamics()
 
         // orthogonalize frame
         m_localRot.orthogonalize();
+        invalidateGlobalPositions();
 
         // update wheels
         for (int i = 0; i < m_bulletVehicle->getNumWheels(); i++)
@@ -220,6 +221,24 @@ void cBulletVehicle::updatePositionFromDynamics()
 }
 
 
+//==============================================================================
+/*!
+    This method assigns a position and orientation computed by the simulation 
+    thread of the Bullet world to the CHAI3D representation. Only the chassis 
+    is updated; wheels keep their last known pose.
+
+    \param  a_pos  Position of the body.
+    \param  a_rot  Orientation of the body.
+*/
+//==============================================================================
+void cBulletVehicle::setPositionFromDynamics(const cVector3d& a_pos, const cMatrix3d& a_rot)
+{
+    m_localPos = a_pos;
+    m_localRot = a_rot;
+    invalidateGlobalPositions();
+}
+
+
 //==============================================================================
 /*!
     This method builds a dynamic representation of the object in the Bullet 
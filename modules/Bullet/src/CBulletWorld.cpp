@@ -61,6 +61,10 @@ cBulletWorld::cBulletWorld()
     // reset simulation time
     m_simulationTime = 0.0;
 
+    // list of bodies is empty
+    m_bodiesVersion = 0;
+    m_dynamicBodiesVersion = 0;
+
     // integration time step
     m_integrationTimeStep = 0.001;
 
@@ -82,11 +86,21 @@ cBulletWorld::cBulletWorld()
     // setup the actual physics solver
     m_bulletSolver = new btSequentialImpulseConstraintSolver;
 
-    // setup the dynamic world
-    m_bulletWorld = new btDiscreteDynamicsWorld(m_bulletCollisionDispatcher, m_bulletBroadphase, m_bulletSolver, m_bulletCollisionConfiguration);
+    // setup the dynamic world (single threaded solver by default)
+    m_bulletWorld = new cBulletParallelDynamicsWorld(m_bulletCollisionDispatcher, m_bulletBroadphase, m_bulletSolver, m_bulletCollisionConfiguration);
 
     // assign gravity constant
     m_bulletWorld->setGravity(btVector3( 0.0, 0.0,-9.81));
+
+    // simulation thread not running
+    m_simulationThread = NULL;
+    m_simulationThreadRunning = false;
+    m_posesPreviousTime = 0.0;
+    m_posesCurrentTime = 0.0;
+    m_numUpdatesSinceStep = 0;
+
+    // no collision shapes being built
+    m_numCollisionShapeRequests = 0;
 }
 
 
@@ -97,8 +111,21 @@ cBulletWorld::cBulletWorld()
 //==============================================================================
 cBulletWorld::~cBulletWorld()
 {
+    // stop simulation thread
+    stopSimulationThread();
+
+    // discard collision shapes requested by the bodies of this world. shapes 
+    // being built are released by the background thread once completed, so 
+    // requests from other worlds are not waited for.
+    list<cBulletGenericObject*>::iterator i;
+    for(i = m_bodies.begin(); i != m_bodies.end(); ++i)
+    {
+        (*i)->discardCollisionShapeRequest();
+    }
+
     // clear all bodies
     m_bodies.clear();
+    m_bodiesVersion++;
 
     // delete resources
     delete m_bulletWorld;
@@ -137,6 +164,36 @@ cVector3d cBulletWorld::getGravity()
 }
 
 
+//==============================================================================
+/*!
+    This methods sets the number of threads used by the constraint solver. 
+    Independent simulation islands, such as separate stacks of objects, are 
+    then solved in parallel. A value of 1 (default) solves all islands on 
+    the thread which steps the simulation. This method must not be called 
+    while the simulation is being updated.
+
+    \param  a_numThreads  Number of threads.
+*/
+//==============================================================================
+void cBulletWorld::setNumSolverThreads(const unsigned int a_numThreads)
+{
+    ((cBulletParallelDynamicsWorld*)m_bulletWorld)->setNumThreads(a_numThreads);
+}
+
+
+//==============================================================================
+/*!
+    This methods returns the number of threads used by the constraint solver.
+
+    \return Number of threads.
+*/
+//==============================================================================
+unsigned int cBulletWorld::getNumSolverThreads() const
+{
+    return (((cBulletParallelDynamicsWorld*)m_bulletWorld)->getNumThreads());
+}
+
+
 //==============================================================================
 /*!
     This methods updates the simulation over a time interval passed as
@@ -147,9 +204,20 @@ cVector3d cBulletWorld::getGravity()
 //==============================================================================
 void cBulletWorld::updateDynamics(double a_interval)
 {
+    // simulation is integrated by its own thread, only update poses
+    if (m_simulationThreadRunning)
+    {
+        m_numUpdatesSinceStep++;
+        updatePositionFromPublishedPoses();
+        return;
+    }
+
     // sanity check
     if (a_interval <= 0) { return; }
 
+    // assign collision shapes built in the background
+    updateCollisionShapes();
+
     // integrate simulation during an certain interval
     m_bulletWorld->stepSimulation(a_interval, m_integrationMaxIterations, m_integrationTimeStep);
 
@@ -164,21 +232,305 @@ void cBulletWorld::updateDynamics(double a_interval)
 //==============================================================================
 /*!
     This methods updates the position and orientation from the Bullet models 
-    to CHAI3D models.
+    to CHAI3D models. Only bodies whose transform was updated by Bullet since
+    the last call are synchronized. Static and sleeping bodies are skipped.
 */
 //==============================================================================
 void cBulletWorld::updatePositionFromDynamics()
 {
+    // poses are published by the simulation thread
+    if (m_simulationThreadRunning)
+    {
+        updatePositionFromPublishedPoses();
+        return;
+    }
+
+    // rebuild contiguous array of bodies if bodies were added or removed
+    if (m_dynamicBodiesVersion != m_bodiesVersion)
+    {
+        m_dynamicBodies.assign(m_bodies.begin(), m_bodies.end());
+        m_dynamicBodiesVersion = m_bodiesVersion;
+    }
+
+    // only synchronize bodies which were moved by Bullet since the last update
+    unsigned int numBodies = (unsigned int)(m_dynamicBodies.size());
+    for (unsigned int i=0; i<numBodies; i++)
+    {
+        cBulletGenericObject* nextItem = m_dynamicBodies[i];
+        if (nextItem->checkUpdatedFromDynamics())
+        {
+            nextItem->updatePositionFromDynamics();
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This methods assigns collision shapes built in the background to their
+    bodies. It is called before each simulation step and only iterates over
+    the bodies when shapes are pending.
+*/
+//==============================================================================
+void cBulletWorld::updateCollisionShapes()
+{
+    if (m_numCollisionShapeRequests <= 0)
+    {
+        return;
+    }
+
     list<cBulletGenericObject*>::iterator i;
+    for(i = m_bodies.begin(); i != m_bodies.end(); ++i)
+    {
+        (*i)->applyRequestedCollisionShape();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method starts a dedicated thread which integrates the simulation at
+    the fixed rate given by the integration time step. If the thread falls
+    behind real time by more than the maximum number of iterations, 
+    the missing steps are dropped.
+
+    \param  a_priority  Priority level of the simulation thread.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cBulletWorld::startSimulationThread(const CThreadPriority a_priority)
+{
+    // thread already running
+    if (m_simulationThreadRunning)
+    {
+        return (C_ERROR);
+    }
+
+    // build list of simulated bodies and publish their initial poses
+    m_simulationBodies.assign(m_bodies.begin(), m_bodies.end());
+    m_posesPrevious.resize(m_simulationBodies.size());
+    m_posesCurrent.resize(m_simulationBodies.size());
+    m_posesNext.resize(m_simulationBodies.size());
+
+    m_simulationClock.reset();
+    m_simulationClock.start();
+
+    publishPoses();
+    publishPoses();
+
+    // start thread
+    m_numUpdatesSinceStep = 0;
+    m_simulationThreadRunning = true;
 
+    m_simulationThread = new cThread();
+    m_simulationThread->start(simulationThread, a_priority, this);
+
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method stops the simulation thread and waits for it to terminate.
+    Once stopped, the simulation is again integrated by \ref updateDynamics().
+*/
+//==============================================================================
+void cBulletWorld::stopSimulationThread()
+{
+    if (m_simulationThread == NULL)
+    {
+        return;
+    }
+
+    // request thread to terminate and wait
+    m_simulationThreadRunning = false;
+    m_simulationThread->join();
+
+    delete m_simulationThread;
+    m_simulationThread = NULL;
+
+    // apply any forces still queued
+    list<cBulletGenericObject*>::iterator i;
     for(i = m_bodies.begin(); i != m_bodies.end(); ++i)
     {
-        cBulletGenericObject* nextItem = *i;
-        nextItem->updatePositionFromDynamics();
+        (*i)->applyQueuedForces(1.0);
+    }
+
+    // synchronize CHAI3D models with last simulation state
+    updatePositionFromDynamics();
+}
+
+
+//==============================================================================
+/*!
+    This method implements the entry point of the simulation thread.
+
+    \param  a_world  Bullet world.
+*/
+//==============================================================================
+void cBulletWorld::simulationThread(void* a_world)
+{
+    ((cBulletWorld*)a_world)->runSimulationThread();
+}
+
+
+//==============================================================================
+/*!
+    This method runs the fixed time step simulation loop. Before each step,
+    forces queued by other threads are averaged over the number of calls to
+    \ref updateDynamics() since the previous step, so that a force applied 
+    at every haptic update is applied with the same magnitude regardless of
+    the relative rates of both threads.
+*/
+//==============================================================================
+void cBulletWorld::runSimulationThread()
+{
+    double nextTime = m_simulationClock.getCurrentTimeSeconds();
+
+    while (m_simulationThreadRunning)
+    {
+        double timeStep = m_integrationTimeStep;
+
+        m_simulationMutex.acquire();
+
+        // assign collision shapes built in the background
+        updateCollisionShapes();
+
+        // apply queued forces
+        unsigned int numUpdates = m_numUpdatesSinceStep.exchange(0);
+        double scale = 1.0 / (double)(cMax(numUpdates, 1u));
+        for (unsigned int i=0; i<m_simulationBodies.size(); i++)
+        {
+            m_simulationBodies[i]->applyQueuedForces(scale);
+        }
+
+        // integrate a single time step
+        m_bulletWorld->stepSimulation(timeStep, 1, timeStep);
+        m_simulationTime = m_simulationTime + timeStep;
+
+        m_simulationMutex.release();
+
+        // publish new poses
+        publishPoses();
+
+        // wait for next step, drop steps if simulation is running behind
+        nextTime = nextTime + timeStep;
+        double time = m_simulationClock.getCurrentTimeSeconds();
+        if (time - nextTime > m_integrationMaxIterations * timeStep)
+        {
+            nextTime = time;
+        }
+        while (m_simulationThreadRunning && (time < nextTime))
+        {
+            // block for the remaining time, less a short margin absorbed by 
+            // yielding, so that the thread does not spin between steps
+            double remaining = nextTime - time;
+            if (remaining > 0.0002)
+            {
+                std::this_thread::sleep_for(std::chrono::duration<double>(remaining - 0.0001));
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+            time = m_simulationClock.getCurrentTimeSeconds();
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method stores the poses of all simulated bodies into the back buffer
+    and publishes it. Publishing only swaps buffers, so the pose mutex is held
+    for a constant time.
+*/
+//==============================================================================
+void cBulletWorld::publishPoses()
+{
+    for (unsigned int i=0; i<m_simulationBodies.size(); i++)
+    {
+        btRigidBody* body = m_simulationBodies[i]->m_bulletRigidBody;
+        cBulletPose& pose = m_posesNext[i];
+
+        pose.m_valid = (body != NULL) && (body->getMotionState() != NULL);
+        if (pose.m_valid)
+        {
+            btTransform trans;
+            body->getMotionState()->getWorldTransform(trans);
+
+            btVector3 pos = trans.getOrigin();
+            btQuaternion q = trans.getRotation();
+
+            pose.m_pos.set(pos[0], pos[1], pos[2]);
+            pose.m_rot = cQuaternion(q.getW(), q.getX(), q.getY(), q.getZ());
+        }
+    }
+
+    double time = m_simulationClock.getCurrentTimeSeconds();
+
+    m_poseMutex.acquire();
+    m_posesPrevious.swap(m_posesCurrent);
+    m_posesCurrent.swap(m_posesNext);
+    m_posesPreviousTime = m_posesCurrentTime;
+    m_posesCurrentTime = time;
+    m_poseMutex.release();
+}
+
+
+//==============================================================================
+/*!
+    This method assigns to all simulated bodies a pose interpolated between 
+    the last two published simulation steps. Poses are rendered one simulation
+    step behind real time so that motion remains smooth when the simulation 
+    thread and the calling thread run at different rates.
+*/
+//==============================================================================
+void cBulletWorld::updatePositionFromPublishedPoses()
+{
+    double time = m_simulationClock.getCurrentTimeSeconds();
+
+    m_poseMutex.acquire();
+
+    double interval = m_posesCurrentTime - m_posesPreviousTime;
+    double level = 1.0;
+    if (interval > C_SMALL)
+    {
+        level = cClamp((time - m_posesCurrentTime) / interval, 0.0, 1.0);
     }
+
+    for (unsigned int i=0; i<m_simulationBodies.size(); i++)
+    {
+        const cBulletPose& pose0 = m_posesPrevious[i];
+        const cBulletPose& pose1 = m_posesCurrent[i];
+        if (!pose0.m_valid || !pose1.m_valid)
+        {
+            continue;
+        }
+
+        // interpolate position
+        cVector3d pos = cAdd(cMul(1.0 - level, pose0.m_pos), cMul(level, pose1.m_pos));
+
+        // interpolate orientation along the shortest path
+        cQuaternion rot1 = pose1.m_rot;
+        if (pose0.m_rot.dot(rot1) < 0.0)
+        {
+            rot1.negate();
+        }
+        cQuaternion q;
+        q.slerp(level, pose0.m_rot, rot1);
+        cMatrix3d rot;
+        q.toRotMat(rot);
+        rot.orthogonalize();
+
+        m_simulationBodies[i]->setPositionFromDynamics(pos, rot);
+    }
+
+    m_poseMutex.release();
 }
 
 
 //------------------------------------------------------------------------------
 } // namespace chai3d
-//------------------------------------------------------------------------------
\ No newline at end of file
+//------------------------------------------------------------------------------
\ No newline at end of file
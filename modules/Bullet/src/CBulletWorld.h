@@ -46,10 +46,16 @@
 //------------------------------------------------------------------------------
 #include "chai3d.h"
 #include "CBulletGenericObject.h"
+#include "CBulletParallelDynamicsWorld.h"
 //------------------------------------------------------------------------------
 #include "btBulletDynamicsCommon.h"
 #include "BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h"
 //------------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+//------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
 namespace chai3d {
@@ -75,7 +81,18 @@ namespace chai3d {
 
     \details
     cBulletWorld implements a virtual world to handle Bullet based objects 
-    (cBulletGenericBody).
+    (cBulletGenericBody).\n
+
+    By default, the simulation is integrated by \ref updateDynamics() on the
+    calling thread. Alternatively, \ref startSimulationThread() runs the 
+    simulation at a fixed time step on a dedicated thread. In this mode, 
+    \ref updateDynamics() no longer integrates the simulation; it assigns to 
+    the CHAI3D objects poses interpolated between the last two published 
+    simulation steps, and external forces applied to bodies are accumulated 
+    without locks and applied at the next simulation step. Any other access
+    to the Bullet world from another thread must be enclosed between 
+    \ref acquireSimulation() and \ref releaseSimulation(). Bodies must not
+    be created or deleted while the simulation thread is running.
 */
 //==============================================================================
 class cBulletWorld : public chai3d::cWorld
@@ -99,9 +116,12 @@ public:
 
 public:
 
-    //! List of all Bullet dynamic bodies in world.
+    //! List of all Bullet dynamic bodies in world (modified through \ref addBody() and \ref removeBody()).
     std::list<cBulletGenericObject*> m_bodies;
 
+    //! Number of bodies waiting for a collision shape built in the background.
+    std::atomic<int> m_numCollisionShapeRequests;
+
 
     //--------------------------------------------------------------------------
     // PUBLIC METHODS:
@@ -112,6 +132,12 @@ public:
     //! This method returns a point to the Bullet world object.
     btDiscreteDynamicsWorld* getBulletWorld() { return (m_bulletWorld); }
 
+    //! This method adds a body to the list of dynamic bodies.
+    void addBody(cBulletGenericObject* a_body) { m_bodies.push_back(a_body); m_bodiesVersion++; }
+
+    //! This method removes a body from the list of dynamic bodies.
+    void removeBody(cBulletGenericObject* a_body) { m_bodies.remove(a_body); m_bodiesVersion++; }
+
     //! This method assigns integration settings of simulator.
     void setIntegrationSettings(const double a_integrationTimeStep = 0.001, const int a_integrationMaxIterations = 1) { setIntegrationTimeStep(a_integrationTimeStep); setIntegrationMaxIterations(a_integrationMaxIterations); }
 
@@ -120,6 +146,9 @@ public:
     
     //! The method returns the integration time step of the simulation.
     double getIntegrationTimeStep() { return (m_integrationTimeStep); }
+
+    //! This method returns the current time of the simulation.
+    double getSimulationTime() const { return (m_simulationTime); }
     
     //! This method sets the maximum number of iteration per integration time step.
     void setIntegrationMaxIterations(const int a_integrationMaxIterations = 1) { m_integrationMaxIterations = chai3d::cMax(a_integrationMaxIterations, 1); };
@@ -136,12 +165,43 @@ public:
     //! This method returns the gravity field vector.
     chai3d::cVector3d getGravity();
 
+    //! This method sets the number of threads used by the constraint solver.
+    void setNumSolverThreads(const unsigned int a_numThreads);
+
+    //! This method returns the number of threads used by the constraint solver.
+    unsigned int getNumSolverThreads() const;
+
     //! This method updates the simulation over a time interval.
     void updateDynamics(double a_interval);
 
     //! This method updates the position and orientation from Bullet models to CHAI3D models.
     void updatePositionFromDynamics(void);
 
+    //! This method assigns collision shapes built in the background to their bodies.
+    void updateCollisionShapes(void);
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - SIMULATION THREAD:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method starts integrating the simulation at a fixed time step on a dedicated thread.
+    bool startSimulationThread(const CThreadPriority a_priority = CTHREAD_PRIORITY_GRAPHICS);
+
+    //! This method stops the simulation thread and waits for it to terminate.
+    void stopSimulationThread();
+
+    //! This method returns __true__ if the simulation thread is running, __false__ otherwise.
+    bool getSimulationThreadRunning() const { return (m_simulationThreadRunning); }
+
+    //! This method blocks the simulation thread between two simulation steps.
+    void acquireSimulation() { m_simulationMutex.acquire(); }
+
+    //! This method releases the simulation thread.
+    void releaseSimulation() { m_simulationMutex.release(); }
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -171,14 +231,98 @@ public:
 
 protected:
 
-    //! Current time of simulation.
-    double m_simulationTime;
+    //! Current time of simulation (may be advanced by the simulation thread).
+    std::atomic<double> m_simulationTime;
 
     //! Integration time step.
     double m_integrationTimeStep;
 
     //! Maximum number of iterations.
     int m_integrationMaxIterations;
+
+    //! Contiguous copy of \ref m_bodies used to synchronize CHAI3D models after each step.
+    std::vector<cBulletGenericObject*> m_dynamicBodies;
+
+    //! Version of \ref m_bodies, incremented each time a body is added or removed.
+    unsigned int m_bodiesVersion;
+
+    //! Version of \ref m_bodies from which \ref m_dynamicBodies was built.
+    unsigned int m_dynamicBodiesVersion;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - SIMULATION THREAD:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Pose of a body published by the simulation thread.
+    struct cBulletPose
+    {
+        //! If __true__ then the pose is valid.
+        bool m_valid;
+
+        //! Position of body.
+        cVector3d m_pos;
+
+        //! Orientation of body.
+        cQuaternion m_rot;
+    };
+
+    //! Simulation thread.
+    cThread* m_simulationThread;
+
+    //! If __true__ then the simulation thread is running.
+    std::atomic<bool> m_simulationThreadRunning;
+
+    //! Mutex held by the simulation thread while it steps the Bullet world.
+    cMutex m_simulationMutex;
+
+    //! Mutex protecting the published poses.
+    cMutex m_poseMutex;
+
+    //! Bodies simulated by the simulation thread.
+    std::vector<cBulletGenericObject*> m_simulationBodies;
+
+    //! Poses published by the previous simulation step.
+    std::vector<cBulletPose> m_posesPrevious;
+
+    //! Poses published by the last simulation step.
+    std::vector<cBulletPose> m_posesCurrent;
+
+    //! Poses being computed by the simulation thread.
+    std::vector<cBulletPose> m_posesNext;
+
+    //! Time at which the previous poses were published.
+    double m_posesPreviousTime;
+
+    //! Time at which the current poses were published.
+    double m_posesCurrentTime;
+
+    //! Clock shared by the simulation thread and the threads reading poses.
+    cPrecisionClock m_simulationClock;
+
+    //! Number of calls to \ref updateDynamics() since the last simulation step.
+    std::atomic<unsigned int> m_numUpdatesSinceStep;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS - SIMULATION THREAD:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method runs the simulation loop of the simulation thread.
+    void runSimulationThread();
+
+    //! This method stores the poses of all simulated bodies and publishes them.
+    void publishPoses();
+
+    //! This method assigns interpolated published poses to all simulated bodies.
+    void updatePositionFromPublishedPoses();
+
+    //! Entry point of the simulation thread.
+    static void simulationThread(void* a_world);
 };
 
 //------------------------------------------------------------------------------
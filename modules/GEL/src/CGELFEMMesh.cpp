@@ -0,0 +1,1206 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include "CGELFEMMesh.h"
+//---------------------------------------------------------------------------
+#include "Eigen/Dense"
+#include "Eigen/Geometry"
+#include <algorithm>
+//---------------------------------------------------------------------------
+using namespace chai3d;
+using namespace std;
+//---------------------------------------------------------------------------
+//! Minimum number of tetrahedra processed by a thread.
+#define GEL_FEM_MIN_TET_BLOCK_SIZE 128
+
+//! Minimum number of nodes processed by a thread.
+#define GEL_FEM_MIN_NODE_BLOCK_SIZE 256
+
+//! Number of nodes per partial sum of dot products.
+#define GEL_FEM_DOT_CHUNK_SIZE 256
+
+//! Maximum number of iterations of the polar decomposition.
+#define GEL_FEM_MAX_POLAR_ITERATIONS 8
+
+//! Rotation angle [rad] below which the polar decomposition has converged.
+#define GEL_FEM_POLAR_TOLERANCE 1.0e-6
+//---------------------------------------------------------------------------
+
+
+//===========================================================================
+/*!
+    Constructor of cGELFEMMesh.
+*/
+//===========================================================================
+cGELFEMMesh::cGELFEMMesh()
+{
+    m_youngModulus = 10000.0;
+    m_poissonRatio = 0.3;
+    m_density = 1000.0;
+    m_massDamping = 0.0;
+    m_stiffnessDamping = 0.0;
+    if (cGELMassParticle::s_default_useGravity)
+    {
+        m_gravity = cGELMassParticle::s_default_gravity;
+    }
+    else
+    {
+        m_gravity.zero();
+    }
+
+    m_massScale = 1.0;
+    m_stiffnessScale = 0.0;
+    m_tolerance = 1e-4;
+    m_maxIterations = 100;
+    m_numIterations = 0;
+    m_error = 0.0;
+    m_femValid = false;
+}
+
+
+//===========================================================================
+/*!
+    This method creates a new node at a rest position passed as argument.
+    The current position of the node is initialized to its rest position.
+
+    \param  a_pos  Rest position of node.
+
+    \return Index of the new node.
+*/
+//===========================================================================
+int cGELFEMMesh::newNode(const cVector3d& a_pos)
+{
+    for (int k=0; k<3; k++)
+    {
+        m_nodeRestPos.push_back(a_pos(k));
+        m_nodePos.push_back(a_pos(k));
+        m_nodeNextPos.push_back(a_pos(k));
+        m_nodeVel.push_back(0.0);
+        m_nodeExtForce.push_back(0.0);
+        m_nodeForce.push_back(0.0);
+    }
+    m_nodeMass.push_back(0.0);
+    m_nodeFixed.push_back(0);
+    m_nodeMassless.push_back(0);
+    m_femValid = false;
+
+    return (getNumNodes() - 1);
+}
+
+
+//===========================================================================
+/*!
+    This method creates a new tetrahedron from four node indices.
+
+    \param  a_node0  Index of first node.
+    \param  a_node1  Index of second node.
+    \param  a_node2  Index of third node.
+    \param  a_node3  Index of fourth node.
+
+    \return Index of the new tetrahedron.
+*/
+//===========================================================================
+int cGELFEMMesh::newTetrahedron(const int a_node0, const int a_node1, const int a_node2, const int a_node3)
+{
+    m_tetrahedra.push_back(a_node0);
+    m_tetrahedra.push_back(a_node1);
+    m_tetrahedra.push_back(a_node2);
+    m_tetrahedra.push_back(a_node3);
+    m_femValid = false;
+
+    return (getNumTetrahedra() - 1);
+}
+
+
+//===========================================================================
+/*!
+    This method removes all nodes and tetrahedra of the model.
+*/
+//===========================================================================
+void cGELFEMMesh::clearFEMModel()
+{
+    m_nodeRestPos.clear();
+    m_nodePos.clear();
+    m_nodeNextPos.clear();
+    m_nodeVel.clear();
+    m_nodeExtForce.clear();
+    m_nodeForce.clear();
+    m_nodeMass.clear();
+    m_nodeFixed.clear();
+    m_nodeMassless.clear();
+    m_tetrahedra.clear();
+    m_skinTet.clear();
+    m_skinWeight.clear();
+    m_femValid = false;
+}
+
+
+//===========================================================================
+/*!
+    This method sets the current position of a node. It is typically used
+    to move fixed nodes.
+
+    \param  a_node  Index of node.
+    \param  a_pos   New position.
+*/
+//===========================================================================
+void cGELFEMMesh::setNodePos(const int a_node, const cVector3d& a_pos)
+{
+    for (int k=0; k<3; k++)
+    {
+        m_nodePos[3*a_node+k] = a_pos(k);
+        m_nodeNextPos[3*a_node+k] = a_pos(k);
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method sets the external force applied on a node.
+
+    \param  a_node   Index of node.
+    \param  a_force  External force.
+*/
+//===========================================================================
+void cGELFEMMesh::setNodeExternalForce(const int a_node, const cVector3d& a_force)
+{
+    for (int k=0; k<3; k++)
+    {
+        m_nodeExtForce[3*a_node+k] = a_force(k);
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method sets the material of the model. The model is rebuilt at 
+    the next step.
+
+    \param  a_youngModulus  Young's modulus [Pa].
+    \param  a_poissonRatio  Poisson's ratio (smaller than 0.5).
+    \param  a_density       Density [kg/m^3].
+*/
+//===========================================================================
+void cGELFEMMesh::setMaterial(const double a_youngModulus, const double a_poissonRatio, const double a_density)
+{
+    m_youngModulus = a_youngModulus;
+    m_poissonRatio = cClamp(a_poissonRatio, 0.0, 0.49);
+    m_density = a_density;
+    m_femValid = false;
+}
+
+
+//===========================================================================
+/*!
+    This method precomputes the data of the model: the inverse rest shape
+    and stiffness matrix of each tetrahedron, the lumped masses of the 
+    nodes and the sparse block structure of the global stiffness matrix.
+    It is called automatically when nodes, tetrahedra or the material are
+    modified. Nodes which do not belong to any tetrahedron have no mass and
+    are held in place. They are tracked separately from the nodes fixed by
+    \ref setNodeFixed(), so that they are released when the model is 
+    rebuilt with tetrahedra attached to them.
+*/
+//===========================================================================
+void cGELFEMMesh::buildFEMModel()
+{
+    int numNodes = getNumNodes();
+    int numTets = getNumTetrahedra();
+
+    // Lame coefficients
+    double lambda = m_youngModulus * m_poissonRatio / ((1.0 + m_poissonRatio) * (1.0 - 2.0 * m_poissonRatio));
+    double mu = m_youngModulus / (2.0 * (1.0 + m_poissonRatio));
+
+    // compute rest shape, stiffness and mass of each tetrahedron
+    m_tetInvRestShape.assign(9 * numTets, 0.0);
+    m_tetStiffness.assign(144 * numTets, 0.0);
+    m_tetRotation.assign(4 * numTets, 0.0);
+    m_tetRotatedStiffness.assign(144 * numTets, 0.0);
+    m_tetForce.assign(12 * numTets, 0.0);
+    m_nodeMass.assign(numNodes, 0.0);
+    m_nodeMassless.assign(numNodes, 0);
+
+    for (int t=0; t<numTets; t++)
+    {
+        const int* n = &m_tetrahedra[4*t];
+        m_tetRotation[4*t] = 1.0;
+
+        Eigen::Vector3d X0(&m_nodeRestPos[3*n[0]]);
+        Eigen::Matrix3d restShape;
+        for (int k=0; k<3; k++)
+        {
+            restShape.col(k) = Eigen::Vector3d(&m_nodeRestPos[3*n[k+1]]) - X0;
+        }
+
+        // ignore degenerated tetrahedra
+        double det = restShape.determinant();
+        if (fabs(det) < C_TINY) { continue; }
+
+        Eigen::Matrix3d invRestShape = restShape.inverse();
+        Eigen::Map<Eigen::Matrix3d> storedInvRestShape(&m_tetInvRestShape[9*t]);
+        storedInvRestShape = invRestShape;
+        double volume = fabs(det) / 6.0;
+
+        // gradients of shape functions
+        Eigen::Vector3d b[4];
+        for (int k=0; k<3; k++)
+        {
+            b[k+1] = invRestShape.row(k).transpose();
+        }
+        b[0] = -(b[1] + b[2] + b[3]);
+
+        // K_ab = V (lambda b_a b_b^T + mu b_b b_a^T + mu (b_a . b_b) I)
+        for (int i=0; i<4; i++)
+        {
+            for (int j=0; j<4; j++)
+            {
+                Eigen::Map<Eigen::Matrix3d> K(&m_tetStiffness[144*t + 9*(4*i+j)]);
+                K = volume * (lambda * b[i] * b[j].transpose() +
+                              mu * b[j] * b[i].transpose() +
+                              mu * b[i].dot(b[j]) * Eigen::Matrix3d::Identity());
+            }
+        }
+
+        // lumped mass
+        for (int i=0; i<4; i++)
+        {
+            m_nodeMass[n[i]] += 0.25 * m_density * volume;
+        }
+    }
+
+    // hold nodes without mass in place
+    for (int i=0; i<numNodes; i++)
+    {
+        if (m_nodeMass[i] <= 0.0)
+        {
+            m_nodeMass[i] = 1.0;
+            m_nodeMassless[i] = 1;
+        }
+    }
+
+    // tetrahedra attached to each node
+    m_nodeTetOffset.assign(numNodes + 1, 0);
+    for (int t=0; t<numTets; t++)
+    {
+        for (int i=0; i<4; i++)
+        {
+            m_nodeTetOffset[m_tetrahedra[4*t+i] + 1]++;
+        }
+    }
+    for (int i=0; i<numNodes; i++)
+    {
+        m_nodeTetOffset[i+1] += m_nodeTetOffset[i];
+    }
+    m_nodeTet.resize(4 * numTets);
+    vector<int> count(m_nodeTetOffset.begin(), m_nodeTetOffset.end() - 1);
+    for (int t=0; t<numTets; t++)
+    {
+        for (int i=0; i<4; i++)
+        {
+            m_nodeTet[count[m_tetrahedra[4*t+i]]++] = 4*t + i;
+        }
+    }
+
+    // block structure of stiffness matrix: one block per pair of nodes 
+    // sharing a tetrahedron
+    vector<vector<int> > columns(numNodes);
+    for (int i=0; i<numNodes; i++)
+    {
+        columns[i].push_back(i);
+    }
+    for (int t=0; t<numTets; t++)
+    {
+        for (int i=0; i<4; i++)
+        {
+            for (int j=0; j<4; j++)
+            {
+                columns[m_tetrahedra[4*t+i]].push_back(m_tetrahedra[4*t+j]);
+            }
+        }
+    }
+
+    m_blockRowOffset.assign(numNodes + 1, 0);
+    m_blockColumn.clear();
+    m_diagonalBlock.resize(numNodes);
+    for (int i=0; i<numNodes; i++)
+    {
+        sort(columns[i].begin(), columns[i].end());
+        columns[i].erase(unique(columns[i].begin(), columns[i].end()), columns[i].end());
+        m_blockRowOffset[i+1] = m_blockRowOffset[i] + (int)(columns[i].size());
+        for (unsigned int k=0; k<columns[i].size(); k++)
+        {
+            if (columns[i][k] == i) { m_diagonalBlock[i] = (int)(m_blockColumn.size()); }
+            m_blockColumn.push_back(columns[i][k]);
+        }
+    }
+    int numBlocks = (int)(m_blockColumn.size());
+    m_blocks.assign(9 * numBlocks, 0.0);
+
+    // blocks of tetrahedra contributing to each block of the matrix
+    vector<int> tetBlock(16 * numTets);
+    m_blockTetOffset.assign(numBlocks + 1, 0);
+    for (int t=0; t<numTets; t++)
+    {
+        for (int i=0; i<4; i++)
+        {
+            int row = m_tetrahedra[4*t+i];
+            for (int j=0; j<4; j++)
+            {
+                const int* first = &m_blockColumn[m_blockRowOffset[row]];
+                const int* last = &m_blockColumn[0] + m_blockRowOffset[row+1];
+                int block = (int)(lower_bound(first, last, m_tetrahedra[4*t+j]) - &m_blockColumn[0]);
+                tetBlock[16*t + 4*i + j] = block;
+                m_blockTetOffset[block + 1]++;
+            }
+        }
+    }
+    for (int i=0; i<numBlocks; i++)
+    {
+        m_blockTetOffset[i+1] += m_blockTetOffset[i];
+    }
+    m_blockTet.resize(16 * numTets);
+    count.assign(m_blockTetOffset.begin(), m_blockTetOffset.end() - 1);
+    for (int i=0; i<16 * numTets; i++)
+    {
+        m_blockTet[count[tetBlock[i]]++] = i;
+    }
+
+    // allocate solver
+    m_rhs.assign(3 * numNodes, 0.0);
+    m_deltaVel.assign(3 * numNodes, 0.0);
+    m_residual.assign(3 * numNodes, 0.0);
+    m_preconditioned.assign(3 * numNodes, 0.0);
+    m_direction.assign(3 * numNodes, 0.0);
+    m_product.assign(3 * numNodes, 0.0);
+    m_preconditioner.assign(9 * numNodes, 0.0);
+    m_partialSums.assign(3 * ((numNodes + GEL_FEM_DOT_CHUNK_SIZE - 1) / GEL_FEM_DOT_CHUNK_SIZE), 0.0);
+    m_numIterations = 0;
+    m_error = 0.0;
+
+    m_femValid = true;
+}
+
+
+//===========================================================================
+/*!
+    This method attaches each vertex of the skin, created by 
+    \ref buildVertices(), to the tetrahedron which contains it, using the 
+    current position of the nodes. Vertices located outside the model are
+    attached to the nearest tetrahedron found in their neighborhood, with 
+    extrapolated barycentric coordinates. Vertices and nodes must be 
+    expressed in the same reference frame.
+*/
+//===========================================================================
+void cGELFEMMesh::connectVerticesToTetrahedra()
+{
+    if (!m_femValid) { buildFEMModel(); }
+
+    int numVertices = (int)(m_gelVertices.size());
+    int numNodes = getNumNodes();
+    int numTets = getNumTetrahedra();
+    m_skinTet.assign(numVertices, -1);
+    m_skinWeight.assign(4 * numVertices, 0.0);
+    if ((numTets == 0) || (numVertices == 0)) { return; }
+
+    // bounding box of nodes
+    Eigen::Vector3d lower = Eigen::Vector3d::Constant( C_LARGE);
+    Eigen::Vector3d upper = Eigen::Vector3d::Constant(-C_LARGE);
+    for (int i=0; i<numNodes; i++)
+    {
+        lower = lower.cwiseMin(Eigen::Vector3d(&m_nodePos[3*i]));
+        upper = upper.cwiseMax(Eigen::Vector3d(&m_nodePos[3*i]));
+    }
+
+    // uniform grid of tetrahedra, with about one tetrahedron per cell
+    int res = cClamp((int)(pow((double)numTets, 1.0 / 3.0) + 0.5), 1, 128);
+    Eigen::Vector3d cellSize = ((upper - lower) / (double)res).cwiseMax(Eigen::Vector3d::Constant(C_SMALL));
+    int numCells = res * res * res;
+
+    vector<int> tetMin(3 * numTets), tetMax(3 * numTets);
+    vector<int> cellOffset(numCells + 1, 0);
+    for (int t=0; t<numTets; t++)
+    {
+        Eigen::Vector3d tl = Eigen::Vector3d::Constant( C_LARGE);
+        Eigen::Vector3d tu = Eigen::Vector3d::Constant(-C_LARGE);
+        for (int i=0; i<4; i++)
+        {
+            tl = tl.cwiseMin(Eigen::Vector3d(&m_nodePos[3*m_tetrahedra[4*t+i]]));
+            tu = tu.cwiseMax(Eigen::Vector3d(&m_nodePos[3*m_tetrahedra[4*t+i]]));
+        }
+        for (int k=0; k<3; k++)
+        {
+            tetMin[3*t+k] = cClamp((int)((tl(k) - lower(k)) / cellSize(k)), 0, res - 1);
+            tetMax[3*t+k] = cClamp((int)((tu(k) - lower(k)) / cellSize(k)), 0, res - 1);
+        }
+        for (int x=tetMin[3*t]; x<=tetMax[3*t]; x++)
+            for (int y=tetMin[3*t+1]; y<=tetMax[3*t+1]; y++)
+                for (int z=tetMin[3*t+2]; z<=tetMax[3*t+2]; z++)
+                    cellOffset[(x * res + y) * res + z + 1]++;
+    }
+    for (int i=0; i<numCells; i++)
+    {
+        cellOffset[i+1] += cellOffset[i];
+    }
+    vector<int> cellTets(cellOffset[numCells]);
+    vector<int> count(cellOffset.begin(), cellOffset.end() - 1);
+    for (int t=0; t<numTets; t++)
+    {
+        for (int x=tetMin[3*t]; x<=tetMax[3*t]; x++)
+            for (int y=tetMin[3*t+1]; y<=tetMax[3*t+1]; y++)
+                for (int z=tetMin[3*t+2]; z<=tetMax[3*t+2]; z++)
+                    cellTets[count[(x * res + y) * res + z]++] = t;
+    }
+
+    // barycentric coordinates of a point in a tetrahedron; returns the 
+    // smallest coordinate (negative if the point is outside)
+    auto computeWeights = [this](const Eigen::Vector3d& a_pos, const int a_tet, double* a_weights) -> double
+    {
+        const int* n = &m_tetrahedra[4*a_tet];
+        Eigen::Vector3d x0(&m_nodePos[3*n[0]]);
+        Eigen::Matrix3d shape;
+        for (int k=0; k<3; k++)
+        {
+            shape.col(k) = Eigen::Vector3d(&m_nodePos[3*n[k+1]]) - x0;
+        }
+        if (fabs(shape.determinant()) < C_TINY) { return (-C_LARGE); }
+
+        Eigen::Vector3d w = shape.inverse() * (a_pos - x0);
+        a_weights[0] = 1.0 - w.sum();
+        a_weights[1] = w(0);
+        a_weights[2] = w(1);
+        a_weights[3] = w(2);
+        return (cMin(cMin(a_weights[0], a_weights[1]), cMin(a_weights[2], a_weights[3])));
+    };
+
+    // attach each vertex
+    cGELParallelFor(m_threadPool, numVertices, [&](int a_begin, int a_end)
+    {
+        for (int v=a_begin; v<a_end; v++)
+        {
+            cGELVertex* curVertex = &m_gelVertices[v];
+            cVector3d p = curVertex->m_mesh->m_vertices->getLocalPos(curVertex->m_vertexIndex);
+            Eigen::Vector3d pos(p(0), p(1), p(2));
+
+            int cell[3];
+            for (int k=0; k<3; k++)
+            {
+                cell[k] = cClamp((int)((pos(k) - lower(k)) / cellSize(k)), 0, res - 1);
+            }
+
+            // search cell of vertex, then its neighbors, then all tetrahedra
+            double best = -C_LARGE;
+            double weights[4];
+            for (int ring=0; (ring<=2) && (best < 0.0); ring++)
+            {
+                if (ring < 2)
+                {
+                    for (int x=cMax(cell[0]-ring, 0); x<=cMin(cell[0]+ring, res-1); x++)
+                        for (int y=cMax(cell[1]-ring, 0); y<=cMin(cell[1]+ring, res-1); y++)
+                            for (int z=cMax(cell[2]-ring, 0); z<=cMin(cell[2]+ring, res-1); z++)
+                            {
+                                int c = (x * res + y) * res + z;
+                                for (int j=cellOffset[c]; j<cellOffset[c+1]; j++)
+                                {
+                                    double minWeight = computeWeights(pos, cellTets[j], weights);
+                                    if (minWeight > best)
+                                    {
+                                        best = minWeight;
+                                        m_skinTet[v] = cellTets[j];
+                                        std::copy(weights, weights + 4, &m_skinWeight[4*v]);
+                                    }
+                                }
+                            }
+                }
+                else if (m_skinTet[v] < 0)
+                {
+                    for (int t=0; t<numTets; t++)
+                    {
+                        double minWeight = computeWeights(pos, t, weights);
+                        if (minWeight > best)
+                        {
+                            best = minWeight;
+                            m_skinTet[v] = t;
+                            std::copy(weights, weights + 4, &m_skinWeight[4*v]);
+                        }
+                    }
+                }
+            }
+        }
+    }, GEL_FEM_MIN_NODE_BLOCK_SIZE);
+}
+
+
+//===========================================================================
+/*!
+    This method clears the external forces applied on all nodes and on the
+    mass particles of the skin.
+*/
+//===========================================================================
+void cGELFEMMesh::clearExternalForces()
+{
+    fill(m_nodeExtForce.begin(), m_nodeExtForce.end(), 0.0);
+
+    vector<cGELVertex>::iterator i;
+    for(i = m_gelVertices.begin(); i != m_gelVertices.end(); ++i)
+    {
+        if (i->m_massParticle != NULL)
+        {
+            i->m_massParticle->clearExternalForces();
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the next position of all nodes over a time 
+    interval passed as argument using a backward Euler step.
+
+    \param  a_timeInterval  Time interval.
+*/
+//===========================================================================
+void cGELFEMMesh::computeNextPose(double a_timeInterval)
+{
+    if (!m_femValid) { buildFEMModel(); }
+    if (getNumTetrahedra() == 0) { return; }
+
+    const double h = a_timeInterval;
+    m_massScale = 1.0 + h * m_massDamping;
+    m_stiffnessScale = h * m_stiffnessDamping + h * h;
+
+    // forces applied on the skin
+    gatherSkinForces();
+
+    // rotations, rotated stiffness matrices and elastic forces of tetrahedra
+    cGELParallelFor(m_threadPool, getNumTetrahedra(), [this](int a_begin, int a_end)
+    {
+        computeRotations(a_begin, a_end);
+        computeElementForces(a_begin, a_end);
+    }, GEL_FEM_MIN_TET_BLOCK_SIZE);
+
+    // assemble forces, stiffness matrix and preconditioner
+    cGELParallelFor(m_threadPool, getNumNodes(), [this](int a_begin, int a_end)
+    {
+        assembleNodes(a_begin, a_end);
+    }, GEL_FEM_MIN_NODE_BLOCK_SIZE);
+
+    // right hand side h (f - (beta + h) K v)
+    cGELParallelFor(m_threadPool, getNumNodes(), [this, h](int a_begin, int a_end)
+    {
+        multiplyStiffness(&m_nodeVel[0], &m_product[0], a_begin, a_end);
+        for (int i=a_begin; i<a_end; i++)
+        {
+            double mobile = isNodeStatic(i) ? 0.0 : 1.0;
+            for (int k=0; k<3; k++)
+            {
+                m_rhs[3*i+k] = mobile * h * (m_nodeForce[3*i+k] - (m_stiffnessDamping + h) * m_product[3*i+k]);
+            }
+        }
+    }, GEL_FEM_MIN_NODE_BLOCK_SIZE);
+
+    // solve system, starting from previous solution
+    solve(h);
+
+    // update velocities and positions
+    cGELParallelFor(m_threadPool, getNumNodes(), [this, h](int a_begin, int a_end)
+    {
+        for (int i=a_begin; i<a_end; i++)
+        {
+            for (int k=0; k<3; k++)
+            {
+                if (isNodeStatic(i))
+                {
+                    m_nodeVel[3*i+k] = 0.0;
+                    m_nodeNextPos[3*i+k] = m_nodePos[3*i+k];
+                }
+                else
+                {
+                    m_nodeVel[3*i+k] += m_deltaVel[3*i+k];
+                    m_nodeNextPos[3*i+k] = m_nodePos[3*i+k] + h * m_nodeVel[3*i+k];
+                }
+            }
+        }
+    }, GEL_FEM_MIN_NODE_BLOCK_SIZE);
+}
+
+
+//===========================================================================
+/*!
+    This method applies the next position of all nodes.
+*/
+//===========================================================================
+void cGELFEMMesh::applyNextPose()
+{
+    m_nodePos.swap(m_nodeNextPos);
+    m_nodeNextPos = m_nodePos;
+}
+
+
+//===========================================================================
+/*!
+    This method updates the position of each vertex of the skin from the 
+    position of the nodes of its tetrahedron. The position of the mass 
+    particle of each vertex is updated as well.
+*/
+//===========================================================================
+void cGELFEMMesh::updateVertexPosition()
+{
+    int numVertices = (int)(cMin(m_gelVertices.size(), m_skinTet.size()));
+
+    cGELParallelFor(m_threadPool, numVertices, [this](int a_begin, int a_end)
+    {
+        for (int v=a_begin; v<a_end; v++)
+        {
+            int t = m_skinTet[v];
+            if (t < 0) { continue; }
+
+            const int* n = &m_tetrahedra[4*t];
+            const double* w = &m_skinWeight[4*v];
+            cVector3d pos;
+            for (int k=0; k<3; k++)
+            {
+                pos(k) = w[0] * m_nodePos[3*n[0]+k] + w[1] * m_nodePos[3*n[1]+k] + 
+                         w[2] * m_nodePos[3*n[2]+k] + w[3] * m_nodePos[3*n[3]+k];
+            }
+
+            cGELVertex* curVertex = &m_gelVertices[v];
+            curVertex->m_mesh->m_vertices->m_localPos[curVertex->m_vertexIndex] = pos;
+            if (curVertex->m_massParticle != NULL)
+            {
+                curVertex->m_massParticle->m_pos = pos;
+            }
+        }
+    }, GEL_FEM_MIN_NODE_BLOCK_SIZE);
+
+    // mark vertex data for update (vertex arrays are written directly above)
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        (*it)->m_vertices->markForUpdate();
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method transmits the external forces applied on the mass particles
+    of the skin to the nodes of their tetrahedra. The result initializes 
+    the total forces of the nodes.
+*/
+//===========================================================================
+void cGELFEMMesh::gatherSkinForces()
+{
+    fill(m_nodeForce.begin(), m_nodeForce.end(), 0.0);
+
+    int numVertices = (int)(cMin(m_gelVertices.size(), m_skinTet.size()));
+    for (int v=0; v<numVertices; v++)
+    {
+        cGELMassParticle* particle = m_gelVertices[v].m_massParticle;
+        int t = m_skinTet[v];
+        if ((particle == NULL) || (t < 0)) { continue; }
+
+        const cVector3d& force = particle->getExternalForce();
+        if ((force(0) == 0.0) && (force(1) == 0.0) && (force(2) == 0.0)) { continue; }
+
+        for (int i=0; i<4; i++)
+        {
+            int node = m_tetrahedra[4*t+i];
+            for (int k=0; k<3; k++)
+            {
+                m_nodeForce[3*node+k] += m_skinWeight[4*v+i] * force(k);
+            }
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method extracts the rotation of a range of tetrahedra from their 
+    deformation gradient. The rotation of the previous step is refined 
+    iteratively until it aligns with the deformation gradient (Mueller et 
+    al., "A Robust Method to Extract the Rotational Part of Deformations",
+    2016). The method remains stable for inverted tetrahedra.
+
+    \param  a_begin  First tetrahedron.
+    \param  a_end    Last tetrahedron (excluded).
+*/
+//===========================================================================
+void cGELFEMMesh::computeRotations(const int a_begin, const int a_end)
+{
+    for (int t=a_begin; t<a_end; t++)
+    {
+        const int* n = &m_tetrahedra[4*t];
+
+        // deformation gradient
+        Eigen::Vector3d x0(&m_nodePos[3*n[0]]);
+        Eigen::Matrix3d shape;
+        for (int k=0; k<3; k++)
+        {
+            shape.col(k) = Eigen::Vector3d(&m_nodePos[3*n[k+1]]) - x0;
+        }
+        Eigen::Matrix3d F = shape * Eigen::Map<const Eigen::Matrix3d>(&m_tetInvRestShape[9*t]);
+
+        // refine rotation of previous step
+        double* r = &m_tetRotation[4*t];
+        Eigen::Quaterniond q(r[0], r[1], r[2], r[3]);
+        for (int i=0; i<GEL_FEM_MAX_POLAR_ITERATIONS; i++)
+        {
+            Eigen::Matrix3d R = q.matrix();
+            Eigen::Vector3d omega = R.col(0).cross(F.col(0)) + R.col(1).cross(F.col(1)) + R.col(2).cross(F.col(2));
+            omega /= fabs(R.col(0).dot(F.col(0)) + R.col(1).dot(F.col(1)) + R.col(2).dot(F.col(2))) + 1.0e-9;
+            double angle = omega.norm();
+            if (angle < GEL_FEM_POLAR_TOLERANCE) { break; }
+            q = Eigen::Quaterniond(Eigen::AngleAxisd(angle, omega / angle)) * q;
+            q.normalize();
+        }
+
+        r[0] = q.w();
+        r[1] = q.x();
+        r[2] = q.y();
+        r[3] = q.z();
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes, for a range of tetrahedra, the stiffness matrix 
+    rotated into the current configuration, R K R^T, and the elastic force 
+    applied on each node, f_a = -R sum_b K_ab (R^T x_b - X_b). Since 
+    K_ba = K_ab^T, only the blocks with a <= b are rotated.
+
+    \param  a_begin  First tetrahedron.
+    \param  a_end    Last tetrahedron (excluded).
+*/
+//===========================================================================
+void cGELFEMMesh::computeElementForces(const int a_begin, const int a_end)
+{
+    for (int t=a_begin; t<a_end; t++)
+    {
+        const int* n = &m_tetrahedra[4*t];
+        const double* r = &m_tetRotation[4*t];
+        Eigen::Matrix3d R = Eigen::Quaterniond(r[0], r[1], r[2], r[3]).matrix();
+
+        // displacement of nodes in the rotated frame
+        Eigen::Vector3d u[4];
+        for (int j=0; j<4; j++)
+        {
+            u[j] = R.transpose() * Eigen::Vector3d(&m_nodePos[3*n[j]]) - Eigen::Vector3d(&m_nodeRestPos[3*n[j]]);
+        }
+
+        for (int i=0; i<4; i++)
+        {
+            Eigen::Vector3d f = Eigen::Vector3d::Zero();
+            for (int j=0; j<4; j++)
+            {
+                Eigen::Map<const Eigen::Matrix3d> K(&m_tetStiffness[144*t + 9*(4*i+j)]);
+                f += K * u[j];
+                if (i <= j)
+                {
+                    Eigen::Map<Eigen::Matrix3d> rotatedK(&m_tetRotatedStiffness[144*t + 9*(4*i+j)]);
+                    rotatedK.noalias() = R * K * R.transpose();
+                }
+            }
+            Eigen::Map<Eigen::Vector3d> force(&m_tetForce[12*t + 3*i]);
+            force = -(R * f);
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method sums, for a range of nodes, the elastic forces of their 
+    tetrahedra, the external, gravity and damping forces, and the blocks
+    of their row of the stiffness matrix. It also computes the inverse of
+    the diagonal block of the system matrix used as preconditioner.
+
+    \param  a_begin  First node.
+    \param  a_end    Last node (excluded).
+*/
+//===========================================================================
+void cGELFEMMesh::assembleNodes(const int a_begin, const int a_end)
+{
+    for (int i=a_begin; i<a_end; i++)
+    {
+        // forces
+        double mass = m_nodeMass[i];
+        for (int k=0; k<3; k++)
+        {
+            m_nodeForce[3*i+k] += m_nodeExtForce[3*i+k] + mass * m_gravity(k) - m_massDamping * mass * m_nodeVel[3*i+k];
+        }
+        for (int j=m_nodeTetOffset[i]; j<m_nodeTetOffset[i+1]; j++)
+        {
+            const double* f = &m_tetForce[3 * m_nodeTet[j]];
+            for (int k=0; k<3; k++)
+            {
+                m_nodeForce[3*i+k] += f[k];
+            }
+        }
+
+        // row of stiffness matrix
+        for (int b=m_blockRowOffset[i]; b<m_blockRowOffset[i+1]; b++)
+        {
+            double* block = &m_blocks[9*b];
+            fill(block, block + 9, 0.0);
+            for (int j=m_blockTetOffset[b]; j<m_blockTetOffset[b+1]; j++)
+            {
+                // lower blocks are the transpose of upper blocks
+                int index = m_blockTet[j];
+                int row = (index >> 2) & 3;
+                int col = index & 3;
+                if (row <= col)
+                {
+                    const double* K = &m_tetRotatedStiffness[9 * index];
+                    for (int k=0; k<9; k++)
+                    {
+                        block[k] += K[k];
+                    }
+                }
+                else
+                {
+                    const double* K = &m_tetRotatedStiffness[9 * (index + 3 * (col - row))];
+                    for (int r=0; r<3; r++)
+                    {
+                        for (int c=0; c<3; c++)
+                        {
+                            block[3*c+r] += K[3*r+c];
+                        }
+                    }
+                }
+            }
+        }
+
+        // preconditioner
+        Eigen::Map<Eigen::Matrix3d> P(&m_preconditioner[9*i]);
+        if (isNodeStatic(i))
+        {
+            P.setIdentity();
+        }
+        else
+        {
+            Eigen::Matrix3d A = m_stiffnessScale * Eigen::Map<const Eigen::Matrix3d>(&m_blocks[9 * m_diagonalBlock[i]]);
+            A.diagonal().array() += m_massScale * mass;
+            P = A.inverse();
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the product of the stiffness matrix with a vector 
+    for a range of nodes.
+
+    \param  a_in     Input vector.
+    \param  a_out    Output vector.
+    \param  a_begin  First node.
+    \param  a_end    Last node (excluded).
+*/
+//===========================================================================
+void cGELFEMMesh::multiplyStiffness(const double* a_in, double* a_out, const int a_begin, const int a_end)
+{
+    for (int i=a_begin; i<a_end; i++)
+    {
+        double y0 = 0.0;
+        double y1 = 0.0;
+        double y2 = 0.0;
+        for (int b=m_blockRowOffset[i]; b<m_blockRowOffset[i+1]; b++)
+        {
+            const double* B = &m_blocks[9*b];
+            const double* x = &a_in[3 * m_blockColumn[b]];
+            y0 += B[0] * x[0] + B[3] * x[1] + B[6] * x[2];
+            y1 += B[1] * x[0] + B[4] * x[1] + B[7] * x[2];
+            y2 += B[2] * x[0] + B[5] * x[1] + B[8] * x[2];
+        }
+        a_out[3*i+0] = y0;
+        a_out[3*i+1] = y1;
+        a_out[3*i+2] = y2;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the product of the system matrix 
+    (1 + h alpha) M + (h beta + h^2) K with a vector for a range of nodes.
+    Rows and columns of fixed nodes are replaced by identity.
+
+    \param  a_in     Input vector.
+    \param  a_out    Output vector.
+    \param  a_begin  First node.
+    \param  a_end    Last node (excluded).
+*/
+//===========================================================================
+void cGELFEMMesh::multiplySystem(const double* a_in, double* a_out, const int a_begin, const int a_end)
+{
+    for (int i=a_begin; i<a_end; i++)
+    {
+        if (isNodeStatic(i))
+        {
+            a_out[3*i+0] = a_in[3*i+0];
+            a_out[3*i+1] = a_in[3*i+1];
+            a_out[3*i+2] = a_in[3*i+2];
+            continue;
+        }
+
+        double y0 = 0.0;
+        double y1 = 0.0;
+        double y2 = 0.0;
+        for (int b=m_blockRowOffset[i]; b<m_blockRowOffset[i+1]; b++)
+        {
+            int j = m_blockColumn[b];
+            if (isNodeStatic(j)) { continue; }
+
+            const double* B = &m_blocks[9*b];
+            const double* x = &a_in[3*j];
+            y0 += B[0] * x[0] + B[3] * x[1] + B[6] * x[2];
+            y1 += B[1] * x[0] + B[4] * x[1] + B[7] * x[2];
+            y2 += B[2] * x[0] + B[5] * x[1] + B[8] * x[2];
+        }
+
+        double m = m_massScale * m_nodeMass[i];
+        a_out[3*i+0] = m * a_in[3*i+0] + m_stiffnessScale * y0;
+        a_out[3*i+1] = m * a_in[3*i+1] + m_stiffnessScale * y1;
+        a_out[3*i+2] = m * a_in[3*i+2] + m_stiffnessScale * y2;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method runs a task on fixed chunks of __GEL_FEM_DOT_CHUNK_SIZE__ 
+    nodes, distributed on the threads of the thread pool. The task receives
+    the range of nodes of the chunk and stores up to three partial sums of 
+    dot products for this chunk, so that vector updates and the dot 
+    products that follow them are computed in a single pass. Since chunks 
+    do not depend on the number of threads, neither do the results.
+
+    \param  a_task  Task called with the first node, the last node (excluded)
+                    and the partial sums of a chunk.
+*/
+//===========================================================================
+void cGELFEMMesh::reduceNodes(const function<void(int, int, double*)>& a_task)
+{
+    int numNodes = getNumNodes();
+    int numChunks = (numNodes + GEL_FEM_DOT_CHUNK_SIZE - 1) / GEL_FEM_DOT_CHUNK_SIZE;
+
+    cGELParallelFor(m_threadPool, numChunks, [&](int a_begin, int a_end)
+    {
+        for (int c=a_begin; c<a_end; c++)
+        {
+            int first = c * GEL_FEM_DOT_CHUNK_SIZE;
+            int last = cMin(first + GEL_FEM_DOT_CHUNK_SIZE, numNodes);
+            a_task(first, last, &m_partialSums[3*c]);
+        }
+    }, 1);
+}
+
+
+//===========================================================================
+/*!
+    This method returns a dot product computed by \ref reduceNodes(), by 
+    summing its partial sums over all chunks of nodes in a fixed order.
+
+    \param  a_index  Index of the partial sum in each chunk (0 to 2).
+
+    \return Dot product.
+*/
+//===========================================================================
+double cGELFEMMesh::sumPartialSums(const int a_index) const
+{
+    int numChunks = (int)(m_partialSums.size() / 3);
+
+    double result = 0.0;
+    for (int c=0; c<numChunks; c++)
+    {
+        result += m_partialSums[3*c + a_index];
+    }
+    return (result);
+}
+
+
+//===========================================================================
+/*!
+    This method solves the system for the velocity change of all nodes 
+    with a conjugate gradient preconditioned by the inverse of the diagonal
+    blocks of the system matrix. The solution of the previous step is used
+    as initial guess.\n
+
+    Dot products are accumulated in the passes that update the vectors they
+    depend on (see \ref reduceNodes()), so that each iteration requires 
+    three passes over the nodes: the matrix product, the update of the 
+    solution and residual, and the update of the search direction.
+
+    \param  a_timeInterval  Time interval.
+*/
+//===========================================================================
+void cGELFEMMesh::solve(const double a_timeInterval)
+{
+    int numNodes = getNumNodes();
+
+    // applies preconditioner to residual
+    auto precondition = [this](int a_begin, int a_end)
+    {
+        for (int i=a_begin; i<a_end; i++)
+        {
+            Eigen::Map<Eigen::Vector3d> z(&m_preconditioned[3*i]);
+            z = Eigen::Map<const Eigen::Matrix3d>(&m_preconditioner[9*i]) * Eigen::Map<const Eigen::Vector3d>(&m_residual[3*i]);
+        }
+    };
+
+    // initial residual r = b - A x, search direction p = P r, and dot 
+    // products b.b, r.z and r.r. The velocity change of static nodes is 
+    // cleared first; this is safe within the pass since the rows of other
+    // nodes never read the columns of static nodes.
+    reduceNodes([this, &precondition](int a_begin, int a_end, double* a_sums)
+    {
+        for (int i=a_begin; i<a_end; i++)
+        {
+            if (isNodeStatic(i))
+            {
+                m_deltaVel[3*i+0] = 0.0;
+                m_deltaVel[3*i+1] = 0.0;
+                m_deltaVel[3*i+2] = 0.0;
+            }
+        }
+        multiplySystem(&m_deltaVel[0], &m_product[0], a_begin, a_end);
+        for (int i=3*a_begin; i<3*a_end; i++)
+        {
+            m_residual[i] = m_rhs[i] - m_product[i];
+        }
+        precondition(a_begin, a_end);
+
+        double bb = 0.0;
+        double rz = 0.0;
+        double rr = 0.0;
+        for (int i=3*a_begin; i<3*a_end; i++)
+        {
+            m_direction[i] = m_preconditioned[i];
+            bb += m_rhs[i] * m_rhs[i];
+            rz += m_residual[i] * m_preconditioned[i];
+            rr += m_residual[i] * m_residual[i];
+        }
+        a_sums[0] = bb;
+        a_sums[1] = rz;
+        a_sums[2] = rr;
+    });
+
+    double normRhs = sqrt(sumPartialSums(0));
+    if (normRhs == 0.0)
+    {
+        fill(m_deltaVel.begin(), m_deltaVel.end(), 0.0);
+        m_numIterations = 0;
+        m_error = 0.0;
+        return;
+    }
+
+    double rz = sumPartialSums(1);
+    double error = sqrt(sumPartialSums(2)) / normRhs;
+
+    int iteration = 0;
+    while ((iteration < m_maxIterations) && (error > m_tolerance))
+    {
+        // q = A p and p.q
+        reduceNodes([this](int a_begin, int a_end, double* a_sums)
+        {
+            multiplySystem(&m_direction[0], &m_product[0], a_begin, a_end);
+
+            double pq = 0.0;
+            for (int i=3*a_begin; i<3*a_end; i++)
+            {
+                pq += m_direction[i] * m_product[i];
+            }
+            a_sums[0] = pq;
+        });
+
+        double pq = sumPartialSums(0);
+        if (pq <= 0.0) { break; }
+        double alpha = rz / pq;
+
+        // x += alpha p, r -= alpha q, z = P r, r.z and r.r
+        reduceNodes([this, alpha, &precondition](int a_begin, int a_end, double* a_sums)
+        {
+            for (int i=3*a_begin; i<3*a_end; i++)
+            {
+                m_deltaVel[i] += alpha * m_direction[i];
+                m_residual[i] -= alpha * m_product[i];
+            }
+            precondition(a_begin, a_end);
+
+            double rz = 0.0;
+            double rr = 0.0;
+            for (int i=3*a_begin; i<3*a_end; i++)
+            {
+                rz += m_residual[i] * m_preconditioned[i];
+                rr += m_residual[i] * m_residual[i];
+            }
+            a_sums[0] = rz;
+            a_sums[1] = rr;
+        });
+
+        double rzNew = sumPartialSums(0);
+        error = sqrt(sumPartialSums(1)) / normRhs;
+        iteration++;
+
+        // the search direction is not needed once converged
+        if (error <= m_tolerance) { break; }
+
+        double beta = rzNew / rz;
+        rz = rzNew;
+
+        // p = z + beta p
+        cGELParallelFor(m_threadPool, numNodes, [this, beta](int a_begin, int a_end)
+        {
+            for (int i=3*a_begin; i<3*a_end; i++)
+            {
+                m_direction[i] = m_preconditioned[i] + beta * m_direction[i];
+            }
+        }, GEL_FEM_MIN_NODE_BLOCK_SIZE);
+    }
+
+    m_numIterations = iteration;
+    m_error = error;
+}
@@ -0,0 +1,436 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#ifndef CGELFEMMeshH
+#define CGELFEMMeshH
+//---------------------------------------------------------------------------
+#include "CGELMesh.h"
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+//---------------------------------------------------------------------------
+#include <vector>
+//---------------------------------------------------------------------------
+
+//===========================================================================
+/*!
+    \file       CGELFEMMesh.h
+
+    \brief
+    Implementation of a deformable mesh based on a tetrahedral finite 
+    element model.
+*/
+//===========================================================================
+
+//===========================================================================
+/*!
+    \class      cGELFEMMesh
+    \ingroup    GEL
+
+    \brief
+    This class implements a deformable mesh simulated by a co-rotational 
+    linear finite element model on tetrahedra.
+
+    \details
+    cGELFEMMesh replaces the skeleton and mass particle models of cGELMesh
+    by a volumetric model made of nodes and linear tetrahedral elements.
+    The stiffness matrix of each element is computed once in its rest 
+    configuration. At every step, the rotation of each element is extracted
+    from its deformation gradient by an iterative polar decomposition that
+    starts from the rotation of the previous step, and the stiffness matrix
+    of the element is rotated accordingly (co-rotational formulation), 
+    which keeps the model accurate for large rotations.
+
+    The model is integrated with a linearized backward Euler step:
+
+    (M + h D + h^2 K) dv = h (f - h K v)
+
+    with lumped masses and Rayleigh damping D = alpha M + beta K. The 
+    system is solved by a conjugate gradient with a block Jacobi 
+    preconditioner, which starts from the solution of the previous step. 
+    Element computations, matrix products and vector operations are 
+    distributed on the threads of the thread pool assigned to the mesh.
+
+    The surface meshes (skin) are embedded in the tetrahedra: each vertex
+    built by \ref buildVertices() is attached to a tetrahedron with 
+    barycentric coordinates by \ref connectVerticesToTetrahedra(). External 
+    forces applied on the mass particles of these vertices are transmitted
+    to the nodes of their tetrahedra.
+*/
+//===========================================================================
+class cGELFEMMesh : public cGELMesh
+{
+    //-----------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cGELFEMMesh.
+    cGELFEMMesh();
+
+    //! Destructor of cGELFEMMesh.
+    virtual ~cGELFEMMesh() {};
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - MODEL:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method creates a new node at a rest position passed as argument and returns its index.
+    int newNode(const chai3d::cVector3d& a_pos);
+
+    //! This method creates a new tetrahedron from four node indices and returns its index.
+    int newTetrahedron(const int a_node0, const int a_node1, const int a_node2, const int a_node3);
+
+    //! This method removes all nodes and tetrahedra.
+    void clearFEMModel();
+
+    //! This method precomputes the element stiffness matrices, masses and sparse structure of the model.
+    void buildFEMModel();
+
+    //! This method attaches each vertex of the skin to a tetrahedron using barycentric coordinates.
+    void connectVerticesToTetrahedra();
+
+    //! This method returns the number of nodes.
+    int getNumNodes() const { return ((int)(m_nodeMass.size())); }
+
+    //! This method returns the number of tetrahedra.
+    int getNumTetrahedra() const { return ((int)(m_tetrahedra.size() / 4)); }
+
+    //! This method returns the current position of a node.
+    chai3d::cVector3d getNodePos(const int a_node) const { return (chai3d::cVector3d(m_nodePos[3*a_node+0], m_nodePos[3*a_node+1], m_nodePos[3*a_node+2])); }
+
+    //! This method sets the current position of a node.
+    void setNodePos(const int a_node, const chai3d::cVector3d& a_pos);
+
+    //! This method returns the current velocity of a node.
+    chai3d::cVector3d getNodeVel(const int a_node) const { return (chai3d::cVector3d(m_nodeVel[3*a_node+0], m_nodeVel[3*a_node+1], m_nodeVel[3*a_node+2])); }
+
+    //! This method fixes or releases a node.
+    void setNodeFixed(const int a_node, const bool a_fixed) { m_nodeFixed[a_node] = a_fixed ? 1 : 0; }
+
+    //! This method returns __true__ if a node is fixed.
+    bool getNodeFixed(const int a_node) const { return (m_nodeFixed[a_node] != 0); }
+
+    //! This method sets the external force applied on a node.
+    void setNodeExternalForce(const int a_node, const chai3d::cVector3d& a_force);
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - MATERIAL AND SOLVER:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method sets the Young's modulus, Poisson's ratio and density of the material.
+    void setMaterial(const double a_youngModulus, const double a_poissonRatio, const double a_density);
+
+    //! This method sets the Rayleigh damping coefficients (mass and stiffness proportional).
+    void setDamping(const double a_massDamping, const double a_stiffnessDamping) { m_massDamping = a_massDamping; m_stiffnessDamping = a_stiffnessDamping; }
+
+    //! This method sets the gravity field applied on the model.
+    void setGravity(const chai3d::cVector3d& a_gravity) { m_gravity = a_gravity; }
+
+    //! This method returns the gravity field applied on the model.
+    chai3d::cVector3d getGravity() const { return (m_gravity); }
+
+    //! This method sets the relative tolerance of the conjugate gradient.
+    void setTolerance(const double a_tolerance) { m_tolerance = a_tolerance; }
+
+    //! This method returns the relative tolerance of the conjugate gradient.
+    double getTolerance() const { return (m_tolerance); }
+
+    //! This method sets the maximum number of iterations of the conjugate gradient.
+    void setMaxIterations(const int a_maxIterations) { m_maxIterations = a_maxIterations; }
+
+    //! This method returns the maximum number of iterations of the conjugate gradient.
+    int getMaxIterations() const { return (m_maxIterations); }
+
+    //! This method returns the number of iterations performed by the last solve.
+    int getNumIterations() const { return (m_numIterations); }
+
+    //! This method returns the relative residual error of the last solve.
+    double getError() const { return (m_error); }
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - SIMULATION:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method sets all computed forces to zero.
+    virtual void clearForces() {}
+
+    //! This method sets all external forces to zero.
+    virtual void clearExternalForces();
+
+    //! This method computes all internal forces.
+    virtual void computeForces() {}
+
+    //! This method updates the simulation over a time interval.
+    virtual void computeNextPose(double a_timeInterval);
+
+    //! This method updates the position of the model after computation.
+    virtual void applyNextPose();
+
+    //! This method updates the position of all vertices of the skin.
+    virtual void updateVertexPosition();
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! This method reads external forces applied on the mass particles of the skin.
+    void gatherSkinForces();
+
+    //! This method computes the rotation of a range of tetrahedra.
+    void computeRotations(const int a_begin, const int a_end);
+
+    //! This method computes the rotated stiffness matrices and elastic forces of a range of tetrahedra.
+    void computeElementForces(const int a_begin, const int a_end);
+
+    //! This method sums the forces and stiffness matrices of tetrahedra for a range of nodes.
+    void assembleNodes(const int a_begin, const int a_end);
+
+    //! This method computes the product of the stiffness matrix with a vector for a range of nodes.
+    void multiplyStiffness(const double* a_in, double* a_out, const int a_begin, const int a_end);
+
+    //! This method computes the product of the system matrix with a vector for a range of nodes.
+    void multiplySystem(const double* a_in, double* a_out, const int a_begin, const int a_end);
+
+    //! This method runs a task on fixed chunks of nodes, each chunk storing its partial sums of dot products.
+    void reduceNodes(const std::function<void(int, int, double*)>& a_task);
+
+    //! This method returns a dot product by summing its partial sums over all chunks of nodes.
+    double sumPartialSums(const int a_index) const;
+
+    //! This method returns __true__ if a node is held in place, either fixed by the user or without mass.
+    bool isNodeStatic(const int a_node) const { return ((m_nodeFixed[a_node] | m_nodeMassless[a_node]) != 0); }
+
+    //! This method solves the linear system with a preconditioned conjugate gradient.
+    void solve(const double a_timeInterval);
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - NODES:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Rest positions of nodes (x, y, z).
+    std::vector<double> m_nodeRestPos;
+
+    //! Positions of nodes (x, y, z).
+    std::vector<double> m_nodePos;
+
+    //! Next positions of nodes (x, y, z).
+    std::vector<double> m_nodeNextPos;
+
+    //! Velocities of nodes (x, y, z).
+    std::vector<double> m_nodeVel;
+
+    //! External forces applied on nodes (x, y, z).
+    std::vector<double> m_nodeExtForce;
+
+    //! Total forces applied on nodes (x, y, z).
+    std::vector<double> m_nodeForce;
+
+    //! Lumped masses of nodes.
+    std::vector<double> m_nodeMass;
+
+    //! Fixed nodes (1 if fixed, 0 otherwise).
+    std::vector<unsigned char> m_nodeFixed;
+
+    //! Nodes without mass, which do not belong to any tetrahedron and are held in place (1 if massless, 0 otherwise).
+    std::vector<unsigned char> m_nodeMassless;
+
+    //! Offset of the first tetrahedron attached to each node.
+    std::vector<int> m_nodeTetOffset;
+
+    //! Tetrahedra attached to each node (4 x tetrahedron index + local node index).
+    std::vector<int> m_nodeTet;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - TETRAHEDRA:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Node indices of tetrahedra (4 per tetrahedron).
+    std::vector<int> m_tetrahedra;
+
+    //! Inverse of the rest shape matrix of tetrahedra (3x3 column major).
+    std::vector<double> m_tetInvRestShape;
+
+    //! Stiffness matrices of tetrahedra in their rest configuration (16 3x3 column major blocks).
+    std::vector<double> m_tetStiffness;
+
+    //! Rotations of tetrahedra (quaternion w, x, y, z).
+    std::vector<double> m_tetRotation;
+
+    //! Rotated stiffness matrices of tetrahedra (upper 3x3 column major blocks of 16).
+    std::vector<double> m_tetRotatedStiffness;
+
+    //! Elastic forces applied by tetrahedra on their nodes (4 x 3).
+    std::vector<double> m_tetForce;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - STIFFNESS MATRIX:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Offset of the first block of each row of the stiffness matrix.
+    std::vector<int> m_blockRowOffset;
+
+    //! Block column of each block of the stiffness matrix.
+    std::vector<int> m_blockColumn;
+
+    //! Index of the diagonal block of each row.
+    std::vector<int> m_diagonalBlock;
+
+    //! Blocks of the stiffness matrix (3x3 column major).
+    std::vector<double> m_blocks;
+
+    //! Offset of the first tetrahedron block contributing to each block of the stiffness matrix.
+    std::vector<int> m_blockTetOffset;
+
+    //! Tetrahedron blocks contributing to each block (16 x tetrahedron index + local block index).
+    std::vector<int> m_blockTet;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - SOLVER:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Right hand side of the system.
+    std::vector<double> m_rhs;
+
+    //! Velocity change of all nodes (solution of the system).
+    std::vector<double> m_deltaVel;
+
+    //! Residual of the conjugate gradient.
+    std::vector<double> m_residual;
+
+    //! Preconditioned residual of the conjugate gradient.
+    std::vector<double> m_preconditioned;
+
+    //! Search direction of the conjugate gradient.
+    std::vector<double> m_direction;
+
+    //! Product of the system matrix with the search direction.
+    std::vector<double> m_product;
+
+    //! Inverse of the diagonal blocks of the system matrix (3x3 column major).
+    std::vector<double> m_preconditioner;
+
+    //! Partial sums of dot products (three per chunk of nodes).
+    std::vector<double> m_partialSums;
+
+    //! Scale of the mass matrix in the system matrix.
+    double m_massScale;
+
+    //! Scale of the stiffness matrix in the system matrix.
+    double m_stiffnessScale;
+
+    //! Relative tolerance of the conjugate gradient.
+    double m_tolerance;
+
+    //! Maximum number of iterations of the conjugate gradient.
+    int m_maxIterations;
+
+    //! Number of iterations performed by the last solve.
+    int m_numIterations;
+
+    //! Relative residual error of the last solve.
+    double m_error;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - MATERIAL AND SKIN:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Young's modulus of the material.
+    double m_youngModulus;
+
+    //! Poisson's ratio of the material.
+    double m_poissonRatio;
+
+    //! Density of the material.
+    double m_density;
+
+    //! Mass proportional damping coefficient.
+    double m_massDamping;
+
+    //! Stiffness proportional damping coefficient.
+    double m_stiffnessDamping;
+
+    //! Gravity field.
+    chai3d::cVector3d m_gravity;
+
+    //! If __true__, the precomputed data of the model is up to date.
+    bool m_femValid;
+
+    //! Tetrahedron attached to each vertex of the skin (-1 if none).
+    std::vector<int> m_skinTet;
+
+    //! Barycentric coordinates of each vertex of the skin (4 per vertex).
+    std::vector<double> m_skinWeight;
+};
+
+//---------------------------------------------------------------------------
+#endif
+//---------------------------------------------------------------------------
@@ -0,0 +1,406 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include "CGELImplicitSolver.h"
+//---------------------------------------------------------------------------
+#include <algorithm>
+//---------------------------------------------------------------------------
+using namespace chai3d;
+using namespace std;
+//---------------------------------------------------------------------------
+//! Minimum number of particles or springs processed by a thread.
+#define GEL_SOLVER_MIN_BLOCK_SIZE 1024
+//---------------------------------------------------------------------------
+
+
+//===========================================================================
+/*!
+    Constructor of cGELImplicitSolver.
+*/
+//===========================================================================
+cGELImplicitSolver::cGELImplicitSolver()
+{
+    m_tolerance = 1e-6;
+    m_maxIterations = 100;
+    m_numIterations = 0;
+    m_error = 0.0;
+}
+
+
+//===========================================================================
+/*!
+    This method builds the solver from a list of mass particles and a list
+    of linear springs, and allocates the sparse system matrix.
+
+    \param  a_particles  Mass particles.
+    \param  a_springs    Linear springs connecting mass particles.
+*/
+//===========================================================================
+void cGELImplicitSolver::build(const vector<cGELMassParticle*>& a_particles,
+                               const list<cGELLinearSpring*>& a_springs)
+{
+    cGELMassSpringSolver::build(a_particles, a_springs);
+
+    int numParticles = getNumParticles();
+    int numSprings = getNumSprings();
+
+    // build sparsity pattern: one 3x3 block per particle and two per spring
+    vector<Eigen::Triplet<double> > triplets;
+    triplets.reserve(9 * (numParticles + 2 * numSprings));
+    for (int i=0; i<numParticles; i++)
+    {
+        for (int r=0; r<3; r++)
+            for (int c=0; c<3; c++)
+                triplets.push_back(Eigen::Triplet<double>(3*i+r, 3*i+c, 0.0));
+    }
+    for (int i=0; i<numSprings; i++)
+    {
+        int n0 = m_springNode0[i];
+        int n1 = m_springNode1[i];
+        for (int r=0; r<3; r++)
+        {
+            for (int c=0; c<3; c++)
+            {
+                triplets.push_back(Eigen::Triplet<double>(3*n0+r, 3*n1+c, 0.0));
+                triplets.push_back(Eigen::Triplet<double>(3*n1+r, 3*n0+c, 0.0));
+            }
+        }
+    }
+
+    m_matrix.resize(3 * numParticles, 3 * numParticles);
+    m_matrix.setFromTriplets(triplets.begin(), triplets.end());
+    m_matrix.makeCompressed();
+
+    // locate blocks in matrix values
+    m_diagonalBlock.resize(3 * numParticles);
+    for (int i=0; i<numParticles; i++)
+    {
+        for (int k=0; k<3; k++)
+        {
+            m_diagonalBlock[3*i+k] = getBlockIndex(i, i, k);
+        }
+    }
+
+    m_springBlock01.resize(3 * numSprings);
+    m_springBlock10.resize(3 * numSprings);
+    for (int i=0; i<numSprings; i++)
+    {
+        for (int k=0; k<3; k++)
+        {
+            m_springBlock01[3*i+k] = getBlockIndex(m_springNode0[i], m_springNode1[i], k);
+            m_springBlock10[3*i+k] = getBlockIndex(m_springNode1[i], m_springNode0[i], k);
+        }
+    }
+
+    m_springJacobian.resize(6 * numSprings);
+    m_rhs.setZero(3 * numParticles);
+    m_deltaVel.setZero(3 * numParticles);
+    m_numIterations = 0;
+    m_error = 0.0;
+}
+
+
+//===========================================================================
+/*!
+    This method returns the position in the values of the system matrix of
+    the first element of column \p a_k of the 3x3 block located at block 
+    row \p a_row and block column \p a_col. The two other elements of the 
+    block column follow.
+
+    \param  a_row  Block row.
+    \param  a_col  Block column.
+    \param  a_k    Column within block.
+
+    \return Position in the matrix values.
+*/
+//===========================================================================
+int cGELImplicitSolver::getBlockIndex(const int a_row, const int a_col, const int a_k)
+{
+    const int* outer = m_matrix.outerIndexPtr();
+    const int* inner = m_matrix.innerIndexPtr();
+    int col = 3 * a_col + a_k;
+
+    const int* found = lower_bound(inner + outer[col], inner + outer[col + 1], 3 * a_row);
+    return ((int)(found - inner));
+}
+
+
+//===========================================================================
+/*!
+    This method computes the next position of all particles over a time 
+    interval passed as argument using a backward Euler step.
+
+    \param  a_timeInterval  Time interval.
+    \param  a_threadPool    Thread pool (if __NULL__, the calling thread 
+                            performs all computations).
+*/
+//===========================================================================
+void cGELImplicitSolver::computeNextPose(const double a_timeInterval, cGELThreadPool* a_threadPool)
+{
+    if (getNumParticles() == 0) { return; }
+
+    // read external forces
+    cGELParallelFor(a_threadPool, getNumParticles(), [this](int a_begin, int a_end)
+    {
+        gatherExternalState(a_begin, a_end);
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+    // compute spring forces and stiffness matrices
+    cGELParallelFor(a_threadPool, getNumSprings(), [this](int a_begin, int a_end)
+    {
+        computeSpringForces(a_begin, a_end);
+        computeSpringJacobians(a_begin, a_end);
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+    // sum forces and compute right hand side
+    cGELParallelFor(a_threadPool, getNumParticles(), [this, a_timeInterval](int a_begin, int a_end)
+    {
+        accumulateForces(a_begin, a_end);
+        computeRightHandSide(a_begin, a_end, a_timeInterval);
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+    // assemble and solve system, starting from previous solution
+    assembleMatrix(a_timeInterval);
+    m_cg.setTolerance(m_tolerance);
+    m_cg.setMaxIterations(m_maxIterations);
+    m_cg.compute(m_matrix);
+    m_deltaVel = m_cg.solveWithGuess(m_rhs, m_deltaVel);
+    m_numIterations = (int)(m_cg.iterations());
+    m_error = m_cg.error();
+
+    // update velocities and positions
+    cGELParallelFor(a_threadPool, getNumParticles(), [this, a_timeInterval](int a_begin, int a_end)
+    {
+        updateState(a_begin, a_end, a_timeInterval);
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+}
+
+
+//===========================================================================
+/*!
+    This method computes the stiffness matrix of a range of springs. The 
+    matrix is the negated derivative of the force applied on the first 
+    particle with respect to its position. The transverse term of 
+    compressed springs is clamped to zero.
+
+    \param  a_begin  First spring.
+    \param  a_end    Last spring (excluded).
+*/
+//===========================================================================
+void cGELImplicitSolver::computeSpringJacobians(const int a_begin, const int a_end)
+{
+    for (int i=a_begin; i<a_end; i++)
+    {
+        double* J = &m_springJacobian[6 * i];
+
+        int n0 = m_springNode0[i];
+        int n1 = m_springNode1[i];
+        double dx = m_posX[n1] - m_posX[n0];
+        double dy = m_posY[n1] - m_posY[n0];
+        double dz = m_posZ[n1] - m_posZ[n0];
+        double length = sqrt(dx*dx + dy*dy + dz*dz);
+
+        // if distance too small, no forces are applied
+        if (length <= 0.000001)
+        {
+            J[0] = J[1] = J[2] = J[3] = J[4] = J[5] = 0.0;
+            continue;
+        }
+
+        // K = k (u u^T + max(0, 1 - L0 / L) (I - u u^T))
+        double k = m_springStiffness[i];
+        double ux = dx / length;
+        double uy = dy / length;
+        double uz = dz / length;
+        double t = cMax(0.0, 1.0 - m_springLength0[i] / length);
+
+        J[0] = k * (t + (1.0 - t) * ux * ux);
+        J[1] = k * ((1.0 - t) * ux * uy);
+        J[2] = k * ((1.0 - t) * ux * uz);
+        J[3] = k * (t + (1.0 - t) * uy * uy);
+        J[4] = k * ((1.0 - t) * uy * uz);
+        J[5] = k * (t + (1.0 - t) * uz * uz);
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the right hand side h (f - h K v) of the system 
+    for a range of particles. Rows of fixed particles are set to zero.
+
+    \param  a_begin         First particle.
+    \param  a_end           Last particle (excluded).
+    \param  a_timeInterval  Time interval.
+*/
+//===========================================================================
+void cGELImplicitSolver::computeRightHandSide(const int a_begin, const int a_end, const double a_timeInterval)
+{
+    const double h = a_timeInterval;
+    double* rhs = m_rhs.data();
+
+    for (int i=a_begin; i<a_end; i++)
+    {
+        if (m_fixed[i])
+        {
+            rhs[3*i+0] = 0.0;
+            rhs[3*i+1] = 0.0;
+            rhs[3*i+2] = 0.0;
+            continue;
+        }
+
+        // compute K v for this particle
+        double kvx = 0.0;
+        double kvy = 0.0;
+        double kvz = 0.0;
+        for (int j=m_adjacencyOffset[i]; j<m_adjacencyOffset[i+1]; j++)
+        {
+            int spring = m_adjacency[j] >> 1;
+            int other = (m_adjacency[j] & 1) ? m_springNode0[spring] : m_springNode1[spring];
+            const double* J = &m_springJacobian[6 * spring];
+
+            double vx = m_velX[i] - m_velX[other];
+            double vy = m_velY[i] - m_velY[other];
+            double vz = m_velZ[i] - m_velZ[other];
+
+            kvx += J[0] * vx + J[1] * vy + J[2] * vz;
+            kvy += J[1] * vx + J[3] * vy + J[4] * vz;
+            kvz += J[2] * vx + J[4] * vy + J[5] * vz;
+        }
+
+        rhs[3*i+0] = h * (m_forceX[i] - h * kvx);
+        rhs[3*i+1] = h * (m_forceY[i] - h * kvy);
+        rhs[3*i+2] = h * (m_forceZ[i] - h * kvz);
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method assembles the system matrix M + h D + h^2 K. Rows and 
+    columns of fixed particles are replaced by identity.
+
+    \param  a_timeInterval  Time interval.
+*/
+//===========================================================================
+void cGELImplicitSolver::assembleMatrix(const double a_timeInterval)
+{
+    const double h = a_timeInterval;
+    const double h2 = h * h;
+    double* values = m_matrix.valuePtr();
+
+    // clear matrix
+    fill(values, values + m_matrix.nonZeros(), 0.0);
+
+    // mass and damping
+    int numParticles = getNumParticles();
+    for (int i=0; i<numParticles; i++)
+    {
+        double d = m_fixed[i] ? 1.0 : (1.0 / m_invMass[i] + h * m_damping[i]);
+        for (int k=0; k<3; k++)
+        {
+            values[m_diagonalBlock[3*i+k] + k] = d;
+        }
+    }
+
+    // stiffness
+    int numSprings = getNumSprings();
+    for (int i=0; i<numSprings; i++)
+    {
+        int n0 = m_springNode0[i];
+        int n1 = m_springNode1[i];
+        bool fixed0 = (m_fixed[n0] != 0);
+        bool fixed1 = (m_fixed[n1] != 0);
+
+        const double* J = &m_springJacobian[6 * i];
+        double K[3][3] = { { h2 * J[0], h2 * J[1], h2 * J[2] },
+                           { h2 * J[1], h2 * J[3], h2 * J[4] },
+                           { h2 * J[2], h2 * J[4], h2 * J[5] } };
+
+        for (int k=0; k<3; k++)
+        {
+            for (int r=0; r<3; r++)
+            {
+                if (!fixed0) { values[m_diagonalBlock[3*n0+k] + r] += K[r][k]; }
+                if (!fixed1) { values[m_diagonalBlock[3*n1+k] + r] += K[r][k]; }
+                if (!fixed0 && !fixed1)
+                {
+                    values[m_springBlock01[3*i+k] + r] -= K[r][k];
+                    values[m_springBlock10[3*i+k] + r] -= K[r][k];
+                }
+            }
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method applies the velocity changes computed by the solver to a 
+    range of particles and computes their next positions.
+
+    \param  a_begin         First particle.
+    \param  a_end           Last particle (excluded).
+    \param  a_timeInterval  Time interval.
+*/
+//===========================================================================
+void cGELImplicitSolver::updateState(const int a_begin, const int a_end, const double a_timeInterval)
+{
+    const double h = a_timeInterval;
+    const double* deltaVel = m_deltaVel.data();
+
+    for (int i=a_begin; i<a_end; i++)
+    {
+        // fixed particles keep their position and velocity
+        double mobile = m_fixed[i] ? 0.0 : 1.0;
+
+        m_velX[i] += mobile * deltaVel[3*i+0];
+        m_velY[i] += mobile * deltaVel[3*i+1];
+        m_velZ[i] += mobile * deltaVel[3*i+2];
+
+        m_nextPosX[i] = m_posX[i] + mobile * h * m_velX[i];
+        m_nextPosY[i] = m_posY[i] + mobile * h * m_velY[i];
+        m_nextPosZ[i] = m_posZ[i] + mobile * h * m_velZ[i];
+    }
+}
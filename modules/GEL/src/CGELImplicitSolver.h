@@ -0,0 +1,203 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#ifndef CGELImplicitSolverH
+#define CGELImplicitSolverH
+//---------------------------------------------------------------------------
+#include "CGELMassSpringSolver.h"
+//---------------------------------------------------------------------------
+#include "Eigen/Sparse"
+//---------------------------------------------------------------------------
+
+//===========================================================================
+/*!
+    \file       CGELImplicitSolver.h
+
+    \brief
+    Implementation of an implicit mass-spring solver.
+*/
+//===========================================================================
+
+//===========================================================================
+/*!
+    \class      cGELImplicitSolver
+    \ingroup    GEL
+
+    \brief
+    This class implements a backward Euler solver for mass particles and 
+    linear springs.
+
+    \details
+    cGELImplicitSolver integrates the same model as cGELMassSpringSolver 
+    using a linearized backward Euler step. At every step, the Jacobians 
+    of all spring forces are assembled into a sparse symmetric system:
+
+    (M + h D + h^2 K) dv = h (f - h K v)
+
+    where M is the mass matrix, D the damping matrix, K the stiffness 
+    matrix and f the forces applied on the particles. The system is solved
+    by a conjugate gradient which starts from the solution of the previous 
+    step. The stiffness of compressed springs is clamped to keep the system
+    positive definite.
+
+    Unlike the explicit solver, the implicit solver remains stable with 
+    stiff springs and large time steps, at the cost of numerical damping.
+    Fixed particles keep their position and velocity.
+*/
+//===========================================================================
+class cGELImplicitSolver : public cGELMassSpringSolver
+{
+    //-----------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cGELImplicitSolver.
+    cGELImplicitSolver();
+
+    //! Destructor of cGELImplicitSolver.
+    virtual ~cGELImplicitSolver() {};
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method builds the solver from a list of mass particles and linear springs.
+    virtual void build(const std::vector<cGELMassParticle*>& a_particles,
+                       const std::list<cGELLinearSpring*>& a_springs);
+
+    //! This method computes the next position of all particles over a time interval.
+    virtual void computeNextPose(const double a_timeInterval, cGELThreadPool* a_threadPool = NULL);
+
+    //! This method sets the relative tolerance of the conjugate gradient.
+    void setTolerance(const double a_tolerance) { m_tolerance = a_tolerance; }
+
+    //! This method returns the relative tolerance of the conjugate gradient.
+    double getTolerance() const { return (m_tolerance); }
+
+    //! This method sets the maximum number of iterations of the conjugate gradient.
+    void setMaxIterations(const int a_maxIterations) { m_maxIterations = a_maxIterations; }
+
+    //! This method returns the maximum number of iterations of the conjugate gradient.
+    int getMaxIterations() const { return (m_maxIterations); }
+
+    //! This method returns the number of iterations performed by the last solve.
+    int getNumIterations() const { return (m_numIterations); }
+
+    //! This method returns the relative residual error of the last solve.
+    double getError() const { return (m_error); }
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! This method computes the stiffness matrix of a range of springs.
+    void computeSpringJacobians(const int a_begin, const int a_end);
+
+    //! This method computes the right hand side of the system for a range of particles.
+    void computeRightHandSide(const int a_begin, const int a_end, const double a_timeInterval);
+
+    //! This method assembles the system matrix.
+    void assembleMatrix(const double a_timeInterval);
+
+    //! This method updates velocities and positions of a range of particles from the solution.
+    void updateState(const int a_begin, const int a_end, const double a_timeInterval);
+
+    //! This method returns the position of a 3x3 block column in the values of the system matrix.
+    int getBlockIndex(const int a_row, const int a_col, const int a_k);
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! System matrix.
+    Eigen::SparseMatrix<double> m_matrix;
+
+    //! Right hand side of the system.
+    Eigen::VectorXd m_rhs;
+
+    //! Velocity change of all particles (solution of the system).
+    Eigen::VectorXd m_deltaVel;
+
+    //! Conjugate gradient solver.
+    Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower|Eigen::Upper> m_cg;
+
+    //! Stiffness matrix of each spring (xx, xy, xz, yy, yz, zz).
+    std::vector<double> m_springJacobian;
+
+    //! Positions of the diagonal blocks of particles in the matrix values (one per block column).
+    std::vector<int> m_diagonalBlock;
+
+    //! Positions of the off-diagonal blocks (row node0, column node1) of springs in the matrix values.
+    std::vector<int> m_springBlock01;
+
+    //! Positions of the off-diagonal blocks (row node1, column node0) of springs in the matrix values.
+    std::vector<int> m_springBlock10;
+
+    //! Relative tolerance of the conjugate gradient.
+    double m_tolerance;
+
+    //! Maximum number of iterations of the conjugate gradient.
+    int m_maxIterations;
+
+    //! Number of iterations performed by the last solve.
+    int m_numIterations;
+
+    //! Relative residual error of the last solve.
+    double m_error;
+};
+
+//---------------------------------------------------------------------------
+#endif
+//---------------------------------------------------------------------------
@@ -0,0 +1,798 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include "CGELMassSpringSolver.h"
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <map>
+//---------------------------------------------------------------------------
+using namespace chai3d;
+using namespace std;
+//---------------------------------------------------------------------------
+//! Minimum number of particles or springs processed by a thread.
+#define GEL_SOLVER_MIN_BLOCK_SIZE 1024
+//---------------------------------------------------------------------------
+
+
+//===========================================================================
+/*!
+    Constructor of cGELMassSpringSolver.
+*/
+//===========================================================================
+cGELMassSpringSolver::cGELMassSpringSolver()
+{
+    m_rateDivider = 1;
+    m_activeRadius = 0.0;
+    m_rateStep = 0;
+    m_activeStepOnly = false;
+}
+
+
+//===========================================================================
+/*!
+    Destructor of cGELMassSpringSolver.
+*/
+//===========================================================================
+cGELMassSpringSolver::~cGELMassSpringSolver()
+{
+    clear();
+}
+
+
+//===========================================================================
+/*!
+    This method builds the solver from a list of mass particles and a list
+    of linear springs. Particles which are only referenced by springs are 
+    added after the particles of the list.
+
+    \param  a_particles  Mass particles.
+    \param  a_springs    Linear springs connecting mass particles.
+*/
+//===========================================================================
+void cGELMassSpringSolver::build(const vector<cGELMassParticle*>& a_particles,
+                                 const list<cGELLinearSpring*>& a_springs)
+{
+    clear();
+
+    // index particles
+    map<cGELMassParticle*, int> indices;
+    for (unsigned int i=0; i<a_particles.size(); i++)
+    {
+        if ((a_particles[i] != NULL) && (indices.find(a_particles[i]) == indices.end()))
+        {
+            indices[a_particles[i]] = (int)(m_particles.size());
+            m_particles.push_back(a_particles[i]);
+        }
+    }
+
+    // index springs and particles referenced by springs
+    list<cGELLinearSpring*>::const_iterator it;
+    for (it = a_springs.begin(); it != a_springs.end(); ++it)
+    {
+        cGELLinearSpring* spring = *it;
+        cGELMassParticle* nodes[2] = { spring->m_node0, spring->m_node1 };
+        int nodeIndices[2];
+
+        for (int j=0; j<2; j++)
+        {
+            map<cGELMassParticle*, int>::iterator found = indices.find(nodes[j]);
+            if (found == indices.end())
+            {
+                nodeIndices[j] = (int)(m_particles.size());
+                indices[nodes[j]] = nodeIndices[j];
+                m_particles.push_back(nodes[j]);
+            }
+            else
+            {
+                nodeIndices[j] = found->second;
+            }
+        }
+
+        m_springs.push_back(spring);
+        m_springNode0.push_back(nodeIndices[0]);
+        m_springNode1.push_back(nodeIndices[1]);
+    }
+
+    // allocate particle arrays
+    int numParticles = (int)(m_particles.size());
+    m_posX.resize(numParticles); m_posY.resize(numParticles); m_posZ.resize(numParticles);
+    m_nextPosX.resize(numParticles); m_nextPosY.resize(numParticles); m_nextPosZ.resize(numParticles);
+    m_velX.resize(numParticles); m_velY.resize(numParticles); m_velZ.resize(numParticles);
+    m_forceX.resize(numParticles); m_forceY.resize(numParticles); m_forceZ.resize(numParticles);
+    m_extForceX.resize(numParticles); m_extForceY.resize(numParticles); m_extForceZ.resize(numParticles);
+    m_gravityForceX.resize(numParticles); m_gravityForceY.resize(numParticles); m_gravityForceZ.resize(numParticles);
+    m_invMass.resize(numParticles);
+    m_damping.resize(numParticles);
+    m_fixed.resize(numParticles);
+    m_mobility.resize(numParticles);
+
+    // initialize state
+    for (int i=0; i<numParticles; i++)
+    {
+        cGELMassParticle* particle = m_particles[i];
+        m_posX[i] = particle->m_pos(0);
+        m_posY[i] = particle->m_pos(1);
+        m_posZ[i] = particle->m_pos(2);
+        m_nextPosX[i] = m_posX[i];
+        m_nextPosY[i] = m_posY[i];
+        m_nextPosZ[i] = m_posZ[i];
+        m_velX[i] = particle->m_vel(0);
+        m_velY[i] = particle->m_vel(1);
+        m_velZ[i] = particle->m_vel(2);
+    }
+
+    // allocate spring arrays
+    int numSprings = (int)(m_springs.size());
+    m_springStiffness.resize(numSprings);
+    m_springLength0.resize(numSprings);
+    m_springForceX.resize(numSprings);
+    m_springForceY.resize(numSprings);
+    m_springForceZ.resize(numSprings);
+
+    // build adjacency table (springs attached to each particle)
+    m_adjacencyOffset.assign(numParticles + 1, 0);
+    for (int i=0; i<numSprings; i++)
+    {
+        m_adjacencyOffset[m_springNode0[i] + 1]++;
+        m_adjacencyOffset[m_springNode1[i] + 1]++;
+    }
+    for (int i=0; i<numParticles; i++)
+    {
+        m_adjacencyOffset[i + 1] += m_adjacencyOffset[i];
+    }
+
+    m_adjacency.resize(2 * numSprings);
+    vector<int> count(m_adjacencyOffset.begin(), m_adjacencyOffset.end() - 1);
+    for (int i=0; i<numSprings; i++)
+    {
+        m_adjacency[count[m_springNode0[i]]++] = 2 * i;
+        m_adjacency[count[m_springNode1[i]]++] = 2 * i + 1;
+    }
+
+    // allocate multi-rate arrays
+    m_active.assign(numParticles, 0);
+    m_springActive.assign(numSprings, 0);
+    m_impulseX.assign(numParticles, 0.0);
+    m_impulseY.assign(numParticles, 0.0);
+    m_impulseZ.assign(numParticles, 0.0);
+    m_rateStep = 0;
+    m_activeStepOnly = false;
+
+    // read physical properties
+    cGELMassSpringSolver::updateParameters();
+}
+
+
+//===========================================================================
+/*!
+    This method clears all particles and springs.
+*/
+//===========================================================================
+void cGELMassSpringSolver::clear()
+{
+    m_particles.clear();
+    m_springs.clear();
+    m_springNode0.clear();
+    m_springNode1.clear();
+    m_adjacencyOffset.clear();
+    m_adjacency.clear();
+    m_activeParticles.clear();
+    m_slowParticles.clear();
+    m_boundaryParticles.clear();
+    m_activeSprings.clear();
+    m_slowSprings.clear();
+    m_rateStep = 0;
+    m_activeStepOnly = false;
+}
+
+
+//===========================================================================
+/*!
+    This method reads the mass, damping and gravity properties of all 
+    particles, and the stiffness and rest length of all springs from their 
+    respective objects. It must be called when these properties are 
+    modified after the solver has been built.
+*/
+//===========================================================================
+void cGELMassSpringSolver::updateParameters()
+{
+    int numParticles = (int)(m_particles.size());
+    for (int i=0; i<numParticles; i++)
+    {
+        cGELMassParticle* particle = m_particles[i];
+        m_invMass[i] = 1.0 / particle->m_mass;
+        m_damping[i] = particle->m_kDampingPos * particle->m_mass;
+        if (particle->m_useGravity)
+        {
+            m_gravityForceX[i] = particle->m_mass * particle->m_gravity(0);
+            m_gravityForceY[i] = particle->m_mass * particle->m_gravity(1);
+            m_gravityForceZ[i] = particle->m_mass * particle->m_gravity(2);
+        }
+        else
+        {
+            m_gravityForceX[i] = 0.0;
+            m_gravityForceY[i] = 0.0;
+            m_gravityForceZ[i] = 0.0;
+        }
+    }
+
+    int numSprings = (int)(m_springs.size());
+    for (int i=0; i<numSprings; i++)
+    {
+        m_springStiffness[i] = m_springs[i]->m_kSpringElongation;
+        m_springLength0[i] = m_springs[i]->m_length0;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the next position of all particles over a time 
+    interval passed as argument.
+
+    \param  a_timeInterval  Time interval.
+    \param  a_threadPool    Thread pool (if __NULL__, the calling thread 
+                            performs all computations).
+*/
+//===========================================================================
+void cGELMassSpringSolver::computeNextPose(const double a_timeInterval, cGELThreadPool* a_threadPool)
+{
+    // multi-rate stepping
+    if (m_rateDivider > 1)
+    {
+        computeNextPoseMultiRate(a_timeInterval, a_threadPool);
+        return;
+    }
+    m_activeStepOnly = false;
+
+    // read external forces
+    cGELParallelFor(a_threadPool, getNumParticles(), [this](int a_begin, int a_end)
+    {
+        gatherExternalState(a_begin, a_end);
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+    // compute spring forces
+    cGELParallelFor(a_threadPool, getNumSprings(), [this](int a_begin, int a_end)
+    {
+        computeSpringForces(a_begin, a_end);
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+    // sum forces and integrate
+    cGELParallelFor(a_threadPool, getNumParticles(), [this, a_timeInterval](int a_begin, int a_end)
+    {
+        accumulateForces(a_begin, a_end);
+        integrate(a_begin, a_end, a_timeInterval);
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+}
+
+
+//===========================================================================
+/*!
+    This method applies the next position of all particles, and writes the
+    position and velocity of every particle to its object.
+
+    \param  a_threadPool    Thread pool (if __NULL__, the calling thread 
+                            performs all computations).
+*/
+//===========================================================================
+void cGELMassSpringSolver::applyNextPose(cGELThreadPool* a_threadPool)
+{
+    // only particles of the active region have moved
+    if (m_activeStepOnly)
+    {
+        cGELParallelFor(a_threadPool, getNumActiveParticles(), [this](int a_begin, int a_end)
+        {
+            for (int j=a_begin; j<a_end; j++)
+            {
+                int i = m_activeParticles[j];
+                m_posX[i] = m_nextPosX[i];
+                m_posY[i] = m_nextPosY[i];
+                m_posZ[i] = m_nextPosZ[i];
+
+                cGELMassParticle* particle = m_particles[i];
+                particle->m_pos.set(m_posX[i], m_posY[i], m_posZ[i]);
+                particle->m_nextPos.set(m_posX[i], m_posY[i], m_posZ[i]);
+                particle->m_vel.set(m_velX[i], m_velY[i], m_velZ[i]);
+            }
+        }, GEL_SOLVER_MIN_BLOCK_SIZE);
+        return;
+    }
+
+    // next positions become current positions
+    m_posX.swap(m_nextPosX);
+    m_posY.swap(m_nextPosY);
+    m_posZ.swap(m_nextPosZ);
+
+    // write state to particle objects
+    cGELParallelFor(a_threadPool, getNumParticles(), [this](int a_begin, int a_end)
+    {
+        for (int i=a_begin; i<a_end; i++)
+        {
+            cGELMassParticle* particle = m_particles[i];
+            particle->m_pos.set(m_posX[i], m_posY[i], m_posZ[i]);
+            particle->m_nextPos.set(m_posX[i], m_posY[i], m_posZ[i]);
+            particle->m_vel.set(m_velX[i], m_velY[i], m_velZ[i]);
+        }
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+}
+
+
+//===========================================================================
+/*!
+    This method reads the external forces and fixed status of a range of 
+    particles from their objects. The position of fixed particles is also
+    read, so that the application can move them.
+
+    \param  a_begin  First particle.
+    \param  a_end    Last particle (excluded).
+*/
+//===========================================================================
+void cGELMassSpringSolver::gatherExternalState(const int a_begin, const int a_end)
+{
+    for (int i=a_begin; i<a_end; i++)
+    {
+        cGELMassParticle* particle = m_particles[i];
+        const cVector3d& force = particle->getExternalForce();
+        m_extForceX[i] = force(0);
+        m_extForceY[i] = force(1);
+        m_extForceZ[i] = force(2);
+
+        m_fixed[i] = particle->m_fixed ? 1 : 0;
+        m_mobility[i] = particle->m_fixed ? 0.0 : 1.0;
+        if (particle->m_fixed)
+        {
+            m_posX[i] = particle->m_pos(0);
+            m_posY[i] = particle->m_pos(1);
+            m_posZ[i] = particle->m_pos(2);
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the force applied by a range of springs on their 
+    first particle. The opposite force applies on their second particle.
+
+    \param  a_begin  First spring.
+    \param  a_end    Last spring (excluded).
+*/
+//===========================================================================
+void cGELMassSpringSolver::computeSpringForces(const int a_begin, const int a_end)
+{
+    const int* node0 = m_springNode0.data();
+    const int* node1 = m_springNode1.data();
+    const double* posX = m_posX.data();
+    const double* posY = m_posY.data();
+    const double* posZ = m_posZ.data();
+    const double* stiffness = m_springStiffness.data();
+    const double* length0 = m_springLength0.data();
+    double* forceX = m_springForceX.data();
+    double* forceY = m_springForceY.data();
+    double* forceZ = m_springForceZ.data();
+
+    for (int i=a_begin; i<a_end; i++)
+    {
+        // compute current spring vector
+        double dx = posX[node1[i]] - posX[node0[i]];
+        double dy = posY[node1[i]] - posY[node0[i]];
+        double dz = posZ[node1[i]] - posZ[node0[i]];
+        double length = sqrt(dx*dx + dy*dy + dz*dz);
+
+        // if distance too small, no forces are applied
+        double f = (length > 0.000001) ? (stiffness[i] * (length - length0[i]) / length) : 0.0;
+
+        forceX[i] = f * dx;
+        forceY[i] = f * dy;
+        forceZ[i] = f * dz;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method sums the gravity, damping, external and spring forces 
+    applied on a range of particles.
+
+    \param  a_begin  First particle.
+    \param  a_end    Last particle (excluded).
+*/
+//===========================================================================
+void cGELMassSpringSolver::accumulateForces(const int a_begin, const int a_end)
+{
+    const double* damping = m_damping.data();
+    const double* gravityForce[3] = { m_gravityForceX.data(), m_gravityForceY.data(), m_gravityForceZ.data() };
+    const double* extForce[3] = { m_extForceX.data(), m_extForceY.data(), m_extForceZ.data() };
+    const double* vel[3] = { m_velX.data(), m_velY.data(), m_velZ.data() };
+    double* force[3] = { m_forceX.data(), m_forceY.data(), m_forceZ.data() };
+
+    // gravity, damping and external forces (one loop per coordinate so 
+    // that the compiler can vectorize it)
+    for (int k=0; k<3; k++)
+    {
+        const double* g = gravityForce[k];
+        const double* e = extForce[k];
+        const double* v = vel[k];
+        double* f = force[k];
+
+        for (int i=a_begin; i<a_end; i++)
+        {
+            f[i] = g[i] + e[i] - damping[i] * v[i];
+        }
+    }
+
+    // spring forces
+    const int* offset = m_adjacencyOffset.data();
+    const int* adjacency = m_adjacency.data();
+    const double* springForceX = m_springForceX.data();
+    const double* springForceY = m_springForceY.data();
+    const double* springForceZ = m_springForceZ.data();
+
+    for (int i=a_begin; i<a_end; i++)
+    {
+        double fx = 0.0;
+        double fy = 0.0;
+        double fz = 0.0;
+        for (int j=offset[i]; j<offset[i+1]; j++)
+        {
+            int spring = adjacency[j] >> 1;
+            double sign = (adjacency[j] & 1) ? -1.0 : 1.0;
+            fx += sign * springForceX[spring];
+            fy += sign * springForceY[spring];
+            fz += sign * springForceZ[spring];
+        }
+        force[0][i] += fx;
+        force[1][i] += fy;
+        force[2][i] += fz;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method integrates a range of particles using the same Euler scheme
+    as cGELMassParticle.
+
+    \param  a_begin         First particle.
+    \param  a_end           Last particle (excluded).
+    \param  a_timeInterval  Time interval.
+*/
+//===========================================================================
+void cGELMassSpringSolver::integrate(const int a_begin, const int a_end, const double a_timeInterval)
+{
+    const double dt = a_timeInterval;
+    const double* mobility = m_mobility.data();
+    const double* invMass = m_invMass.data();
+    const double* force[3] = { m_forceX.data(), m_forceY.data(), m_forceZ.data() };
+    const double* pos[3] = { m_posX.data(), m_posY.data(), m_posZ.data() };
+    double* vel[3] = { m_velX.data(), m_velY.data(), m_velZ.data() };
+    double* nextPos[3] = { m_nextPosX.data(), m_nextPosY.data(), m_nextPosZ.data() };
+
+    // one loop per coordinate so that the compiler can vectorize it; fixed 
+    // particles have a zero mobility and keep their position and velocity
+    for (int k=0; k<3; k++)
+    {
+        const double* f = force[k];
+        const double* p = pos[k];
+        double* v = vel[k];
+        double* n = nextPos[k];
+
+        for (int i=a_begin; i<a_end; i++)
+        {
+            v[i] += mobility[i] * dt * invMass[i] * f[i];
+            n[i] = p[i] + mobility[i] * dt * v[i];
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method enables multi-rate stepping. Particles located within 
+    a distance __a_activeRadius__ of a particle subject to an external force
+    are integrated at every step. All other particles are integrated once 
+    every __a_rateDivider__ steps. The active region is re-evaluated at the
+    beginning of each cycle of __a_rateDivider__ steps, so the radius should
+    cover the motion of contacts during a cycle. A divider of 1 disables 
+    multi-rate stepping. Multi-rate stepping is only used by the explicit
+    solver implemented by this class.
+
+    \param  a_rateDivider   Number of steps between two integrations of 
+                            particles outside the active region.
+    \param  a_activeRadius  Radius of the active region.
+*/
+//===========================================================================
+void cGELMassSpringSolver::setMultiRate(const int a_rateDivider, const double a_activeRadius)
+{
+    m_rateDivider = cMax(a_rateDivider, 1);
+    m_activeRadius = cMax(a_activeRadius, 0.0);
+
+    // restart cycle
+    m_rateStep = 0;
+    m_activeStepOnly = false;
+    std::fill(m_impulseX.begin(), m_impulseX.end(), 0.0);
+    std::fill(m_impulseY.begin(), m_impulseY.end(), 0.0);
+    std::fill(m_impulseZ.begin(), m_impulseZ.end(), 0.0);
+}
+
+
+//===========================================================================
+/*!
+    This method computes the next position of particles using multi-rate 
+    stepping. Particles of the active region are integrated over the time 
+    interval passed as argument. Forces of active springs on boundary 
+    particles are accumulated as impulses. At the last step of a cycle, 
+    particles outside the active region are integrated over the whole 
+    cycle using their accumulated impulses.
+
+    \param  a_timeInterval  Time interval.
+    \param  a_threadPool    Thread pool (if __NULL__, the calling thread 
+                            performs all computations).
+*/
+//===========================================================================
+void cGELMassSpringSolver::computeNextPoseMultiRate(const double a_timeInterval, cGELThreadPool* a_threadPool)
+{
+    // at the beginning of a cycle, read external forces of all particles 
+    // and update the active region
+    if (m_rateStep == 0)
+    {
+        cGELParallelFor(a_threadPool, getNumParticles(), [this](int a_begin, int a_end)
+        {
+            gatherExternalState(a_begin, a_end);
+        }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+        updateActiveRegion();
+    }
+    else
+    {
+        cGELParallelFor(a_threadPool, getNumActiveParticles(), [this](int a_begin, int a_end)
+        {
+            for (int j=a_begin; j<a_end; j++)
+            {
+                gatherExternalState(m_activeParticles[j], m_activeParticles[j] + 1);
+            }
+        }, GEL_SOLVER_MIN_BLOCK_SIZE);
+    }
+
+    // compute forces of active springs
+    cGELParallelFor(a_threadPool, (int)(m_activeSprings.size()), [this](int a_begin, int a_end)
+    {
+        for (int j=a_begin; j<a_end; j++)
+        {
+            computeSpringForces(m_activeSprings[j], m_activeSprings[j] + 1);
+        }
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+    // integrate particles of the active region (all their springs are active)
+    cGELParallelFor(a_threadPool, getNumActiveParticles(), [this, a_timeInterval](int a_begin, int a_end)
+    {
+        for (int j=a_begin; j<a_end; j++)
+        {
+            accumulateForces(m_activeParticles[j], m_activeParticles[j] + 1);
+            integrate(m_activeParticles[j], m_activeParticles[j] + 1, a_timeInterval);
+        }
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+    // accumulate impulses of active springs on boundary particles
+    cGELParallelFor(a_threadPool, (int)(m_boundaryParticles.size()), [this, a_timeInterval](int a_begin, int a_end)
+    {
+        for (int j=a_begin; j<a_end; j++)
+        {
+            int i = m_boundaryParticles[j];
+            double fx = 0.0;
+            double fy = 0.0;
+            double fz = 0.0;
+            for (int k=m_adjacencyOffset[i]; k<m_adjacencyOffset[i+1]; k++)
+            {
+                int spring = m_adjacency[k] >> 1;
+                if (m_springActive[spring])
+                {
+                    double sign = (m_adjacency[k] & 1) ? -1.0 : 1.0;
+                    fx += sign * m_springForceX[spring];
+                    fy += sign * m_springForceY[spring];
+                    fz += sign * m_springForceZ[spring];
+                }
+            }
+            m_impulseX[i] += a_timeInterval * fx;
+            m_impulseY[i] += a_timeInterval * fy;
+            m_impulseZ[i] += a_timeInterval * fz;
+        }
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+    // advance cycle
+    m_rateStep++;
+    if (m_rateStep < m_rateDivider)
+    {
+        m_activeStepOnly = true;
+        return;
+    }
+    m_rateStep = 0;
+    m_activeStepOnly = false;
+
+    // last step of cycle: integrate particles outside the active region
+    cGELParallelFor(a_threadPool, (int)(m_slowParticles.size()), [this](int a_begin, int a_end)
+    {
+        for (int j=a_begin; j<a_end; j++)
+        {
+            gatherExternalState(m_slowParticles[j], m_slowParticles[j] + 1);
+        }
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+    cGELParallelFor(a_threadPool, (int)(m_slowSprings.size()), [this](int a_begin, int a_end)
+    {
+        for (int j=a_begin; j<a_end; j++)
+        {
+            computeSpringForces(m_slowSprings[j], m_slowSprings[j] + 1);
+        }
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+    const double cycleInterval = m_rateDivider * a_timeInterval;
+    cGELParallelFor(a_threadPool, (int)(m_slowParticles.size()), [this, cycleInterval](int a_begin, int a_end)
+    {
+        for (int j=a_begin; j<a_end; j++)
+        {
+            int i = m_slowParticles[j];
+
+            // gravity, damping, external and slow spring forces
+            double fx = m_gravityForceX[i] + m_extForceX[i] - m_damping[i] * m_velX[i];
+            double fy = m_gravityForceY[i] + m_extForceY[i] - m_damping[i] * m_velY[i];
+            double fz = m_gravityForceZ[i] + m_extForceZ[i] - m_damping[i] * m_velZ[i];
+            for (int k=m_adjacencyOffset[i]; k<m_adjacencyOffset[i+1]; k++)
+            {
+                int spring = m_adjacency[k] >> 1;
+                if (!m_springActive[spring])
+                {
+                    double sign = (m_adjacency[k] & 1) ? -1.0 : 1.0;
+                    fx += sign * m_springForceX[spring];
+                    fy += sign * m_springForceY[spring];
+                    fz += sign * m_springForceZ[spring];
+                }
+            }
+
+            // integrate over the whole cycle, including impulses of active springs
+            double scale = m_mobility[i] * m_invMass[i];
+            m_velX[i] += scale * (cycleInterval * fx + m_impulseX[i]);
+            m_velY[i] += scale * (cycleInterval * fy + m_impulseY[i]);
+            m_velZ[i] += scale * (cycleInterval * fz + m_impulseZ[i]);
+            m_nextPosX[i] = m_posX[i] + m_mobility[i] * cycleInterval * m_velX[i];
+            m_nextPosY[i] = m_posY[i] + m_mobility[i] * cycleInterval * m_velY[i];
+            m_nextPosZ[i] = m_posZ[i] + m_mobility[i] * cycleInterval * m_velZ[i];
+            m_impulseX[i] = 0.0;
+            m_impulseY[i] = 0.0;
+            m_impulseZ[i] = 0.0;
+        }
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+}
+
+
+//===========================================================================
+/*!
+    This method determines the active region, which contains all particles
+    located within the active radius of a particle subject to an external 
+    force, and sorts particles and springs according to it.
+*/
+//===========================================================================
+void cGELMassSpringSolver::updateActiveRegion()
+{
+    int numParticles = getNumParticles();
+    int numSprings = getNumSprings();
+
+    // collect particles subject to external forces, sorted along x
+    vector<int> contacts;
+    for (int i=0; i<numParticles; i++)
+    {
+        if ((m_extForceX[i] != 0.0) || (m_extForceY[i] != 0.0) || (m_extForceZ[i] != 0.0))
+        {
+            contacts.push_back(i);
+        }
+    }
+    std::sort(contacts.begin(), contacts.end(), [this](int a, int b) { return (m_posX[a] < m_posX[b]); });
+
+    vector<double> contactX(contacts.size());
+    for (unsigned int j=0; j<contacts.size(); j++)
+    {
+        contactX[j] = m_posX[contacts[j]];
+    }
+
+    // mark particles located near a contact
+    double radius2 = m_activeRadius * m_activeRadius;
+    m_activeParticles.clear();
+    m_slowParticles.clear();
+    for (int i=0; i<numParticles; i++)
+    {
+        m_active[i] = 0;
+        vector<double>::iterator first = std::lower_bound(contactX.begin(), contactX.end(), m_posX[i] - m_activeRadius);
+        for (int j=(int)(first - contactX.begin()); (j<(int)(contacts.size())) && (contactX[j] <= m_posX[i] + m_activeRadius); j++)
+        {
+            double dx = m_posX[i] - m_posX[contacts[j]];
+            double dy = m_posY[i] - m_posY[contacts[j]];
+            double dz = m_posZ[i] - m_posZ[contacts[j]];
+            if (dx*dx + dy*dy + dz*dz <= radius2)
+            {
+                m_active[i] = 1;
+                break;
+            }
+        }
+
+        if (m_active[i])
+        {
+            m_activeParticles.push_back(i);
+        }
+        else
+        {
+            m_slowParticles.push_back(i);
+        }
+    }
+
+    // sort springs
+    m_activeSprings.clear();
+    m_slowSprings.clear();
+    for (int i=0; i<numSprings; i++)
+    {
+        m_springActive[i] = (m_active[m_springNode0[i]] || m_active[m_springNode1[i]]) ? 1 : 0;
+        if (m_springActive[i])
+        {
+            m_activeSprings.push_back(i);
+        }
+        else
+        {
+            m_slowSprings.push_back(i);
+        }
+    }
+
+    // find particles outside the active region attached to an active spring
+    m_boundaryParticles.clear();
+    for (unsigned int j=0; j<m_slowParticles.size(); j++)
+    {
+        int i = m_slowParticles[j];
+        for (int k=m_adjacencyOffset[i]; k<m_adjacencyOffset[i+1]; k++)
+        {
+            if (m_springActive[m_adjacency[k] >> 1])
+            {
+                m_boundaryParticles.push_back(i);
+                break;
+            }
+        }
+    }
+}
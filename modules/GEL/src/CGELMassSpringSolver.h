@@ -0,0 +1,316 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#ifndef CGELMassSpringSolverH
+#define CGELMassSpringSolverH
+//---------------------------------------------------------------------------
+#include "CGELMassParticle.h"
+#include "CGELLinearSpring.h"
+#include "CGELThreadPool.h"
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+//---------------------------------------------------------------------------
+#include <list>
+#include <vector>
+//---------------------------------------------------------------------------
+
+//===========================================================================
+/*!
+    \file       CGELMassSpringSolver.h
+
+    \brief
+    Implementation of a mass-spring solver using contiguous arrays.
+*/
+//===========================================================================
+
+//===========================================================================
+/*!
+    \class      cGELMassSpringSolver
+    \ingroup    GEL
+
+    \brief
+    This class implements a multithreaded solver for mass particles and 
+    linear springs.
+
+    \details
+    cGELMassSpringSolver simulates the same model as the mass particles
+    (cGELMassParticle) and linear springs (cGELLinearSpring) of a deformable
+    mesh, but stores the state of all particles in contiguous arrays, one 
+    per coordinate (structure of arrays). Springs are stored as pairs of 
+    particle indices.
+
+    Each step runs in three passes that are split between the threads of a
+    thread pool. The first pass reads the external forces set by the 
+    application on the particle objects. The second pass computes the force
+    of every spring. The third pass sums, for every particle, the forces of
+    the springs attached to it using a precomputed adjacency table, then 
+    integrates the particle. No two threads ever write to the same particle,
+    so no locks or atomic operations are needed, and results do not depend
+    on the number of threads. The integration loops run over contiguous 
+    arrays and are vectorized by the compiler.
+
+    Particle and spring objects remain the interface of the model: external
+    forces, fixed flags and positions of fixed particles are read from them
+    at every step, and computed positions and velocities are written back 
+    to them. Other properties (mass, damping, gravity, stiffness and rest 
+    length) are read when the solver is built or when 
+    \ref updateParameters() is called.
+
+    Optionally (see \ref setMultiRate()), only particles located near 
+    active contacts are integrated at every step. Particles within a given 
+    radius of a particle subject to an external force form the active 
+    region. The other particles are integrated once every N steps with a
+    time interval N times larger. Forces of springs crossing the boundary 
+    of the active region are accumulated over these N steps and applied to
+    the slow particles as an impulse, so that momentum is exchanged 
+    consistently between both regions. The active region is re-evaluated 
+    every N steps. The large time interval must remain within the 
+    stability limit of the explicit integrator.
+*/
+//===========================================================================
+class cGELMassSpringSolver
+{
+    //-----------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cGELMassSpringSolver.
+    cGELMassSpringSolver();
+
+    //! Destructor of cGELMassSpringSolver.
+    virtual ~cGELMassSpringSolver();
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method builds the solver from a list of mass particles and linear springs.
+    virtual void build(const std::vector<cGELMassParticle*>& a_particles,
+                       const std::list<cGELLinearSpring*>& a_springs);
+
+    //! This method clears all particles and springs.
+    virtual void clear();
+
+    //! This method reads the mass, damping, gravity and spring properties from the particle and spring objects.
+    virtual void updateParameters();
+
+    //! This method computes the next position of all particles over a time interval.
+    virtual void computeNextPose(const double a_timeInterval, cGELThreadPool* a_threadPool = NULL);
+
+    //! This method applies the next position of all particles and writes it to the particle objects.
+    virtual void applyNextPose(cGELThreadPool* a_threadPool = NULL);
+
+    //! This method returns the number of particles.
+    int getNumParticles() const { return ((int)(m_particles.size())); }
+
+    //! This method returns the number of springs.
+    int getNumSprings() const { return ((int)(m_springs.size())); }
+
+    //! This method enables multi-rate stepping: particles outside the active region are integrated once every __a_rateDivider__ steps.
+    void setMultiRate(const int a_rateDivider, const double a_activeRadius);
+
+    //! This method returns the number of steps between two integrations of particles outside the active region.
+    int getRateDivider() const { return (m_rateDivider); }
+
+    //! This method returns the radius of the active region around particles subject to external forces.
+    double getActiveRadius() const { return (m_activeRadius); }
+
+    //! This method returns the number of particles in the active region.
+    int getNumActiveParticles() const { return ((int)(m_activeParticles.size())); }
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! This method reads external forces and fixed particles from the particle objects.
+    void gatherExternalState(const int a_begin, const int a_end);
+
+    //! This method computes the force of a range of springs.
+    void computeSpringForces(const int a_begin, const int a_end);
+
+    //! This method sums the forces applied on a range of particles.
+    void accumulateForces(const int a_begin, const int a_end);
+
+    //! This method integrates a range of particles.
+    void integrate(const int a_begin, const int a_end, const double a_timeInterval);
+
+    //! This method computes the next position of particles using multi-rate stepping.
+    void computeNextPoseMultiRate(const double a_timeInterval, cGELThreadPool* a_threadPool);
+
+    //! This method determines the particles and springs of the active region.
+    void updateActiveRegion();
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - MODEL:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Particle objects.
+    std::vector<cGELMassParticle*> m_particles;
+
+    //! Spring objects.
+    std::vector<cGELLinearSpring*> m_springs;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - PARTICLES:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Positions of particles.
+    std::vector<double> m_posX, m_posY, m_posZ;
+
+    //! Next positions of particles.
+    std::vector<double> m_nextPosX, m_nextPosY, m_nextPosZ;
+
+    //! Velocities of particles.
+    std::vector<double> m_velX, m_velY, m_velZ;
+
+    //! Total forces applied on particles.
+    std::vector<double> m_forceX, m_forceY, m_forceZ;
+
+    //! External forces applied on particles.
+    std::vector<double> m_extForceX, m_extForceY, m_extForceZ;
+
+    //! Gravity forces applied on particles.
+    std::vector<double> m_gravityForceX, m_gravityForceY, m_gravityForceZ;
+
+    //! Inverse masses of particles.
+    std::vector<double> m_invMass;
+
+    //! Linear damping coefficients of particles (damping constant times mass).
+    std::vector<double> m_damping;
+
+    //! Fixed particles (1 if fixed, 0 otherwise).
+    std::vector<unsigned char> m_fixed;
+
+    //! Mobility of particles (0.0 if fixed, 1.0 otherwise).
+    std::vector<double> m_mobility;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - SPRINGS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Index of first particle of springs.
+    std::vector<int> m_springNode0;
+
+    //! Index of second particle of springs.
+    std::vector<int> m_springNode1;
+
+    //! Stiffness of springs.
+    std::vector<double> m_springStiffness;
+
+    //! Rest length of springs.
+    std::vector<double> m_springLength0;
+
+    //! Forces applied by springs on their first particle.
+    std::vector<double> m_springForceX, m_springForceY, m_springForceZ;
+
+    //! Offset of the first spring attached to each particle in the adjacency table.
+    std::vector<int> m_adjacencyOffset;
+
+    //! Springs attached to each particle (2 x spring index, plus 1 if the particle is the second node).
+    std::vector<int> m_adjacency;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - MULTI-RATE:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Number of steps between two integrations of particles outside the active region (1 if disabled).
+    int m_rateDivider;
+
+    //! Radius of the active region around particles subject to external forces.
+    double m_activeRadius;
+
+    //! Current step within the multi-rate cycle.
+    int m_rateStep;
+
+    //! If __true__, only particles of the active region were integrated at the last step.
+    bool m_activeStepOnly;
+
+    //! Particles of the active region (1 if active, 0 otherwise).
+    std::vector<unsigned char> m_active;
+
+    //! Springs attached to at least one particle of the active region (1 if active, 0 otherwise).
+    std::vector<unsigned char> m_springActive;
+
+    //! Indices of particles of the active region.
+    std::vector<int> m_activeParticles;
+
+    //! Indices of particles outside the active region.
+    std::vector<int> m_slowParticles;
+
+    //! Indices of particles outside the active region attached to an active spring.
+    std::vector<int> m_boundaryParticles;
+
+    //! Indices of springs attached to at least one particle of the active region.
+    std::vector<int> m_activeSprings;
+
+    //! Indices of springs between particles outside the active region.
+    std::vector<int> m_slowSprings;
+
+    //! Impulses accumulated by active springs on boundary particles.
+    std::vector<double> m_impulseX, m_impulseY, m_impulseZ;
+};
+
+//---------------------------------------------------------------------------
+#endif
+//---------------------------------------------------------------------------
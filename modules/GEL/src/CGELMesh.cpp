@@ -59,6 +59,148 @@ void cGELMesh::initialise()
     m_showMassParticleModel = false;
     m_useSkeletonModel = false;
     m_useMassParticleModel = false;
+    m_massParticleSolverType = GEL_SOLVER_EXPLICIT;
+    m_massParticleSolver = NULL;
+    m_threadPool = NULL;
+    m_solverNumVertices = 0;
+    m_solverNumSprings = 0;
+    m_skinUpdateThreshold = 0.0;
+    m_skinValid = false;
+    m_collisionBoxValid = false;
+}
+
+
+//===========================================================================
+/*!
+    Destructor of cGELMesh.
+*/
+//===========================================================================
+cGELMesh::~cGELMesh()
+{
+    if (m_massParticleSolver != NULL)
+    {
+        delete m_massParticleSolver;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method selects the solver used by the mass particle model. 
+    __GEL_SOLVER_EXPLICIT__ updates every particle and spring object 
+    individually. __GEL_SOLVER_EXPLICIT_SOA__ simulates the same model 
+    using a cGELMassSpringSolver, which stores the state of the model in
+    contiguous arrays and distributes computations on the threads of the
+    thread pool assigned to this mesh. __GEL_SOLVER_IMPLICIT__ integrates 
+    the model with a backward Euler step (cGELImplicitSolver), which remains
+    stable with stiff springs and large time steps. __GEL_SOLVER_XPBD__
+    replaces springs by position based constraints solved with a fixed 
+    number of iterations per step (cGELXPBDSolver).
+
+    \param  a_solverType  Solver type.
+*/
+//===========================================================================
+void cGELMesh::setMassParticleSolver(cGELSolverType a_solverType)
+{
+    if (m_massParticleSolver != NULL)
+    {
+        delete m_massParticleSolver;
+        m_massParticleSolver = NULL;
+    }
+
+    m_massParticleSolverType = a_solverType;
+
+    switch (a_solverType)
+    {
+        case GEL_SOLVER_EXPLICIT_SOA:
+            m_massParticleSolver = new cGELMassSpringSolver();
+            break;
+
+        case GEL_SOLVER_IMPLICIT:
+            m_massParticleSolver = new cGELImplicitSolver();
+            break;
+
+        case GEL_SOLVER_XPBD:
+            m_massParticleSolver = new cGELXPBDSolver();
+            break;
+
+        default:
+            break;
+    }
+
+    m_solverNumVertices = 0;
+    m_solverNumSprings = 0;
+}
+
+
+//===========================================================================
+/*!
+    This method rebuilds the solver of the mass particle model. It must be 
+    called after mass particles or springs have been modified, or after 
+    the mass, damping, gravity, stiffness or rest length of a particle or 
+    spring has been changed. Additions and removals of vertices or springs
+    are detected automatically.
+*/
+//===========================================================================
+void cGELMesh::rebuildMassParticleSolver()
+{
+    if (m_massParticleSolver == NULL) { return; }
+
+    vector<cGELMassParticle*> particles;
+    particles.reserve(m_gelVertices.size());
+
+    vector<cGELVertex>::iterator i;
+    for(i = m_gelVertices.begin(); i != m_gelVertices.end(); ++i)
+    {
+        particles.push_back(i->m_massParticle);
+    }
+
+    // pass triangles of the mesh to the position based solver
+    cGELXPBDSolver* xpbdSolver = dynamic_cast<cGELXPBDSolver*>(m_massParticleSolver);
+    if (xpbdSolver != NULL)
+    {
+        vector<int> triangles;
+        vector<cMesh*>::iterator it;
+        for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+        {
+            cMesh* mesh = (*it);
+            unsigned int numTriangles = mesh->m_triangles->getNumElements();
+            for (unsigned int j=0; j<numTriangles; j++)
+            {
+                if (mesh->m_triangles->getAllocated(j))
+                {
+                    triangles.push_back(mesh->m_vertices->getUserData(mesh->m_triangles->getVertexIndex0(j)));
+                    triangles.push_back(mesh->m_vertices->getUserData(mesh->m_triangles->getVertexIndex1(j)));
+                    triangles.push_back(mesh->m_vertices->getUserData(mesh->m_triangles->getVertexIndex2(j)));
+                }
+            }
+        }
+        xpbdSolver->setTriangles(triangles);
+    }
+
+    m_massParticleSolver->build(particles, m_linearSprings);
+
+    m_solverNumVertices = (unsigned int)(m_gelVertices.size());
+    m_solverNumSprings = (unsigned int)(m_linearSprings.size());
+}
+
+
+//===========================================================================
+/*!
+    This method rebuilds the solver of the mass particle model if vertices 
+    or springs have been added or removed since it was last built.
+*/
+//===========================================================================
+void cGELMesh::updateMassParticleSolver()
+{
+    if (m_massParticleSolver == NULL) { return; }
+
+    if ((m_solverNumVertices != m_gelVertices.size()) ||
+        (m_solverNumSprings != m_linearSprings.size()) ||
+        (m_massParticleSolver->getNumParticles() == 0))
+    {
+        rebuildMassParticleSolver();
+    }
 }
 
 
@@ -78,7 +220,7 @@ void cGELMesh::clearForces()
             (*i)->clearForces();
         }
     }
-    if (m_useMassParticleModel)
+    if (m_useMassParticleModel && (m_massParticleSolver == NULL))
     {
         vector<cGELVertex>::iterator i;
 
@@ -135,7 +277,7 @@ void cGELMesh::computeForces()
             (*i)->computeForces();
         }
     }
-    if (m_useMassParticleModel)
+    if (m_useMassParticleModel && (m_massParticleSolver == NULL))
     {
         list<cGELLinearSpring*>::iterator i;
 
@@ -168,11 +310,19 @@ void cGELMesh::computeNextPose(double a_timeInterval)
     }
     if (m_useMassParticleModel)
     {
-        vector<cGELVertex>::iterator i;
-
-        for(i = m_gelVertices.begin(); i != m_gelVertices.end(); ++i)
+        if (m_massParticleSolver != NULL)
+        {
+            updateMassParticleSolver();
+            m_massParticleSolver->computeNextPose(a_timeInterval, m_threadPool);
+        }
+        else
         {
-            i->m_massParticle->computeNextPose(a_timeInterval);
+            vector<cGELVertex>::iterator i;
+
+            for(i = m_gelVertices.begin(); i != m_gelVertices.end(); ++i)
+            {
+                i->m_massParticle->computeNextPose(a_timeInterval);
+            }
         }
     }
 }
@@ -196,11 +346,18 @@ void cGELMesh::applyNextPose()
     }
     if (m_useMassParticleModel)
     {
-        vector<cGELVertex>::iterator i;
-
-        for(i = m_gelVertices.begin(); i != m_gelVertices.end(); ++i)
+        if (m_massParticleSolver != NULL)
+        {
+            m_massParticleSolver->applyNextPose(m_threadPool);
+        }
+        else
         {
-            i->m_massParticle->applyNextPose();
+            vector<cGELVertex>::iterator i;
+
+            for(i = m_gelVertices.begin(); i != m_gelVertices.end(); ++i)
+            {
+                i->m_massParticle->applyNextPose();
+            }
         }
     }
 }
@@ -312,7 +469,10 @@ void cGELMesh::buildVertices()
 //===========================================================================
 /*!
     This method connects each dynamic vertex to the nearest node on the
-    skeleton.
+    skeleton. Nodes and links are stored in a bounding volume hierarchy
+    (cGELSkeletonBVH) so that each vertex is only tested against nearby 
+    nodes and links. Vertices are processed in parallel by the threads of
+    the thread pool assigned to this mesh.
 
     \param  a_connectToNodesOnly  if __true__, then skin is only connected 
             to nodes only, if __false__ then skin mesh is connected to nodes
@@ -324,147 +484,354 @@ void cGELMesh::connectVerticesToSkeleton(bool a_connectToNodesOnly)
     // get number of vertices
     int numVertices = (int)(m_gelVertices.size());
 
+    // build spatial index of skeleton
+    cGELSkeletonBVH bvh;
+    bvh.build(m_nodes, m_links, !a_connectToNodesOnly);
+
     // for each deformable vertex we search for the nearest sphere or link
-    for (int i=0; i<numVertices; i++)
+    cGELParallelFor(m_threadPool, numVertices, [this, &bvh](int a_begin, int a_end)
     {
-        // get current deformable vertex
-        cGELVertex* curVertex = &m_gelVertices[i];
+        for (int i=a_begin; i<a_end; i++)
+        {
+            // get current deformable vertex
+            cGELVertex* curVertex = &m_gelVertices[i];
 
-        // get current vertex position
-        cVector3d pos = curVertex->m_mesh->m_vertices->getLocalPos(curVertex->m_vertexIndex);
+            // get current vertex position
+            cVector3d pos = curVertex->m_mesh->m_vertices->getLocalPos(curVertex->m_vertexIndex);
 
-        // initialize constant
-        double min_distance = 99999999999999999.0;
-        cGELSkeletonNode* nearest_node = NULL;
-        cGELSkeletonLink* nearest_link = NULL;
+            // search for the nearest node or link
+            cGELSkeletonNode* nearest_node = NULL;
+            cGELSkeletonLink* nearest_link = NULL;
+            bvh.findNearest(pos, nearest_node, nearest_link);
 
-        // search for the nearest node
-        list<cGELSkeletonNode*>::iterator itr;
-        for(itr = m_nodes.begin(); itr != m_nodes.end(); ++itr)
-        {
-            cGELSkeletonNode* nextNode = *itr;
-            double distance = cDistance(pos, nextNode->m_pos);
-            if (distance < min_distance)
+            // attach vertex to nearest node if it exists
+            if (nearest_node != NULL)
+            {
+                curVertex->m_node = nearest_node;
+                curVertex->m_link = NULL;
+                cVector3d posRel = cSub(pos, nearest_node->m_pos);
+                curVertex->m_massParticle->m_pos = cMul(cTranspose(nearest_node->m_rot), posRel);
+            }
+
+            // attach vertex to nearest link if it exists
+            else if (nearest_link != NULL)
             {
-                min_distance = distance;
-                nearest_node = nextNode;
-                nearest_link = NULL;
+                curVertex->m_node = NULL;
+                curVertex->m_link = nearest_link;
+
+                cMatrix3d rot;
+                rot.setCol( nearest_link->m_A0,
+                            nearest_link->m_B0,
+                            nearest_link->m_wLink01);
+                cVector3d posRel = cSub(pos, nearest_link->m_node0->m_pos);
+                curVertex->m_massParticle->m_pos = cMul(cInverse(rot), posRel);
             }
         }
+    }, 256);
+
+    // compute extent of vertices attached to each node and link
+    list<cGELSkeletonNode*>::iterator itr;
+    for(itr = m_nodes.begin(); itr != m_nodes.end(); ++itr)
+    {
+        (*itr)->m_skinExtent = 0.0;
+    }
+
+    list<cGELSkeletonLink*>::iterator j;
+    for(j = m_links.begin(); j != m_links.end(); ++j)
+    {
+        (*j)->m_skinExtent.zero();
+    }
+
+    for (int i=0; i<numVertices; i++)
+    {
+        cGELVertex* curVertex = &m_gelVertices[i];
+        const cVector3d& pos = curVertex->m_massParticle->m_pos;
+
+        if (curVertex->m_node != NULL)
+        {
+            curVertex->m_node->m_skinExtent = cMax(curVertex->m_node->m_skinExtent, pos.length());
+        }
+        else if (curVertex->m_link != NULL)
+        {
+            cVector3d& extent = curVertex->m_link->m_skinExtent;
+            extent.set(cMax(extent(0), cAbs(pos(0))),
+                       cMax(extent(1), cAbs(pos(1))),
+                       cMax(extent(2), cAbs(pos(2))));
+        }
+    }
+
+    // update all vertices at next skin update
+    m_skinValid = false;
+}
+
+
+//===========================================================================
+/*!
+    This method determines, for every node and link of the skeleton, if 
+    the vertices attached to it may have moved by more than the skin update
+    threshold since they were last updated. The displacement of a vertex 
+    is bounded using the largest distance between the node or link and 
+    its vertices.
+*/
+//===========================================================================
+void cGELMesh::updateSkinMotion()
+{
+    list<cGELSkeletonNode*>::iterator i;
+    for(i = m_nodes.begin(); i != m_nodes.end(); ++i)
+    {
+        cGELSkeletonNode* node = *i;
 
-        // search for the nearest link if any
-        if (!a_connectToNodesOnly)
+        bool moved = !m_skinValid;
+        if (!moved)
         {
-            list<cGELSkeletonLink*>::iterator j;
-            for(j = m_links.begin(); j != m_links.end(); ++j)
+            // bound displacement of attached vertices: |dp| + |dR| * extent
+            double rotation = 0.0;
+            for (int r=0; r<3; r++)
             {
-                cGELSkeletonLink* nextLink = *j;
-                double angle0 = cAngle(nextLink->m_wLink01, cSub(pos, nextLink->m_node0->m_pos));
-                double angle1 = cAngle(nextLink->m_wLink10, cSub(pos, nextLink->m_node1->m_pos));
-
-                if ((angle0 < (C_PI / 2.0)) && (angle1 < (C_PI / 2.0)))
+                for (int c=0; c<3; c++)
                 {
-                    cVector3d p = cProjectPointOnLine(pos,
-                                                      nextLink->m_node0->m_pos,
-                                                      nextLink->m_wLink01);
-
-                    double distance = cDistance(pos, p);
-
-                    if (distance < min_distance)
-                    {
-                        min_distance = distance;
-                        nearest_node = NULL;
-                        nearest_link = nextLink;
-                    }
+                    double d = node->m_rot(r,c) - node->m_skinRot(r,c);
+                    rotation += d * d;
                 }
             }
+            double displacement = cDistance(node->m_pos, node->m_skinPos) + sqrt(rotation) * node->m_skinExtent;
+            moved = (displacement > m_skinUpdateThreshold) || (displacement != displacement);
+        }
+
+        node->m_skinMoved = moved;
+        if (moved)
+        {
+            node->m_skinPos = node->m_pos;
+            node->m_skinRot = node->m_rot;
         }
+    }
+
+    list<cGELSkeletonLink*>::iterator j;
+    for(j = m_links.begin(); j != m_links.end(); ++j)
+    {
+        cGELSkeletonLink* link = *j;
 
-        // attach vertex to nearest node if it exists
-        if (nearest_node != NULL)
+        bool moved = !m_skinValid;
+        if (!moved)
         {
-            curVertex->m_node = nearest_node;
-            curVertex->m_link = NULL;
-            cVector3d posRel = cSub(pos, nearest_node->m_pos);
-            curVertex->m_massParticle->m_pos = cMul(cTranspose(nearest_node->m_rot), posRel);
+            // bound displacement of attached vertices
+            double displacement = cDistance(link->m_node0->m_pos, link->m_skinPos) +
+                                  link->m_skinExtent(0) * cDistance(link->m_wA0, link->m_skinA0) +
+                                  link->m_skinExtent(1) * cDistance(link->m_wB0, link->m_skinB0) +
+                                  link->m_skinExtent(2) * cDistance(link->m_wLink01, link->m_skinLink01);
+            moved = (displacement > m_skinUpdateThreshold) || (displacement != displacement);
         }
 
-        // attach vertex to nearest link if it exists
-        else if (nearest_link != NULL)
+        link->m_skinMoved = moved;
+        if (moved)
         {
-            curVertex->m_node = NULL;
-            curVertex->m_link = nearest_link;
-
-            cMatrix3d rot;
-            rot.setCol( nearest_link->m_A0,
-                        nearest_link->m_B0,
-                        nearest_link->m_wLink01);
-            cVector3d posRel = cSub(pos, nearest_link->m_node0->m_pos);
-            curVertex->m_massParticle->m_pos = cMul(cInverse(rot), posRel);
+            link->m_skinPos = link->m_node0->m_pos;
+            link->m_skinA0 = link->m_wA0;
+            link->m_skinB0 = link->m_wB0;
+            link->m_skinLink01 = link->m_wLink01;
         }
     }
+
+    m_skinValid = true;
 }
 
 
 //===========================================================================
 /*!
     This method updates the position of each vertex attached to the skeleton.
+    Vertices attached to nodes or links which have not moved by more than
+    the skin update threshold (see \ref setSkinUpdateThreshold()) are not
+    updated. With the default threshold of zero, only vertices attached to
+    nodes and links that have not moved at all are skipped. Vertices are 
+    processed in parallel by the threads of the thread pool assigned to 
+    this mesh.
 */
 //===========================================================================
 void cGELMesh::updateVertexPosition()
 {
+    // get number of vertices
+    int numVertices = (int)(m_gelVertices.size());
+
     if (m_useSkeletonModel)
     {
-        // get number of vertices
-        int numVertices = (int)(m_gelVertices.size());
+        // find nodes and links that have moved
+        updateSkinMotion();
 
         // for each deformable vertex, update its position
-        for (int i=0; i<numVertices; i++)
+        cGELParallelFor(m_threadPool, numVertices, [this](int a_begin, int a_end)
         {
-            // get current deformable vertex
-            cGELVertex* curVertex = &m_gelVertices[i];
-
-            // vertex is attached to an node
-            if (curVertex->m_node != NULL)
+            for (int i=a_begin; i<a_end; i++)
             {
-                cVector3d newPos;
-                curVertex->m_node->m_rot.mulr(curVertex->m_massParticle->m_pos, newPos);
-                newPos.add(curVertex->m_node->m_pos);
-                curVertex->m_mesh->m_vertices->setLocalPos(curVertex->m_vertexIndex, newPos);
+                // get current deformable vertex
+                cGELVertex* curVertex = &m_gelVertices[i];
+
+                // vertex is attached to an node
+                if (curVertex->m_node != NULL)
+                {
+                    if (!curVertex->m_node->m_skinMoved) { continue; }
+
+                    cVector3d newPos;
+                    curVertex->m_node->m_rot.mulr(curVertex->m_massParticle->m_pos, newPos);
+                    newPos.add(curVertex->m_node->m_pos);
+                    curVertex->m_mesh->m_vertices->m_localPos[curVertex->m_vertexIndex] = newPos;
+                }
+
+                // vertex is attached to a link
+                else if (curVertex->m_link != NULL)
+                {
+                    if (!curVertex->m_link->m_skinMoved) { continue; }
+
+                    cVector3d newPos;
+                    curVertex->m_link->m_node0->m_pos.addr(curVertex->m_massParticle->m_pos.z() * curVertex->m_link->m_wLink01, newPos);
+                    newPos.add(curVertex->m_massParticle->m_pos.x() * curVertex->m_link->m_wA0);
+                    newPos.add(curVertex->m_massParticle->m_pos.y() * curVertex->m_link->m_wB0);
+                    curVertex->m_mesh->m_vertices->m_localPos[curVertex->m_vertexIndex] = newPos;
+                }
             }
+        }, 1024);
+    }
 
-            // vertex is attached to a link
-            else if (curVertex->m_link != NULL)
+    if (m_useMassParticleModel)
+    {
+        // for each deformable vertex, update its position
+        cGELParallelFor(m_threadPool, numVertices, [this](int a_begin, int a_end)
+        {
+            for (int i=a_begin; i<a_end; i++)
             {
-                cVector3d newPos;
-                curVertex->m_link->m_node0->m_pos.addr(curVertex->m_massParticle->m_pos.z() * curVertex->m_link->m_wLink01, newPos);
-                newPos.add(curVertex->m_massParticle->m_pos.x() * curVertex->m_link->m_wA0);
-                newPos.add(curVertex->m_massParticle->m_pos.y() * curVertex->m_link->m_wB0);
+                // get current deformable vertex
+                cGELVertex* curVertex = &m_gelVertices[i];
 
-
-                //curVertex->node->m_rot.mulr(curVertex->pos, newPos);
-                //newPos.add(curVertex->node->m_pos);
-                curVertex->m_mesh->m_vertices->setLocalPos(curVertex->m_vertexIndex, newPos);
+                // vertex is attached to an node
+                if (curVertex->m_massParticle != NULL)
+                {
+                    curVertex->m_mesh->m_vertices->m_localPos[curVertex->m_vertexIndex] = curVertex->m_massParticle->m_pos;
+                }
             }
+        }, 1024);
+    }
+
+    // mark vertex data for update (vertex arrays are written directly above
+    // so that threads never share the modification flags and dirty range)
+    if (m_useSkeletonModel || m_useMassParticleModel)
+    {
+        vector<cMesh*>::iterator it;
+        for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+        {
+            (*it)->m_vertices->markForUpdate();
         }
     }
+}
 
-    if (m_useMassParticleModel)
+
+//===========================================================================
+/*!
+    This method refits the collision detectors of all meshes composing the 
+    deformable object to the current position of their vertices. AABB 
+    collision trees are refitted without being rebuilt. Other collision 
+    detectors are updated. The method also computes the bounding box that
+    encloses all collision detectors, which is used by cGELWorldCollision
+    to discard the deformable mesh quickly.
+*/
+//===========================================================================
+void cGELMesh::updateCollisionDetectors()
+{
+    m_collisionBoxValid = false;
+    m_collisionBoxMin.set( C_LARGE,  C_LARGE,  C_LARGE);
+    m_collisionBoxMax.set(-C_LARGE, -C_LARGE, -C_LARGE);
+
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
     {
-        // get number of vertices
-        int numVertices = (int)(m_gelVertices.size());
+        cMesh* mesh = (*it);
+        cGenericCollision* collisionDetector = mesh->getCollisionDetector();
+        if (collisionDetector == NULL) { continue; }
 
-        // for each deformable vertex, update its position
+        // refit collision tree
+        cCollisionAABB* collisionAABB = dynamic_cast<cCollisionAABB*>(collisionDetector);
+        if (collisionAABB != NULL)
+        {
+            collisionAABB->refit();
+        }
+        else
+        {
+            collisionDetector->update();
+        }
+
+        // compute bounding box of vertices in the reference frame of the mesh
+        int numVertices = mesh->getNumVertices();
+        if (numVertices == 0) { continue; }
+
+        cVector3d lower( C_LARGE,  C_LARGE,  C_LARGE);
+        cVector3d upper(-C_LARGE, -C_LARGE, -C_LARGE);
         for (int i=0; i<numVertices; i++)
         {
-            // get current deformable vertex
-            cGELVertex* curVertex = &m_gelVertices[i];
+            const cVector3d& pos = mesh->m_vertices->m_localPos[i];
+            for (int k=0; k<3; k++)
+            {
+                lower(k) = cMin(lower(k), pos(k));
+                upper(k) = cMax(upper(k), pos(k));
+            }
+        }
 
-            // vertex is attached to an node
-            if (curVertex->m_massParticle != NULL)
+        // add collision radius
+        double radius = collisionDetector->getBoundaryRadius();
+        lower.sub(radius, radius, radius);
+        upper.add(radius, radius, radius);
+
+        // enclose corners of box in the reference frame of the deformable mesh
+        for (int i=0; i<8; i++)
+        {
+            cVector3d corner((i & 1) ? upper(0) : lower(0),
+                             (i & 2) ? upper(1) : lower(1),
+                             (i & 4) ? upper(2) : lower(2));
+            cVector3d pos = cAdd(mesh->getLocalPos(), cMul(mesh->getLocalRot(), corner));
+            for (int k=0; k<3; k++)
             {
-                curVertex->m_mesh->m_vertices->setLocalPos(curVertex->m_vertexIndex, curVertex->m_massParticle->m_pos);
+                m_collisionBoxMin(k) = cMin(m_collisionBoxMin(k), pos(k));
+                m_collisionBoxMax(k) = cMax(m_collisionBoxMax(k), pos(k));
             }
         }
+        m_collisionBoxValid = true;
     }
 }
+
+
+//===========================================================================
+/*!
+    This method tests a segment against the bounding box computed by 
+    \ref updateCollisionDetectors(). If the bounding box has not been 
+    computed, the method always returns __true__.
+
+    \param  a_segmentPointA  Initial point of segment in the reference frame of the parent.
+    \param  a_segmentPointB  End point of segment in the reference frame of the parent.
+    \param  a_radius         Radius added around the bounding box.
+
+    \return __false__ if the segment cannot intersect the deformable mesh, __true__ otherwise.
+*/
+//===========================================================================
+bool cGELMesh::intersectBoundingBox(const cVector3d& a_segmentPointA,
+                                    const cVector3d& a_segmentPointB,
+                                    const double a_radius) const
+{
+    if (!m_collisionBoxValid) { return (true); }
+
+    // convert segment into local coordinate frame
+    cMatrix3d transLocalRot;
+    m_localRot.transr(transLocalRot);
+    cVector3d localSegmentPointA = cMul(transLocalRot, cSub(a_segmentPointA, m_localPos));
+    cVector3d localSegmentPointB = cMul(transLocalRot, cSub(a_segmentPointB, m_localPos));
+
+    // build bounding box
+    cCollisionAABBBox box;
+    box.setValue(cSub(m_collisionBoxMin, cVector3d(a_radius, a_radius, a_radius)),
+                 cAdd(m_collisionBoxMax, cVector3d(a_radius, a_radius, a_radius)));
+
+    // test bounding box of segment, then segment
+    cCollisionAABBBox lineBox;
+    lineBox.setEmpty();
+    lineBox.enclose(localSegmentPointA);
+    lineBox.enclose(localSegmentPointB);
+    if (!box.intersect(lineBox)) { return (false); }
+
+    return (box.intersect(localSegmentPointA, localSegmentPointB));
+}
@@ -47,8 +47,13 @@
 //---------------------------------------------------------------------------
 #include "CGELSkeletonNode.h"
 #include "CGELSkeletonLink.h"
+#include "CGELSkeletonBVH.h"
 #include "CGELLinearSpring.h"
 #include "CGELVertex.h"
+#include "CGELMassSpringSolver.h"
+#include "CGELImplicitSolver.h"
+#include "CGELXPBDSolver.h"
+#include "CGELThreadPool.h"
 //---------------------------------------------------------------------------
 #include "chai3d.h"
 //---------------------------------------------------------------------------
@@ -62,6 +67,24 @@
 */
 //===========================================================================
 
+//===========================================================================
+/*!
+    \enum       cGELSolverType
+    \ingroup    GEL
+
+    \brief
+    Solvers available for the mass particle model of a deformable mesh.
+*/
+//===========================================================================
+enum cGELSolverType
+{
+    GEL_SOLVER_EXPLICIT,
+    GEL_SOLVER_EXPLICIT_SOA,
+    GEL_SOLVER_IMPLICIT,
+    GEL_SOLVER_XPBD
+};
+
+
 //===========================================================================
 /*!
     \class      cGELMesh
@@ -84,7 +107,7 @@ public:
     cGELMesh(){ initialise(); };
 
     //! Destructor of cGELMesh.
-    virtual ~cGELMesh() {};
+    virtual ~cGELMesh();
 
 
     //-----------------------------------------------------------------------
@@ -100,26 +123,58 @@ public:
     void connectVerticesToSkeleton(bool a_connectToNodesOnly);
 
     //! This method updates the position of all vertices connected to the skeleton.
-    void updateVertexPosition();
+    virtual void updateVertexPosition();
+
+    //! This method sets the displacement below which vertices attached to the skeleton are not updated.
+    void setSkinUpdateThreshold(const double a_threshold) { m_skinUpdateThreshold = chai3d::cMax(a_threshold, 0.0); }
+
+    //! This method returns the displacement below which vertices attached to the skeleton are not updated.
+    double getSkinUpdateThreshold() const { return (m_skinUpdateThreshold); }
+
+    //! This method refits the collision detectors of all meshes to their current vertex positions and updates the bounding box of the deformable mesh.
+    void updateCollisionDetectors();
+
+    //! This method returns __false__ if a segment, expressed in the reference frame of the parent, cannot intersect the bounding box of the deformable mesh.
+    bool intersectBoundingBox(const chai3d::cVector3d& a_segmentPointA,
+                              const chai3d::cVector3d& a_segmentPointB,
+                              const double a_radius) const;
 
     //! This method sets all computed forces to zero.
-    void clearForces();
+    virtual void clearForces();
 
     //! This method sets all external forces to zero.
-    void clearExternalForces();
+    virtual void clearExternalForces();
 
     //! This method computes all internal forces.
-    void computeForces();
+    virtual void computeForces();
 
     //! This method updates the simulation over a time interval.
-    void computeNextPose(double iTimeInterval);
+    virtual void computeNextPose(double iTimeInterval);
 
     //! This method updates the position of the mesh after computation.
-    void applyNextPose();
+    virtual void applyNextPose();
 
     //! This method renders the deformable mesh graphically.
     virtual void render(chai3d::cRenderOptions& a_options);
 
+    //! This method selects the solver used by the mass particle model.
+    void setMassParticleSolver(cGELSolverType a_solverType);
+
+    //! This method returns the solver type used by the mass particle model.
+    cGELSolverType getMassParticleSolverType() const { return (m_massParticleSolverType); }
+
+    //! This method returns the solver used by the mass particle model, or __NULL__ for the default explicit solver.
+    cGELMassSpringSolver* getMassParticleSolver() { return (m_massParticleSolver); }
+
+    //! This method rebuilds the solver of the mass particle model after particles or springs have been modified.
+    void rebuildMassParticleSolver();
+
+    //! This method assigns a thread pool used by the solver of the mass particle model.
+    void setThreadPool(cGELThreadPool* a_threadPool) { m_threadPool = a_threadPool; }
+
+    //! This method returns the thread pool used by the solver of the mass particle model.
+    cGELThreadPool* getThreadPool() { return (m_threadPool); }
+
 
     //-----------------------------------------------------------------------
     // MEMBERS:
@@ -152,6 +207,43 @@ public:
     bool m_useMassParticleModel;
 
 
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Solver type used by the mass particle model.
+    cGELSolverType m_massParticleSolverType;
+
+    //! Solver used by the mass particle model (__NULL__ for the default explicit solver).
+    cGELMassSpringSolver* m_massParticleSolver;
+
+    //! Thread pool used by the solver of the mass particle model.
+    cGELThreadPool* m_threadPool;
+
+    //! Number of vertices when the solver was last built.
+    unsigned int m_solverNumVertices;
+
+    //! Number of linear springs when the solver was last built.
+    unsigned int m_solverNumSprings;
+
+    //! Displacement below which vertices attached to the skeleton are not updated.
+    double m_skinUpdateThreshold;
+
+    //! If __false__, all vertices attached to the skeleton are updated at the next skin update.
+    bool m_skinValid;
+
+    //! Lower corner of the bounding box enclosing all collision detectors of the deformable mesh.
+    chai3d::cVector3d m_collisionBoxMin;
+
+    //! Upper corner of the bounding box enclosing all collision detectors of the deformable mesh.
+    chai3d::cVector3d m_collisionBoxMax;
+
+    //! If __true__, the collision bounding box has been computed.
+    bool m_collisionBoxValid;
+
+
     //-----------------------------------------------------------------------
     // METHODS:
     //-----------------------------------------------------------------------
@@ -160,6 +252,12 @@ private:
 
     //! This method initializes the deformable mesh.
     void initialise();
+
+    //! This method builds the solver of the mass particle model if it is missing or outdated.
+    void updateMassParticleSolver();
+
+    //! This method determines which skeleton nodes and links have moved since the skin was last updated.
+    void updateSkinMotion();
 };
 
 //---------------------------------------------------------------------------
@@ -0,0 +1,289 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include "CGELSkeletonBVH.h"
+//---------------------------------------------------------------------------
+#include <algorithm>
+//---------------------------------------------------------------------------
+using namespace chai3d;
+using namespace std;
+//---------------------------------------------------------------------------
+//! Maximum number of elements in a leaf.
+#define GEL_BVH_LEAF_SIZE 4
+//---------------------------------------------------------------------------
+
+
+//===========================================================================
+/*!
+    This method builds the hierarchy from lists of nodes and links passed 
+    as argument.
+
+    \param  a_nodes         Skeleton nodes.
+    \param  a_links         Skeleton links.
+    \param  a_includeLinks  If __false__, links are ignored.
+*/
+//===========================================================================
+void cGELSkeletonBVH::build(const list<cGELSkeletonNode*>& a_nodes,
+                            const list<cGELSkeletonLink*>& a_links,
+                            const bool a_includeLinks)
+{
+    m_elements.clear();
+    m_boxes.clear();
+
+    // nodes
+    list<cGELSkeletonNode*>::const_iterator i;
+    for (i = a_nodes.begin(); i != a_nodes.end(); ++i)
+    {
+        cElement element;
+        element.m_node = *i;
+        element.m_link = NULL;
+        element.m_rank = (int)(m_elements.size());
+        element.m_min = (*i)->m_pos;
+        element.m_max = (*i)->m_pos;
+        m_elements.push_back(element);
+    }
+
+    // links (segment from node 0 along current link vector)
+    if (a_includeLinks)
+    {
+        list<cGELSkeletonLink*>::const_iterator j;
+        for (j = a_links.begin(); j != a_links.end(); ++j)
+        {
+            cVector3d p0 = (*j)->m_node0->m_pos;
+            cVector3d p1 = cAdd(p0, (*j)->m_wLink01);
+
+            cElement element;
+            element.m_node = NULL;
+            element.m_link = *j;
+            element.m_rank = (int)(m_elements.size());
+            element.m_min.set(cMin(p0(0), p1(0)), cMin(p0(1), p1(1)), cMin(p0(2), p1(2)));
+            element.m_max.set(cMax(p0(0), p1(0)), cMax(p0(1), p1(1)), cMax(p0(2), p1(2)));
+            m_elements.push_back(element);
+        }
+    }
+
+    if (m_elements.size() > 0)
+    {
+        m_boxes.reserve(2 * m_elements.size());
+        buildBox(0, (int)(m_elements.size()));
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method builds the subtree containing a range of elements, by 
+    splitting them at the median of their centers along the largest axis
+    of their bounding box.
+
+    \param  a_first  First element.
+    \param  a_count  Number of elements.
+
+    \return Index of the box of the subtree.
+*/
+//===========================================================================
+int cGELSkeletonBVH::buildBox(const int a_first, const int a_count)
+{
+    int index = (int)(m_boxes.size());
+    m_boxes.push_back(cBox());
+
+    // compute bounding box
+    cVector3d boxMin = m_elements[a_first].m_min;
+    cVector3d boxMax = m_elements[a_first].m_max;
+    for (int i=a_first+1; i<a_first+a_count; i++)
+    {
+        for (int k=0; k<3; k++)
+        {
+            boxMin(k) = cMin(boxMin(k), m_elements[i].m_min(k));
+            boxMax(k) = cMax(boxMax(k), m_elements[i].m_max(k));
+        }
+    }
+
+    cBox box;
+    box.m_min = boxMin;
+    box.m_max = boxMax;
+    box.m_left = -1;
+    box.m_right = -1;
+    box.m_first = a_first;
+    box.m_count = a_count;
+
+    // split large boxes
+    if (a_count > GEL_BVH_LEAF_SIZE)
+    {
+        cVector3d size = cSub(boxMax, boxMin);
+        int axis = 0;
+        if (size(1) > size(axis)) { axis = 1; }
+        if (size(2) > size(axis)) { axis = 2; }
+
+        int half = a_count / 2;
+        nth_element(m_elements.begin() + a_first,
+                    m_elements.begin() + a_first + half,
+                    m_elements.begin() + a_first + a_count,
+                    [axis](const cElement& a, const cElement& b)
+                    {
+                        return ((a.m_min(axis) + a.m_max(axis)) < (b.m_min(axis) + b.m_max(axis)));
+                    });
+
+        box.m_left = buildBox(a_first, half);
+        box.m_right = buildBox(a_first + half, a_count - half);
+        box.m_count = 0;
+    }
+
+    m_boxes[index] = box;
+    return (index);
+}
+
+
+//===========================================================================
+/*!
+    This method computes the distance between a point and a node or link. 
+    A link is only a candidate if the point projects between its two nodes.
+
+    \param  a_pos       Point.
+    \param  a_element   Node or link.
+    \param  a_distance  Returned distance.
+
+    \return __true__ if the element is a candidate, __false__ otherwise.
+*/
+//===========================================================================
+bool cGELSkeletonBVH::computeDistance(const cVector3d& a_pos, const cElement& a_element, double& a_distance) const
+{
+    if (a_element.m_node != NULL)
+    {
+        a_distance = cDistance(a_pos, a_element.m_node->m_pos);
+        return (true);
+    }
+
+    cGELSkeletonLink* link = a_element.m_link;
+    double angle0 = cAngle(link->m_wLink01, cSub(a_pos, link->m_node0->m_pos));
+    double angle1 = cAngle(link->m_wLink10, cSub(a_pos, link->m_node1->m_pos));
+
+    if ((angle0 < (C_PI / 2.0)) && (angle1 < (C_PI / 2.0)))
+    {
+        cVector3d p = cProjectPointOnLine(a_pos, link->m_node0->m_pos, link->m_wLink01);
+        a_distance = cDistance(a_pos, p);
+        return (true);
+    }
+
+    return (false);
+}
+
+
+//===========================================================================
+/*!
+    This method finds the node or link nearest to a point passed as 
+    argument.
+
+    \param  a_pos   Point.
+    \param  a_node  Returned nearest node, or __NULL__ if a link is nearer.
+    \param  a_link  Returned nearest link, or __NULL__ if a node is nearer.
+
+    \return __true__ if a node or link was found, __false__ otherwise.
+*/
+//===========================================================================
+bool cGELSkeletonBVH::findNearest(const cVector3d& a_pos,
+                                  cGELSkeletonNode*& a_node,
+                                  cGELSkeletonLink*& a_link) const
+{
+    a_node = NULL;
+    a_link = NULL;
+    if (m_boxes.empty()) { return (false); }
+
+    double bestDistance = C_LARGE;
+    int bestRank = -1;
+
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const cBox& box = m_boxes[stack[--stackSize]];
+
+        // distance to box is a lower bound of the distance to its elements
+        double boxDistance2 = 0.0;
+        for (int k=0; k<3; k++)
+        {
+            double d = cMax(0.0, cMax(box.m_min(k) - a_pos(k), a_pos(k) - box.m_max(k)));
+            boxDistance2 += d * d;
+        }
+        if ((bestRank >= 0) && (sqrt(boxDistance2) > bestDistance * (1.0 + 1e-9)))
+        {
+            continue;
+        }
+
+        // leaf
+        if (box.m_left < 0)
+        {
+            for (int i=box.m_first; i<box.m_first+box.m_count; i++)
+            {
+                double distance;
+                if (computeDistance(a_pos, m_elements[i], distance))
+                {
+                    if ((bestRank < 0) || 
+                        (distance < bestDistance) ||
+                        ((distance == bestDistance) && (m_elements[i].m_rank < bestRank)))
+                    {
+                        bestDistance = distance;
+                        bestRank = m_elements[i].m_rank;
+                        a_node = m_elements[i].m_node;
+                        a_link = m_elements[i].m_link;
+                    }
+                }
+            }
+        }
+
+        // visit nearest child first
+        else
+        {
+            const cBox& left = m_boxes[box.m_left];
+            cVector3d center = cMul(0.5, cAdd(left.m_min, left.m_max));
+            bool leftFirst = (cDistance(a_pos, center) <= cDistance(a_pos, cMul(0.5, cAdd(m_boxes[box.m_right].m_min, m_boxes[box.m_right].m_max))));
+            stack[stackSize++] = leftFirst ? box.m_right : box.m_left;
+            stack[stackSize++] = leftFirst ? box.m_left : box.m_right;
+        }
+    }
+
+    return (bestRank >= 0);
+}
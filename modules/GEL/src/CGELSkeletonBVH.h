@@ -0,0 +1,198 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#ifndef CGELSkeletonBVHH
+#define CGELSkeletonBVHH
+//---------------------------------------------------------------------------
+#include "CGELSkeletonNode.h"
+#include "CGELSkeletonLink.h"
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+//---------------------------------------------------------------------------
+#include <list>
+#include <vector>
+//---------------------------------------------------------------------------
+
+//===========================================================================
+/*!
+    \file       CGELSkeletonBVH.h
+
+    \brief
+    Implementation of a bounding volume hierarchy over skeleton nodes and
+    links.
+*/
+//===========================================================================
+
+//===========================================================================
+/*!
+    \class      cGELSkeletonBVH
+    \ingroup    GEL
+
+    \brief
+    This class implements a bounding volume hierarchy over the nodes and 
+    links of a skeleton.
+
+    \details
+    cGELSkeletonBVH stores the nodes (points) and links (segments) of a 
+    skeleton in a tree of axis-aligned bounding boxes, and finds the 
+    element nearest to a point without testing every node and link. The
+    search follows the rules of cGELMesh::connectVerticesToSkeleton():
+    the distance to a node is measured to its center, a link is only a 
+    candidate if the point projects between its two nodes, and in case of 
+    equal distances nodes are preferred to links and elements that appear 
+    first in their list are preferred to the following ones.
+
+    The hierarchy is a snapshot of the skeleton and must be rebuilt when 
+    nodes move.
+*/
+//===========================================================================
+class cGELSkeletonBVH
+{
+    //-----------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cGELSkeletonBVH.
+    cGELSkeletonBVH() {};
+
+    //! Destructor of cGELSkeletonBVH.
+    virtual ~cGELSkeletonBVH() {};
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method builds the hierarchy from lists of nodes and links.
+    void build(const std::list<cGELSkeletonNode*>& a_nodes,
+               const std::list<cGELSkeletonLink*>& a_links,
+               const bool a_includeLinks);
+
+    //! This method finds the node or link nearest to a point.
+    bool findNearest(const chai3d::cVector3d& a_pos,
+                     cGELSkeletonNode*& a_node,
+                     cGELSkeletonLink*& a_link) const;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED TYPES:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Node or link stored in the hierarchy.
+    struct cElement
+    {
+        //! Node, or __NULL__ if element is a link.
+        cGELSkeletonNode* m_node;
+
+        //! Link, or __NULL__ if element is a node.
+        cGELSkeletonLink* m_link;
+
+        //! Rank of the element (nodes first, then links, in list order).
+        int m_rank;
+
+        //! Minimum corner of bounding box.
+        chai3d::cVector3d m_min;
+
+        //! Maximum corner of bounding box.
+        chai3d::cVector3d m_max;
+    };
+
+    //! Box of the hierarchy.
+    struct cBox
+    {
+        //! Minimum corner of bounding box.
+        chai3d::cVector3d m_min;
+
+        //! Maximum corner of bounding box.
+        chai3d::cVector3d m_max;
+
+        //! First child box, or -1 for a leaf.
+        int m_left;
+
+        //! Second child box, or -1 for a leaf.
+        int m_right;
+
+        //! First element of a leaf.
+        int m_first;
+
+        //! Number of elements of a leaf.
+        int m_count;
+    };
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! This method builds the subtree containing a range of elements.
+    int buildBox(const int a_first, const int a_count);
+
+    //! This method computes the distance between a point and an element, or returns __false__ if the element is not a candidate.
+    bool computeDistance(const chai3d::cVector3d& a_pos, const cElement& a_element, double& a_distance) const;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Elements sorted by box.
+    std::vector<cElement> m_elements;
+
+    //! Boxes of the hierarchy (the first box is the root).
+    std::vector<cBox> m_boxes;
+};
+
+//---------------------------------------------------------------------------
+#endif
+//---------------------------------------------------------------------------
@@ -118,6 +118,14 @@ cGELSkeletonLink::cGELSkeletonLink(cGELSkeletonNode* a_node0, cGELSkeletonNode*
 
     // set torsion angular spring constant [NM/RAD]
     m_kSpringTorsion = s_default_kSpringTorsion;
+
+    // initialize skin update state
+    m_skinPos.zero();
+    m_skinLink01.zero();
+    m_skinA0.zero();
+    m_skinB0.zero();
+    m_skinExtent.zero();
+    m_skinMoved = true;
 }
 
 
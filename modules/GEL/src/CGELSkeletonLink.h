@@ -311,6 +311,31 @@ public:
     double m_length;
 
 
+    //-----------------------------------------------------------------------
+    // PUBLIC MEMBERS - SKIN:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! Position of node 0 when the vertices attached to the link were last updated.
+    chai3d::cVector3d m_skinPos;
+
+    //! Link vector when the vertices attached to the link were last updated.
+    chai3d::cVector3d m_skinLink01;
+
+    //! Reference vector A when the vertices attached to the link were last updated.
+    chai3d::cVector3d m_skinA0;
+
+    //! Reference vector B when the vertices attached to the link were last updated.
+    chai3d::cVector3d m_skinB0;
+
+    //! Largest absolute coordinates of the vertices attached to the link.
+    chai3d::cVector3d m_skinExtent;
+
+    //! If __true__, then the vertices attached to this link are updated.
+    bool m_skinMoved;
+
+
     //-----------------------------------------------------------------------
     // STATIC MEMBERS - DEFAULT SETTINGS:
     //-----------------------------------------------------------------------
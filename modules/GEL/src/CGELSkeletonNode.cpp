@@ -89,6 +89,10 @@ cGELSkeletonNode::cGELSkeletonNode()
     m_gravity       = s_default_gravity;
     m_useGravity    = s_default_useGravity;
     m_fixed         = false;
+    m_skinPos.zero();
+    m_skinRot.identity();
+    m_skinExtent    = 0.0;
+    m_skinMoved     = true;
     setMass(s_default_mass);
 }
 
@@ -115,4 +119,4 @@ void cGELSkeletonNode::setMass(double a_mass)
 {
     m_mass = a_mass;
     m_inertia = (2.0 / 5.0) * m_mass * m_radius * m_radius ;
-}
\ No newline at end of file
+}
\ No newline at end of file
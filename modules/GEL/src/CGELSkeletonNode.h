@@ -295,6 +295,25 @@ public:
     chai3d::cMatrix3d m_nextRot;
 
 
+    //-----------------------------------------------------------------------
+    // PUBLIC MEMBERS - SKIN:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! Position of node when the vertices attached to it were last updated.
+    chai3d::cVector3d m_skinPos;
+
+    //! Rotation of node when the vertices attached to it were last updated.
+    chai3d::cMatrix3d m_skinRot;
+
+    //! Largest distance between node and the vertices attached to it.
+    double m_skinExtent;
+
+    //! If __true__, then the vertices attached to this node are updated.
+    bool m_skinMoved;
+
+
     //-----------------------------------------------------------------------
     // PRIVATE MEMBERS - EXTERNAL FORCES:
     //-----------------------------------------------------------------------
@@ -0,0 +1,121 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#ifndef CGELThreadPoolH
+#define CGELThreadPoolH
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+//---------------------------------------------------------------------------
+#include <functional>
+//---------------------------------------------------------------------------
+
+//===========================================================================
+/*!
+    \file       CGELThreadPool.h
+
+    \brief
+    Implementation of a pool of threads for GEL solvers.
+*/
+//===========================================================================
+
+//===========================================================================
+/*!
+    \class      cGELThreadPool
+    \ingroup    GEL
+
+    \brief
+    This class implements a pool of worker threads used by GEL solvers.
+
+    \details
+    cGELThreadPool is a \ref chai3d::cThreadPool whose worker threads run at
+    haptic priority, since GEL solvers are stepped from the haptic loop.
+    Ranges are split into contiguous blocks of equal size, one per thread, 
+    so results are reproducible from one step to the next.
+*/
+//===========================================================================
+class cGELThreadPool : public chai3d::cThreadPool
+{
+    //-----------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cGELThreadPool.
+    cGELThreadPool(const unsigned int a_numThreads = 1) : chai3d::cThreadPool(a_numThreads, chai3d::CTHREAD_PRIORITY_HAPTICS) {}
+
+    //! Destructor of cGELThreadPool.
+    virtual ~cGELThreadPool() {}
+};
+
+
+//===========================================================================
+/*!
+    This function processes a range of indices with a thread pool, or with
+    the calling thread if no pool is defined.
+
+    \param  a_pool          Thread pool (may be __NULL__).
+    \param  a_count         Number of indices.
+    \param  a_task          Task processing indices [begin, end).
+    \param  a_minBlockSize  Minimum number of indices per thread.
+*/
+//===========================================================================
+inline void cGELParallelFor(cGELThreadPool* a_pool,
+                            const int a_count,
+                            const std::function<void(int, int)>& a_task,
+                            const int a_minBlockSize = 256)
+{
+    if (a_pool != NULL)
+    {
+        a_pool->parallelFor(a_count, a_task, a_minBlockSize);
+    }
+    else if (a_count > 0)
+    {
+        a_task(0, a_count);
+    }
+}
+
+//---------------------------------------------------------------------------
+#endif
+//---------------------------------------------------------------------------
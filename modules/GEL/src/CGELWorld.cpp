@@ -52,6 +52,7 @@ using namespace std;
     This method checks if the given line segment intersects any object
     located inside the virtual world.
 
+    \param  a_object         Object for which collision detector is being used.
     \param  a_segmentPointA  Initial point of segment.
     \param  a_segmentPointB  End point of segment.
     \param  a_recorder       Recorder which stores all collision events.
@@ -61,7 +62,8 @@ using namespace std;
     \return __true__ if collision occurred, __false__ otherwise.
 */
 //===========================================================================
-bool cGELWorldCollision::computeCollision(cVector3d& a_segmentPointA,
+bool cGELWorldCollision::computeCollision(cGenericObject* a_object,
+                                          cVector3d& a_segmentPointA,
                                           cVector3d& a_segmentPointB,
                                           cCollisionRecorder& a_recorder,
                                           cCollisionSettings& a_settings)
@@ -71,6 +73,16 @@ bool cGELWorldCollision::computeCollision(cVector3d& a_segmentPointA,
     for(i = m_gelWorld->m_gelMeshes.begin(); i != m_gelWorld->m_gelMeshes.end(); ++i)
     {
         cGELMesh *nextItem = *i;
+
+        // discard meshes whose bounding box is not crossed by the segment 
+        // (the first point of the segment may be moved when object motion 
+        // is compensated, in which case all meshes are tested)
+        if (!a_settings.m_adjustObjectMotion &&
+            !nextItem->intersectBoundingBox(a_segmentPointA, a_segmentPointB, a_settings.m_collisionRadius))
+        {
+            continue;
+        }
+
         bool collide = nextItem->computeCollisionDetection(a_segmentPointA, a_segmentPointB, a_recorder,
                         a_settings);
         if (collide) { result = true; }
@@ -158,6 +170,10 @@ void cGELWorld::updateDynamics(double a_timeInterval)
     for(i = m_gelMeshes.begin(); i != m_gelMeshes.end(); ++i)
     {
         cGELMesh *nextItem = *i;
+        if (nextItem->getThreadPool() == NULL)
+        {
+            nextItem->setThreadPool(&m_threadPool);
+        }
         nextItem->clearForces();
     }
 
@@ -190,7 +206,8 @@ void cGELWorld::updateDynamics(double a_timeInterval)
 //===========================================================================
 /*!
     This method update the mesh of every deformable object contained
-    in the virtual world.
+    in the virtual world, and refits their collision detectors to the
+    deformed mesh.
 
     \param  a_updateNormals  If __true__ then surface normals are recomputed.
 */
@@ -208,5 +225,8 @@ void cGELWorld::updateSkins(bool a_updateNormals)
         {
             nextItem->computeAllNormals();
         }
+
+        // refit collision trees to deformed mesh
+        nextItem->updateCollisionDetectors();
     }
-}
\ No newline at end of file
+}
\ No newline at end of file
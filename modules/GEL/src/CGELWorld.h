@@ -100,6 +100,12 @@ public:
     //! This method updates the mesh of all deformable objects.
     void updateSkins(bool a_updateNormals = true);
 
+    //! This method sets the number of threads used by the solvers of deformable objects.
+    void setNumThreads(const unsigned int a_numThreads) { m_threadPool.setNumThreads(a_numThreads); }
+
+    //! This method returns the number of threads used by the solvers of deformable objects.
+    unsigned int getNumThreads() const { return (m_threadPool.getNumThreads()); }
+
 
     //-----------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -117,6 +123,16 @@ public:
     chai3d::cVector3d m_gravity;
 
 
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Thread pool shared by the solvers of deformable objects.
+    cGELThreadPool m_threadPool;
+
+
     //-----------------------------------------------------------------------
     // PRIVATE METHODS:
     //-----------------------------------------------------------------------
@@ -169,7 +185,8 @@ public:
     virtual void render() {};
 
     //! This method computes all collisions between a segment passed as argument and the objects in this world.
-    virtual bool computeCollision(chai3d::cVector3d& a_segmentPointA,
+    virtual bool computeCollision(chai3d::cGenericObject* a_object,
+                                  chai3d::cVector3d& a_segmentPointA,
                                   chai3d::cVector3d& a_segmentPointB,
                                   chai3d::cCollisionRecorder& a_recorder,
                                   chai3d::cCollisionSettings& a_settings);
@@ -0,0 +1,593 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include "CGELXPBDSolver.h"
+//---------------------------------------------------------------------------
+#include <algorithm>
+#include <map>
+//---------------------------------------------------------------------------
+using namespace chai3d;
+using namespace std;
+//---------------------------------------------------------------------------
+//! Minimum number of particles processed by a thread.
+#define GEL_SOLVER_MIN_BLOCK_SIZE 1024
+//! Minimum number of constraints of a color processed by a thread.
+#define GEL_SOLVER_MIN_CONSTRAINT_BLOCK_SIZE 512
+//---------------------------------------------------------------------------
+
+
+//===========================================================================
+/*!
+    Constructor of cGELXPBDSolver.
+*/
+//===========================================================================
+cGELXPBDSolver::cGELXPBDSolver()
+{
+    m_numIterations = 10;
+    m_useBendingConstraints = false;
+    m_bendingCompliance = 0.0;
+    m_useVolumeConstraint = false;
+    m_volumeCompliance = 0.0;
+    m_restVolume = 0.0;
+    m_volumeLambda = 0.0;
+}
+
+
+//===========================================================================
+/*!
+    This method enables or disables bending constraints. Bending 
+    constraints are created when the solver is built, from the triangles
+    assigned with \ref setTriangles().
+
+    \param  a_enabled     If __true__ then bending constraints are created.
+    \param  a_compliance  Compliance of bending constraints (inverse of
+                          stiffness). A value of zero makes them rigid.
+*/
+//===========================================================================
+void cGELXPBDSolver::setUseBendingConstraints(const bool a_enabled, const double a_compliance)
+{
+    m_useBendingConstraints = a_enabled;
+    m_bendingCompliance = cMax(a_compliance, 0.0);
+}
+
+
+//===========================================================================
+/*!
+    This method enables or disables the volume constraint. The rest volume 
+    is the volume enclosed by the triangles when the solver is built. 
+    The triangles must describe a closed surface.
+
+    \param  a_enabled     If __true__ then the volume constraint is enforced.
+    \param  a_compliance  Compliance of the volume constraint. A value of 
+                          zero makes the volume incompressible.
+*/
+//===========================================================================
+void cGELXPBDSolver::setUseVolumeConstraint(const bool a_enabled, const double a_compliance)
+{
+    m_useVolumeConstraint = a_enabled;
+    m_volumeCompliance = cMax(a_compliance, 0.0);
+}
+
+
+//===========================================================================
+/*!
+    This method builds the solver from a list of mass particles and a list
+    of linear springs. A distance constraint is created for every spring 
+    and, if enabled, a bending constraint for every edge shared by two 
+    triangles. Constraints are then sorted by color.
+
+    \param  a_particles  Mass particles.
+    \param  a_springs    Linear springs connecting mass particles.
+*/
+//===========================================================================
+void cGELXPBDSolver::build(const vector<cGELMassParticle*>& a_particles,
+                           const list<cGELLinearSpring*>& a_springs)
+{
+    cGELMassSpringSolver::build(a_particles, a_springs);
+
+    // distance constraints
+    vector<int> node0;
+    vector<int> node1;
+    vector<int> spring;
+    int numSprings = getNumSprings();
+    for (int i=0; i<numSprings; i++)
+    {
+        if (m_springNode0[i] != m_springNode1[i])
+        {
+            node0.push_back(m_springNode0[i]);
+            node1.push_back(m_springNode1[i]);
+            spring.push_back(i);
+        }
+    }
+
+    // bending constraints
+    if (m_useBendingConstraints)
+    {
+        buildBendingConstraints(node0, node1, spring);
+    }
+
+    // sort constraints by color
+    colorConstraints(node0, node1, spring);
+
+    // rest volume
+    m_restVolume = computeVolume(m_posX, m_posY, m_posZ);
+    m_volumeLambda = 0.0;
+    m_volumeGradient.resize(3 * getNumParticles());
+
+    m_weight.resize(getNumParticles());
+    updateParameters();
+}
+
+
+//===========================================================================
+/*!
+    This method creates a bending constraint for every edge shared by two
+    triangles. The constraint connects the two vertices opposite to the 
+    edge and its rest length is their current distance.
+
+    \param  a_node0   First particles of constraints.
+    \param  a_node1   Second particles of constraints.
+    \param  a_spring  Springs of constraints.
+*/
+//===========================================================================
+void cGELXPBDSolver::buildBendingConstraints(vector<int>& a_node0, 
+                                             vector<int>& a_node1, 
+                                             vector<int>& a_spring)
+{
+    int numParticles = getNumParticles();
+    int numTriangles = (int)(m_triangles.size() / 3);
+
+    // for each edge, store the vertex opposite to it in the first triangle
+    map<pair<int, int>, int> edges;
+    for (int i=0; i<numTriangles; i++)
+    {
+        for (int j=0; j<3; j++)
+        {
+            int a = m_triangles[3*i + j];
+            int b = m_triangles[3*i + (j+1)%3];
+            int c = m_triangles[3*i + (j+2)%3];
+            if ((a < 0) || (b < 0) || (c < 0) || 
+                (a >= numParticles) || (b >= numParticles) || (c >= numParticles))
+            {
+                continue;
+            }
+
+            pair<int, int> edge(cMin(a, b), cMax(a, b));
+            map<pair<int, int>, int>::iterator it = edges.find(edge);
+            if (it == edges.end())
+            {
+                edges[edge] = c;
+            }
+            else if ((it->second >= 0) && (it->second != c))
+            {
+                a_node0.push_back(it->second);
+                a_node1.push_back(c);
+                a_spring.push_back(-1);
+
+                // only the first two triangles of an edge are used
+                it->second = -1;
+            }
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method sorts constraints by color using a greedy graph coloring, 
+    so that two constraints of the same color never share a particle.
+
+    \param  a_node0   First particles of constraints.
+    \param  a_node1   Second particles of constraints.
+    \param  a_spring  Springs of constraints (-1 for bending constraints).
+*/
+//===========================================================================
+void cGELXPBDSolver::colorConstraints(const vector<int>& a_node0, 
+                                      const vector<int>& a_node1, 
+                                      const vector<int>& a_spring)
+{
+    int numConstraints = (int)(a_node0.size());
+    int numParticles = getNumParticles();
+
+    // assign to each constraint the lowest color not used by its particles
+    vector<vector<bool> > used(numParticles);
+    vector<int> color(numConstraints);
+    int numColors = 0;
+    for (int i=0; i<numConstraints; i++)
+    {
+        vector<bool>& used0 = used[a_node0[i]];
+        vector<bool>& used1 = used[a_node1[i]];
+
+        int c = 0;
+        while (((c < (int)(used0.size())) && used0[c]) ||
+               ((c < (int)(used1.size())) && used1[c]))
+        {
+            c++;
+        }
+
+        if ((int)(used0.size()) <= c) { used0.resize(c + 1, false); }
+        if ((int)(used1.size()) <= c) { used1.resize(c + 1, false); }
+        used0[c] = true;
+        used1[c] = true;
+
+        color[i] = c;
+        numColors = cMax(numColors, c + 1);
+    }
+
+    // count constraints per color
+    m_colorOffset.assign(numColors + 1, 0);
+    for (int i=0; i<numConstraints; i++)
+    {
+        m_colorOffset[color[i] + 1]++;
+    }
+    for (int i=0; i<numColors; i++)
+    {
+        m_colorOffset[i + 1] += m_colorOffset[i];
+    }
+
+    // store constraints sorted by color
+    m_constraintNode0.resize(numConstraints);
+    m_constraintNode1.resize(numConstraints);
+    m_constraintSpring.resize(numConstraints);
+    m_constraintLength0.resize(numConstraints);
+    m_constraintCompliance.resize(numConstraints);
+    m_constraintLambda.assign(numConstraints, 0.0);
+
+    vector<int> next(m_colorOffset.begin(), m_colorOffset.end() - 1);
+    for (int i=0; i<numConstraints; i++)
+    {
+        int index = next[color[i]]++;
+        m_constraintNode0[index] = a_node0[i];
+        m_constraintNode1[index] = a_node1[i];
+        m_constraintSpring[index] = a_spring[i];
+
+        // rest length of bending constraints is the current distance
+        double dx = m_posX[a_node1[i]] - m_posX[a_node0[i]];
+        double dy = m_posY[a_node1[i]] - m_posY[a_node0[i]];
+        double dz = m_posZ[a_node1[i]] - m_posZ[a_node0[i]];
+        m_constraintLength0[index] = sqrt(dx*dx + dy*dy + dz*dz);
+        m_constraintCompliance[index] = m_bendingCompliance;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method reads the mass and gravity properties of all particles and
+    the stiffness and rest length of all springs from their objects. The 
+    compliance of distance constraints is the inverse of the stiffness of 
+    their spring.
+*/
+//===========================================================================
+void cGELXPBDSolver::updateParameters()
+{
+    cGELMassSpringSolver::updateParameters();
+
+    int numConstraints = getNumConstraints();
+    for (int i=0; i<numConstraints; i++)
+    {
+        int spring = m_constraintSpring[i];
+        if (spring >= 0)
+        {
+            double k = m_springStiffness[spring];
+            m_constraintLength0[i] = m_springLength0[spring];
+            m_constraintCompliance[i] = (k > 0.0) ? (1.0 / k) : C_LARGE;
+        }
+        else
+        {
+            m_constraintCompliance[i] = m_bendingCompliance;
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the next position of all particles over a time 
+    interval passed as argument.
+
+    \param  a_timeInterval  Time interval.
+    \param  a_threadPool    Thread pool (if __NULL__, the calling thread 
+                            performs all computations).
+*/
+//===========================================================================
+void cGELXPBDSolver::computeNextPose(const double a_timeInterval, cGELThreadPool* a_threadPool)
+{
+    if ((getNumParticles() == 0) || (a_timeInterval <= 0.0)) { return; }
+
+    // read external forces and predict positions
+    cGELParallelFor(a_threadPool, getNumParticles(), [this, a_timeInterval](int a_begin, int a_end)
+    {
+        gatherExternalState(a_begin, a_end);
+        predictPositions(a_begin, a_end, a_timeInterval);
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+
+    // reset lagrange multipliers
+    fill(m_constraintLambda.begin(), m_constraintLambda.end(), 0.0);
+    m_volumeLambda = 0.0;
+
+    // project constraints
+    int numColors = getNumColors();
+    for (int i=0; i<m_numIterations; i++)
+    {
+        for (int c=0; c<numColors; c++)
+        {
+            int offset = m_colorOffset[c];
+            cGELParallelFor(a_threadPool, m_colorOffset[c+1] - offset, [this, offset, a_timeInterval](int a_begin, int a_end)
+            {
+                projectConstraints(offset + a_begin, offset + a_end, a_timeInterval);
+            }, GEL_SOLVER_MIN_CONSTRAINT_BLOCK_SIZE);
+        }
+
+        if (m_useVolumeConstraint)
+        {
+            projectVolumeConstraint(a_timeInterval);
+        }
+    }
+
+    // update velocities
+    cGELParallelFor(a_threadPool, getNumParticles(), [this, a_timeInterval](int a_begin, int a_end)
+    {
+        updateVelocities(a_begin, a_end, a_timeInterval);
+    }, GEL_SOLVER_MIN_BLOCK_SIZE);
+}
+
+
+//===========================================================================
+/*!
+    This method applies damping, gravity and external forces to the 
+    velocity of a range of particles and predicts their next positions.
+
+    \param  a_begin         First particle.
+    \param  a_end           Last particle (excluded).
+    \param  a_timeInterval  Time interval.
+*/
+//===========================================================================
+void cGELXPBDSolver::predictPositions(const int a_begin, const int a_end, const double a_timeInterval)
+{
+    const double dt = a_timeInterval;
+
+    for (int i=a_begin; i<a_end; i++)
+    {
+        // fixed particles have no weight
+        m_weight[i] = m_mobility[i] * m_invMass[i];
+
+        // damping
+        double damping = cMax(0.0, 1.0 - dt * m_damping[i] * m_invMass[i]);
+        double vx = damping * m_velX[i];
+        double vy = damping * m_velY[i];
+        double vz = damping * m_velZ[i];
+
+        // gravity and external forces
+        vx += dt * m_invMass[i] * (m_gravityForceX[i] + m_extForceX[i]);
+        vy += dt * m_invMass[i] * (m_gravityForceY[i] + m_extForceY[i]);
+        vz += dt * m_invMass[i] * (m_gravityForceZ[i] + m_extForceZ[i]);
+
+        m_nextPosX[i] = m_posX[i] + m_mobility[i] * dt * vx;
+        m_nextPosY[i] = m_posY[i] + m_mobility[i] * dt * vy;
+        m_nextPosZ[i] = m_posZ[i] + m_mobility[i] * dt * vz;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method projects a range of distance and bending constraints on 
+    the predicted positions. Constraints of the range must not share any 
+    particle with constraints processed concurrently.
+
+    \param  a_begin         First constraint.
+    \param  a_end           Last constraint (excluded).
+    \param  a_timeInterval  Time interval.
+*/
+//===========================================================================
+void cGELXPBDSolver::projectConstraints(const int a_begin, const int a_end, const double a_timeInterval)
+{
+    const double invDt2 = 1.0 / (a_timeInterval * a_timeInterval);
+
+    for (int i=a_begin; i<a_end; i++)
+    {
+        int n0 = m_constraintNode0[i];
+        int n1 = m_constraintNode1[i];
+        double w0 = m_weight[n0];
+        double w1 = m_weight[n1];
+        double alpha = m_constraintCompliance[i] * invDt2;
+        if ((w0 + w1 + alpha) <= 0.0) { continue; }
+
+        double dx = m_nextPosX[n1] - m_nextPosX[n0];
+        double dy = m_nextPosY[n1] - m_nextPosY[n0];
+        double dz = m_nextPosZ[n1] - m_nextPosZ[n0];
+        double length = sqrt(dx*dx + dy*dy + dz*dz);
+        if (length <= 0.000001) { continue; }
+
+        // compute multiplier update
+        double C = length - m_constraintLength0[i];
+        double deltaLambda = (-C - alpha * m_constraintLambda[i]) / (w0 + w1 + alpha);
+        m_constraintLambda[i] += deltaLambda;
+
+        // move particles along constraint direction
+        double s = deltaLambda / length;
+        m_nextPosX[n0] -= w0 * s * dx;
+        m_nextPosY[n0] -= w0 * s * dy;
+        m_nextPosZ[n0] -= w0 * s * dz;
+        m_nextPosX[n1] += w1 * s * dx;
+        m_nextPosY[n1] += w1 * s * dy;
+        m_nextPosZ[n1] += w1 * s * dz;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method projects the volume constraint on the predicted positions.
+
+    \param  a_timeInterval  Time interval.
+*/
+//===========================================================================
+void cGELXPBDSolver::projectVolumeConstraint(const double a_timeInterval)
+{
+    int numTriangles = (int)(m_triangles.size() / 3);
+    int numParticles = getNumParticles();
+    if (numTriangles == 0) { return; }
+
+    // compute volume gradient: dV/dp_a = (p_b x p_c) / 6
+    fill(m_volumeGradient.begin(), m_volumeGradient.end(), 0.0);
+    for (int i=0; i<numTriangles; i++)
+    {
+        int n[3] = { m_triangles[3*i], m_triangles[3*i+1], m_triangles[3*i+2] };
+        if ((n[0] < 0) || (n[1] < 0) || (n[2] < 0) ||
+            (n[0] >= numParticles) || (n[1] >= numParticles) || (n[2] >= numParticles))
+        {
+            continue;
+        }
+
+        for (int j=0; j<3; j++)
+        {
+            int a = n[j];
+            int b = n[(j+1)%3];
+            int c = n[(j+2)%3];
+            m_volumeGradient[3*a+0] += (m_nextPosY[b] * m_nextPosZ[c] - m_nextPosZ[b] * m_nextPosY[c]) / 6.0;
+            m_volumeGradient[3*a+1] += (m_nextPosZ[b] * m_nextPosX[c] - m_nextPosX[b] * m_nextPosZ[c]) / 6.0;
+            m_volumeGradient[3*a+2] += (m_nextPosX[b] * m_nextPosY[c] - m_nextPosY[b] * m_nextPosX[c]) / 6.0;
+        }
+    }
+
+    // compute multiplier update
+    double sum = 0.0;
+    for (int i=0; i<numParticles; i++)
+    {
+        const double* g = &m_volumeGradient[3*i];
+        sum += m_weight[i] * (g[0]*g[0] + g[1]*g[1] + g[2]*g[2]);
+    }
+
+    double alpha = m_volumeCompliance / (a_timeInterval * a_timeInterval);
+    if ((sum + alpha) <= C_SMALL) { return; }
+
+    double C = computeVolume(m_nextPosX, m_nextPosY, m_nextPosZ) - m_restVolume;
+    double deltaLambda = (-C - alpha * m_volumeLambda) / (sum + alpha);
+    m_volumeLambda += deltaLambda;
+
+    // move particles along gradient
+    for (int i=0; i<numParticles; i++)
+    {
+        double s = m_weight[i] * deltaLambda;
+        m_nextPosX[i] += s * m_volumeGradient[3*i+0];
+        m_nextPosY[i] += s * m_volumeGradient[3*i+1];
+        m_nextPosZ[i] += s * m_volumeGradient[3*i+2];
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the velocity of a range of particles from the 
+    displacement between their current and next positions. Fixed particles
+    keep their velocity.
+
+    \param  a_begin         First particle.
+    \param  a_end           Last particle (excluded).
+    \param  a_timeInterval  Time interval.
+*/
+//===========================================================================
+void cGELXPBDSolver::updateVelocities(const int a_begin, const int a_end, const double a_timeInterval)
+{
+    const double invDt = 1.0 / a_timeInterval;
+    const double* mobility = m_mobility.data();
+    const double* pos[3] = { m_posX.data(), m_posY.data(), m_posZ.data() };
+    const double* nextPos[3] = { m_nextPosX.data(), m_nextPosY.data(), m_nextPosZ.data() };
+    double* vel[3] = { m_velX.data(), m_velY.data(), m_velZ.data() };
+
+    for (int k=0; k<3; k++)
+    {
+        const double* p = pos[k];
+        const double* n = nextPos[k];
+        double* v = vel[k];
+
+        for (int i=a_begin; i<a_end; i++)
+        {
+            v[i] = mobility[i] * (n[i] - p[i]) * invDt + (1.0 - mobility[i]) * v[i];
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the volume enclosed by the triangles for a set of
+    particle positions passed as argument.
+
+    \param  a_x  Positions of particles along x.
+    \param  a_y  Positions of particles along y.
+    \param  a_z  Positions of particles along z.
+
+    \return Enclosed volume.
+*/
+//===========================================================================
+double cGELXPBDSolver::computeVolume(const vector<double>& a_x,
+                                     const vector<double>& a_y,
+                                     const vector<double>& a_z) const
+{
+    int numTriangles = (int)(m_triangles.size() / 3);
+    int numParticles = (int)(a_x.size());
+
+    double volume = 0.0;
+    for (int i=0; i<numTriangles; i++)
+    {
+        int a = m_triangles[3*i];
+        int b = m_triangles[3*i+1];
+        int c = m_triangles[3*i+2];
+        if ((a < 0) || (b < 0) || (c < 0) ||
+            (a >= numParticles) || (b >= numParticles) || (c >= numParticles))
+        {
+            continue;
+        }
+
+        // signed volume of tetrahedron (origin, a, b, c)
+        volume += a_x[a] * (a_y[b] * a_z[c] - a_z[b] * a_y[c]) +
+                  a_y[a] * (a_z[b] * a_x[c] - a_x[b] * a_z[c]) +
+                  a_z[a] * (a_x[b] * a_y[c] - a_y[b] * a_x[c]);
+    }
+
+    return (volume / 6.0);
+}
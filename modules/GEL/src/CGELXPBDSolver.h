@@ -0,0 +1,253 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   1.0.0
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#ifndef CGELXPBDSolverH
+#define CGELXPBDSolverH
+//---------------------------------------------------------------------------
+#include "CGELMassSpringSolver.h"
+//---------------------------------------------------------------------------
+
+//===========================================================================
+/*!
+    \file       CGELXPBDSolver.h
+
+    \brief
+    Implementation of an extended position based dynamics (XPBD) solver.
+*/
+//===========================================================================
+
+//===========================================================================
+/*!
+    \class      cGELXPBDSolver
+    \ingroup    GEL
+
+    \brief
+    This class implements an extended position based dynamics (XPBD) 
+    solver for mass particles.
+
+    \details
+    cGELXPBDSolver replaces the forces of the linear springs by constraints
+    which are solved directly on the positions of the particles:
+
+    - __Distance constraints__ are created from the linear springs. Their 
+    rest length is the rest length of the spring and their compliance is 
+    the inverse of the spring stiffness.
+
+    - __Bending constraints__ are created for every edge shared by two 
+    triangles. They constrain the distance between the two vertices 
+    opposite to the edge, which resists folding of the surface.
+
+    - A __volume constraint__ preserves the volume enclosed by the 
+    triangles of a closed mesh.
+
+    At each step, particles are first moved by gravity and external 
+    forces, then constraints are projected for a fixed number of 
+    iterations. Distance and bending constraints are sorted by color so 
+    that constraints of the same color share no particle. Each color is 
+    processed in parallel by the threads of the thread pool (graph colored
+    Gauss-Seidel). Since the number of iterations is fixed, the cost of a 
+    step is bounded and known in advance, and the solver remains stable
+    for any stiffness and time step.
+*/
+//===========================================================================
+class cGELXPBDSolver : public cGELMassSpringSolver
+{
+    //-----------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cGELXPBDSolver.
+    cGELXPBDSolver();
+
+    //! Destructor of cGELXPBDSolver.
+    virtual ~cGELXPBDSolver() {};
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method builds the solver from a list of mass particles and linear springs.
+    virtual void build(const std::vector<cGELMassParticle*>& a_particles,
+                       const std::list<cGELLinearSpring*>& a_springs);
+
+    //! This method reads the mass, gravity and spring properties from the particle and spring objects.
+    virtual void updateParameters();
+
+    //! This method computes the next position of all particles over a time interval.
+    virtual void computeNextPose(const double a_timeInterval, cGELThreadPool* a_threadPool = NULL);
+
+    //! This method sets the triangles used by bending and volume constraints (three particle indices per triangle).
+    void setTriangles(const std::vector<int>& a_triangles) { m_triangles = a_triangles; }
+
+    //! This method sets the number of constraint iterations per step.
+    void setNumIterations(const int a_numIterations) { m_numIterations = chai3d::cMax(a_numIterations, 1); }
+
+    //! This method returns the number of constraint iterations per step.
+    int getNumIterations() const { return (m_numIterations); }
+
+    //! This method enables or disables bending constraints. The solver must be rebuilt.
+    void setUseBendingConstraints(const bool a_enabled, const double a_compliance = 0.0);
+
+    //! This method returns __true__ if bending constraints are enabled.
+    bool getUseBendingConstraints() const { return (m_useBendingConstraints); }
+
+    //! This method enables or disables the volume constraint.
+    void setUseVolumeConstraint(const bool a_enabled, const double a_compliance = 0.0);
+
+    //! This method returns __true__ if the volume constraint is enabled.
+    bool getUseVolumeConstraint() const { return (m_useVolumeConstraint); }
+
+    //! This method returns the rest volume enclosed by the triangles.
+    double getRestVolume() const { return (m_restVolume); }
+
+    //! This method returns the current volume enclosed by the triangles.
+    double getVolume() const { return (computeVolume(m_posX, m_posY, m_posZ)); }
+
+    //! This method returns the number of distance and bending constraints.
+    int getNumConstraints() const { return ((int)(m_constraintNode0.size())); }
+
+    //! This method returns the number of colors of the constraint graph.
+    int getNumColors() const { return ((int)(m_colorOffset.size()) - 1); }
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! This method creates the bending constraints from the triangles.
+    void buildBendingConstraints(std::vector<int>& a_node0, 
+                                 std::vector<int>& a_node1, 
+                                 std::vector<int>& a_spring);
+
+    //! This method sorts the constraints by color.
+    void colorConstraints(const std::vector<int>& a_node0, 
+                          const std::vector<int>& a_node1, 
+                          const std::vector<int>& a_spring);
+
+    //! This method predicts the positions of a range of particles from their velocity and external forces.
+    void predictPositions(const int a_begin, const int a_end, const double a_timeInterval);
+
+    //! This method projects a range of distance and bending constraints.
+    void projectConstraints(const int a_begin, const int a_end, const double a_timeInterval);
+
+    //! This method projects the volume constraint.
+    void projectVolumeConstraint(const double a_timeInterval);
+
+    //! This method computes the velocity of a range of particles from their displacement.
+    void updateVelocities(const int a_begin, const int a_end, const double a_timeInterval);
+
+    //! This method computes the volume enclosed by the triangles for a set of positions.
+    double computeVolume(const std::vector<double>& a_x,
+                         const std::vector<double>& a_y,
+                         const std::vector<double>& a_z) const;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Number of constraint iterations per step.
+    int m_numIterations;
+
+    //! Triangles (three particle indices per triangle).
+    std::vector<int> m_triangles;
+
+    //! If __true__ then bending constraints are created.
+    bool m_useBendingConstraints;
+
+    //! Compliance of bending constraints.
+    double m_bendingCompliance;
+
+    //! If __true__ then the volume constraint is enforced.
+    bool m_useVolumeConstraint;
+
+    //! Compliance of the volume constraint.
+    double m_volumeCompliance;
+
+    //! Rest volume enclosed by the triangles.
+    double m_restVolume;
+
+    //! Lagrange multiplier of the volume constraint.
+    double m_volumeLambda;
+
+    //! Inverse masses of particles (zero for fixed particles).
+    std::vector<double> m_weight;
+
+    //! First particle of each constraint (sorted by color).
+    std::vector<int> m_constraintNode0;
+
+    //! Second particle of each constraint (sorted by color).
+    std::vector<int> m_constraintNode1;
+
+    //! Spring of each constraint, or -1 for bending constraints.
+    std::vector<int> m_constraintSpring;
+
+    //! Rest length of each constraint.
+    std::vector<double> m_constraintLength0;
+
+    //! Compliance of each constraint.
+    std::vector<double> m_constraintCompliance;
+
+    //! Lagrange multiplier of each constraint.
+    std::vector<double> m_constraintLambda;
+
+    //! First constraint of each color (with one extra entry for the end).
+    std::vector<int> m_colorOffset;
+
+    //! Gradient of the volume constraint for each particle.
+    std::vector<double> m_volumeGradient;
+};
+
+//---------------------------------------------------------------------------
+#endif
+//---------------------------------------------------------------------------
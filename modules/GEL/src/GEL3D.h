@@ -62,10 +62,16 @@
 
 #include "CGELMassParticle.h"
 #include "CGELLinearSpring.h"
+#include "CGELThreadPool.h"
+#include "CGELMassSpringSolver.h"
+#include "CGELImplicitSolver.h"
+#include "CGELXPBDSolver.h"
 #include "CGELSkeletonNode.h"
 #include "CGELSkeletonLink.h"
+#include "CGELSkeletonBVH.h"
 #include "CGELVertex.h"
 #include "CGELMesh.h"
+#include "CGELFEMMesh.h"
 #include "CGELWorld.h"
 
 //---------------------------------------------------------------------------
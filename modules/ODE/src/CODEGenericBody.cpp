@@ -77,8 +77,13 @@ void cODEGenericBody::initialize(cODEWorld* a_world)
     // add body to world
     m_ODEWorld->m_bodies.push_back(this);
 
+    // the image model is updated at every call to updateGlobalPositions()
+    m_useIncrementalGlobalPositions = false;
+
     // init ODE data
     m_ode_triMeshDataID = NULL;
+    m_vertices = NULL;
+    m_vertexIndices = NULL;
     m_ode_body = NULL;
 
     m_prevTransform[0] = 1.0;
@@ -148,6 +153,7 @@ void cODEGenericBody::setLocalPos(const chai3d::cVector3d &a_position)
     {
         // store value
         m_localPos = a_position;
+        invalidateGlobalPositions();
 
         // adjust position
         dBodySetPosition(m_ode_body, a_position.x(), a_position.y(), a_position.z());
@@ -156,6 +162,7 @@ void cODEGenericBody::setLocalPos(const chai3d::cVector3d &a_position)
     {
         // store value
         m_localPos = a_position;
+        invalidateGlobalPositions();
 
         // adjust position
         dGeomSetPosition(m_ode_geom, a_position.x(), a_position.y(), a_position.z());
@@ -190,12 +197,14 @@ void cODEGenericBody::setLocalRot(const cMatrix3d &a_rotation)
     {
         // store new rotation matrix
         m_localRot = a_rotation;
+        invalidateGlobalPositions();
         dBodySetRotation(m_ode_body, R);
     }
     else if (m_ode_geom != NULL)
     {
         // store new rotation matrix
         m_localRot = a_rotation;
+        invalidateGlobalPositions();
         dGeomSetRotation(m_ode_geom, R);
     }
 }
@@ -894,15 +903,8 @@ void cODEGenericBody::createDynamicMesh(const bool a_staticObject,
         nTriangles = buildMeshTable(multiMesh);
     }
 
-    // build box
-    m_ode_triMeshDataID = dGeomTriMeshDataCreate();
-    dGeomTriMeshDataBuildSingle(m_ode_triMeshDataID,
-                                m_vertices,          // vertex positions
-                                3 * sizeof(float),   // size of vertex
-                                vertexCount,         // number of vertices
-                                m_vertexIndices,     // triangle indices
-                                3 * nTriangles,      // number of triangles
-                                3 * sizeof(int));
+    // build triangle mesh data, or share it with bodies of identical geometry
+    m_ode_triMeshDataID = m_ODEWorld->shareTriMeshData(m_vertices, vertexCount, m_vertexIndices, 3 * nTriangles);
 
     m_ode_geom = dCreateTriMesh(m_ODEWorld->m_ode_space, m_ode_triMeshDataID, 0, 0, 0);
 
@@ -1040,9 +1042,9 @@ int cODEGenericBody::buildMeshTable(chai3d::cMesh* a_mesh)
             unsigned int vertex0 = a_mesh->m_triangles->getVertexIndex0(i);
             unsigned int vertex1 = a_mesh->m_triangles->getVertexIndex1(i);
             unsigned int vertex2 = a_mesh->m_triangles->getVertexIndex2(i);
-            m_vertexIndices[3*i+0] = vertex0;
-            m_vertexIndices[3*i+1] = vertex1;
-            m_vertexIndices[3*i+2] = vertex2;
+            m_vertexIndices[3*nTriangles+0] = vertex0;
+            m_vertexIndices[3*nTriangles+1] = vertex1;
+            m_vertexIndices[3*nTriangles+2] = vertex2;
             nTriangles++;
         }
     }
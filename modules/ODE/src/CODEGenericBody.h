@@ -317,16 +317,16 @@ protected:
     //! Mass of object units: [kg].
     double m_mass;
 
-    //! ODE vertices (for triangle mesh models) - Do not use doubles since not supported under ODE! 
+    //! ODE vertices (for triangle mesh models, owned by world) - Do not use doubles since not supported under ODE! 
     float* m_vertices;
 
-    //! ODE indices (for triangle mesh models).
+    //! ODE indices (for triangle mesh models, owned by world).
     int* m_vertexIndices;
 
     //! ODE previous tri mesh position and orientation.
     double m_prevTransform[16];
 
-    //! ODE triangle mesh ID.
+    //! ODE triangle mesh ID (shared by bodies of identical geometry).
     dTriMeshDataID m_ode_triMeshDataID;
 
     //! Enable/Disable graphical representation of collision model.
@@ -44,14 +44,49 @@
 //---------------------------------------------------------------------------
 #include "CODEWorld.h"
 //---------------------------------------------------------------------------
+#include <cstring>
+//---------------------------------------------------------------------------
 using namespace chai3d;
 using namespace std;
 //---------------------------------------------------------------------------
 //! Maximum number of contact points per body.
 #define MAX_CONTACTS_PER_BODY 16
+
+//! Number of pairs fetched at once by a thread computing contacts.
+#define PAIRS_PER_FETCH 8
 //---------------------------------------------------------------------------
 
 
+//===========================================================================
+/*!
+    This function returns __true__ if collisions with a geometry of a given
+    class can be computed concurrently with other collisions.
+
+    \param  a_geom  ODE geometry.
+
+    \return __true__ if the geometry is a primitive, __false__ otherwise.
+*/
+//===========================================================================
+static inline bool cODEIsThreadSafeGeom(dGeomID a_geom)
+{
+    switch (dGeomGetClass(a_geom))
+    {
+        case dSphereClass:
+        case dBoxClass:
+        case dCapsuleClass:
+        case dCylinderClass:
+        case dPlaneClass:
+        case dRayClass:
+            return (true);
+
+        default:
+            // triangle meshes, heightfields and convex shapes use shared 
+            // temporary buffers inside ODE
+            return (false);
+    }
+}
+
+
 //==========================================================================
 /*!
     Constructor of cODEWorld.
@@ -67,14 +102,29 @@ cODEWorld::cODEWorld(cWorld* a_parentWorld)
     // set parent world
     m_parentWorld = a_parentWorld;
 
+    // bodies are not children of this world and are updated at every call
+    // to updateGlobalPositions()
+    m_useIncrementalGlobalPositions = false;
+
     // reset simulation time.
     m_simulationTime = 0.0;
 
+    // reset profiling information
+    m_timeCollision = 0.0;
+    m_timeStep = 0.0;
+    m_timeSync = 0.0;
+    m_numContacts = 0;
+
+    // contacts are computed by the calling thread only
+    m_numThreads = 1;
+    m_nextPair = 0;
+
     // create ODE world
     m_ode_world = dWorldCreate();
 
     // create ODE space
     m_ode_space = dHashSpaceCreate(0);
+    m_broadphaseType = ODE_BROADPHASE_HASH;
 
     // setup callback to handle collision
     dSpaceCollide(m_ode_space, this, &(cODEWorld::nearCallback));
@@ -96,6 +146,9 @@ cODEWorld::cODEWorld(cWorld* a_parentWorld)
 //===========================================================================
 cODEWorld::~cODEWorld()
 {
+    // stop threads
+    m_threadPool.setNumThreads(1);
+
     // clear all bodies
     m_bodies.clear();
 
@@ -103,6 +156,16 @@ cODEWorld::~cODEWorld()
     dJointGroupDestroy(m_ode_contactgroup);
     dSpaceDestroy(m_ode_space);
     dWorldDestroy(m_ode_world);
+
+    // cleanup triangle mesh data (once all geometries are destroyed)
+    multimap<unsigned long long, cODETriMeshData>::iterator it;
+    for (it = m_triMeshData.begin(); it != m_triMeshData.end(); ++it)
+    {
+        dGeomTriMeshDataDestroy(it->second.m_data);
+        delete [] it->second.m_vertices;
+        delete [] it->second.m_indices;
+    }
+    m_triMeshData.clear();
 }
 
 
@@ -198,8 +261,12 @@ void cODEWorld::updateDynamics(double a_interval)
     // sanity check
     if (a_interval <= 0) { return; }
 
-    // update collision callback information
-    dSpaceCollide (m_ode_space, 0, &(cODEWorld::nearCallback));
+    double time0 = cPrecisionClock::getCPUTimeSeconds();
+
+    // compute collisions and create contact joints
+    computeContacts();
+
+    double time1 = cPrecisionClock::getCPUTimeSeconds();
 
     // integrate simulation during an certain interval
     // dWorldStep (m_ode_world, a_interval);
@@ -209,11 +276,353 @@ void cODEWorld::updateDynamics(double a_interval)
     // cleanup contacts from previous iteration
     dJointGroupEmpty(m_ode_contactgroup);
 
+    double time2 = cPrecisionClock::getCPUTimeSeconds();
+
     // add time to overall simulation
     m_simulationTime = m_simulationTime + a_interval;
 
     // update CHAI3D positions for of all object
     updateBodyPositions();
+
+    double time3 = cPrecisionClock::getCPUTimeSeconds();
+
+    // store profiling information
+    m_timeCollision = time1 - time0;
+    m_timeStep = time2 - time1;
+    m_timeSync = time3 - time2;
+}
+
+
+//===========================================================================
+/*!
+    This methods returns ODE triangle mesh data for a list of vertices and 
+    triangle indices. If another body of the world already uses identical 
+    arrays, its triangle mesh data and collision structures are shared, the 
+    arrays passed as argument are deleted and replaced by the shared ones.
+    Otherwise, new triangle mesh data is built from the arrays. In both 
+    cases, the world takes ownership of the arrays, which remain allocated 
+    until the world is deleted.
+
+    \param  a_vertices     Vertex positions (3 floats per vertex).
+    \param  a_numVertices  Number of vertices.
+    \param  a_indices      Triangle vertex indices (3 indices per triangle).
+    \param  a_numIndices   Number of indices.
+
+    \return ODE triangle mesh data.
+*/
+//===========================================================================
+dTriMeshDataID cODEWorld::shareTriMeshData(float*& a_vertices, 
+                                           const int a_numVertices,
+                                           int*& a_indices,
+                                           const int a_numIndices)
+{
+    // compute hash of content (FNV-1a)
+    unsigned long long hash = 14695981039346656037ULL;
+    const unsigned char* bytes = (const unsigned char*)a_vertices;
+    for (size_t i=0; i<3 * a_numVertices * sizeof(float); i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    bytes = (const unsigned char*)a_indices;
+    for (size_t i=0; i<a_numIndices * sizeof(int); i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+
+    // search for identical geometry
+    pair<multimap<unsigned long long, cODETriMeshData>::iterator, 
+         multimap<unsigned long long, cODETriMeshData>::iterator> range = m_triMeshData.equal_range(hash);
+
+    for (multimap<unsigned long long, cODETriMeshData>::iterator it = range.first; it != range.second; ++it)
+    {
+        cODETriMeshData& data = it->second;
+        if ((data.m_numVertices == a_numVertices) &&
+            (data.m_numIndices == a_numIndices) &&
+            (memcmp(data.m_vertices, a_vertices, 3 * a_numVertices * sizeof(float)) == 0) &&
+            (memcmp(data.m_indices, a_indices, a_numIndices * sizeof(int)) == 0))
+        {
+            delete [] a_vertices;
+            delete [] a_indices;
+            a_vertices = data.m_vertices;
+            a_indices = data.m_indices;
+            return (data.m_data);
+        }
+    }
+
+    // build new triangle mesh data
+    cODETriMeshData data;
+    data.m_vertices = a_vertices;
+    data.m_numVertices = a_numVertices;
+    data.m_indices = a_indices;
+    data.m_numIndices = a_numIndices;
+    data.m_data = dGeomTriMeshDataCreate();
+    dGeomTriMeshDataBuildSingle(data.m_data,
+                                data.m_vertices,     // vertex positions
+                                3 * sizeof(float),   // size of vertex
+                                data.m_numVertices,  // number of vertices
+                                data.m_indices,      // triangle indices
+                                data.m_numIndices,   // number of indices
+                                3 * sizeof(int));
+
+    m_triMeshData.insert(make_pair(hash, data));
+
+    return (data.m_data);
+}
+
+
+//===========================================================================
+/*!
+    This methods selects a simple space as broad phase collision algorithm.
+    All pairs of geometries are tested, which is only suited for small 
+    scenes.
+*/
+//===========================================================================
+void cODEWorld::setBroadphaseSimple()
+{
+    setSpace(dSimpleSpaceCreate(0), ODE_BROADPHASE_SIMPLE);
+}
+
+
+//===========================================================================
+/*!
+    This methods selects a multi-resolution hash table space as broad phase
+    collision algorithm. Cell sizes range from 2^a_minLevel to 2^a_maxLevel.
+    This is the default algorithm.
+
+    \param  a_minLevel  Smallest cell size exponent.
+    \param  a_maxLevel  Largest cell size exponent.
+*/
+//===========================================================================
+void cODEWorld::setBroadphaseHash(const int a_minLevel, const int a_maxLevel)
+{
+    dSpaceID space = dHashSpaceCreate(0);
+    dHashSpaceSetLevels(space, a_minLevel, a_maxLevel);
+    setSpace(space, ODE_BROADPHASE_HASH);
+}
+
+
+//===========================================================================
+/*!
+    This methods selects a sweep and prune space as broad phase collision 
+    algorithm. This algorithm performs well for large scenes in which many 
+    objects are distributed along one main axis.
+
+    \param  a_axisOrder  Order of the axes used for sorting (__dSAP_AXES_XYZ__,
+                         __dSAP_AXES_XZY__, ...).
+*/
+//===========================================================================
+void cODEWorld::setBroadphaseSweepAndPrune(const int a_axisOrder)
+{
+    setSpace(dSweepAndPruneSpaceCreate(0, a_axisOrder), ODE_BROADPHASE_SAP);
+}
+
+
+//===========================================================================
+/*!
+    This methods selects a quadtree space as broad phase collision 
+    algorithm. This algorithm performs well for large scenes in which 
+    objects are spread over a known region of a plane.
+
+    \param  a_center   Center of region covered by the quadtree.
+    \param  a_extents  Extents of region covered by the quadtree.
+    \param  a_depth    Depth of quadtree.
+*/
+//===========================================================================
+void cODEWorld::setBroadphaseQuadTree(const cVector3d& a_center,
+                                      const cVector3d& a_extents,
+                                      const int a_depth)
+{
+    dVector3 center, extents;
+    center[0] = a_center(0);
+    center[1] = a_center(1);
+    center[2] = a_center(2);
+    center[3] = 0.0;
+    extents[0] = a_extents(0);
+    extents[1] = a_extents(1);
+    extents[2] = a_extents(2);
+    extents[3] = 0.0;
+
+    setSpace(dQuadTreeSpaceCreate(0, center, extents, a_depth), ODE_BROADPHASE_QUADTREE);
+}
+
+
+//===========================================================================
+/*!
+    This methods replaces the collision space of the world. All geometries 
+    of the current space are moved to the new space before the current 
+    space is destroyed.
+
+    \param  a_space  New collision space.
+    \param  a_type   Broad phase collision algorithm of new space.
+*/
+//===========================================================================
+void cODEWorld::setSpace(dSpaceID a_space, cODEBroadphaseType a_type)
+{
+    // collect geometries of current space
+    int numGeoms = dSpaceGetNumGeoms(m_ode_space);
+    vector<dGeomID> geoms(numGeoms);
+    for (int i=0; i<numGeoms; i++)
+    {
+        geoms[i] = dSpaceGetGeom(m_ode_space, i);
+    }
+
+    // move geometries to new space
+    for (int i=0; i<numGeoms; i++)
+    {
+        dSpaceRemove(m_ode_space, geoms[i]);
+        dSpaceAdd(a_space, geoms[i]);
+    }
+
+    // replace space
+    dSpaceDestroy(m_ode_space);
+    m_ode_space = a_space;
+    m_broadphaseType = a_type;
+}
+
+
+//===========================================================================
+/*!
+    This methods sets the number of threads used to compute contacts 
+    between pairs of geometries, including the thread that calls 
+    \ref updateDynamics(). A value of 1 disables multithreading.
+
+    \param  a_numThreads  Number of threads.
+*/
+//===========================================================================
+void cODEWorld::setNumThreads(const unsigned int a_numThreads)
+{
+    unsigned int numThreads = cMax(a_numThreads, 1u);
+    if (numThreads == m_numThreads)
+    {
+        return;
+    }
+
+    m_numThreads = numThreads;
+    m_threadPool.setNumThreads(m_numThreads);
+}
+
+
+//===========================================================================
+/*!
+    This methods runs the broad phase, computes contacts between all pairs
+    of geometries and creates the corresponding contact joints.
+*/
+//===========================================================================
+void cODEWorld::computeContacts()
+{
+    // collect pairs of potentially colliding geometries
+    m_pairs.clear();
+    m_serialPairs.clear();
+    m_numContacts = 0;
+
+    dSpaceCollide (m_ode_space, this, &(cODEWorld::nearCallback));
+
+    // compute contacts
+    m_pairContacts.resize(m_pairs.size() * MAX_CONTACTS_PER_BODY);
+    m_serialPairContacts.resize(m_serialPairs.size() * MAX_CONTACTS_PER_BODY);
+    m_nextPair = 0;
+
+    bool parallel = (m_numThreads > 1) && (m_pairs.size() > PAIRS_PER_FETCH);
+    m_threadPool.run([this](unsigned int a_thread)
+    {
+        // pairs which cannot be processed concurrently are handled by the calling thread
+        if (a_thread == 0)
+        {
+            processSerialPairs();
+        }
+        processPairs();
+    }, parallel ? 0 : 1);
+
+    // create contact joints in the order pairs were reported
+    for (unsigned int i=0; i<m_pairs.size(); i++)
+    {
+        createContactJoints(&m_pairContacts[i * MAX_CONTACTS_PER_BODY], m_pairs[i].m_numContacts);
+    }
+    for (unsigned int i=0; i<m_serialPairs.size(); i++)
+    {
+        createContactJoints(&m_serialPairContacts[i * MAX_CONTACTS_PER_BODY], m_serialPairs[i].m_numContacts);
+    }
+}
+
+
+//===========================================================================
+/*!
+    This methods computes contacts for pairs of primitive geometries. Pairs
+    are fetched in small batches until all have been processed, so that 
+    the calling thread and all workers share the load.
+*/
+//===========================================================================
+void cODEWorld::processPairs()
+{
+    int numPairs = (int)(m_pairs.size());
+
+    while (true)
+    {
+        int first = m_nextPair.fetch_add(PAIRS_PER_FETCH);
+        if (first >= numPairs)
+        {
+            break;
+        }
+
+        int last = cMin(first + PAIRS_PER_FETCH, numPairs);
+        for (int i=first; i<last; i++)
+        {
+            cODEPair& pair = m_pairs[i];
+            pair.m_numContacts = dCollide (pair.m_geom1, pair.m_geom2, MAX_CONTACTS_PER_BODY, 
+                                           &(m_pairContacts[i * MAX_CONTACTS_PER_BODY].geom), sizeof(dContact));
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This methods computes contacts for the pairs of geometries which cannot 
+    be processed concurrently, such as pairs involving triangle meshes.
+*/
+//===========================================================================
+void cODEWorld::processSerialPairs()
+{
+    for (unsigned int i=0; i<m_serialPairs.size(); i++)
+    {
+        cODEPair& pair = m_serialPairs[i];
+        pair.m_numContacts = dCollide (pair.m_geom1, pair.m_geom2, MAX_CONTACTS_PER_BODY, 
+                                       &(m_serialPairContacts[i * MAX_CONTACTS_PER_BODY].geom), sizeof(dContact));
+    }
+}
+
+
+//===========================================================================
+/*!
+    This methods creates contact joints for the contacts found between two
+    geometries.
+
+    \param  a_contacts     Contacts.
+    \param  a_numContacts  Number of contacts.
+*/
+//===========================================================================
+void cODEWorld::createContactJoints(dContact* a_contacts, const int a_numContacts)
+{
+    for (int i=0; i<a_numContacts; i++)
+    {
+        dContact& contact = a_contacts[i];
+
+        // define default collision properties (this section could be extended to support some ODE material class!)
+        contact.surface.slip1 = 0.7;
+        contact.surface.slip2 = 0.7;
+        contact.surface.mode = dContactSoftERP | dContactSoftCFM | dContactApprox1 | dContactSlip1 | dContactSlip2;
+        contact.surface.mu = 50;
+        contact.surface.soft_erp = 0.90;
+        contact.surface.soft_cfm = 0.10;
+
+        // create a joint following collision
+        dBodyID b1 = dGeomGetBody(contact.geom.g1);
+        dBodyID b2 = dGeomGetBody(contact.geom.g2);
+
+        dJointID c = dJointCreateContact (m_ode_world, m_ode_contactgroup, &contact);
+        dJointAttach (c, b1, b2);
+        m_numContacts++;
+    }
 }
 
 
@@ -239,7 +648,7 @@ void cODEWorld::updateBodyPositions(void)
 /*!
     This methods is an ODE callback for handling collision detection.
 
-    \param  a_data     Not used here.
+    \param  a_data     Pointer to world.
     \param  a_object1  Reference to ODE object 1.
     \param  a_object2  Reference to ODE object 2.
 */
@@ -254,44 +663,24 @@ void cODEWorld::nearCallback (void *a_data, dGeomID a_object1, dGeomID a_object2
     // exit without doing anything if the two bodies are connected by a joint
     if (b1 && b2 && dAreConnectedExcluding (b1,b2,dJointTypeContact)) return;
 
-    dContact contact[MAX_CONTACTS_PER_BODY];
-    int n = dCollide (a_object1, a_object2, MAX_CONTACTS_PER_BODY,&(contact[0].geom),sizeof(dContact));
-    if (n > 0) 
-    {
-        for (int i=0; i<n; i++) 
-        {
-            // define default collision properties (this section could be extended to support some ODE material class!)
-            contact[i].surface.slip1 = 0.7;
-            contact[i].surface.slip2 = 0.7;
-            contact[i].surface.mode = dContactSoftERP | dContactSoftCFM | dContactApprox1 | dContactSlip1 | dContactSlip2;
-            contact[i].surface.mu = 50;
-            contact[i].surface.soft_erp = 0.90;
-            contact[i].surface.soft_cfm = 0.10;
-
-            // get handles on each body
-            cODEGenericBody* ode_body = NULL;
-            if (b1 != NULL)
-            {
-                ode_body = (cODEGenericBody*)dBodyGetData (b1);
-            }
-            else if (b2 != NULL)
-            {
-                // if first object is static, use the second one. (both objects can not be static) 
-                ode_body = (cODEGenericBody*)dBodyGetData (b2);
-            }
-                
-            // create a joint following collision
-            if (ode_body != NULL)
-            {
-                dJointID c = dJointCreateContact (ode_body->m_ODEWorld->m_ode_world,
-                                                    ode_body->m_ODEWorld->m_ode_contactgroup,
-                                                    &contact[i]);
-                dJointAttach (c,
-                            dGeomGetBody(contact[i].geom.g1),
-                            dGeomGetBody(contact[i].geom.g2));
-            }
+    // exit without doing anything if both objects are static
+    if ((b1 == NULL) && (b2 == NULL)) return;
 
-        }
+    // store pair. contacts are computed once all pairs have been reported.
+    cODEWorld* world = (cODEWorld*)a_data;
+
+    cODEPair pair;
+    pair.m_geom1 = a_object1;
+    pair.m_geom2 = a_object2;
+    pair.m_numContacts = 0;
+
+    if (cODEIsThreadSafeGeom(a_object1) && cODEIsThreadSafeGeom(a_object2))
+    {
+        world->m_pairs.push_back(pair);
+    }
+    else
+    {
+        world->m_serialPairs.push_back(pair);
     }
 }
 
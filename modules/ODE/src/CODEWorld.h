@@ -48,6 +48,10 @@
 #include "chai3d.h"
 #include "CODEGenericBody.h"
 //---------------------------------------------------------------------------
+#include <atomic>
+#include <map>
+#include <vector>
+//---------------------------------------------------------------------------
 
 //===========================================================================
 /*!
@@ -59,6 +63,21 @@
 //===========================================================================
 
 
+//---------------------------------------------------------------------------
+/*!
+    Defines the broad phase collision algorithms supported by cODEWorld.
+*/
+//---------------------------------------------------------------------------
+enum cODEBroadphaseType
+{
+    ODE_BROADPHASE_SIMPLE,
+    ODE_BROADPHASE_HASH,
+    ODE_BROADPHASE_SAP,
+    ODE_BROADPHASE_QUADTREE
+};
+//---------------------------------------------------------------------------
+
+
 //===========================================================================
 /*!
     \class      cODEWorld
@@ -70,6 +89,15 @@
     \details
     cODEWorld implements a virtual world to handle ODE based objects 
     (cODEGenericBody).
+
+    The broad phase collision algorithm can be selected among the spaces 
+    provided by ODE (simple, hash, sweep and prune, quadtree). Contact 
+    generation between pairs of primitive geometries (box, sphere, capsule,
+    cylinder, plane, ray) can be distributed on several threads by calling
+    \ref setNumThreads(). Pairs involving other geometries such as triangle 
+    meshes rely on shared ODE collider caches and are always processed by 
+    the calling thread. Contact joints are created in the same order as 
+    with a single thread, so results do not depend on the number of threads.
 */
 //===========================================================================
 class cODEWorld : public chai3d::cGenericObject
@@ -127,6 +155,78 @@ public:
     //! This method updates all global position frames.
     void updateGlobalPositions(const bool a_frameOnly);
 
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - BROAD PHASE:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method selects a simple space which tests all pairs of geometries.
+    void setBroadphaseSimple();
+
+    //! This method selects a multi-resolution hash table space.
+    void setBroadphaseHash(const int a_minLevel = -3, const int a_maxLevel = 10);
+
+    //! This method selects a sweep and prune space.
+    void setBroadphaseSweepAndPrune(const int a_axisOrder = dSAP_AXES_XZY);
+
+    //! This method selects a quadtree space covering a given region.
+    void setBroadphaseQuadTree(const chai3d::cVector3d& a_center,
+                               const chai3d::cVector3d& a_extents,
+                               const int a_depth = 6);
+
+    //! This method returns the broad phase collision algorithm currently used.
+    cODEBroadphaseType getBroadphaseType() const { return (m_broadphaseType); }
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - THREADING:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method sets the number of threads used to compute contacts.
+    void setNumThreads(const unsigned int a_numThreads);
+
+    //! This method returns the number of threads used to compute contacts.
+    unsigned int getNumThreads() const { return (m_numThreads); }
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - PROFILING:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method returns the time spent in collision detection during the last step (seconds).
+    double getTimeCollision() const { return (m_timeCollision); }
+
+    //! This method returns the time spent integrating the dynamics during the last step (seconds).
+    double getTimeStep() const { return (m_timeStep); }
+
+    //! This method returns the time spent updating CHAI3D bodies during the last step (seconds).
+    double getTimeSync() const { return (m_timeSync); }
+
+    //! This method returns the number of contact joints created during the last step.
+    int getNumContacts() const { return (m_numContacts); }
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - TRIANGLE MESH DATA:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method returns triangle mesh data shared by all bodies with identical geometry.
+    dTriMeshDataID shareTriMeshData(float*& a_vertices, 
+                                    const int a_numVertices,
+                                    int*& a_indices,
+                                    const int a_numIndices);
+
+    //! This method returns the number of distinct triangle mesh data in the world.
+    int getNumTriMeshData() const { return ((int)(m_triMeshData.size())); }
+
     //! This method computes any collision between a segment and all objects in this world.
     virtual bool computeCollisionDetection(const chai3d::cVector3d& a_segmentPointA,
                                            const chai3d::cVector3d& a_segmentPointB,
@@ -162,6 +262,91 @@ protected:
     //! Parent CHAI3D world.
     chai3d::cWorld* m_parentWorld;
 
+    //! Broad phase collision algorithm.
+    cODEBroadphaseType m_broadphaseType;
+
+    //! Time spent in collision detection during the last step.
+    double m_timeCollision;
+
+    //! Time spent integrating the dynamics during the last step.
+    double m_timeStep;
+
+    //! Time spent updating CHAI3D bodies during the last step.
+    double m_timeSync;
+
+    //! Number of contact joints created during the last step.
+    int m_numContacts;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - TRIANGLE MESH DATA:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Triangle mesh data shared between bodies.
+    struct cODETriMeshData
+    {
+        //! ODE triangle mesh data.
+        dTriMeshDataID m_data;
+
+        //! Vertex positions.
+        float* m_vertices;
+
+        //! Number of vertices.
+        int m_numVertices;
+
+        //! Triangle vertex indices.
+        int* m_indices;
+
+        //! Number of indices.
+        int m_numIndices;
+    };
+
+    //! Triangle mesh data of world indexed by hash of their content.
+    std::multimap<unsigned long long, cODETriMeshData> m_triMeshData;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - THREADING:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Pair of geometries reported by the broad phase.
+    struct cODEPair
+    {
+        //! First geometry.
+        dGeomID m_geom1;
+
+        //! Second geometry.
+        dGeomID m_geom2;
+
+        //! Number of contacts found between both geometries.
+        int m_numContacts;
+    };
+
+    //! Number of threads (including the calling thread).
+    unsigned int m_numThreads;
+
+    //! Pairs of primitive geometries processed by all threads.
+    std::vector<cODEPair> m_pairs;
+
+    //! Pairs of geometries processed by the calling thread only.
+    std::vector<cODEPair> m_serialPairs;
+
+    //! Contact buffer of pairs processed by all threads.
+    std::vector<dContact> m_pairContacts;
+
+    //! Contact buffer of pairs processed by the calling thread.
+    std::vector<dContact> m_serialPairContacts;
+
+    //! Index of next pair to be processed by a thread.
+    std::atomic<int> m_nextPair;
+
+    //! Pool of threads computing contacts.
+    chai3d::cThreadPool m_threadPool;
+
 
     //-----------------------------------------------------------------------
     // PROTECTED METHODS:
@@ -172,6 +357,21 @@ protected:
     //! This method is an ODE callback that reports collisions.
     static void nearCallback (void *data, dGeomID o1, dGeomID o2);
 
+    //! This method replaces the collision space and moves all geometries to it.
+    void setSpace(dSpaceID a_space, cODEBroadphaseType a_type);
+
+    //! This method computes all contacts and creates the contact joints.
+    void computeContacts();
+
+    //! This method computes contacts for the shared pairs until all are processed.
+    void processPairs();
+
+    //! This method computes contacts for the pairs which cannot be processed concurrently.
+    void processSerialPairs();
+
+    //! This method creates contact joints for contacts found between two geometries.
+    void createContactJoints(dContact* a_contacts, const int a_numContacts);
+
     //! This method render graphically all objects in the world.
     virtual void render(chai3d::cRenderOptions& a_options);
 };
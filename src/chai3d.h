@@ -186,6 +186,7 @@
 //---------------------------------------------------------------------------  
 #include "display/CCamera.h"
 #include "display/CFrameBuffer.h"
+#include "display/CRenderQueue.h"
 #include "display/CViewport.h"
 
 
@@ -229,6 +230,7 @@
 #include "forces/CGenericForceAlgorithm.h"
 #include "forces/CAlgorithmFingerProxy.h"
 #include "forces/CAlgorithmPotentialField.h"
+#include "forces/CAlgorithmVoxmapPointShell.h"
 #include "forces/CInteractionBasics.h"
 
 
@@ -273,11 +275,13 @@
 //! \defgroup   system  System
 //! \brief      Implements general capabilities that are OS dependent.
 //---------------------------------------------------------------------------
+#include "system/CAllocationGuard.h"
 #include "system/CGenericType.h"
 #include "system/CGlobals.h"
 #include "system/CMutex.h"
 #include "system/CString.h"
 #include "system/CThread.h"
+#include "system/CThreadPool.h"
 
 
 //---------------------------------------------------------------------------
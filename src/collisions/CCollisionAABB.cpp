@@ -124,6 +124,7 @@ void cCollisionAABB::initialize(const cGenericArrayPtr a_elements, const double
 
     // store radius
     m_radius = a_radius;
+    m_radiusAroundElements = a_radius;
 
     // clear previous tree
     m_nodes.clear();
@@ -249,6 +250,84 @@ void cCollisionAABB::update()
 }
 
 
+//==============================================================================
+/*!
+    This method refits the bounding boxes of the collision tree to the current
+    position of the elements, without modifying the structure of the tree.
+    The bounding box of each leaf is fitted to its element, then the bounding
+    box of each internal node is fitted to its two children.
+
+    This method is much faster than \ref update() and should be called when
+    the vertices of a deformable model move, but no element is added or 
+    removed. If the number of elements has changed, the tree is rebuilt.
+    After large deformations, the boxes of a refitted tree may overlap more 
+    than those of a rebuilt tree, which makes collision queries slower.
+*/
+//==============================================================================
+void cCollisionAABB::refit()
+{
+    // sanity check
+    if ((m_elements == nullptr) || (m_rootIndex == -1))
+    {
+        update();
+        return;
+    }
+
+    // rebuild tree if elements were added or removed
+    if ((int)(m_elements->getNumElements()) != m_numElements)
+    {
+        update();
+        return;
+    }
+
+    // get number of vertices per element
+    int numVerticesPerElement = m_elements->getNumVerticesPerElement();
+
+    // refit leaf nodes (leaves are stored first)
+    for (int i=0; i<m_numElements; ++i)
+    {
+        cCollisionAABBNode& leaf = m_nodes[i];
+        int element = leaf.m_leftSubTree;
+
+        switch (numVerticesPerElement)
+        {
+        case 1:
+            {
+                cVector3d vertex0 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+                leaf.fitBBox(m_radius, vertex0);
+                break;
+            }
+
+        case 2:
+            {
+                cVector3d vertex0 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+                cVector3d vertex1 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 1));
+                leaf.fitBBox(m_radius, vertex0, vertex1);
+                break;
+            }
+
+        case 3:
+            {
+                cVector3d vertex0 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+                cVector3d vertex1 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 1));
+                cVector3d vertex2 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 2));
+                leaf.fitBBox(m_radius, vertex0, vertex1, vertex2);
+                break;
+            }
+        }
+    }
+
+    // refit internal nodes (each internal node is stored after its children)
+    int numNodes = (int)(m_nodes.size());
+    for (int i=m_numElements; i<numNodes; ++i)
+    {
+        cCollisionAABBNode& node = m_nodes[i];
+        node.m_bbox.enclose(m_nodes[node.m_leftSubTree].m_bbox,
+                            m_nodes[node.m_rightSubTree].m_bbox);
+    }
+}
+
+
 //==============================================================================
 /*!
     Given a __start__ and __end__ index value of leaf nodes, this method creates
@@ -399,9 +478,16 @@ bool cCollisionAABB::computeCollision(cGenericObject* a_object,
     // sanity check
     if (m_rootIndex == -1) { return (false); }
 
-    // init stack
-    std::vector<cCollisionAABBStack> stack;
-    stack.resize(m_maxDepth+1);
+    // init stack. the search stack is stored on the call stack so that no heap
+    // allocation occurs during the haptic loop, except for very deep trees.
+    cCollisionAABBStack localStack[C_AABB_MAX_LOCAL_STACK_DEPTH];
+    std::vector<cCollisionAABBStack> heapStack;
+    cCollisionAABBStack* stack = localStack;
+    if (m_maxDepth >= C_AABB_MAX_LOCAL_STACK_DEPTH)
+    {
+        heapStack.resize(m_maxDepth+1);
+        stack = &heapStack[0];
+    }
 
     int index = 0;
     stack[0].m_index = m_rootIndex;
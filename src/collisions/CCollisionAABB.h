@@ -67,6 +67,11 @@ namespace chai3d {
 */
 //==============================================================================
 
+//------------------------------------------------------------------------------
+//! Maximum tree depth for which the collision search stack is kept on the call stack.
+const int C_AABB_MAX_LOCAL_STACK_DEPTH = 128;
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     \class      cCollisionAABB
@@ -119,6 +124,9 @@ public:
     //! This methods updates the collision detector and should be called if the 3D model it represents is modified.
     virtual void update();
 
+    //! This method refits the bounding boxes of the tree to the current position of the elements without rebuilding it.
+    void refit();
+
     //! This method computes all collisions between a segment passed as argument and the attributed 3D object.
     virtual bool computeCollision(cGenericObject* a_object,
                                   cVector3d& a_segmentPointA,
@@ -168,6 +168,12 @@ struct cCollisionEvent
 };
 
 
+//------------------------------------------------------------------------------
+//! Number of collision events preallocated by a collision recorder.
+const unsigned int C_COLLISION_RECORDER_DEFAULT_CAPACITY = 64;
+//------------------------------------------------------------------------------
+
+
 //==============================================================================
 /*!
     \class      cCollisionRecorder
@@ -179,7 +185,10 @@ struct cCollisionEvent
 
     \details
     This class implements a collision detection recorder that stores all collision
-    events that are reported by a collision detector.
+    events that are reported by a collision detector. Storage for 
+    \ref C_COLLISION_RECORDER_DEFAULT_CAPACITY events is preallocated, and 
+    clearing the recorder preserves its capacity, so that a recorder reused 
+    across haptic updates does not allocate memory.
 */
 //==============================================================================
 class cCollisionRecorder
@@ -191,7 +200,7 @@ class cCollisionRecorder
 public:
 
     //! Constructor of cCollisionRecorder
-    cCollisionRecorder() { clear(); }
+    cCollisionRecorder() { m_collisions.reserve(C_COLLISION_RECORDER_DEFAULT_CAPACITY); clear(); }
 
     //! Destructor of cCollisionRecorder
     virtual ~cCollisionRecorder() {};
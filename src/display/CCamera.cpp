@@ -118,6 +118,12 @@ cCamera::cCamera(cWorld* a_parentWorld)
     // disable multipass transparency rendering by default
     m_useMultipassTransparency = false;
 
+    // disable view frustum culling by default
+    m_useFrustumCulling = false;
+
+    // disable render queue by default
+    m_useRenderQueue = false;
+
     // reset display status
     m_markForUpdate = false;
 
@@ -1409,6 +1415,25 @@ void cCamera::renderView(const int a_windowWidth,
         // rendering options
         cRenderOptions options;
 
+        // determine which objects are located inside the view frustum. Visibility
+        // is computed once and shared by all rendering passes and stereo eyes.
+        if (m_useFrustumCulling && (m_parentWorld != NULL) && (i == 0))
+        {
+            computeViewFrustum(stereo == GL_TRUE, glAspect);
+            m_parentWorld->computeFrustumVisibility(this, cVector3d(0.0, 0.0, 0.0), cIdentity3d());
+        }
+
+        // build the render queue. The scene graph is traversed once and all
+        // rendering passes and stereo eyes are executed from the queue.
+        if (m_useRenderQueue && (m_parentWorld != NULL) && (i == 0))
+        {
+            options.m_markForUpdate = m_markForUpdate;
+            options.m_useFrustumCulling = m_useFrustumCulling;
+
+            cVector3d viewDir = -1.0 * m_globalRot.getCol0();
+            m_renderQueue.build(m_parentWorld, options, m_globalPos, viewDir);
+        }
+
         if (m_parentWorld != NULL)
         {
             // optionally perform multiple rendering passes for transparency
@@ -1437,9 +1462,14 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_shadow_light_level                    = 1.0 - m_parentWorld->getShadowIntensity();
                     options.m_storeObjectPositions                  = false;
                     options.m_markForUpdate                         = m_markForUpdate;
+                    options.m_useFrustumCulling                     = m_useFrustumCulling;
+                    options.m_keepTextureBound                      = false;
+                    options.m_keepShaderProgramBound                = false;
+                    options.m_boundTexture                          = NULL;
+                    options.m_boundShaderProgram                    = NULL;
 
                     // render 1st pass (opaque objects - shadowed regions)
-                    m_parentWorld->renderSceneGraph(options);
+                    renderWorld(options);
 
                     // setup rendering options
                     options.m_rendering_shadow                      = false;
@@ -1454,7 +1484,7 @@ void cCamera::renderView(const int a_windowWidth,
 
                         if (m_parentWorld != NULL)
                         {
-                            m_parentWorld->renderSceneGraph(options);
+                            renderWorld(options);
                         }
 
                         // restore states
@@ -1478,7 +1508,7 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_rendering_shadow                      = false;
 
                     // render 3rd pass (transparent objects - back faces only)
-                    m_parentWorld->renderSceneGraph(options);
+                    renderWorld(options);
 
                     // modify rendering options for third pass
                     options.m_render_opaque_objects_only            = false;
@@ -1488,7 +1518,7 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_shadow_light_level                    = 1.0 - m_parentWorld->getShadowIntensity();
 
                     // render 4th pass (transparent objects - front faces only - shadowed areas)
-                    m_parentWorld->renderSceneGraph(options);
+                    renderWorld(options);
                 
                     for(lst = m_parentWorld->m_shadowMaps.begin(); lst != m_parentWorld->m_shadowMaps.end(); ++lst)
                     {
@@ -1497,7 +1527,7 @@ void cCamera::renderView(const int a_windowWidth,
 
                         if (m_parentWorld != NULL)
                         {
-                            m_parentWorld->renderSceneGraph(options);
+                            renderWorld(options);
                         }
 
                         // restore states
@@ -1522,7 +1552,7 @@ void cCamera::renderView(const int a_windowWidth,
 
                         if (m_parentWorld != NULL)
                         {
-                            m_parentWorld->renderSceneGraph(options);
+                            renderWorld(options);
                         }
 
                         // restore states
@@ -1556,11 +1586,16 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_shadow_light_level                    = 1.0;
                     options.m_storeObjectPositions                  = true;
                     options.m_markForUpdate                         = m_markForUpdate;
+                    options.m_useFrustumCulling                     = m_useFrustumCulling;
+                    options.m_keepTextureBound                      = false;
+                    options.m_keepShaderProgramBound                = false;
+                    options.m_boundTexture                          = NULL;
+                    options.m_boundShaderProgram                    = NULL;
 
                     // render 1st pass (opaque objects - all faces)
                     if (m_parentWorld != NULL)
                     {
-                        m_parentWorld->renderSceneGraph(options);
+                        renderWorld(options);
                     }
 
                     // modify rendering options
@@ -1571,7 +1606,7 @@ void cCamera::renderView(const int a_windowWidth,
                     // render 2nd pass (transparent objects - back faces only)
                     if (m_parentWorld != NULL)
                     {
-                        m_parentWorld->renderSceneGraph(options);
+                        renderWorld(options);
                     }
 
                     // modify rendering options
@@ -1581,7 +1616,7 @@ void cCamera::renderView(const int a_windowWidth,
                     // render 3rd pass (transparent objects - front faces only)
                     if (m_parentWorld != NULL)
                     {
-                        m_parentWorld->renderSceneGraph(options);
+                        renderWorld(options);
                     }
                 }
             }
@@ -1606,9 +1641,14 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_shadow_light_level                    = 1.0 - m_parentWorld->getShadowIntensity();
                     options.m_storeObjectPositions                  = false;
                     options.m_markForUpdate                         = m_markForUpdate;
+                    options.m_useFrustumCulling                     = m_useFrustumCulling;
+                    options.m_keepTextureBound                      = false;
+                    options.m_keepShaderProgramBound                = false;
+                    options.m_boundTexture                          = NULL;
+                    options.m_boundShaderProgram                    = NULL;
 
                     // render 1st pass (opaque objects - all faces - shadowed regions)
-                    m_parentWorld->renderSceneGraph(options);
+                    renderWorld(options);
 
                     // setup rendering options
                     options.m_rendering_shadow                      = false;
@@ -1623,7 +1663,7 @@ void cCamera::renderView(const int a_windowWidth,
 
                         if (m_parentWorld != NULL)
                         {
-                            m_parentWorld->renderSceneGraph(options);
+                            renderWorld(options);
                         }
 
                         // restore states
@@ -1644,7 +1684,7 @@ void cCamera::renderView(const int a_windowWidth,
                     // render 3rd pass (transparent objects - all faces)
                     if (m_parentWorld != NULL)
                     {
-                        m_parentWorld->renderSceneGraph(options);
+                        renderWorld(options);
                     }
                 }
 
@@ -1668,11 +1708,16 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_shadow_light_level                    = 1.0;
                     options.m_storeObjectPositions                  = true;
                     options.m_markForUpdate                         = m_markForUpdate;
+                    options.m_useFrustumCulling                     = m_useFrustumCulling;
+                    options.m_keepTextureBound                      = false;
+                    options.m_keepShaderProgramBound                = false;
+                    options.m_boundTexture                          = NULL;
+                    options.m_boundShaderProgram                    = NULL;
 
                     // render single pass (all objects)
                     if (m_parentWorld != NULL)
                     {
-                        m_parentWorld->renderSceneGraph(options); 
+                        renderWorld(options);
                     }
                 }
             }
@@ -1776,6 +1821,186 @@ void cCamera::setUseMultipassTransparency(bool a_enabled)
 }
 
 
+//==============================================================================
+/*!
+    This method enables or disables view frustum culling. When this option is 
+    enabled (it's disabled by default), the boundary box of each object is 
+    tested against the view frustum of the camera before the scene is rendered,
+    and objects or entire subtrees located outside of the view are skipped 
+    during all rendering passes. \n
+
+    Culling relies on up-to-date boundary boxes. Objects that are modified
+    (for instance deformable meshes) should update their boundary box by 
+    calling computeBoundaryBox(). Objects with an empty boundary box are 
+    always rendered.
+
+    \param  a_enabled  If __true__, frustum culling is enabled, __false__ otherwise.
+*/
+//==============================================================================
+void cCamera::setUseFrustumCulling(const bool a_enabled)
+{
+    m_useFrustumCulling = a_enabled;
+}
+
+
+//==============================================================================
+/*!
+    This method enables or disables the render queue. When this option is 
+    enabled (it's disabled by default), the scene graph is traversed only once
+    each time the camera is asked to render the scene. Objects are collected 
+    in a render queue (see \ref cRenderQueue) and all rendering passes 
+    (multipass transparency, shadow casting and stereo eyes) are executed from
+    the queue. \n
+
+    Opaque objects are sorted by shader program and texture to reduce state 
+    changes, and transparent objects are rendered last, sorted from back to 
+    front. Since objects are no longer rendered in scene graph 
+    order, objects whose rendering depends on the order in which they are drawn
+    (for instance objects rendered without depth testing) may be affected.
+
+    \param  a_enabled  If __true__, the render queue is used, __false__ otherwise.
+*/
+//==============================================================================
+void cCamera::setUseRenderQueue(const bool a_enabled)
+{
+    m_useRenderQueue = a_enabled;
+}
+
+
+//==============================================================================
+/*!
+    This method renders the world for the rendering pass described by the 
+    rendering options, either by traversing the scene graph or from the render
+    queue when enabled.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cCamera::renderWorld(cRenderOptions& a_options)
+{
+    if (m_parentWorld == NULL) { return; }
+
+    if (m_useRenderQueue)
+    {
+        m_renderQueue.render(a_options);
+    }
+    else
+    {
+        m_parentWorld->renderSceneGraph(a_options);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if an axis-aligned box, expressed in world 
+    coordinates, intersects the view frustum computed during the most recent 
+    call to renderView() with frustum culling enabled. The test is 
+    conservative: boxes located near a corner of the frustum may be reported 
+    as visible.
+
+    \param  a_boxMin  Minimum corner of box.
+    \param  a_boxMax  Maximum corner of box.
+
+    \return __true__ if the box intersects the view frustum, __false__ otherwise.
+*/
+//==============================================================================
+bool cCamera::isBoxInViewFrustum(const cVector3d& a_boxMin, 
+                                 const cVector3d& a_boxMax) const
+{
+    for (int i=0; i<6; i++)
+    {
+        const cVector3d& normal = m_frustumPlaneNormals[i];
+
+        // select the box corner located furthest along the plane normal
+        cVector3d corner((normal(0) >= 0.0) ? a_boxMax(0) : a_boxMin(0),
+                         (normal(1) >= 0.0) ? a_boxMax(1) : a_boxMin(1),
+                         (normal(2) >= 0.0) ? a_boxMax(2) : a_boxMin(2));
+
+        // if this corner lies outside of the plane, the entire box does
+        if (cDot(normal, corner) + m_frustumPlaneOffsets[i] < 0.0)
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method computes the planes of the view frustum in world coordinates
+    from the current projection and modelview matrices. \n
+
+    When perspective stereo is used, a single frustum enclosing the view 
+    volumes of both eyes is computed, so that object visibility can be shared
+    by both eyes.
+
+    \param  a_stereo  If __true__, then stereo rendering is active.
+    \param  a_aspect  Aspect ratio of the viewport.
+*/
+//==============================================================================
+void cCamera::computeViewFrustum(const bool a_stereo, 
+                                 const double a_aspect)
+{
+    cTransform clip;
+
+    if (a_stereo && m_perspectiveMode)
+    {
+        // both eyes are offset sideways by half the eye separation and their 
+        // frustums converge at the focal length. The union of both view 
+        // volumes is contained in a symmetric frustum whose apex is moved 
+        // behind the camera.
+        double slopeV = tan(0.5 * cDegToRad(m_fieldViewAngleDeg));
+        double slopeH = a_aspect * slopeV + 0.5 * m_stereoEyeSeparation / m_stereoFocalLength;
+        double offset = 0.5 * m_stereoEyeSeparation / slopeH;
+
+        cVector3d lookv = -1.0 * m_globalRot.getCol0();
+        cVector3d upv = m_globalRot.getCol2();
+        cVector3d pos = m_globalPos - offset * lookv;
+
+        double n = m_distanceNear + offset;
+        double f = m_distanceFar + offset;
+
+        cTransform projection;
+        projection.setFrustumMatrix(-slopeH * n, slopeH * n, -slopeV * n, slopeV * n, n, f);
+
+        cTransform view;
+        view.setLookAtMatrix(pos, pos + lookv, upv);
+
+        clip = projection * view;
+    }
+    else
+    {
+        clip = m_projectionMatrix * m_modelViewMatrix;
+    }
+
+    // extract planes from the rows of the clip matrix (left, right, bottom, top, near, far)
+    for (int i=0; i<6; i++)
+    {
+        int row = i / 2;
+        double sign = (i % 2 == 0) ? 1.0 : -1.0;
+
+        cVector3d normal(clip(3,0) + sign * clip(row,0),
+                         clip(3,1) + sign * clip(row,1),
+                         clip(3,2) + sign * clip(row,2));
+        double offset = clip(3,3) + sign * clip(row,3);
+
+        // normalize plane equation
+        double length = normal.length();
+        if (length > 0.0)
+        {
+            normal.div(length);
+            offset = offset / length;
+        }
+
+        m_frustumPlaneNormals[i] = normal;
+        m_frustumPlaneOffsets[i] = offset;
+    }
+}
+
+
 //==============================================================================
 /*!
     This method automatically adjusts the front and back clipping planes to
@@ -1866,6 +2091,11 @@ void cCamera::renderLayer(cGenericObject* a_graph,
     options.m_shadow_light_level                    = 1.0;
     options.m_storeObjectPositions                  = true;
     options.m_markForUpdate                         = false;
+    options.m_useFrustumCulling                     = false;
+    options.m_keepTextureBound                      = false;
+    options.m_keepShaderProgramBound                = false;
+    options.m_boundTexture                          = NULL;
+    options.m_boundShaderProgram                    = NULL;
 
     // render light source
     glColorMaterial(GL_FRONT_AND_BACK,GL_AMBIENT_AND_DIFFUSE);
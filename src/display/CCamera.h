@@ -48,6 +48,7 @@
 //------------------------------------------------------------------------------
 #include "audio/CAudioDevice.h"
 #include "world/CGenericObject.h"
+#include "display/CRenderQueue.h"
 #include "math/CMaths.h"
 #include "graphics/CImage.h"
 //------------------------------------------------------------------------------
@@ -352,6 +353,21 @@ public:
     //! This method returns __true__ if multipass rendering is enabled, __false__ otherwise.
     bool getUseMultipassTransparency() { return (m_useMultipassTransparency); }
 
+    //! This method enables or disables view frustum culling of objects located outside of the camera view.
+    void setUseFrustumCulling(const bool a_enabled);
+
+    //! This method returns __true__ if view frustum culling is enabled, __false__ otherwise.
+    bool getUseFrustumCulling() const { return (m_useFrustumCulling); }
+
+    //! This method enables or disables the render queue used to execute all rendering passes from a single scene graph traversal.
+    void setUseRenderQueue(const bool a_enabled);
+
+    //! This method returns __true__ if the render queue is enabled, __false__ otherwise.
+    bool getUseRenderQueue() const { return (m_useRenderQueue); }
+
+    //! This method returns __true__ if an axis-aligned box expressed in world coordinates intersects the view frustum.
+    bool isBoxInViewFrustum(const cVector3d& a_boxMin, const cVector3d& a_boxMax) const;
+
     //! This method returns the width of the current window display in pixels.
     int getDisplayWidth() { return (m_lastDisplayWidth); }
 
@@ -456,6 +472,21 @@ protected:
     //! If __true__, then shadow casting is used.
     bool m_useShadowCasting;
 
+    //! If __true__, then objects located outside of the view frustum are not rendered.
+    bool m_useFrustumCulling;
+
+    //! Normals of view frustum planes in world coordinates. (left, right, bottom, top, near, far)
+    cVector3d m_frustumPlaneNormals[6];
+
+    //! Offsets of view frustum planes in world coordinates.
+    double m_frustumPlaneOffsets[6];
+
+    //! If __true__, then all rendering passes are executed from a render queue.
+    bool m_useRenderQueue;
+
+    //! Render queue built once per rendered view.
+    cRenderQueue m_renderQueue;
+
     //! Stereo focal length.
     double m_stereoFocalLength;
 
@@ -519,6 +550,12 @@ protected:
 
     //! Renders a 2D layer within this camera's view.
     void renderLayer(cGenericObject* a_graph, int a_width, int a_height);
+
+    //! This method computes the planes of the view frustum from the current camera settings.
+    void computeViewFrustum(const bool a_stereo, const double a_aspect);
+
+    //! This method renders the world for the current rendering pass.
+    void renderWorld(cRenderOptions& a_options);
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,292 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.3.0
+*/
+//==============================================================================
+
+
+//------------------------------------------------------------------------------
+#include "display/CRenderQueue.h"
+//------------------------------------------------------------------------------
+#include "world/CMesh.h"
+#include "shaders/CShaderProgram.h"
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <functional>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    This function defines the rendering order of two entries of a render queue.
+
+    \param  a_entry0  First entry.
+    \param  a_entry1  Second entry.
+
+    \return __true__ if \p a_entry0 should be rendered before \p a_entry1, __false__ otherwise.
+*/
+//==============================================================================
+static bool cRenderQueueOrder(const cRenderQueueEntry& a_entry0, 
+                              const cRenderQueueEntry& a_entry1)
+{
+    // the root of the scene graph is rendered first
+    if (a_entry0.m_root != a_entry1.m_root)
+    {
+        return (a_entry0.m_root);
+    }
+
+    // opaque objects are rendered before transparent objects
+    if (a_entry0.m_transparent != a_entry1.m_transparent)
+    {
+        return (!a_entry0.m_transparent);
+    }
+
+    // transparent objects are sorted from back to front
+    if (a_entry0.m_transparent)
+    {
+        return (a_entry0.m_depth > a_entry1.m_depth);
+    }
+
+    // opaque objects are grouped by shader program and texture
+    less<const void*> order;
+    if (a_entry0.m_shaderProgram != a_entry1.m_shaderProgram)
+    {
+        return (order(a_entry0.m_shaderProgram, a_entry1.m_shaderProgram));
+    }
+    if (a_entry0.m_texture != a_entry1.m_texture)
+    {
+        return (order(a_entry0.m_texture, a_entry1.m_texture));
+    }
+
+    // within each group, objects keep their scene graph order
+    return (false);
+}
+
+
+//==============================================================================
+/*!
+    This method builds the queue by traversing the scene graph once, starting 
+    at object \p a_root, and sorts it according to the rendering state of each 
+    object and, for transparent objects, their distance to the camera.
+
+    \param  a_root     Root of the scene graph.
+    \param  a_options  Rendering options. (display reset and frustum culling)
+    \param  a_viewPos  Position of the camera in world coordinates.
+    \param  a_viewDir  Viewing direction of the camera in world coordinates.
+*/
+//==============================================================================
+void cRenderQueue::build(cGenericObject* a_root,
+                         cRenderOptions& a_options,
+                         const cVector3d& a_viewPos,
+                         const cVector3d& a_viewDir)
+{
+    // clear previous content while preserving allocated memory
+    clear();
+
+    if (a_root == NULL) { return; }
+
+    // collect objects
+    m_root = a_root;
+    cTransform frame;
+    frame.identity();
+    a_root->enqueueSceneGraph(*this, frame, a_options);
+
+    // compute depth of each object
+    for (unsigned int i=0; i<m_entries.size(); i++)
+    {
+        cRenderQueueEntry& entry = m_entries[i];
+
+        cVector3d center;
+        if (entry.m_object->getBoundaryBoxEmpty())
+        {
+            center = entry.m_frame.getLocalPos();
+        }
+        else
+        {
+            entry.m_frame.mulr(entry.m_object->getBoundaryCenter(), center);
+        }
+
+        entry.m_depth = cDot(center - a_viewPos, a_viewDir);
+    }
+
+    // sort queue
+    stable_sort(m_entries.begin(), m_entries.end(), cRenderQueueOrder);
+}
+
+
+//==============================================================================
+/*!
+    This method adds an object to the queue together with its position and 
+    orientation in world coordinates. The rendering state of the object is
+    recorded for sorting.
+
+    \param  a_object  Object to be rendered.
+    \param  a_frame   Position and orientation of object in world coordinates.
+*/
+//==============================================================================
+void cRenderQueue::add(cGenericObject* a_object, const cTransform& a_frame)
+{
+    cRenderQueueEntry entry;
+    entry.m_object          = a_object;
+    entry.m_frame           = a_frame;
+    entry.m_root            = (a_object == m_root);
+    entry.m_transparent     = a_object->getUseTransparency();
+    entry.m_transparentParts = a_object->hasTransparentParts();
+    entry.m_shaderProgram   = a_object->getShaderProgram().get();
+    entry.m_texture         = a_object->getUseTexture() ? a_object->m_texture.get() : NULL;
+    entry.m_depth           = 0.0;
+
+    // meshes that render no additional primitives (boundary box, frame, normals,
+    // edges...) around their triangles can share bound states with neighbours
+    cMesh* mesh = dynamic_cast<cMesh*>(a_object);
+    entry.m_shareStates     = (mesh != NULL) &&
+                              !mesh->getShowBoundaryBox() &&
+                              !mesh->getShowFrame() &&
+                              !mesh->getShowCollisionDetector() &&
+                              !mesh->getShowNormals() &&
+                              !mesh->getShowTangents() &&
+                              !(mesh->getShowEdges() && !mesh->m_edges.empty());
+
+    m_entries.push_back(entry);
+}
+
+
+//==============================================================================
+/*!
+    This method renders all objects of the queue for the rendering pass 
+    described by the rendering options. The current modelview matrix must 
+    describe the view of the camera (world coordinates) and is left unchanged.\n
+
+    When the next object rendered during the pass is a mesh using the same 
+    texture or shader program, the current mesh is told through the rendering
+    options to leave that state bound, and the next mesh skips setting it up 
+    again. All states are released before this method returns.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cRenderQueue::render(cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+
+    // retrieve view matrix
+    cTransform view;
+    glGetDoublev(GL_MODELVIEW_MATRIX, view.getData());
+
+    // check if only transparent parts are rendered during this pass
+    bool transparentPass = !SECTION_RENDER_OPAQUE_PARTS_ONLY(a_options);
+
+    glPushMatrix();
+
+    // no state is bound at the beginning of the pass
+    a_options.m_boundTexture = NULL;
+    a_options.m_boundShaderProgram = NULL;
+
+    unsigned int numEntries = (unsigned int)(m_entries.size());
+    for (unsigned int i=0; i<numEntries; i++)
+    {
+        cRenderQueueEntry& entry = m_entries[i];
+
+        // skip objects that render nothing during transparent passes
+        if (transparentPass && !entry.m_transparentParts)
+        {
+            continue;
+        }
+
+        // find next object rendered during this pass
+        const cRenderQueueEntry* next = NULL;
+        for (unsigned int j=i+1; j<numEntries; j++)
+        {
+            if (!transparentPass || m_entries[j].m_transparentParts)
+            {
+                next = &m_entries[j];
+                break;
+            }
+        }
+
+        // release states that are not used by this object
+        if (a_options.m_boundTexture != entry.m_texture)
+        {
+            a_options.m_boundTexture = NULL;
+        }
+        if ((a_options.m_boundShaderProgram != NULL) && (a_options.m_boundShaderProgram != entry.m_shaderProgram))
+        {
+            a_options.m_boundShaderProgram->disable();
+            a_options.m_boundShaderProgram = NULL;
+        }
+
+        // let the object leave its states bound if the next object shares them
+        bool share = entry.m_shareStates && (next != NULL) && next->m_shareStates;
+        a_options.m_keepTextureBound = share && (entry.m_texture != NULL) && (next->m_texture == entry.m_texture);
+        a_options.m_keepShaderProgramBound = share && (entry.m_shaderProgram != NULL) && (next->m_shaderProgram == entry.m_shaderProgram);
+
+        // set position and orientation of object
+        cTransform modelView;
+        view.mulr(entry.m_frame, modelView);
+        glLoadMatrixd(modelView.getData());
+
+        // render object
+        entry.m_object->renderObject(a_options);
+    }
+
+    // release remaining states
+    if (a_options.m_boundShaderProgram != NULL)
+    {
+        a_options.m_boundShaderProgram->disable();
+    }
+    a_options.m_keepTextureBound = false;
+    a_options.m_keepShaderProgramBound = false;
+    a_options.m_boundTexture = NULL;
+    a_options.m_boundShaderProgram = NULL;
+
+    glPopMatrix();
+
+#endif
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,204 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.3.0
+*/
+//==============================================================================
+
+
+//------------------------------------------------------------------------------
+#ifndef CRenderQueueH
+#define CRenderQueueH
+//------------------------------------------------------------------------------
+#include "graphics/CRenderOptions.h"
+#include "math/CTransform.h"
+#include "math/CVector3d.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+class cGenericObject;
+class cGenericTexture;
+class cShaderProgram;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CRenderQueue.h
+
+    \brief
+    Implements a render queue for rendering a scene graph in multiple passes.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \struct     cRenderQueueEntry
+    \ingroup    display
+
+    \brief
+    This structure describes an object stored in a render queue.
+*/
+//==============================================================================
+struct cRenderQueueEntry
+{
+    //! Object to be rendered.
+    cGenericObject* m_object;
+
+    //! Position and orientation of object in world coordinates.
+    cTransform m_frame;
+
+    //! If __true__, then this entry is the root of the scene graph and is rendered first.
+    bool m_root;
+
+    //! If __true__, then the object uses transparency and is rendered after opaque objects.
+    bool m_transparent;
+
+    //! If __false__, then the object renders nothing during transparent rendering passes and is skipped.
+    bool m_transparentParts;
+
+    //! Shader program used by the object, or __NULL__ if none.
+    cShaderProgram* m_shaderProgram;
+
+    //! Texture used by the object, or __NULL__ if none.
+    cGenericTexture* m_texture;
+
+    //! If __true__, then the object is a mesh that can leave its texture and shader program bound for the next object.
+    bool m_shareStates;
+
+    //! Distance from the camera to the object along the viewing direction.
+    double m_depth;
+};
+
+
+//==============================================================================
+/*!
+    \class      cRenderQueue
+    \ingroup    display
+
+    \brief
+    This class implements a render queue.
+
+    \details
+    A render queue collects the objects of a scene graph in a single traversal
+    (see \ref cGenericObject::enqueueSceneGraph()) together with their 
+    position in world coordinates. Once sorted, the queue can be rendered 
+    any number of times, for instance once per rendering pass when multipass
+    transparency or shadow casting is used, without traversing the scene graph
+    again. \n
+
+    Opaque objects are sorted by shader program and texture so that objects 
+    sharing these states are drawn consecutively, while keeping their scene 
+    graph order within each group. When consecutive meshes share a texture 
+    or a shader program, the state is left bound from one mesh to the next
+    instead of being set up and released for every object (see 
+    \ref cRenderOptions::m_boundTexture and 
+    \ref cRenderOptions::m_boundShaderProgram). Transparent objects are rendered after all
+    opaque objects and sorted from back to front. The root of the 
+    scene graph (the world), which sets up light sources and fog, is always 
+    rendered first. Objects that render nothing during transparent rendering
+    passes (see \ref cGenericObject::hasTransparentParts()) are skipped 
+    during these passes.
+*/
+//==============================================================================
+class cRenderQueue
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cRenderQueue.
+    cRenderQueue() { m_root = NULL; }
+
+    //! Destructor of cRenderQueue.
+    virtual ~cRenderQueue() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method builds and sorts the queue from a scene graph.
+    void build(cGenericObject* a_root,
+               cRenderOptions& a_options,
+               const cVector3d& a_viewPos,
+               const cVector3d& a_viewDir);
+
+    //! This method adds an object to the queue.
+    void add(cGenericObject* a_object, const cTransform& a_frame);
+
+    //! This method clears the queue.
+    void clear() { m_entries.clear(); m_root = NULL; }
+
+    //! This method renders all objects of the queue for the rendering pass described by the rendering options.
+    void render(cRenderOptions& a_options);
+
+    //! This method returns the number of objects in the queue.
+    unsigned int getNumEntries() const { return ((unsigned int)(m_entries.size())); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Objects of the queue.
+    std::vector<cRenderQueueEntry> m_entries;
+
+    //! Root of the scene graph from which the queue was built.
+    cGenericObject* m_root;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
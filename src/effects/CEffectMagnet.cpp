@@ -134,6 +134,26 @@ bool cEffectMagnet::computeForce(const cVector3d& a_toolPos,
 }
 
 
+//==============================================================================
+/*!
+    This method returns the largest distance from the surface of the object
+    at which the magnetic effect may produce a force. This distance is 
+    defined by the magnetic properties of the material of the object.
+
+    \return Maximum distance of influence.
+*/
+//==============================================================================
+double cEffectMagnet::getMaxInfluenceDistance()
+{
+    if (m_parent->m_material == nullptr)
+    {
+        return (0.0);
+    }
+
+    return (cMax(0.0, m_parent->m_material->getMagnetMaxDistance()));
+}
+
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
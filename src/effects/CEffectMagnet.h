@@ -101,6 +101,9 @@ public:
                       const unsigned int& a_toolID,
                       cVector3d& a_reactionForce);
 
+    //! This method returns the largest distance from the surface of the object at which this effect may produce a force.
+    virtual double getMaxInfluenceDistance();
+
     //! This method enables or disables the magnetic effect when the tool is located inside the object.
     void setEnabledInside(const bool a_enabled) { m_enabledInside = a_enabled; }
 
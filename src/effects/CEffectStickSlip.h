@@ -124,6 +124,9 @@ public:
                       const unsigned int& a_toolID,
                       cVector3d& a_reactionForce);
 
+    //! This method returns the largest distance from the surface of the object at which this effect may produce a force.
+    virtual double getMaxInfluenceDistance() { return (0.0); }
+
 
     //--------------------------------------------------------------------------
     // MEMBERS:
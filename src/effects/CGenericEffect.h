@@ -145,6 +145,9 @@ public:
                                   return (false);
                               }
 
+    //! This method returns the largest distance from the surface of the object at which this effect may produce a force.
+    virtual double getMaxInfluenceDistance() { return (C_LARGE); }
+
     //! This method enables or disables this effect.
     inline void setEnabled(bool a_enabled) { m_enabled = a_enabled; }
 
@@ -339,7 +339,7 @@ void cAlgorithmFingerProxy::adjustDynamicProxy(const cVector3d& a_goal)
     collisionSettings.m_collisionRadius = m_radius;
 
     // setup recorder
-    cCollisionRecorder collisionRecorder;
+    cCollisionRecorder& collisionRecorder = m_collisionRecorderDynamicProxy;
     collisionRecorder.clear();
 
     cVector3d nextProxyOffset(0.0, 0.0, 0.0);
@@ -1190,55 +1190,9 @@ void cAlgorithmFingerProxy::updateForce()
                     cVector3d gradientSurface(0,0,0);
                     cVector3d gradientTexture;
 
-                    // pixel and colors
-                    cColorb color00, color01, color10, color11;
-                    int pixelX0, pixelX1;
-                    int pixelY0, pixelY1;
-
-                    // image size
-                    int w = normalMap->m_image->getWidth();
-                    int h = normalMap->m_image->getHeight();
-
-                    // compute nearest pixels along the X axis.
-                    double px = (w-1) * texCoord(0);
-                    double py = (h-1) * texCoord(1);
-
-                    pixelX0 = (int)(floor(px));
-                    pixelY0 = (int)(floor(py));
-                    pixelX1 = cClamp(pixelX0+1, 0, (w-1));
-                    pixelY1 = cClamp(pixelY0+1, 0, (h-1));
-
-                    // get normals from 
-                    normalMap->m_image->getPixelColor(pixelX0, pixelY0, color00);
-                    normalMap->m_image->getPixelColor(pixelX1, pixelY0, color10);
-                    normalMap->m_image->getPixelColor(pixelX1, pixelY1, color11);
-                    normalMap->m_image->getPixelColor(pixelX0, pixelY1, color01);
-
-                    // compute relative position within 4 texels
-                    double x = px - floor(px);
-                    double y = py - floor(py);
-
-                    const double SCALE = (1.0/255.0);
-                    double fX00 = SCALE * (color00.getR() - 128);
-                    double fY00 = SCALE * (color00.getG() - 128);
-                    double fZ00 = SCALE * (color00.getB() - 128);
-                    double fX01 = SCALE * (color01.getR() - 128);
-                    double fY01 = SCALE * (color01.getG() - 128);
-                    double fZ01 = SCALE * (color01.getB() - 128);
-                    double fX10 = SCALE * (color10.getR() - 128);
-                    double fY10 = SCALE * (color10.getG() - 128);
-                    double fZ10 = SCALE * (color10.getB() - 128);
-                    double fX11 = SCALE * (color11.getR() - 128);
-                    double fY11 = SCALE * (color11.getG() - 128);
-                    double fZ11 = SCALE * (color11.getB() - 128);
-
-                    // bilinear interpolation
-                    double fX = fX00 * (1-x)*(1-y) + fX10*x*(1-y) + fX01*(1-x)*y + fX11*x*y;
-                    double fY = fY00 * (1-x)*(1-y) + fY10*x*(1-y) + fY01*(1-x)*y + fY11*x*y;
-                    double fZ = fZ00 * (1-x)*(1-y) + fZ10*x*(1-y) + fZ01*(1-x)*y + fZ11*x*y;
-
-                    // assign gradient
-                    gradientTexture.set(fX, fY, fZ);
+                    // sample gradient from the haptic field published by the graphics side (bilinear interpolation)
+                    double height = 0.0;
+                    normalMap->sampleHapticField(texCoord(0), texCoord(1), gradientTexture, height);
 
                     // boolean used to inform us if the projection succeeds
                     bool success = false;
@@ -276,6 +276,9 @@ protected:
     //! Collision detection recorder for searching third constraint.
     cCollisionRecorder m_collisionRecorderConstraint2;
 
+    //! Collision detection recorder for detecting objects moving into the proxy.
+    cCollisionRecorder m_collisionRecorderDynamicProxy;
+
     //! Local position of contact point first object.
     cVector3d m_contactPointLocalPos0;
 
@@ -95,7 +95,8 @@ cVector3d cAlgorithmPotentialField::computeForces(const cVector3d& a_toolPos,
         force = m_world->computeInteractions(a_toolPos,
                                              a_toolVel,
                                              m_IDN,
-                                             m_interactionRecorder);
+                                             m_interactionRecorder,
+                                             m_world->getUseInteractionCulling());
     }
 
     // return resulting force
@@ -0,0 +1,808 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.3.0
+*/
+//==============================================================================
+
+
+//------------------------------------------------------------------------------
+#include "forces/CAlgorithmVoxmapPointShell.h"
+//------------------------------------------------------------------------------
+#include "world/CMesh.h"
+#include "world/CWorld.h"
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+//------------------------------------------------------------------------------
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define C_VOXMAP_USE_SSE2
+#include <emmintrin.h>
+#endif
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Number of points transformed and looked up per block during force computation.
+const int C_VOXMAP_POINT_BLOCK_SIZE = 64;
+
+// Temporary label assigned to interior voxels before distance layers are computed.
+const signed char C_VOXMAP_INTERIOR_UNVISITED = -127;
+
+// Deepest interior distance layer stored in the voxmap.
+const signed char C_VOXMAP_INTERIOR_MAX = -126;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    This function collects all meshes contained in an object, its children 
+    and its components (for instance the meshes of a \ref cMultiMesh).
+
+    \param  a_object  Root object.
+    \param  a_meshes  List of meshes to which meshes are appended.
+*/
+//==============================================================================
+static void cCollectMeshes(cGenericObject* a_object, vector<cMesh*>& a_meshes)
+{
+    if (a_object == NULL) { return; }
+
+    cMesh* mesh = dynamic_cast<cMesh*>(a_object);
+    if (mesh != NULL)
+    {
+        a_meshes.push_back(mesh);
+    }
+
+    unsigned int numChildren = a_object->getNumChildren();
+    for (unsigned int i=0; i<numChildren; i++)
+    {
+        cCollectMeshes(a_object->getChild(i), a_meshes);
+    }
+
+    unsigned int numComponents = a_object->getNumComponents();
+    for (unsigned int i=0; i<numComponents; i++)
+    {
+        cCollectMeshes(a_object->getComponent(i), a_meshes);
+    }
+}
+
+
+//==============================================================================
+/*!
+    Constructor of cAlgorithmVoxmapPointShell.
+*/
+//==============================================================================
+cAlgorithmVoxmapPointShell::cAlgorithmVoxmapPointShell()
+{
+    // voxmap
+    m_voxmapOrigin.zero();
+    m_voxelSize = 0.0;
+    m_numDistanceLayers = 0;
+    m_sizeX = 0;
+    m_sizeY = 0;
+    m_sizeZ = 0;
+
+    // force model
+    m_stiffness = 1000.0f;
+    m_damping = 0.0f;
+    m_contactAveragingThreshold = 10;
+    m_toolRot.identity();
+    m_lastGlobalForce.zero();
+    m_lastGlobalTorque.zero();
+    m_numContacts = 0;
+    m_minDistanceLayer = C_VOXMAP_FREE;
+
+    // graphic rendering
+    m_showEnabled = false;
+}
+
+
+//==============================================================================
+/*!
+    This method initializes the algorithm. The point shell is evaluated once 
+    at the initial position of the tool, using the last known orientation, 
+    so that the contact state (\ref getNumContacts(), 
+    \ref getMinDistanceLayer()) and the last computed force and torque 
+    describe the starting pose before the first haptic update.
+
+    \param  a_world       World in which the tool operates.
+    \param  a_initialPos  Initial position of the tool.
+*/
+//==============================================================================
+void cAlgorithmVoxmapPointShell::initialize(cWorld* a_world, const cVector3d& a_initialPos)
+{
+    m_world = a_world;
+    computeForces(a_initialPos, m_toolRot, cVector3d(0.0, 0.0, 0.0));
+}
+
+
+//==============================================================================
+/*!
+    This method voxelizes all meshes contained in an object and its children 
+    into the voxmap. Mesh vertices are expressed in world coordinates, 
+    therefore global positions of the object must be up to date when calling
+    this method.\n
+
+    Surface voxels are obtained by sampling each triangle at half the voxel 
+    size. Voxels that cannot be reached from outside the model are then 
+    labelled as interior voxels, and distance layers are finally propagated
+    from the surface.
+
+    \param  a_object             Object to voxelize.
+    \param  a_voxelSize          Size of a voxel.
+    \param  a_numDistanceLayers  Number of free space distance layers (1 to 126).
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cAlgorithmVoxmapPointShell::voxelize(cGenericObject* a_object, 
+                                          const double a_voxelSize, 
+                                          const unsigned int a_numDistanceLayers)
+{
+    // sanity check
+    if ((a_object == NULL) || (a_voxelSize <= 0.0) || (a_numDistanceLayers == 0) || (a_numDistanceLayers > 126))
+    {
+        return (C_ERROR);
+    }
+
+    clearVoxmap();
+
+    // collect meshes
+    vector<cMesh*> meshes;
+    cCollectMeshes(a_object, meshes);
+
+    // compute boundary box of all meshes in world coordinates
+    cVector3d boxMin( C_LARGE,  C_LARGE,  C_LARGE);
+    cVector3d boxMax(-C_LARGE, -C_LARGE, -C_LARGE);
+    bool empty = true;
+    for (unsigned int i=0; i<meshes.size(); i++)
+    {
+        cMesh* mesh = meshes[i];
+        cVector3d pos = mesh->getGlobalPos();
+        cMatrix3d rot = mesh->getGlobalRot();
+        unsigned int numVertices = mesh->getNumVertices();
+        for (unsigned int j=0; j<numVertices; j++)
+        {
+            cVector3d vertex = pos + rot * mesh->m_vertices->getLocalPos(j);
+            boxMin.set(cMin(boxMin.x(), vertex.x()), cMin(boxMin.y(), vertex.y()), cMin(boxMin.z(), vertex.z()));
+            boxMax.set(cMax(boxMax.x(), vertex.x()), cMax(boxMax.y(), vertex.y()), cMax(boxMax.z(), vertex.z()));
+            empty = false;
+        }
+    }
+
+    if (empty)
+    {
+        return (C_ERROR);
+    }
+
+    // add padding so that distance layers and exterior flood fill fit in the voxmap
+    int padding = (int)a_numDistanceLayers + 1;
+    cVector3d size = boxMax - boxMin;
+    m_sizeX = (int)ceil(size.x() / a_voxelSize) + 2 * padding + 1;
+    m_sizeY = (int)ceil(size.y() / a_voxelSize) + 2 * padding + 1;
+    m_sizeZ = (int)ceil(size.z() / a_voxelSize) + 2 * padding + 1;
+    m_voxelSize = a_voxelSize;
+    m_numDistanceLayers = a_numDistanceLayers;
+    m_voxmapOrigin = boxMin - cVector3d(padding * a_voxelSize, padding * a_voxelSize, padding * a_voxelSize);
+
+    // allocate voxmap
+    m_voxmap.assign((size_t)m_sizeX * (size_t)m_sizeY * (size_t)m_sizeZ, C_VOXMAP_FREE);
+
+    // rasterize triangles into surface voxels
+    double invVoxelSize = 1.0 / a_voxelSize;
+    double delta = 0.5 * a_voxelSize;
+    for (unsigned int i=0; i<meshes.size(); i++)
+    {
+        cMesh* mesh = meshes[i];
+        cVector3d pos = mesh->getGlobalPos();
+        cMatrix3d rot = mesh->getGlobalRot();
+        unsigned int numTriangles = mesh->getNumTriangles();
+        for (unsigned int j=0; j<numTriangles; j++)
+        {
+            if (!mesh->m_triangles->getAllocated(j)) { continue; }
+
+            // get vertex positions
+            cVector3d vertex0 = pos + rot * mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex0(j)) - m_voxmapOrigin;
+            cVector3d vertex1 = pos + rot * mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex1(j)) - m_voxmapOrigin;
+            cVector3d vertex2 = pos + rot * mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex2(j)) - m_voxmapOrigin;
+
+            // compute two edge vectors
+            cVector3d vec01 = vertex1 - vertex0;
+            cVector3d vec02 = vertex2 - vertex0;
+
+            // compute delta step for each edge vector
+            double delta01 = 1.0 / cMax(1.0, ceil(vec01.length() / delta));
+            double delta02 = 1.0 / cMax(1.0, ceil(vec02.length() / delta));
+
+            for (double relPos01 = 0.0; relPos01 <= 1.0 + C_SMALL; relPos01 += delta01)
+            {
+                double limit02 = 1.0 - relPos01 + C_SMALL;
+                for (double relPos02 = 0.0; relPos02 <= limit02; relPos02 += delta02)
+                {
+                    cVector3d point = vertex0 + relPos01 * vec01 + relPos02 * vec02;
+
+                    int x = cClamp((int)(point.x() * invVoxelSize), 0, m_sizeX - 1);
+                    int y = cClamp((int)(point.y() * invVoxelSize), 0, m_sizeY - 1);
+                    int z = cClamp((int)(point.z() * invVoxelSize), 0, m_sizeZ - 1);
+
+                    m_voxmap[((size_t)z * m_sizeY + y) * m_sizeX + x] = C_VOXMAP_SURFACE;
+                }
+            }
+        }
+    }
+
+    // compute distance layers
+    computeDistanceLayers();
+
+    // return success
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method labels interior voxels and propagates distance layers from
+    the surface voxels using a breadth-first traversal. Free space voxels 
+    are labelled up to the number of distance layers, while interior voxels
+    store their (clamped) depth as a negative value.
+*/
+//==============================================================================
+void cAlgorithmVoxmapPointShell::computeDistanceLayers()
+{
+    const int strideY = m_sizeX;
+    const int strideZ = m_sizeX * m_sizeY;
+    const int numVoxels = (int)m_voxmap.size();
+    const int offsets[6] = { -1, 1, -strideY, strideY, -strideZ, strideZ };
+
+    // flood fill exterior from the first voxel, which always lies in the padding
+    vector<unsigned char> exterior(numVoxels, 0);
+    vector<int> queue;
+    queue.reserve(numVoxels / 4 + 1);
+    queue.push_back(0);
+    exterior[0] = 1;
+    size_t head = 0;
+    while (head < queue.size())
+    {
+        int index = queue[head++];
+        int x = index % m_sizeX;
+        int y = (index / m_sizeX) % m_sizeY;
+        int z = index / strideZ;
+
+        const bool valid[6] = { x > 0, x < m_sizeX - 1, y > 0, y < m_sizeY - 1, z > 0, z < m_sizeZ - 1 };
+        for (int k=0; k<6; k++)
+        {
+            if (!valid[k]) { continue; }
+            int next = index + offsets[k];
+            if ((exterior[next] == 0) && (m_voxmap[next] == C_VOXMAP_FREE))
+            {
+                exterior[next] = 1;
+                queue.push_back(next);
+            }
+        }
+    }
+
+    // label interior voxels and seed distance propagation with surface voxels
+    queue.clear();
+    for (int i=0; i<numVoxels; i++)
+    {
+        if (m_voxmap[i] == C_VOXMAP_SURFACE)
+        {
+            queue.push_back(i);
+        }
+        else if (exterior[i] == 0)
+        {
+            m_voxmap[i] = C_VOXMAP_INTERIOR_UNVISITED;
+        }
+    }
+
+    // propagate distance layers from the surface
+    vector<int> distance(numVoxels, 0);
+    head = 0;
+    while (head < queue.size())
+    {
+        int index = queue[head++];
+        int layer = distance[index] + 1;
+        int x = index % m_sizeX;
+        int y = (index / m_sizeX) % m_sizeY;
+        int z = index / strideZ;
+
+        const bool valid[6] = { x > 0, x < m_sizeX - 1, y > 0, y < m_sizeY - 1, z > 0, z < m_sizeZ - 1 };
+        for (int k=0; k<6; k++)
+        {
+            if (!valid[k]) { continue; }
+            int next = index + offsets[k];
+            signed char value = m_voxmap[next];
+            if (value == C_VOXMAP_INTERIOR_UNVISITED)
+            {
+                m_voxmap[next] = (signed char)cMax(-layer, (int)C_VOXMAP_INTERIOR_MAX);
+                distance[next] = layer;
+                queue.push_back(next);
+            }
+            else if ((value == C_VOXMAP_FREE) && (exterior[next] == 1) && (layer <= (int)m_numDistanceLayers))
+            {
+                m_voxmap[next] = (signed char)layer;
+                exterior[next] = 2;
+                distance[next] = layer;
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method clears the voxmap.
+*/
+//==============================================================================
+void cAlgorithmVoxmapPointShell::clearVoxmap()
+{
+    m_voxmap.clear();
+    m_voxmapOrigin.zero();
+    m_voxelSize = 0.0;
+    m_numDistanceLayers = 0;
+    m_sizeX = 0;
+    m_sizeY = 0;
+    m_sizeZ = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the voxmap value at a given position. Positions 
+    located outside of the voxmap are reported as free space.
+
+    \param  a_globalPos  Position in world coordinates.
+
+    \return Voxmap value.
+*/
+//==============================================================================
+signed char cAlgorithmVoxmapPointShell::getVoxmapValue(const cVector3d& a_globalPos) const
+{
+    if (m_voxmap.empty()) { return (C_VOXMAP_FREE); }
+
+    cVector3d pos = (a_globalPos - m_voxmapOrigin) / m_voxelSize;
+    int x = (int)floor(pos.x());
+    int y = (int)floor(pos.y());
+    int z = (int)floor(pos.z());
+
+    if ((x < 0) || (y < 0) || (z < 0) || (x >= m_sizeX) || (y >= m_sizeY) || (z >= m_sizeZ))
+    {
+        return (C_VOXMAP_FREE);
+    }
+
+    return (m_voxmap[((size_t)z * m_sizeY + y) * m_sizeX + x]);
+}
+
+
+//==============================================================================
+/*!
+    This method samples the triangles of all meshes contained in an object and
+    its children. Points and face normals are expressed in a reference frame.
+
+    \param  a_object   Root object.
+    \param  a_refPos   Position of the reference frame in world coordinates.
+    \param  a_refRot   Orientation of the reference frame in world coordinates.
+    \param  a_spacing  Distance between two sampled points.
+    \param  a_points   Sampled points.
+    \param  a_normals  Normals of sampled points.
+*/
+//==============================================================================
+void cAlgorithmVoxmapPointShell::sampleMesh(cGenericObject* a_object,
+                                            const cVector3d& a_refPos,
+                                            const cMatrix3d& a_refRot,
+                                            const double a_spacing,
+                                            vector<cVector3d>& a_points,
+                                            vector<cVector3d>& a_normals)
+{
+    vector<cMesh*> meshes;
+    cCollectMeshes(a_object, meshes);
+
+    cMatrix3d refRotT;
+    a_refRot.transr(refRotT);
+
+    for (unsigned int i=0; i<meshes.size(); i++)
+    {
+        cMesh* mesh = meshes[i];
+
+        // transformation from mesh to reference frame
+        cMatrix3d rot = refRotT * mesh->getGlobalRot();
+        cVector3d pos = refRotT * (mesh->getGlobalPos() - a_refPos);
+
+        unsigned int numTriangles = mesh->getNumTriangles();
+        for (unsigned int j=0; j<numTriangles; j++)
+        {
+            if (!mesh->m_triangles->getAllocated(j)) { continue; }
+
+            cVector3d vertex0 = pos + rot * mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex0(j));
+            cVector3d vertex1 = pos + rot * mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex1(j));
+            cVector3d vertex2 = pos + rot * mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex2(j));
+
+            cVector3d vec01 = vertex1 - vertex0;
+            cVector3d vec02 = vertex2 - vertex0;
+            cVector3d normal = cCross(vec01, vec02);
+            if (normal.length() < C_TINY) { continue; }
+            normal.normalize();
+
+            double delta01 = 1.0 / cMax(1.0, ceil(vec01.length() / a_spacing));
+            double delta02 = 1.0 / cMax(1.0, ceil(vec02.length() / a_spacing));
+
+            for (double relPos01 = 0.0; relPos01 <= 1.0 + C_SMALL; relPos01 += delta01)
+            {
+                double limit02 = 1.0 - relPos01 + C_SMALL;
+                for (double relPos02 = 0.0; relPos02 <= limit02; relPos02 += delta02)
+                {
+                    a_points.push_back(vertex0 + relPos01 * vec01 + relPos02 * vec02);
+                    a_normals.push_back(normal);
+                }
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method builds the point shell by sampling the triangles of all meshes
+    contained in an object and its children. Points are expressed in the 
+    local frame of the object, which is considered to be the tool frame. 
+    Only one point is kept per cell of size __a_spacing__. Normals are taken
+    from the triangle faces, so triangles must be oriented counter-clockwise
+    when seen from the outside of the tool.
+
+    \param  a_object   Object describing the shape of the tool.
+    \param  a_spacing  Distance between two points of the point shell.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cAlgorithmVoxmapPointShell::buildPointShell(cGenericObject* a_object, const double a_spacing)
+{
+    // sanity check
+    if ((a_object == NULL) || (a_spacing <= 0.0))
+    {
+        return (C_ERROR);
+    }
+
+    clearPointShell();
+
+    // sample surface
+    vector<cVector3d> points;
+    vector<cVector3d> normals;
+    sampleMesh(a_object, a_object->getGlobalPos(), a_object->getGlobalRot(), 0.5 * a_spacing, points, normals);
+
+    if (points.empty())
+    {
+        return (C_ERROR);
+    }
+
+    // keep a single point per cell by sorting points by cell key
+    vector<pair<long long, unsigned int> > keys(points.size());
+    double invSpacing = 1.0 / a_spacing;
+    for (unsigned int i=0; i<points.size(); i++)
+    {
+        long long x = (long long)floor(points[i].x() * invSpacing) & 0x1FFFFF;
+        long long y = (long long)floor(points[i].y() * invSpacing) & 0x1FFFFF;
+        long long z = (long long)floor(points[i].z() * invSpacing) & 0x1FFFFF;
+        keys[i] = make_pair((z << 42) | (y << 21) | x, i);
+    }
+    sort(keys.begin(), keys.end());
+
+    for (unsigned int i=0; i<keys.size(); i++)
+    {
+        if ((i > 0) && (keys[i].first == keys[i-1].first)) { continue; }
+        addPoint(points[keys[i].second], normals[keys[i].second]);
+    }
+
+    // return success
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method adds a point to the point shell.
+
+    \param  a_pos     Position of point in tool coordinates.
+    \param  a_normal  Outward surface normal at point in tool coordinates.
+*/
+//==============================================================================
+void cAlgorithmVoxmapPointShell::addPoint(const cVector3d& a_pos, const cVector3d& a_normal)
+{
+    cVector3d normal = cNormalize(a_normal);
+
+    m_px.push_back((float)a_pos.x());
+    m_py.push_back((float)a_pos.y());
+    m_pz.push_back((float)a_pos.z());
+    m_nx.push_back((float)normal.x());
+    m_ny.push_back((float)normal.y());
+    m_nz.push_back((float)normal.z());
+}
+
+
+//==============================================================================
+/*!
+    This method clears the point shell.
+*/
+//==============================================================================
+void cAlgorithmVoxmapPointShell::clearPointShell()
+{
+    m_px.clear();
+    m_py.clear();
+    m_pz.clear();
+    m_nx.clear();
+    m_ny.clear();
+    m_nz.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method computes the interaction force using the last tool 
+    orientation passed to \ref computeForces(const cVector3d&, const cMatrix3d&, const cVector3d&).
+    The tool velocity is used by the viscous term of the contact model.
+
+    \param  a_toolPos  Position of tool.
+    \param  a_toolVel  Velocity of tool.
+
+    \return Computed force in world coordinates.
+*/
+//==============================================================================
+cVector3d cAlgorithmVoxmapPointShell::computeForces(const cVector3d& a_toolPos,
+                                                    const cVector3d& a_toolVel)
+{
+    return (computeForces(a_toolPos, m_toolRot, a_toolVel));
+}
+
+
+//==============================================================================
+/*!
+    This method computes the interaction force and torque between the point 
+    shell, placed at the given pose, and the voxmap. The resulting torque is
+    expressed about the tool position and can be retrieved by calling
+    \ref getTorque().\n
+
+    Points are processed in blocks: a first pass transforms the block into 
+    voxmap coordinates and computes voxel indices four points at a time 
+    with SSE2 when available (scalar single precision code otherwise), 
+    a second pass looks up voxels, and only points in contact are then 
+    evaluated with the tangent-plane force model. Each contact additionally 
+    applies a viscous force opposing the tool velocity along the contact 
+    normal; the viscous term may reduce but never reverse the contact force, 
+    so the surface cannot pull the tool.
+
+    \param  a_toolPos  Position of tool in world coordinates.
+    \param  a_toolRot  Orientation of tool in world coordinates.
+    \param  a_toolVel  Linear velocity of tool in world coordinates.
+
+    \return Computed force in world coordinates.
+*/
+//==============================================================================
+cVector3d cAlgorithmVoxmapPointShell::computeForces(const cVector3d& a_toolPos,
+                                                    const cMatrix3d& a_toolRot,
+                                                    const cVector3d& a_toolVel)
+{
+    m_toolRot = a_toolRot;
+    m_numContacts = 0;
+    m_minDistanceLayer = C_VOXMAP_FREE;
+
+    double fx = 0.0, fy = 0.0, fz = 0.0;
+    double tx = 0.0, ty = 0.0, tz = 0.0;
+
+    const int numPoints = (int)m_px.size();
+    if (m_voxmap.empty() || (numPoints == 0))
+    {
+        m_lastGlobalForce.zero();
+        m_lastGlobalTorque.zero();
+        return (m_lastGlobalForce);
+    }
+
+    // tool pose expressed in voxel units relative to voxmap origin
+    const float s = (float)m_voxelSize;
+    const float is = (float)(1.0 / m_voxelSize);
+    const float r00 = (float)a_toolRot(0,0), r01 = (float)a_toolRot(0,1), r02 = (float)a_toolRot(0,2);
+    const float r10 = (float)a_toolRot(1,0), r11 = (float)a_toolRot(1,1), r12 = (float)a_toolRot(1,2);
+    const float r20 = (float)a_toolRot(2,0), r21 = (float)a_toolRot(2,1), r22 = (float)a_toolRot(2,2);
+    const float ox = (float)((a_toolPos.x() - m_voxmapOrigin.x()) * is);
+    const float oy = (float)((a_toolPos.y() - m_voxmapOrigin.y()) * is);
+    const float oz = (float)((a_toolPos.z() - m_voxmapOrigin.z()) * is);
+    const int sizeX = m_sizeX;
+    const int sizeY = m_sizeY;
+    const int sizeZ = m_sizeZ;
+    const float k = m_stiffness;
+    const float b = m_damping;
+    const float vx = (float)a_toolVel.x();
+    const float vy = (float)a_toolVel.y();
+    const float vz = (float)a_toolVel.z();
+
+    const float* px = &m_px[0];
+    const float* py = &m_py[0];
+    const float* pz = &m_pz[0];
+    const float* nx = &m_nx[0];
+    const float* ny = &m_ny[0];
+    const float* nz = &m_nz[0];
+    const signed char* voxmap = &m_voxmap[0];
+
+    float gx[C_VOXMAP_POINT_BLOCK_SIZE];
+    float gy[C_VOXMAP_POINT_BLOCK_SIZE];
+    float gz[C_VOXMAP_POINT_BLOCK_SIZE];
+    int ix[C_VOXMAP_POINT_BLOCK_SIZE];
+    int iy[C_VOXMAP_POINT_BLOCK_SIZE];
+    int iz[C_VOXMAP_POINT_BLOCK_SIZE];
+    signed char value[C_VOXMAP_POINT_BLOCK_SIZE];
+
+    int minLayer = C_VOXMAP_FREE;
+    unsigned int numContacts = 0;
+
+    for (int block=0; block<numPoints; block+=C_VOXMAP_POINT_BLOCK_SIZE)
+    {
+        const int n = cMin(C_VOXMAP_POINT_BLOCK_SIZE, numPoints - block);
+
+        // transform points into voxmap coordinates and compute voxel indices
+        int i = 0;
+
+#if defined(C_VOXMAP_USE_SSE2)
+        {
+            const __m128 vr00 = _mm_set1_ps(r00 * is), vr01 = _mm_set1_ps(r01 * is), vr02 = _mm_set1_ps(r02 * is);
+            const __m128 vr10 = _mm_set1_ps(r10 * is), vr11 = _mm_set1_ps(r11 * is), vr12 = _mm_set1_ps(r12 * is);
+            const __m128 vr20 = _mm_set1_ps(r20 * is), vr21 = _mm_set1_ps(r21 * is), vr22 = _mm_set1_ps(r22 * is);
+            const __m128 vox = _mm_set1_ps(ox);
+            const __m128 voy = _mm_set1_ps(oy);
+            const __m128 voz = _mm_set1_ps(oz);
+
+            for (; i+4<=n; i+=4)
+            {
+                const __m128 x = _mm_loadu_ps(px + block + i);
+                const __m128 y = _mm_loadu_ps(py + block + i);
+                const __m128 z = _mm_loadu_ps(pz + block + i);
+
+                const __m128 tx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vr00, x), _mm_mul_ps(vr01, y)), _mm_add_ps(_mm_mul_ps(vr02, z), vox));
+                const __m128 ty = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vr10, x), _mm_mul_ps(vr11, y)), _mm_add_ps(_mm_mul_ps(vr12, z), voy));
+                const __m128 tz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vr20, x), _mm_mul_ps(vr21, y)), _mm_add_ps(_mm_mul_ps(vr22, z), voz));
+
+                _mm_storeu_ps(gx + i, tx);
+                _mm_storeu_ps(gy + i, ty);
+                _mm_storeu_ps(gz + i, tz);
+
+                // floor: truncate, then subtract one where truncation rounded up (negative values)
+                __m128i fx = _mm_cvttps_epi32(tx);
+                __m128i fy = _mm_cvttps_epi32(ty);
+                __m128i fz = _mm_cvttps_epi32(tz);
+                fx = _mm_add_epi32(fx, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(fx), tx)));
+                fy = _mm_add_epi32(fy, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(fy), ty)));
+                fz = _mm_add_epi32(fz, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(fz), tz)));
+
+                _mm_storeu_si128((__m128i*)(ix + i), fx);
+                _mm_storeu_si128((__m128i*)(iy + i), fy);
+                _mm_storeu_si128((__m128i*)(iz + i), fz);
+            }
+        }
+#endif
+
+        for (; i<n; i++)
+        {
+            const float x = px[block+i];
+            const float y = py[block+i];
+            const float z = pz[block+i];
+            gx[i] = (r00 * x + r01 * y + r02 * z) * is + ox;
+            gy[i] = (r10 * x + r11 * y + r12 * z) * is + oy;
+            gz[i] = (r20 * x + r21 * y + r22 * z) * is + oz;
+            ix[i] = (int)floorf(gx[i]);
+            iy[i] = (int)floorf(gy[i]);
+            iz[i] = (int)floorf(gz[i]);
+        }
+
+        // look up voxmap
+        for (i=0; i<n; i++)
+        {
+            const int x = ix[i];
+            const int y = iy[i];
+            const int z = iz[i];
+            const bool inside = (x >= 0) & (y >= 0) & (z >= 0) & (x < sizeX) & (y < sizeY) & (z < sizeZ);
+            value[i] = inside ? voxmap[((size_t)z * sizeY + y) * sizeX + x] : C_VOXMAP_FREE;
+        }
+
+        // evaluate contacts with the tangent-plane force model
+        for (i=0; i<n; i++)
+        {
+            const int v = value[i];
+            minLayer = cMin(minLayer, v);
+            if (v > C_VOXMAP_SURFACE) { continue; }
+
+            const int j = block + i;
+
+            // normal in world coordinates
+            const float wnx = r00 * nx[j] + r01 * ny[j] + r02 * nz[j];
+            const float wny = r10 * nx[j] + r11 * ny[j] + r12 * nz[j];
+            const float wnz = r20 * nx[j] + r21 * ny[j] + r22 * nz[j];
+
+            // depth of point below the tangent plane passing through the voxel center
+            const float dx = gx[i] - ((float)ix[i] + 0.5f);
+            const float dy = gy[i] - ((float)iy[i] + 0.5f);
+            const float dz = gz[i] - ((float)iz[i] + 0.5f);
+            const float depth = (dx * wnx + dy * wny + dz * wnz + 0.5f - (float)v) * s;
+            if (depth <= 0.0f) { continue; }
+
+            numContacts++;
+
+            // contact force pushes the tool along its inward normal, and the
+            // viscous term opposes the tool velocity along the same normal; when
+            // the tool leaves the surface quickly the viscous term is limited so
+            // that the resulting contact force never pulls the tool inwards
+            const float f = cMin(-k * depth - b * (vx * wnx + vy * wny + vz * wnz), 0.0f);
+            const float cfx = f * wnx;
+            const float cfy = f * wny;
+            const float cfz = f * wnz;
+
+            // lever arm from tool position
+            const float ax = (gx[i] - ox) * s;
+            const float ay = (gy[i] - oy) * s;
+            const float az = (gz[i] - oz) * s;
+
+            fx += cfx;
+            fy += cfy;
+            fz += cfz;
+            tx += ay * cfz - az * cfy;
+            ty += az * cfx - ax * cfz;
+            tz += ax * cfy - ay * cfx;
+        }
+    }
+
+    // average contributions when many points are in contact to preserve stability
+    double scale = 1.0;
+    if (numContacts > m_contactAveragingThreshold)
+    {
+        scale = (double)m_contactAveragingThreshold / (double)numContacts;
+    }
+
+    m_numContacts = numContacts;
+    m_minDistanceLayer = minLayer;
+    m_lastGlobalForce.set(scale * fx, scale * fy, scale * fz);
+    m_lastGlobalTorque.set(scale * tx, scale * ty, scale * tz);
+
+    return (m_lastGlobalForce);
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,329 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.3.0
+*/
+//==============================================================================
+
+
+//------------------------------------------------------------------------------
+#ifndef CAlgorithmVoxmapPointShellH
+#define CAlgorithmVoxmapPointShellH
+//------------------------------------------------------------------------------
+#include "forces/CGenericForceAlgorithm.h"
+#include "math/CMatrix3d.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CAlgorithmVoxmapPointShell.h
+
+    \brief
+    Implements a voxmap-pointshell force algorithm for 6-DOF haptic rendering.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Voxmap value of a surface voxel.
+const signed char C_VOXMAP_SURFACE = 0;
+
+//! Voxmap value of a free voxel located beyond the last distance layer.
+const signed char C_VOXMAP_FREE = 127;
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \class      cAlgorithmVoxmapPointShell
+    \ingroup    forces
+
+    \brief
+    This class implements a voxmap-pointshell force algorithm for rendering
+    rigid tools of arbitrary shape.
+
+    \details
+    cAlgorithmVoxmapPointShell implements the voxmap-pointshell (VPS) approach
+    for 6-DOF haptic rendering. The static environment is voxelized once into
+    a compact voxmap where each voxel stores a signed distance layer
+    (one byte per voxel): __0__ for surface voxels, __1__ to __N__ for the 
+    free space layers surrounding the surface, and negative values for the 
+    depth of voxels located inside the environment.\n
+
+    The tool is described by a point shell, a set of points sampled on its 
+    surface together with their outward normals, expressed in the local frame 
+    of the tool. At every haptic tick, all points are transformed by the tool 
+    pose and looked up in the voxmap. Each point that lies in a surface or 
+    interior voxel contributes a force computed with the tangent-plane force 
+    model, and the sum of all contributions yields the force and torque 
+    applied to the tool.\n
+
+    Point shell data is stored as contiguous single precision arrays 
+    (structure of arrays) and processed in fixed size blocks, which keeps the
+    voxmap lookups cache friendly. On processors supporting SSE2, points are
+    transformed and converted to voxel indices four at a time; a scalar 
+    implementation is used otherwise.\n
+
+    When a tool velocity is provided, each point in contact also contributes
+    a viscous force opposing the motion of the tool along the contact normal
+    (see \ref setDamping()).\n
+
+    The environment is considered static; call \ref voxelize() again if the
+    environment is modified.
+*/
+//==============================================================================
+class cAlgorithmVoxmapPointShell : public cGenericForceAlgorithm
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cAlgorithmVoxmapPointShell.
+    cAlgorithmVoxmapPointShell();
+
+    //! Destructor of cAlgorithmVoxmapPointShell.
+    virtual ~cAlgorithmVoxmapPointShell() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - VOXMAP:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method voxelizes all meshes of an object (and its children) into the voxmap.
+    bool voxelize(cGenericObject* a_object, const double a_voxelSize, const unsigned int a_numDistanceLayers = 4);
+
+    //! This method clears the voxmap.
+    void clearVoxmap();
+
+    //! This method returns the size of a voxel.
+    double getVoxelSize() const { return (m_voxelSize); }
+
+    //! This method returns the number of free space distance layers stored in the voxmap.
+    unsigned int getNumDistanceLayers() const { return (m_numDistanceLayers); }
+
+    //! This method returns the number of voxels along X.
+    int getVoxmapSizeX() const { return (m_sizeX); }
+
+    //! This method returns the number of voxels along Y.
+    int getVoxmapSizeY() const { return (m_sizeY); }
+
+    //! This method returns the number of voxels along Z.
+    int getVoxmapSizeZ() const { return (m_sizeZ); }
+
+    //! This method returns the voxmap value at a given position in world coordinates.
+    signed char getVoxmapValue(const cVector3d& a_globalPos) const;
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - POINT SHELL:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method builds the point shell by sampling the meshes of an object (and its children).
+    bool buildPointShell(cGenericObject* a_object, const double a_spacing);
+
+    //! This method adds a point and its outward normal, expressed in tool coordinates, to the point shell.
+    void addPoint(const cVector3d& a_pos, const cVector3d& a_normal);
+
+    //! This method clears the point shell.
+    void clearPointShell();
+
+    //! This method returns the number of points composing the point shell.
+    unsigned int getNumPoints() const { return ((unsigned int)(m_px.size())); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - FORCE RENDERING:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method initializes the algorithm by passing the starting position of the haptic device.
+    void initialize(cWorld* a_world, const cVector3d& a_initialPos);
+
+    //! This method computes the force using the last specified tool orientation.
+    virtual cVector3d computeForces(const cVector3d& a_toolPos, const cVector3d& a_toolVel);
+
+    //! This method computes the force and torque given the updated pose of the tool.
+    cVector3d computeForces(const cVector3d& a_toolPos, const cMatrix3d& a_toolRot, const cVector3d& a_toolVel = cVector3d(0.0, 0.0, 0.0));
+
+    //! This method returns the last computed force in world coordinates.
+    cVector3d getForce() const { return (m_lastGlobalForce); }
+
+    //! This method returns the last computed torque in world coordinates.
+    cVector3d getTorque() const { return (m_lastGlobalTorque); }
+
+    //! This method returns the number of points in contact during the last computation.
+    unsigned int getNumContacts() const { return (m_numContacts); }
+
+    //! This method returns the smallest distance layer reached by the point shell during the last computation.
+    int getMinDistanceLayer() const { return (m_minDistanceLayer); }
+
+    //! This method sets the stiffness of the contact model [N/m].
+    void setStiffness(const double a_stiffness) { m_stiffness = (float)cMax(0.0, a_stiffness); }
+
+    //! This method returns the stiffness of the contact model [N/m].
+    double getStiffness() const { return (m_stiffness); }
+
+    //! This method sets the viscous damping of the contact model [N.s/m].
+    void setDamping(const double a_damping) { m_damping = (float)cMax(0.0, a_damping); }
+
+    //! This method returns the viscous damping of the contact model [N.s/m].
+    double getDamping() const { return (m_damping); }
+
+    //! This method sets the number of contacts above which the resulting force is averaged.
+    void setContactAveragingThreshold(const unsigned int a_numContacts) { m_contactAveragingThreshold = cMax(1u, a_numContacts); }
+
+    //! This method returns the number of contacts above which the resulting force is averaged.
+    unsigned int getContactAveragingThreshold() const { return (m_contactAveragingThreshold); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method samples the triangles of a mesh, expressed in the frame of a reference object.
+    void sampleMesh(cGenericObject* a_object, const cVector3d& a_refPos, const cMatrix3d& a_refRot, const double a_spacing, std::vector<cVector3d>& a_points, std::vector<cVector3d>& a_normals);
+
+    //! This method computes the distance layers of the voxmap from the surface voxels.
+    void computeDistanceLayers();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - VOXMAP:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Voxmap data stored in X, Y, Z order (one signed distance layer per voxel).
+    std::vector<signed char> m_voxmap;
+
+    //! Position of the lowest voxmap corner in world coordinates.
+    cVector3d m_voxmapOrigin;
+
+    //! Size of a voxel.
+    double m_voxelSize;
+
+    //! Number of free space distance layers.
+    unsigned int m_numDistanceLayers;
+
+    //! Number of voxels along X.
+    int m_sizeX;
+
+    //! Number of voxels along Y.
+    int m_sizeY;
+
+    //! Number of voxels along Z.
+    int m_sizeZ;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - POINT SHELL:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! X coordinates of point shell (tool coordinates).
+    std::vector<float> m_px;
+
+    //! Y coordinates of point shell (tool coordinates).
+    std::vector<float> m_py;
+
+    //! Z coordinates of point shell (tool coordinates).
+    std::vector<float> m_pz;
+
+    //! X components of point shell normals (tool coordinates).
+    std::vector<float> m_nx;
+
+    //! Y components of point shell normals (tool coordinates).
+    std::vector<float> m_ny;
+
+    //! Z components of point shell normals (tool coordinates).
+    std::vector<float> m_nz;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - FORCE MODEL:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Stiffness of the tangent-plane contact model.
+    float m_stiffness;
+
+    //! Viscous damping of the contact model.
+    float m_damping;
+
+    //! Number of contacts above which the resulting force is averaged.
+    unsigned int m_contactAveragingThreshold;
+
+    //! Last specified orientation of the tool.
+    cMatrix3d m_toolRot;
+
+    //! Last computed force in world coordinates.
+    cVector3d m_lastGlobalForce;
+
+    //! Last computed torque in world coordinates.
+    cVector3d m_lastGlobalTorque;
+
+    //! Number of points in contact during the last computation.
+    unsigned int m_numContacts;
+
+    //! Smallest distance layer reached by the point shell during the last computation.
+    int m_minDistanceLayer;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -117,6 +117,12 @@ struct cInteractionEvent
 };
 
 
+//------------------------------------------------------------------------------
+//! Number of interaction events preallocated by an interaction recorder.
+const unsigned int C_INTERACTION_RECORDER_DEFAULT_CAPACITY = 64;
+//------------------------------------------------------------------------------
+
+
 //==============================================================================
 /*!
     \class      cInteractionRecorder
@@ -127,7 +133,9 @@ struct cInteractionEvent
 
     \details
     cInteractionRecorder stores a list of interaction events that occur between
-    a haptic tool and haptic effects programmed on objects.
+    a haptic tool and haptic effects programmed on objects. Storage for
+    \ref C_INTERACTION_RECORDER_DEFAULT_CAPACITY events is preallocated, and 
+    clearing the recorder preserves its capacity.
 */
 //==============================================================================
 class cInteractionRecorder
@@ -139,7 +147,7 @@ class cInteractionRecorder
 public:
 
     //! Constructor of cInteractionRecorder.
-    cInteractionRecorder() { clear(); }
+    cInteractionRecorder() { m_interactions.reserve(C_INTERACTION_RECORDER_DEFAULT_CAPACITY); clear(); }
 
     //! Destructor of cInteractionRecorder.
     virtual ~cInteractionRecorder() {};
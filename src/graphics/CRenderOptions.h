@@ -52,6 +52,8 @@ namespace chai3d {
 
 //------------------------------------------------------------------------------
 class cCamera;
+class cGenericTexture;
+class cShaderProgram;
 //------------------------------------------------------------------------------
 
 //==============================================================================
@@ -119,6 +121,21 @@ struct cRenderOptions
 
     //! If __true__, then reset OpenGL display lists and texture objects.
     bool m_markForUpdate;
+
+    //! If __true__, then objects located outside of the view frustum of the camera are not rendered.
+    bool m_useFrustumCulling;
+
+    //! If __true__, then the next object uses the same texture and the current object may leave it bound. (see \ref cRenderQueue)
+    bool m_keepTextureBound;
+
+    //! If __true__, then the next object uses the same shader program and the current object may leave it in use. (see \ref cRenderQueue)
+    bool m_keepShaderProgramBound;
+
+    //! Texture left bound and configured by the previous object, or __NULL__ if none.
+    cGenericTexture* m_boundTexture;
+
+    //! Shader program left in use by the previous object, or __NULL__ if none.
+    cShaderProgram* m_boundShaderProgram;
 };
 
 
@@ -547,8 +547,8 @@ public:
                 cVector3d B0 = cProjectPointOnPlane(B, cVector3d(0, 0, 0), N0);
                 T0.normalize();
                 B0.normalize();
-                m_vertices->m_tangent[index0] = T0;
-                m_vertices->m_bitangent[index0] = B0;
+                m_vertices->setTangent(index0, T0);
+                m_vertices->setBitangent(index0, B0);
 
                 // compute tangent and bi-tangent vector for vertex 1
                 cVector3d N1 = m_vertices->getNormal(index1);
@@ -556,8 +556,8 @@ public:
                 cVector3d B1 = cProjectPointOnPlane(B, cVector3d(0, 0, 0), N1);
                 T1.normalize();
                 B1.normalize();
-                m_vertices->m_tangent[index1] = T1;
-                m_vertices->m_bitangent[index1] = B1;
+                m_vertices->setTangent(index1, T1);
+                m_vertices->setBitangent(index1, B1);
 
                 // compute tangent and bi-tangent vector for vertex 2
                 cVector3d N2 = m_vertices->getNormal(index2);
@@ -565,8 +565,8 @@ public:
                 cVector3d B2 = cProjectPointOnPlane(B, cVector3d(0, 0, 0), N2);
                 T2.normalize();
                 B2.normalize();
-                m_vertices->m_tangent[index2] = T2;
-                m_vertices->m_bitangent[index2] = B2;
+                m_vertices->setTangent(index2, T2);
+                m_vertices->setBitangent(index2, B2);
 
                 // mark for update
                 m_vertices->m_flagTangentData = true;
@@ -583,6 +583,25 @@ public:
     //--------------------------------------------------------------------------
     inline void renderInitialize()
     { 
+#ifdef C_USE_OPENGL
+        // initialize rendering of vertices
+        m_vertices->renderInitialize();
+        
+        // render object
+        glEnableClientState(GL_VERTEX_ARRAY);
+        renderElements();
+#endif
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method updates the OpenGL index buffer if needed and renders all 
+        triangles using the vertex arrays currently bound.
+    */
+    //--------------------------------------------------------------------------
+    inline void renderElements()
+    { 
 #ifdef C_USE_OPENGL
         unsigned int numtriangles = getNumElements();
 
@@ -599,24 +618,18 @@ public:
         if (m_flagMarkForResize)
         {
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, 3 * numtriangles * sizeof(unsigned int), &(m_indices[0]), GL_STATIC_DRAW);
-            m_flagMarkForResize = true;
+            m_flagMarkForResize = false;
+            m_flagMarkForUpdate = false;
         }
 
         // update data if needed
         if (m_flagMarkForUpdate)
         {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementBuffer);
             glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, 3 * numtriangles * sizeof(unsigned int), &(m_indices[0]));
-
             m_flagMarkForUpdate = false;
         }
 
-        // initialize rendering of vertices
-        m_vertices->renderInitialize();
-        
         // render object
-        glEnableClientState(GL_VERTEX_ARRAY);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementBuffer);
         glDrawElements(GL_TRIANGLES, 3 * numtriangles, GL_UNSIGNED_INT, (void*)0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 #endif
@@ -0,0 +1,639 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.3.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "graphics/CVertexArray.h"
+#include "system/CThreadPool.h"
+//------------------------------------------------------------------------------
+#include <cstring>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+const int C_VERTEX_ARRAY_MIN_BLOCK_SIZE = 131072;
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    This function transforms a range of positions stored as contiguous 
+    triplets of doubles. The rotation and translation are copied into local 
+    variables so that the compiler can vectorize the loop.
+
+    \param  a_src    Source positions.
+    \param  a_dst    Destination positions.
+    \param  a_begin  First vertex.
+    \param  a_end    Last vertex (excluded).
+    \param  a_pos    Translation.
+    \param  a_rot    Rotation matrix.
+*/
+//==============================================================================
+static void cTransformPositions(const double* a_src,
+                                double* a_dst,
+                                const int a_begin,
+                                const int a_end,
+                                const cVector3d& a_pos,
+                                const cMatrix3d& a_rot)
+{
+    const double r00 = a_rot(0,0), r01 = a_rot(0,1), r02 = a_rot(0,2);
+    const double r10 = a_rot(1,0), r11 = a_rot(1,1), r12 = a_rot(1,2);
+    const double r20 = a_rot(2,0), r21 = a_rot(2,1), r22 = a_rot(2,2);
+    const double t0 = a_pos(0), t1 = a_pos(1), t2 = a_pos(2);
+
+    for (int i=3*a_begin; i<3*a_end; i+=3)
+    {
+        const double x = a_src[i];
+        const double y = a_src[i+1];
+        const double z = a_src[i+2];
+        a_dst[i]   = r00 * x + r01 * y + r02 * z + t0;
+        a_dst[i+1] = r10 * x + r11 * y + r12 * z + t1;
+        a_dst[i+2] = r20 * x + r21 * y + r22 * z + t2;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method computes the global position of all vertices given the global 
+    position and global rotation matrix of the parent object. Arrays larger 
+    than a few hundred thousand vertices are split into blocks which are 
+    transformed by the threads of the shared thread pool 
+    (see \ref cThreadPool::getSharedPool()). If global positions are not stored, only
+    the global position and rotation of the parent object are recorded.
+
+    \param  a_globalPos  Global position vector of parent.
+    \param  a_globalRot  Global rotation matrix of parent.
+*/
+//==============================================================================
+void cVertexArray::computeGlobalPositions(const cVector3d& a_globalPos, 
+                                          const cMatrix3d& a_globalRot)
+{
+    m_parentGlobalPos = a_globalPos;
+    m_parentGlobalRot = a_globalRot;
+    if (!m_useGlobalPosData) { return; }
+
+    int numVertices = (int)(cMin(m_localPos.size(), m_globalPos.size()));
+    if (numVertices == 0) { return; }
+
+    const double* src = &(m_localPos[0](0));
+    double* dst = &(m_globalPos[0](0));
+
+    // small arrays are transformed by the calling thread
+    if (numVertices < 2 * C_VERTEX_ARRAY_MIN_BLOCK_SIZE)
+    {
+        cTransformPositions(src, dst, 0, numVertices, a_globalPos, a_globalRot);
+        return;
+    }
+
+    // transform blocks in parallel on the shared thread pool
+    cThreadPool::getSharedPool()->parallelFor(numVertices, [=, &a_globalPos, &a_globalRot](int a_begin, int a_end)
+    {
+        cTransformPositions(src, dst, a_begin, a_end, a_globalPos, a_globalRot);
+    }, C_VERTEX_ARRAY_MIN_BLOCK_SIZE);
+}
+
+
+
+//==============================================================================
+/*!
+    This method sets the memory layout of vertex attributes. Existing vertex
+    data is converted to the new layout and the storage used by the previous
+    layout is released. Converting to a compact layout is lossy: vectors are 
+    quantized to 10 bits per component, colors to 8 bits per component, and 
+    the __W__ component of texture coordinates is discarded.
+
+    \param  a_layout  Memory layout of vertex attributes.
+*/
+//==============================================================================
+void cVertexArray::setLayout(const cVertexArrayLayout& a_layout)
+{
+    if ((a_layout.m_vectorFormat == m_layout.m_vectorFormat) &&
+        (a_layout.m_texCoordFormat == m_layout.m_texCoordFormat) &&
+        (a_layout.m_colorFormat == m_layout.m_colorFormat))
+    {
+        return;
+    }
+
+    // read vertex attributes using the current layout
+    unsigned int numVertices = m_numVertices;
+    std::vector<cVector3d> normal(m_useNormalData ? numVertices : 0);
+    std::vector<cVector3d> texCoord(m_useTexCoordData ? numVertices : 0);
+    std::vector<cColorf> color(m_useColorData ? numVertices : 0);
+    std::vector<cVector3d> tangent(m_useTangentData ? numVertices : 0);
+    std::vector<cVector3d> bitangent(m_useBitangentData ? numVertices : 0);
+
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        if (m_useNormalData) { normal[i] = getNormal(i); }
+        if (m_useTexCoordData) { texCoord[i] = getTexCoord(i); }
+        if (m_useColorData) { color[i] = getColor(i); }
+        if (m_useTangentData) { tangent[i] = getTangent(i); }
+        if (m_useBitangentData) { bitangent[i] = getBitangent(i); }
+    }
+
+    // release storage of the current layout
+    std::vector<cVector3d>().swap(m_normal);
+    std::vector<cVector3d>().swap(m_texCoord);
+    std::vector<cColorf>().swap(m_color);
+    std::vector<cVector3d>().swap(m_tangent);
+    std::vector<cVector3d>().swap(m_bitangent);
+    std::vector<unsigned int>().swap(m_normalPacked);
+    std::vector<float>().swap(m_texCoordFloat);
+    std::vector<unsigned short>().swap(m_texCoordHalf);
+    std::vector<unsigned int>().swap(m_colorPacked);
+    std::vector<unsigned int>().swap(m_tangentPacked);
+    std::vector<unsigned int>().swap(m_bitangentPacked);
+
+    // allocate storage for the new layout
+    m_layout = a_layout;
+    m_numVertices = 0;
+    allocateData(numVertices, m_useNormalData, m_useTexCoordData, m_useColorData, m_useTangentData, m_useBitangentData, m_useUserData);
+
+    // write vertex attributes using the new layout
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        if (m_useNormalData) { setNormal(i, normal[i]); }
+        if (m_useTexCoordData) { setTexCoord(i, texCoord[i]); }
+        if (m_useColorData) { setColor(i, color[i]); }
+        if (m_useTangentData) { setTangent(i, tangent[i]); }
+        if (m_useBitangentData) { setBitangent(i, bitangent[i]); }
+    }
+}
+
+
+
+//==============================================================================
+/*!
+    This function writes vectors into an interleaved vertex buffer, either as
+    three floats or, for vectors stored in the compact layout, as four signed
+    normalized shorts. Packed 10:10:10:2 integers cannot be used directly since
+    the fixed pipeline only accepts them for four-component attributes.
+
+    \param  a_dst     Destination of first vertex.
+    \param  a_stride  Size in bytes of an interleaved vertex.
+    \param  a_begin   First vertex.
+    \param  a_end     Last vertex (excluded).
+    \param  a_vector  Vectors stored in double precision.
+    \param  a_packed  Vectors stored as packed integers.
+*/
+//==============================================================================
+static void cPackVectors(unsigned char* a_dst,
+                         const unsigned int a_stride,
+                         const unsigned int a_begin,
+                         const unsigned int a_end,
+                         const std::vector<cVector3d>& a_vector,
+                         const std::vector<unsigned int>& a_packed)
+{
+    if (!a_packed.empty())
+    {
+        for (unsigned int i=a_begin; i<a_end; i++, a_dst+=a_stride)
+        {
+            short* dst = (short*)a_dst;
+            for (int j=0; j<3; j++)
+            {
+                int component = (int)((a_packed[i] >> (10 * j)) & 0x3FF);
+                if (component & 0x200) { component -= 0x400; }
+                if (component < -511) { component = -511; }
+                dst[j] = (short)((component * 32767) / 511);
+            }
+            dst[3] = 0;
+        }
+    }
+    else
+    {
+        for (unsigned int i=a_begin; i<a_end; i++, a_dst+=a_stride)
+        {
+            float* dst = (float*)a_dst;
+            dst[0] = (float)a_vector[i](0);
+            dst[1] = (float)a_vector[i](1);
+            dst[2] = (float)a_vector[i](2);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method packs the vertices modified since the last call into a single
+    interleaved buffer. Positions, normals, tangents, bitangents and texture 
+    coordinates stored in double precision are converted to floats; compact
+    texture coordinates and colors are copied as is. If the number of vertices or
+    the layout changed, the whole buffer is reallocated. Otherwise only the
+    range of vertices recorded by the set methods is written, or the entire
+    buffer if modification flags were raised without a range.
+*/
+//==============================================================================
+void cVertexArray::updateVertexBuffer()
+{
+#ifdef C_USE_OPENGL
+    // compute layout of an interleaved vertex
+    bool vectorDouble = (m_layout.m_vectorFormat == C_VERTEX_VECTOR_DOUBLE);
+    unsigned int vectorSize = vectorDouble ? 3 * sizeof(float) : 4 * sizeof(short);
+    unsigned int texCoordSize = 3 * sizeof(float);
+    if (m_layout.m_texCoordFormat == C_VERTEX_TEXCOORD_FLOAT) { texCoordSize = 2 * sizeof(float); }
+    if (m_layout.m_texCoordFormat == C_VERTEX_TEXCOORD_HALF) { texCoordSize = 2 * sizeof(unsigned short); }
+    unsigned int colorSize = (m_layout.m_colorFormat == C_VERTEX_COLOR_FLOAT) ? 4 * sizeof(float) : sizeof(unsigned int);
+
+    unsigned int stride = 3 * sizeof(float);
+    m_normalOffset = stride;     if (m_useNormalData) { stride += vectorSize; }
+    m_texCoordOffset = stride;   if (m_useTexCoordData) { stride += texCoordSize; }
+    m_colorOffset = stride;      if (m_useColorData) { stride += colorSize; }
+    m_tangentOffset = stride;    if (m_useTangentData) { stride += vectorSize; }
+    m_bitangentOffset = stride;  if (m_useBitangentData) { stride += vectorSize; }
+
+    // create buffer first time
+    if (m_vertexBuffer == (GLuint)(-1))
+    {
+        glGenBuffers(1, &m_vertexBuffer);
+    }
+
+    // determine range of vertices to update
+    bool resize = m_flagBufferResize || (m_vertexBufferSize != m_numVertices) || (m_vertexBufferStride != stride);
+    bool modified = m_flagPositionData || m_flagNormalData || m_flagTexCoordData || m_flagColorData || m_flagTangentData || m_flagBitangentData;
+    if (!resize && !modified)
+    {
+        return;
+    }
+
+    unsigned int begin = 0;
+    unsigned int end = m_numVertices;
+    if (!resize && (m_modifiedEnd > m_modifiedBegin))
+    {
+        begin = m_modifiedBegin;
+        end = cMin(m_modifiedEnd, m_numVertices);
+    }
+
+    // reset flags
+    m_flagBufferResize  = false;
+    m_flagPositionData  = false;
+    m_flagNormalData    = false;
+    m_flagTexCoordData  = false;
+    m_flagColorData     = false;
+    m_flagTangentData   = false;
+    m_flagBitangentData = false;
+    m_modifiedBegin     = (unsigned int)(-1);
+    m_modifiedEnd       = 0;
+    m_vertexBufferSize  = m_numVertices;
+    m_vertexBufferStride = stride;
+
+    if (end <= begin)
+    {
+        return;
+    }
+
+    // map the range of the buffer to update, or use temporary memory if 
+    // buffer mapping is not available
+    GLintptr offset = (GLintptr)begin * stride;
+    GLsizeiptr size = (GLsizeiptr)(end - begin) * stride;
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    if (resize)
+    {
+        glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+    }
+
+    unsigned char* data = NULL;
+    std::vector<unsigned char> staging;
+    if (glMapBufferRange != NULL)
+    {
+        data = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    }
+    if (data == NULL)
+    {
+        staging.resize(size);
+        data = &staging[0];
+    }
+
+    // pack positions
+    unsigned char* dst = data;
+    for (unsigned int i=begin; i<end; i++, dst+=stride)
+    {
+        float* pos = (float*)dst;
+        pos[0] = (float)m_localPos[i](0);
+        pos[1] = (float)m_localPos[i](1);
+        pos[2] = (float)m_localPos[i](2);
+    }
+
+    // pack normals, tangents and bitangents
+    if (m_useNormalData)
+    {
+        cPackVectors(data + m_normalOffset, stride, begin, end, m_normal, m_normalPacked);
+    }
+    if (m_useTangentData)
+    {
+        cPackVectors(data + m_tangentOffset, stride, begin, end, m_tangent, m_tangentPacked);
+    }
+    if (m_useBitangentData)
+    {
+        cPackVectors(data + m_bitangentOffset, stride, begin, end, m_bitangent, m_bitangentPacked);
+    }
+
+    // pack texture coordinates
+    if (m_useTexCoordData)
+    {
+        dst = data + m_texCoordOffset;
+        for (unsigned int i=begin; i<end; i++, dst+=stride)
+        {
+            switch (m_layout.m_texCoordFormat)
+            {
+                case C_VERTEX_TEXCOORD_DOUBLE:
+                {
+                    float* texCoord = (float*)dst;
+                    texCoord[0] = (float)m_texCoord[i](0);
+                    texCoord[1] = (float)m_texCoord[i](1);
+                    texCoord[2] = (float)m_texCoord[i](2);
+                    break;
+                }
+
+                case C_VERTEX_TEXCOORD_FLOAT:
+                    memcpy(dst, &m_texCoordFloat[2*i], 2 * sizeof(float));
+                    break;
+
+                case C_VERTEX_TEXCOORD_HALF:
+                    memcpy(dst, &m_texCoordHalf[2*i], 2 * sizeof(unsigned short));
+                    break;
+            }
+        }
+    }
+
+    // pack colors
+    if (m_useColorData)
+    {
+        dst = data + m_colorOffset;
+        for (unsigned int i=begin; i<end; i++, dst+=stride)
+        {
+            if (m_layout.m_colorFormat == C_VERTEX_COLOR_FLOAT)
+            {
+                memcpy(dst, m_color[i].getData(), 4 * sizeof(float));
+            }
+            else
+            {
+                memcpy(dst, &m_colorPacked[i], sizeof(unsigned int));
+            }
+        }
+    }
+
+    // upload data
+    if (staging.empty())
+    {
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    else
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method updates the vertex buffer and binds each vertex attribute to 
+    the generic attribute locations used by shaders.
+*/
+//==============================================================================
+void cVertexArray::renderInitialize()
+{
+#ifdef C_USE_OPENGL
+    // update vertex buffer
+    updateVertexBuffer();
+
+    bool vectorDouble = (m_layout.m_vectorFormat == C_VERTEX_VECTOR_DOUBLE);
+    GLsizei stride = m_vertexBufferStride;
+
+    // bind buffer and set attributes
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+
+    glEnableVertexAttribArray(C_VB_POSITION);
+    glVertexAttribPointer(C_VB_POSITION, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)0);
+    glVertexPointer(3, GL_FLOAT, stride, (const GLvoid*)0);
+
+    if (m_useNormalData)
+    {
+        glEnableVertexAttribArray(C_VB_NORMAL);
+        if (vectorDouble)
+        {
+            glVertexAttribPointer(C_VB_NORMAL, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(size_t)m_normalOffset);
+        }
+        else
+        {
+            glVertexAttribPointer(C_VB_NORMAL, 3, GL_SHORT, GL_TRUE, stride, (const GLvoid*)(size_t)m_normalOffset);
+        }
+    }
+    else
+    {
+        glDisableVertexAttribArray(C_VB_NORMAL);
+    }
+
+    if (m_useTexCoordData)
+    {
+        glEnableVertexAttribArray(C_VB_TEXCOORD);
+        switch (m_layout.m_texCoordFormat)
+        {
+            case C_VERTEX_TEXCOORD_DOUBLE:
+                glVertexAttribPointer(C_VB_TEXCOORD, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(size_t)m_texCoordOffset);
+                break;
+
+            case C_VERTEX_TEXCOORD_FLOAT:
+                glVertexAttribPointer(C_VB_TEXCOORD, 2, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(size_t)m_texCoordOffset);
+                break;
+
+            case C_VERTEX_TEXCOORD_HALF:
+                glVertexAttribPointer(C_VB_TEXCOORD, 2, GL_HALF_FLOAT, GL_FALSE, stride, (const GLvoid*)(size_t)m_texCoordOffset);
+                break;
+        }
+    }
+    else
+    {
+        glDisableVertexAttribArray(C_VB_TEXCOORD);
+    }
+
+    if (m_useColorData)
+    {
+        glEnableVertexAttribArray(C_VB_COLOR);
+        if (m_layout.m_colorFormat == C_VERTEX_COLOR_FLOAT)
+        {
+            glVertexAttribPointer(C_VB_COLOR, 4, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(size_t)m_colorOffset);
+        }
+        else
+        {
+            glVertexAttribPointer(C_VB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (const GLvoid*)(size_t)m_colorOffset);
+        }
+    }
+    else
+    {
+        glDisableVertexAttribArray(C_VB_COLOR);
+    }
+
+    if (m_useTangentData)
+    {
+        glEnableVertexAttribArray(C_VB_TANGENT);
+        if (vectorDouble)
+        {
+            glVertexAttribPointer(C_VB_TANGENT, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(size_t)m_tangentOffset);
+        }
+        else
+        {
+            glVertexAttribPointer(C_VB_TANGENT, 3, GL_SHORT, GL_TRUE, stride, (const GLvoid*)(size_t)m_tangentOffset);
+        }
+    }
+    else
+    {
+        glDisableVertexAttribArray(C_VB_TANGENT);
+    }
+
+    if (m_useBitangentData)
+    {
+        glEnableVertexAttribArray(C_VB_BITANGENT);
+        if (vectorDouble)
+        {
+            glVertexAttribPointer(C_VB_BITANGENT, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(size_t)m_bitangentOffset);
+        }
+        else
+        {
+            glVertexAttribPointer(C_VB_BITANGENT, 3, GL_SHORT, GL_TRUE, stride, (const GLvoid*)(size_t)m_bitangentOffset);
+        }
+    }
+    else
+    {
+        glDisableVertexAttribArray(C_VB_BITANGENT);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method updates the vertex buffer and sets up the vertex, normal, 
+    texture coordinate and color arrays of the fixed pipeline.
+
+    \param  a_useTexCoordData  If __true__, then texture coordinates are enabled.
+    \param  a_useColorData     If __true__, then vertex colors are enabled.
+    \param  a_textureUnit      Texture unit receiving texture coordinates.
+*/
+//==============================================================================
+void cVertexArray::renderInitializeFixedPipeline(const bool a_useTexCoordData, 
+                                                 const bool a_useColorData, 
+                                                 const GLenum a_textureUnit)
+{
+#ifdef C_USE_OPENGL
+    // update vertex buffer
+    updateVertexBuffer();
+
+    GLsizei stride = m_vertexBufferStride;
+
+    // bind buffer and set arrays
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, stride, (const GLvoid*)0);
+
+    if (m_useNormalData)
+    {
+        GLenum type = (m_layout.m_vectorFormat == C_VERTEX_VECTOR_DOUBLE) ? GL_FLOAT : GL_SHORT;
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glNormalPointer(type, stride, (const GLvoid*)(size_t)m_normalOffset);
+    }
+
+    if (a_useTexCoordData && m_useTexCoordData)
+    {
+        glClientActiveTexture(a_textureUnit);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        switch (m_layout.m_texCoordFormat)
+        {
+            case C_VERTEX_TEXCOORD_DOUBLE:
+                glTexCoordPointer(3, GL_FLOAT, stride, (const GLvoid*)(size_t)m_texCoordOffset);
+                break;
+
+            case C_VERTEX_TEXCOORD_FLOAT:
+                glTexCoordPointer(2, GL_FLOAT, stride, (const GLvoid*)(size_t)m_texCoordOffset);
+                break;
+
+            case C_VERTEX_TEXCOORD_HALF:
+                glTexCoordPointer(2, GL_HALF_FLOAT, stride, (const GLvoid*)(size_t)m_texCoordOffset);
+                break;
+        }
+        glClientActiveTexture(GL_TEXTURE0);
+    }
+
+    if (a_useColorData && m_useColorData)
+    {
+        GLenum type = (m_layout.m_colorFormat == C_VERTEX_COLOR_FLOAT) ? GL_FLOAT : GL_UNSIGNED_BYTE;
+        glEnableClientState(GL_COLOR_ARRAY);
+        glColorPointer(4, type, stride, (const GLvoid*)(size_t)m_colorOffset);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method disables the vertex arrays of the fixed pipeline enabled by
+    \ref renderInitializeFixedPipeline().
+
+    \param  a_textureUnit  Texture unit receiving texture coordinates.
+*/
+//==============================================================================
+void cVertexArray::renderFinalizeFixedPipeline(const GLenum a_textureUnit)
+{
+#ifdef C_USE_OPENGL
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glClientActiveTexture(a_textureUnit);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glClientActiveTexture(GL_TEXTURE0);
+#endif
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -52,6 +52,8 @@
 //------------------------------------------------------------------------------
 #include <vector>
 #include <list>
+#include <cmath>
+#include <cstring>
 //------------------------------------------------------------------------------
 namespace chai3d {
 //------------------------------------------------------------------------------
@@ -103,6 +105,74 @@ public:
     bool m_useUserData; 
 };
 
+
+//------------------------------------------------------------------------------
+enum cVertexVectorFormat
+{
+    C_VERTEX_VECTOR_DOUBLE,
+    C_VERTEX_VECTOR_INT_2_10_10_10
+};
+
+enum cVertexTexCoordFormat
+{
+    C_VERTEX_TEXCOORD_DOUBLE,
+    C_VERTEX_TEXCOORD_FLOAT,
+    C_VERTEX_TEXCOORD_HALF
+};
+
+enum cVertexColorFormat
+{
+    C_VERTEX_COLOR_FLOAT,
+    C_VERTEX_COLOR_BYTE
+};
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \struct     cVertexArrayLayout
+    \ingroup    graphics
+
+    \brief
+    This structure describes how vertex attributes are stored in memory.
+
+    \details
+    By default, normals, tangents, bitangents and texture coordinates are 
+    stored as \ref cVector3d and colors as \ref cColorf. A compact layout 
+    stores normals, tangents and bitangents as signed normalized 10:10:10:2 
+    integers (4 bytes), texture coordinates as two float or half float values 
+    (8 or 4 bytes) and colors as four bytes. Compact texture coordinates only
+    store the __U__ and __V__ components. Vertex positions are always stored
+    in double precision since they are used for collision detection.
+*/
+//==============================================================================
+struct cVertexArrayLayout
+{
+
+public:
+
+    cVertexArrayLayout(const cVertexVectorFormat a_vectorFormat = C_VERTEX_VECTOR_DOUBLE,
+                       const cVertexTexCoordFormat a_texCoordFormat = C_VERTEX_TEXCOORD_DOUBLE,
+                       const cVertexColorFormat a_colorFormat = C_VERTEX_COLOR_FLOAT)
+    {
+        m_vectorFormat      = a_vectorFormat;
+        m_texCoordFormat    = a_texCoordFormat;
+        m_colorFormat       = a_colorFormat;
+    }
+
+    //! This method returns __true__ if any attribute uses a compact format.
+    bool isCompact() const
+    {
+        return ((m_vectorFormat != C_VERTEX_VECTOR_DOUBLE) ||
+                (m_texCoordFormat != C_VERTEX_TEXCOORD_DOUBLE) ||
+                (m_colorFormat != C_VERTEX_COLOR_FLOAT));
+    }
+
+    cVertexVectorFormat m_vectorFormat;
+    cVertexTexCoordFormat m_texCoordFormat;
+    cVertexColorFormat m_colorFormat;
+};
+
 //------------------------------------------------------------------------------
 class cVertexArray;
 typedef std::shared_ptr<cVertexArray> cVertexArrayPtr;
@@ -156,6 +226,9 @@ public:
         m_useTangentData    = a_options.m_useTangentData;
         m_useBitangentData  = a_options.m_useBitangentData;
         m_useUserData       = a_options.m_useUserData;
+        m_useGlobalPosData  = true;
+        m_parentGlobalPos.zero();
+        m_parentGlobalRot.identity();
         m_flagPositionData  = false;
         m_flagNormalData    = false;
         m_flagTexCoordData  = false;
@@ -164,12 +237,16 @@ public:
         m_flagBitangentData = false;
         m_flagUserData      = false;
         m_flagBufferResize  = true;
-        m_positionBuffer    = (GLuint)(-1);
-        m_normalBuffer      = (GLuint)(-1);
-        m_texCoordBuffer    = (GLuint)(-1);
-        m_colorBuffer       = (GLuint)(-1);
-        m_tangentBuffer     = (GLuint)(-1);
-        m_bitangentBuffer   = (GLuint)(-1);
+        m_modifiedBegin     = (unsigned int)(-1);
+        m_modifiedEnd       = 0;
+        m_vertexBuffer      = (GLuint)(-1);
+        m_vertexBufferSize  = 0;
+        m_vertexBufferStride = 0;
+        m_normalOffset      = 0;
+        m_texCoordOffset    = 0;
+        m_colorOffset       = 0;
+        m_tangentOffset     = 0;
+        m_bitangentOffset   = 0;
     }
 
 
@@ -232,6 +309,12 @@ public:
         m_tangent.clear();
         m_bitangent.clear();
         m_userData.clear();
+        m_normalPacked.clear();
+        m_texCoordFloat.clear();
+        m_texCoordHalf.clear();
+        m_colorPacked.clear();
+        m_tangentPacked.clear();
+        m_bitangentPacked.clear();
         m_numVertices = 0;
         m_flagBufferResize = true;
     }
@@ -260,6 +343,12 @@ public:
         vertexArray->m_tangent = m_tangent;
         vertexArray->m_bitangent = m_bitangent;
         vertexArray->m_userData = m_userData;
+        vertexArray->m_normalPacked = m_normalPacked;
+        vertexArray->m_texCoordFloat = m_texCoordFloat;
+        vertexArray->m_texCoordHalf = m_texCoordHalf;
+        vertexArray->m_colorPacked = m_colorPacked;
+        vertexArray->m_tangentPacked = m_tangentPacked;
+        vertexArray->m_bitangentPacked = m_bitangentPacked;
 
         // copy data
         vertexArray->m_useNormalData = m_useNormalData;
@@ -268,6 +357,10 @@ public:
         vertexArray->m_useTangentData = m_useTangentData;
         vertexArray->m_useBitangentData = m_useBitangentData;
         vertexArray->m_useUserData = m_useUserData;
+        vertexArray->m_useGlobalPosData = m_useGlobalPosData;
+        vertexArray->m_parentGlobalPos = m_parentGlobalPos;
+        vertexArray->m_parentGlobalRot = m_parentGlobalRot;
+        vertexArray->m_layout = m_layout;
         vertexArray->m_numVertices = m_numVertices;
 
         // return new vertex array
@@ -330,6 +423,7 @@ public:
     {
         m_localPos[a_vertexIndex].set(a_x, a_y, a_z);
         m_flagPositionData = true;
+        markModified(a_vertexIndex);
     }
 
 
@@ -346,6 +440,7 @@ public:
     {
         m_localPos[a_vertexIndex] = a_pos;
         m_flagPositionData = true;
+        markModified(a_vertexIndex);
     }
 
 
@@ -363,6 +458,7 @@ public:
     {
         m_localPos[a_vertexIndex].add(a_translation);
         m_flagPositionData = true;
+        markModified(a_vertexIndex);
     }
 
 
@@ -384,7 +480,9 @@ public:
     /*!
         This method returns the global position of a selected vertex. This value 
         is only correct if the computeGlobalPositions() method has been called 
-        previously.
+        previously. If global positions are not stored (see 
+        \ref setUseGlobalPosData()), the value is computed from the global 
+        position and rotation of the parent object passed at that call.
 
         \param  a_vertexIndex  Vertex index number.
         \return Global position of vertex in world coordinates.
@@ -392,7 +490,76 @@ public:
     //--------------------------------------------------------------------------
     inline cVector3d getGlobalPos(const unsigned int a_vertexIndex) const 
     { 
-        return (m_globalPos[a_vertexIndex]); 
+        if (m_useGlobalPosData)
+        {
+            return (m_globalPos[a_vertexIndex]); 
+        }
+        else
+        {
+            cVector3d pos;
+            m_parentGlobalRot.mulr(m_localPos[a_vertexIndex], pos);
+            pos.add(m_parentGlobalPos);
+            return (pos);
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method enables or disables the storage of the global position of
+        each vertex. When disabled, \ref m_globalPos is released, which halves
+        the memory used by vertex positions, and \ref getGlobalPos() computes 
+        global positions on demand. Storage can be enabled temporarily to cache
+        global positions, for instance while exporting a large model.
+
+        \param  a_useGlobalPosData  If __true__ then global positions are stored.
+    */
+    //--------------------------------------------------------------------------
+    inline void setUseGlobalPosData(const bool a_useGlobalPosData)
+    {
+        if (a_useGlobalPosData == m_useGlobalPosData) { return; }
+
+        m_useGlobalPosData = a_useGlobalPosData;
+        if (m_useGlobalPosData)
+        {
+            m_globalPos.resize(m_localPos.size());
+            computeGlobalPositions(m_parentGlobalPos, m_parentGlobalRot);
+        }
+        else
+        {
+            std::vector<cVector3d>().swap(m_globalPos);
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns __true__ if the global position of each vertex is 
+        stored.
+
+        \return __true__ if global positions are stored.
+    */
+    //--------------------------------------------------------------------------
+    inline bool getUseGlobalPosData() const
+    {
+        return (m_useGlobalPosData);
+    }
+
+
+    //! This method sets the memory layout of vertex attributes and converts existing data.
+    void setLayout(const cVertexArrayLayout& a_layout);
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the memory layout of vertex attributes.
+
+        \return Memory layout of vertex attributes.
+    */
+    //--------------------------------------------------------------------------
+    inline const cVertexArrayLayout& getLayout() const
+    {
+        return (m_layout);
     }
 
 
@@ -409,8 +576,16 @@ public:
     {
         if (m_useNormalData)
         {
-            m_normal[a_vertexIndex] = a_normal;
+            if (m_layout.m_vectorFormat == C_VERTEX_VECTOR_DOUBLE)
+            {
+                m_normal[a_vertexIndex] = a_normal;
+            }
+            else
+            {
+                m_normalPacked[a_vertexIndex] = packVector(a_normal);
+            }
             m_flagNormalData = true;
+            markModified(a_vertexIndex);
         }
     }
 
@@ -432,8 +607,7 @@ public:
     {
         if (m_useNormalData)
         {
-            m_normal[a_vertexIndex].set(a_x, a_y, a_z);
-            m_flagNormalData = true;
+            setNormal(a_vertexIndex, cVector3d(a_x, a_y, a_z));
         }
     }
 
@@ -448,6 +622,10 @@ public:
     //--------------------------------------------------------------------------
     inline cVector3d getNormal(const unsigned int a_vertexIndex) const
     {
+        if (m_layout.m_vectorFormat != C_VERTEX_VECTOR_DOUBLE)
+        {
+            return (unpackVector(m_normalPacked[a_vertexIndex]));
+        }
         return (m_normal[a_vertexIndex]);
     }
 
@@ -465,8 +643,24 @@ public:
     {
         if (m_useTexCoordData)
         {
-            m_texCoord[a_vertexIndex] = a_texCoord;
+            switch (m_layout.m_texCoordFormat)
+            {
+                case C_VERTEX_TEXCOORD_DOUBLE:
+                    m_texCoord[a_vertexIndex] = a_texCoord;
+                    break;
+
+                case C_VERTEX_TEXCOORD_FLOAT:
+                    m_texCoordFloat[2*a_vertexIndex]   = (float)a_texCoord(0);
+                    m_texCoordFloat[2*a_vertexIndex+1] = (float)a_texCoord(1);
+                    break;
+
+                case C_VERTEX_TEXCOORD_HALF:
+                    m_texCoordHalf[2*a_vertexIndex]   = packHalf(a_texCoord(0));
+                    m_texCoordHalf[2*a_vertexIndex+1] = packHalf(a_texCoord(1));
+                    break;
+            }
             m_flagTexCoordData = true;
+            markModified(a_vertexIndex);
         }
     }
 
@@ -489,8 +683,7 @@ public:
     {
         if (m_useTexCoordData)
         {
-            m_texCoord[a_vertexIndex].set(a_tx, a_ty,a_tz);
-            m_flagTexCoordData = true;
+            setTexCoord(a_vertexIndex, cVector3d(a_tx, a_ty, a_tz));
         }
     }
 
@@ -505,7 +698,17 @@ public:
     //--------------------------------------------------------------------------
     inline cVector3d getTexCoord(const unsigned int a_vertexIndex) const 
     { 
-        return (m_texCoord[a_vertexIndex]);
+        switch (m_layout.m_texCoordFormat)
+        {
+            case C_VERTEX_TEXCOORD_FLOAT:
+                return (cVector3d(m_texCoordFloat[2*a_vertexIndex], m_texCoordFloat[2*a_vertexIndex+1], 0.0));
+
+            case C_VERTEX_TEXCOORD_HALF:
+                return (cVector3d(unpackHalf(m_texCoordHalf[2*a_vertexIndex]), unpackHalf(m_texCoordHalf[2*a_vertexIndex+1]), 0.0));
+
+            default:
+                return (m_texCoord[a_vertexIndex]);
+        }
     }
 
 
@@ -522,8 +725,16 @@ public:
     { 
         if (m_useColorData)
         {
-            m_color[a_vertexIndex] = a_color;
+            if (m_layout.m_colorFormat == C_VERTEX_COLOR_FLOAT)
+            {
+                m_color[a_vertexIndex] = a_color;
+            }
+            else
+            {
+                m_colorPacked[a_vertexIndex] = packColor(a_color);
+            }
             m_flagColorData = true;
+            markModified(a_vertexIndex);
         }
     }
 
@@ -548,8 +759,7 @@ public:
     {
         if (m_useColorData)
         {
-            m_color[a_vertexIndex].set(a_red, a_green, a_blue, a_alpha);
-            m_flagColorData = true;
+            setColor(a_vertexIndex, cColorf(a_red, a_green, a_blue, a_alpha));
         }
     }
 
@@ -567,8 +777,7 @@ public:
     {
         if (m_useColorData)
         {
-            m_color[a_vertexIndex] = a_color.getColorf();
-            m_flagColorData = true;
+            setColor(a_vertexIndex, a_color.getColorf());
         }
     }
 
@@ -583,6 +792,10 @@ public:
     //--------------------------------------------------------------------------
     inline cColorf getColor(const unsigned int a_vertexIndex) const
     {
+        if (m_layout.m_colorFormat != C_VERTEX_COLOR_FLOAT)
+        {
+            return (unpackColor(m_colorPacked[a_vertexIndex]));
+        }
         return (m_color[a_vertexIndex]);
     }
 
@@ -600,8 +813,16 @@ public:
     {
         if (m_useTangentData)
         {
-            m_tangent[a_vertexIndex] = a_tangent;
+            if (m_layout.m_vectorFormat == C_VERTEX_VECTOR_DOUBLE)
+            {
+                m_tangent[a_vertexIndex] = a_tangent;
+            }
+            else
+            {
+                m_tangentPacked[a_vertexIndex] = packVector(a_tangent);
+            }
             m_flagTangentData = true;
+            markModified(a_vertexIndex);
         }
     }
 
@@ -623,8 +844,7 @@ public:
     {
         if (m_useTangentData)
         {
-            m_tangent[a_vertexIndex].set(a_x, a_y, a_z);
-            m_flagTangentData = true;
+            setTangent(a_vertexIndex, cVector3d(a_x, a_y, a_z));
         }
     }
 
@@ -639,6 +859,10 @@ public:
     //--------------------------------------------------------------------------
     inline cVector3d getTangent(const unsigned int a_vertexIndex) const
     {
+        if (m_layout.m_vectorFormat != C_VERTEX_VECTOR_DOUBLE)
+        {
+            return (unpackVector(m_tangentPacked[a_vertexIndex]));
+        }
         return (m_tangent[a_vertexIndex]);
     }
 
@@ -656,8 +880,16 @@ public:
     {
         if (m_useBitangentData)
         {
-            m_bitangent[a_vertexIndex] = a_bitangent;
+            if (m_layout.m_vectorFormat == C_VERTEX_VECTOR_DOUBLE)
+            {
+                m_bitangent[a_vertexIndex] = a_bitangent;
+            }
+            else
+            {
+                m_bitangentPacked[a_vertexIndex] = packVector(a_bitangent);
+            }
             m_flagBitangentData = true;
+            markModified(a_vertexIndex);
         }
     }
 
@@ -679,8 +911,7 @@ public:
     {
         if (m_useBitangentData)
         {
-            m_bitangent[a_vertexIndex].set(a_x, a_y, a_z);
-            m_flagBitangentData = true;
+            setBitangent(a_vertexIndex, cVector3d(a_x, a_y, a_z));
         }
     }
 
@@ -695,6 +926,10 @@ public:
     //--------------------------------------------------------------------------
     inline cVector3d getBitangent(const unsigned int a_vertexIndex) const
     {
+        if (m_layout.m_vectorFormat != C_VERTEX_VECTOR_DOUBLE)
+        {
+            return (unpackVector(m_bitangentPacked[a_vertexIndex]));
+        }
         return (m_bitangent[a_vertexIndex]);
     }
 
@@ -746,11 +981,29 @@ public:
                                       const cVector3d& a_globalPos, 
                                       const cMatrix3d& a_globalRot)
     {
+        m_parentGlobalPos = a_globalPos;
+        m_parentGlobalRot = a_globalRot;
+        if (!m_useGlobalPosData) { return; }
+
         a_globalRot.mulr(m_localPos[a_vertexIndex], m_globalPos[a_vertexIndex]);
         m_globalPos[a_vertexIndex].add(a_globalPos);
     }
 
 
+    //--------------------------------------------------------------------------
+    /*!
+        This method computes the global position of all vertices given the 
+        global position and global rotation matrix of the parent object.
+        Large arrays are split across several threads.
+
+        \param  a_globalPos    Global position vector of parent.
+        \param  a_globalRot    Global rotation matrix of parent.
+    */
+    //--------------------------------------------------------------------------
+    void computeGlobalPositions(const cVector3d& a_globalPos, 
+                                const cMatrix3d& a_globalRot);
+
+
     //--------------------------------------------------------------------------
     /*!
         This method returns the number of vertices allocated in this array.
@@ -848,190 +1101,35 @@ public:
     }
 
 
-    //--------------------------------------------------------------------------
-    /*!
-        This method allocates or updates all OpenGL buffers.
-    */
-    //--------------------------------------------------------------------------
-    inline void renderInitialize()
-    { 
-#ifdef C_USE_OPENGL
-        // create buffers first time
-        if (m_positionBuffer == (GLuint)(-1))
-        {
-            glGenBuffers(1, &m_positionBuffer);
-        }
-        
-        if ((m_normalBuffer == (GLuint)(-1)) && (m_useNormalData))
-        {
-            glGenBuffers(1, &m_normalBuffer);
-        }
-        
-        if ((m_texCoordBuffer == (GLuint)(-1)) && (m_useTexCoordData))
-        {
-            glGenBuffers(1, &m_texCoordBuffer);
-        }
-        
-        if ((m_colorBuffer == (GLuint)(-1)) && (m_useColorData))
-        {
-            glGenBuffers(1, &m_colorBuffer);
-        }
-        
-        if ((m_tangentBuffer == (GLuint)(-1)) && (m_useTangentData))
-        {
-            glGenBuffers(1, &m_tangentBuffer);
-        }
-        
-        if ((m_bitangentBuffer == (GLuint)(-1)) && (m_useBitangentData))
-        {
-            glGenBuffers(1, &m_bitangentBuffer);
-        }
-
-        // resize buffers
-        if (m_flagBufferResize)
-        {
-            if (true)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_localPos[0]), GL_STATIC_DRAW);
-            }
-
-            if (m_useNormalData)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_normal[0]), GL_STATIC_DRAW);
-            }
-
-            if (m_useTexCoordData)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_texCoord[0]), GL_STATIC_DRAW);
-            }
+    //! This method updates the vertex buffer and binds its attributes for rendering with shaders.
+    void renderInitialize();
 
-            if (m_useColorData)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_colorBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cColorf), &(m_color[0]), GL_STATIC_DRAW);
-            }
+    //! This method updates the vertex buffer and binds its attributes for rendering with the fixed pipeline.
+    void renderInitializeFixedPipeline(const bool a_useTexCoordData, 
+                                       const bool a_useColorData, 
+                                       const GLenum a_textureUnit);
 
-            if (m_useTangentData)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_tangentBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_tangent[0]), GL_STATIC_DRAW);
-            }
-        
-            if (m_useBitangentData)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_bitangentBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_bitangent[0]), GL_STATIC_DRAW);
-            }
+    //! This method disables the vertex arrays enabled by renderInitializeFixedPipeline().
+    void renderFinalizeFixedPipeline(const GLenum a_textureUnit);
 
-            m_flagBufferResize = false;
-        }
 
-        // update buffers if needed
-        if (m_flagPositionData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_localPos[0]));
-            m_flagPositionData = false;
-        }
-        if (m_flagNormalData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_normal[0]));
-            m_flagNormalData = false;
-        }
-        if (m_flagTexCoordData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_texCoord[0]));
-            m_flagTexCoordData = false;
-        }
-        if (m_flagColorData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_colorBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cColorf), &(m_color[0]));
-            m_flagColorData = false;
-        }
-        if (m_flagTangentData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_tangentBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_tangent[0]));
-            m_flagTangentData = false;
-        }
-        if (m_flagBitangentData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_bitangentBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_bitangent[0]));
-            m_flagBitangentData = false;
-        }
-
-        // bind buffers and set client state
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
-            glEnableVertexAttribArray(C_VB_POSITION);
-            glVertexAttribPointer(C_VB_POSITION, 3, GL_DOUBLE, GL_FALSE, 0, 0);
-            glVertexPointer(3, GL_DOUBLE, 0, 0);
-        }
-        
-        if (m_useNormalData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
-            glEnableVertexAttribArray(C_VB_NORMAL);
-            glVertexAttribPointer(C_VB_NORMAL, 3, GL_DOUBLE, GL_FALSE, 0, 0);
-        }
-        else
-        {
-            glDisableVertexAttribArray(C_VB_NORMAL);
-        }
-
-        if (m_useTexCoordData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
-            glEnableVertexAttribArray(C_VB_TEXCOORD);
-            glVertexAttribPointer(C_VB_TEXCOORD, 3, GL_DOUBLE, GL_FALSE, 0, 0);
-        }
-        else
-        {
-            glDisableVertexAttribArray(C_VB_TEXCOORD);
-        }
-
-        if (m_useColorData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_colorBuffer);
-            glEnableVertexAttribArray(C_VB_COLOR);
-            glVertexAttribPointer(C_VB_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(cColorf), 0);
-        }
-        else
-        {
-            glDisableVertexAttribArray(C_VB_COLOR);
-        }
-
-        if (m_useTangentData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_tangentBuffer);
-            glEnableVertexAttribArray(C_VB_TANGENT);
-            glVertexAttribPointer(C_VB_TANGENT, 3, GL_DOUBLE, GL_FALSE, 0, 0);
-        }
-        else
-        {
-            glDisableVertexAttribArray(C_VB_TANGENT);
-        }
-
-        if (m_useBitangentData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_bitangentBuffer);
-            glEnableVertexAttribArray(C_VB_BITANGENT);
-            glVertexAttribPointer(C_VB_BITANGENT, 3, GL_DOUBLE, GL_FALSE, 0, 0);
-        }
-        else
-        {
-            glDisableVertexAttribArray(C_VB_BITANGENT);
-        }
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-#endif
+    //--------------------------------------------------------------------------
+    /*!
+        This method marks all vertex data for update. It must be called after
+        modifying vertex data directly through the public data members so that
+        the vertex buffer is entirely updated at the next rendering pass.
+    */
+    //--------------------------------------------------------------------------
+    inline void markForUpdate()
+    {
+        m_flagPositionData  = true;
+        m_flagNormalData    = m_useNormalData;
+        m_flagTexCoordData  = m_useTexCoordData;
+        m_flagColorData     = m_useColorData;
+        m_flagTangentData   = m_useTangentData;
+        m_flagBitangentData = m_useBitangentData;
+        m_modifiedBegin     = 0;
+        m_modifiedEnd       = m_numVertices;
     }
 
 
@@ -1080,26 +1178,37 @@ public:
         // update position data allocation
         cVector3d pos(0.0, 0.0, 0.0);
         m_localPos.resize(m_numVertices, pos);
-        m_globalPos.resize(m_numVertices, pos);
+        if (m_useGlobalPosData)
+        {
+            m_globalPos.resize(m_numVertices, pos);
+        }
 
         // update normal data allocation
         m_useNormalData = a_useNormalData;
         if (m_useNormalData)
         {
             cVector3d normal(1.0, 0.0, 0.0);
-            if ((a_numberOfVertices > 1) || (a_numberOfVertices == 0))
+            if (m_layout.m_vectorFormat == C_VERTEX_VECTOR_DOUBLE)
             {
-                m_normal.resize(m_numVertices, normal);
+                if ((a_numberOfVertices > 1) || (a_numberOfVertices == 0))
+                {
+                    m_normal.resize(m_numVertices, normal);
+                }
+                else
+                {
+                    m_normal.push_back(normal);
+                }
             }
             else
             {
-                m_normal.push_back(normal);
+                m_normalPacked.resize(m_numVertices, packVector(normal));
             }
             m_flagNormalData = true;
         }
         else
         {
             m_normal.clear();
+            m_normalPacked.clear();
         }
 
         // texture coordinate data allocation
@@ -1107,19 +1216,34 @@ public:
         if (m_useTexCoordData)
         {
             cVector3d texCoord(0.0, 0.0, 0.0);
-            if ((a_numberOfVertices > 1) || (a_numberOfVertices == 0))
+            switch (m_layout.m_texCoordFormat)
             {
-                m_texCoord.resize(m_numVertices, texCoord);
-            }
-            else
-            {
-                m_texCoord.push_back(texCoord);
+                case C_VERTEX_TEXCOORD_DOUBLE:
+                    if ((a_numberOfVertices > 1) || (a_numberOfVertices == 0))
+                    {
+                        m_texCoord.resize(m_numVertices, texCoord);
+                    }
+                    else
+                    {
+                        m_texCoord.push_back(texCoord);
+                    }
+                    break;
+
+                case C_VERTEX_TEXCOORD_FLOAT:
+                    m_texCoordFloat.resize(2 * m_numVertices, 0.0f);
+                    break;
+
+                case C_VERTEX_TEXCOORD_HALF:
+                    m_texCoordHalf.resize(2 * m_numVertices, 0);
+                    break;
             }
             m_flagTexCoordData = true;
         }
         else
         {
             m_texCoord.clear();
+            m_texCoordFloat.clear();
+            m_texCoordHalf.clear();
         }
 
         // update color data allocation
@@ -1127,19 +1251,27 @@ public:
         if (m_useColorData)
         {
             cColorf color(0.0, 0.0, 0.0, 1.0);
-            if ((a_numberOfVertices > 1) || (a_numberOfVertices == 0))
+            if (m_layout.m_colorFormat == C_VERTEX_COLOR_FLOAT)
             {
-                m_color.resize(m_numVertices, color);
+                if ((a_numberOfVertices > 1) || (a_numberOfVertices == 0))
+                {
+                    m_color.resize(m_numVertices, color);
+                }
+                else
+                {
+                    m_color.push_back(color);
+                }
             }
             else
             {
-                m_color.push_back(color);
+                m_colorPacked.resize(m_numVertices, packColor(color));
             }
             m_flagColorData = true;
         }
         else
         {
             m_color.clear();
+            m_colorPacked.clear();
         }
 
         // update tangent data allocation
@@ -1147,19 +1279,27 @@ public:
         if (m_useTangentData)
         {
             cVector3d tangent(1.0, 0.0, 0.0);
-            if ((a_numberOfVertices > 1) || (a_numberOfVertices == 0))
+            if (m_layout.m_vectorFormat == C_VERTEX_VECTOR_DOUBLE)
             {
-                m_tangent.resize(m_numVertices, tangent);
+                if ((a_numberOfVertices > 1) || (a_numberOfVertices == 0))
+                {
+                    m_tangent.resize(m_numVertices, tangent);
+                }
+                else
+                {
+                    m_tangent.push_back(tangent);
+                }
             }
             else
             {
-                m_tangent.push_back(tangent);
+                m_tangentPacked.resize(m_numVertices, packVector(tangent));
             }
             m_flagTangentData = true;
         }
         else
         {
             m_tangent.clear();
+            m_tangentPacked.clear();
         }
 
         // update bitangent data allocation
@@ -1167,19 +1307,27 @@ public:
         if (m_useBitangentData)
         {
             cVector3d bitangent(0.0, 1.0, 0.0);
-            if ((a_numberOfVertices > 1) || (a_numberOfVertices == 0))
+            if (m_layout.m_vectorFormat == C_VERTEX_VECTOR_DOUBLE)
             {
-                m_bitangent.resize(m_numVertices, bitangent);
+                if ((a_numberOfVertices > 1) || (a_numberOfVertices == 0))
+                {
+                    m_bitangent.resize(m_numVertices, bitangent);
+                }
+                else
+                {
+                    m_bitangent.push_back(bitangent);
+                }
             }
             else
             {
-                m_bitangent.push_back(bitangent);
+                m_bitangentPacked.resize(m_numVertices, packVector(bitangent));
             }
             m_flagBitangentData = true;
         }
         else
         {
             m_bitangent.clear();
+            m_bitangentPacked.clear();
         }
 
         // update user data allocation
@@ -1207,6 +1355,189 @@ public:
     }
 
 
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method extends the range of vertices to be updated in the vertex
+        buffer to include a selected vertex.
+
+        \param  a_vertexIndex  Vertex index number.
+    */
+    //--------------------------------------------------------------------------
+    inline void markModified(const unsigned int a_vertexIndex)
+    {
+        if (a_vertexIndex < m_modifiedBegin) { m_modifiedBegin = a_vertexIndex; }
+        if (a_vertexIndex >= m_modifiedEnd) { m_modifiedEnd = a_vertexIndex + 1; }
+    }
+
+
+    //! This method packs modified vertex data into the interleaved vertex buffer.
+    void updateVertexBuffer();
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method packs a vector into a signed normalized 10:10:10:2 integer
+        as defined by __GL_INT_2_10_10_10_REV__. Components are clamped to 
+        [-1, 1].
+
+        \param  a_vector  Vector to pack.
+        \return Packed vector.
+    */
+    //--------------------------------------------------------------------------
+    static inline unsigned int packVector(const cVector3d& a_vector)
+    {
+        unsigned int result = 0;
+        for (int i=0; i<3; i++)
+        {
+            double value = a_vector(i);
+            if (value > 1.0) { value = 1.0; }
+            else if (value < -1.0) { value = -1.0; }
+            int component = (int)floor(511.0 * value + 0.5);
+            result |= ((unsigned int)component & 0x3FF) << (10 * i);
+        }
+        return (result);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method unpacks a signed normalized 10:10:10:2 integer into a vector.
+
+        \param  a_data  Packed vector.
+        \return Unpacked vector.
+    */
+    //--------------------------------------------------------------------------
+    static inline cVector3d unpackVector(const unsigned int a_data)
+    {
+        cVector3d result;
+        for (int i=0; i<3; i++)
+        {
+            int component = (int)((a_data >> (10 * i)) & 0x3FF);
+            if (component & 0x200) { component -= 0x400; }
+            double value = (double)component / 511.0;
+            result(i) = (value < -1.0) ? -1.0 : value;
+        }
+        return (result);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method converts a value to a half precision float, rounding to 
+        the nearest representable value.
+
+        \param  a_value  Value to convert.
+        \return Half precision float.
+    */
+    //--------------------------------------------------------------------------
+    static inline unsigned short packHalf(const double a_value)
+    {
+        float value = (float)a_value;
+        unsigned int bits;
+        memcpy(&bits, &value, sizeof(bits));
+
+        unsigned int sign = (bits >> 16) & 0x8000;
+        int exponent = (int)((bits >> 23) & 0xFF) - 112;
+        unsigned int mantissa = bits & 0x007FFFFF;
+
+        // overflow, infinity and NaN
+        if (exponent >= 31)
+        {
+            return ((unsigned short)(sign | 0x7C00));
+        }
+
+        // subnormal numbers and zero
+        if (exponent <= 0)
+        {
+            if (exponent < -10) { return ((unsigned short)sign); }
+            mantissa = mantissa | 0x00800000;
+            int shift = 14 - exponent;
+            unsigned int half = mantissa >> shift;
+            if ((mantissa >> (shift - 1)) & 1) { half++; }
+            return ((unsigned short)(sign | half));
+        }
+
+        // normal numbers
+        unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+        if (mantissa & 0x00001000) { half++; }
+        return ((unsigned short)half);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method converts a half precision float to a double.
+
+        \param  a_data  Half precision float.
+        \return Converted value.
+    */
+    //--------------------------------------------------------------------------
+    static inline double unpackHalf(const unsigned short a_data)
+    {
+        int exponent = (a_data >> 10) & 0x1F;
+        int mantissa = a_data & 0x3FF;
+        double value;
+        if (exponent == 0)
+        {
+            value = ldexp((double)mantissa, -24);
+        }
+        else if (exponent == 31)
+        {
+            value = HUGE_VAL;
+        }
+        else
+        {
+            value = ldexp((double)(mantissa | 0x400), exponent - 25);
+        }
+        return ((a_data & 0x8000) ? -value : value);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method packs a color into four bytes stored in __RGBA__ order.
+
+        \param  a_color  Color to pack.
+        \return Packed color.
+    */
+    //--------------------------------------------------------------------------
+    static inline unsigned int packColor(const cColorf& a_color)
+    {
+        GLubyte bytes[4] = { cColorFtoB(a_color.getR()),
+                             cColorFtoB(a_color.getG()),
+                             cColorFtoB(a_color.getB()),
+                             cColorFtoB(a_color.getA()) };
+        unsigned int result;
+        memcpy(&result, bytes, sizeof(result));
+        return (result);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method unpacks four bytes stored in __RGBA__ order into a color.
+
+        \param  a_data  Packed color.
+        \return Unpacked color.
+    */
+    //--------------------------------------------------------------------------
+    static inline cColorf unpackColor(const unsigned int a_data)
+    {
+        GLubyte bytes[4];
+        memcpy(bytes, &a_data, sizeof(a_data));
+        return (cColorf(cColorBtoF(bytes[0]),
+                        cColorBtoF(bytes[1]),
+                        cColorBtoF(bytes[2]),
+                        cColorBtoF(bytes[3])));
+    }
+
+
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
     //--------------------------------------------------------------------------
@@ -1216,7 +1547,7 @@ public:
     //! Local position of vertices.
     std::vector<cVector3d> m_localPos;
 
-    //! Global position of vertices in world coordinates.
+    //! Global position of vertices in world coordinates. Empty if global positions are not stored.
     std::vector<cVector3d> m_globalPos;
 
     //! Surface normal of vertices.
@@ -1237,6 +1568,24 @@ public:
     //! User data of vertices.
     std::vector<int> m_userData;
 
+    //! Surface normal of vertices in compact layout (signed normalized 10:10:10:2).
+    std::vector<unsigned int> m_normalPacked;
+
+    //! Texture coordinate (U,V) of vertices in compact layout (float).
+    std::vector<float> m_texCoordFloat;
+
+    //! Texture coordinate (U,V) of vertices in compact layout (half float).
+    std::vector<unsigned short> m_texCoordHalf;
+
+    //! Color of vertices in compact layout (RGBA bytes).
+    std::vector<unsigned int> m_colorPacked;
+
+    //! Surface tangent of vertices in compact layout (signed normalized 10:10:10:2).
+    std::vector<unsigned int> m_tangentPacked;
+
+    //! Surface bitangent of vertices in compact layout (signed normalized 10:10:10:2).
+    std::vector<unsigned int> m_bitangentPacked;
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
@@ -1265,6 +1614,18 @@ protected:
     //! If __true__ then surface bitangent data will be allocated for each new vertex.
     bool m_useUserData;
 
+    //! If __true__ then the global position of each vertex is stored in \ref m_globalPos.
+    bool m_useGlobalPosData;
+
+    //! Global position of the parent object passed at the last computation of global positions.
+    cVector3d m_parentGlobalPos;
+
+    //! Global rotation of the parent object passed at the last computation of global positions.
+    cMatrix3d m_parentGlobalRot;
+
+    //! Memory layout of vertex attributes.
+    cVertexArrayLayout m_layout;
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -1296,6 +1657,12 @@ public:
     //! If true, then data buffer need to be updated in size.
     bool m_flagBufferResize;
 
+    //! First vertex modified since the last update of the vertex buffer.
+    unsigned int m_modifiedBegin;
+
+    //! Last vertex (excluded) modified since the last update of the vertex buffer.
+    unsigned int m_modifiedEnd;
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS: (OPENGL)
@@ -1303,23 +1670,36 @@ public:
 
 public:
 
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_positionBuffer;
+    //! OpenGL Buffer for storing interleaved vertex data.
+    GLuint m_vertexBuffer;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS: (OPENGL)
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Number of vertices allocated in the vertex buffer.
+    unsigned int m_vertexBufferSize;
+
+    //! Size in bytes of an interleaved vertex.
+    unsigned int m_vertexBufferStride;
 
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_normalBuffer;
+    //! Offset in bytes of the surface normal in an interleaved vertex.
+    unsigned int m_normalOffset;
 
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_texCoordBuffer;
+    //! Offset in bytes of the texture coordinate in an interleaved vertex.
+    unsigned int m_texCoordOffset;
 
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_colorBuffer;
+    //! Offset in bytes of the color in an interleaved vertex.
+    unsigned int m_colorOffset;
 
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_tangentBuffer;
+    //! Offset in bytes of the surface tangent in an interleaved vertex.
+    unsigned int m_tangentOffset;
 
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_bitangentBuffer;
+    //! Offset in bytes of the surface bitangent in an interleaved vertex.
+    unsigned int m_bitangentOffset;
 };
 
 //------------------------------------------------------------------------------
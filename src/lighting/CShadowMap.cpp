@@ -332,6 +332,11 @@ bool cShadowMap::updateMap(cWorld* a_world,
         options.m_shadow_light_level                    = 1.0;
         options.m_storeObjectPositions                  = true;
         options.m_markForUpdate                         = false;
+        options.m_useFrustumCulling                     = false;
+        options.m_keepTextureBound                      = false;
+        options.m_keepShaderProgramBound                = false;
+        options.m_boundTexture                          = NULL;
+        options.m_boundShaderProgram                    = NULL;
 
         // render single pass (all objects)
         a_world->renderSceneGraph(options);
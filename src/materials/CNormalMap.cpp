@@ -59,6 +59,10 @@ cNormalMap::cNormalMap()
 {
     // set default texture unit
     m_textureUnit = GL_TEXTURE2;
+
+    // haptic field has not been built yet
+    m_hapticFieldLevel = 0;
+    m_hapticFieldDirty = false;
 }
 
 
@@ -96,6 +100,11 @@ cNormalMapPtr cNormalMap::copy()
     obj->m_useSphericalMapping      = m_useSphericalMapping;
     obj->m_environmentMode          = m_environmentMode;
 
+    // share haptic field (never modified once published)
+    obj->publishHapticField(getHapticField());
+    obj->m_hapticFieldLevel         = (unsigned int)m_hapticFieldLevel;
+    obj->m_hapticFieldDirty         = (bool)m_hapticFieldDirty;
+
     // return
     return (obj);
 }
@@ -180,6 +189,12 @@ void cNormalMap::createMap(cImagePtr a_image)
             m_image->setPixelColor(u, v, gradient);
         }
     }
+
+    // image data has changed
+    markForUpdate();
+
+    // build haptic field using the luminance of the input image as height
+    buildHapticField(a_image, 0);
 }
 
 
@@ -217,6 +232,248 @@ void cNormalMap::flip(const bool a_flipU, const bool a_flipV)
 }
 
 
+//==============================================================================
+/*!
+    This method loads a normal map image from a file and builds its haptic 
+    field.
+
+    \param  a_fileName  Filename.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cNormalMap::loadFromFile(const string& a_fileName)
+{
+    if (!cTexture2d::loadFromFile(a_fileName))
+    {
+        return (C_ERROR);
+    }
+
+    markForUpdate();
+    buildHapticField();
+
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method marks this texture for GPU update. Since the image data has 
+    changed, the haptic field is rebuilt during the next texture update on 
+    the graphics side, or by an explicit call to \ref buildHapticField().
+    Until then, the haptic thread keeps sampling the previous haptic field.
+*/
+//==============================================================================
+void cNormalMap::markForUpdate()
+{
+    cTexture2d::markForUpdate();
+    m_hapticFieldDirty = true;
+}
+
+
+//==============================================================================
+/*!
+    This method updates this texture to GPU and rebuilds the haptic field if 
+    the image has changed since it was last built.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cNormalMap::update(cRenderOptions& a_options)
+{
+    cTexture2d::update(a_options);
+
+    if (m_hapticFieldDirty)
+    {
+        buildHapticField();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method publishes a new haptic field with an atomic pointer swap. 
+    The previous field is retained until the next swap so that it is released
+    on the loading or graphics side rather than by the haptic thread.
+
+    \param  a_hapticField  New haptic field, or __nullptr__.
+*/
+//==============================================================================
+void cNormalMap::publishHapticField(cNormalMapHapticFieldPtr a_hapticField)
+{
+    m_retiredHapticField = std::atomic_exchange(&m_hapticField, a_hapticField);
+}
+
+
+//==============================================================================
+/*!
+    This method builds the haptic field from the normal map image. 
+    Height values are set to zero.
+
+    \param  a_numLevels  Number of mip levels. If set to 0, the full mip chain 
+                         down to a 1x1 level is created.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cNormalMap::buildHapticField(const unsigned int a_numLevels)
+{
+    return (buildHapticField(nullptr, a_numLevels));
+}
+
+
+//==============================================================================
+/*!
+    This method builds the haptic field from the normal map image. Each texel
+    of the normal map is decoded once into a gradient vector, and the 
+    luminance of the optional height image is stored as height (0.0 to 1.0).
+    Coarser mip levels are computed by averaging blocks of 2x2 texels.
+
+    \param  a_heightImage  Height image, of same size as the normal map, or __nullptr__.
+    \param  a_numLevels    Number of mip levels. If set to 0, the full mip chain 
+                           down to a 1x1 level is created.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cNormalMap::buildHapticField(cImagePtr a_heightImage, const unsigned int a_numLevels)
+{
+    // changes made to the image from now on require another build
+    m_hapticFieldDirty = false;
+
+    // sanity check
+    if ((m_image == nullptr) || (!m_image->isInitialized()))
+    {
+        clearHapticField();
+        return (C_ERROR);
+    }
+
+    int w = m_image->getWidth();
+    int h = m_image->getHeight();
+    if ((w <= 0) || (h <= 0))
+    {
+        clearHapticField();
+        return (C_ERROR);
+    }
+
+    bool useHeight = (a_heightImage != nullptr) && 
+                     (a_heightImage->getWidth() == (unsigned int)w) && 
+                     (a_heightImage->getHeight() == (unsigned int)h);
+
+    // the new field is built aside while the haptic thread samples the current one
+    std::shared_ptr<cNormalMapHapticField> hapticField = std::make_shared<cNormalMapHapticField>();
+
+    // compute size of all levels
+    size_t size = 0;
+    int levelW = w;
+    int levelH = h;
+    while (true)
+    {
+        hapticField->m_offset.push_back(size);
+        hapticField->m_width.push_back(levelW);
+        hapticField->m_height.push_back(levelH);
+        size += 4 * (size_t)(levelW + 1) * (size_t)(levelH + 1);
+
+        if ((a_numLevels > 0) && (hapticField->m_offset.size() >= a_numLevels)) { break; }
+        if ((levelW == 1) && (levelH == 1)) { break; }
+
+        levelW = cMax(1, levelW / 2);
+        levelH = cMax(1, levelH / 2);
+    }
+    hapticField->m_data.resize(size);
+
+    // decode normal map into first level
+    const float SCALE = (1.0f / 255.0f);
+    float* field = &hapticField->m_data[0];
+    int stride = 4 * (w + 1);
+    for (int y=0; y<h; y++)
+    {
+        for (int x=0; x<w; x++)
+        {
+            cColorb color;
+            m_image->getPixelColor(x, y, color);
+
+            float* texel = field + y * stride + 4 * x;
+            texel[0] = SCALE * (float)(color.getR() - 128);
+            texel[1] = SCALE * (float)(color.getG() - 128);
+            texel[2] = SCALE * (float)(color.getB() - 128);
+            texel[3] = 0.0f;
+
+            if (useHeight)
+            {
+                a_heightImage->getPixelColor(x, y, color);
+                texel[3] = SCALE * (float)(color.getLuminance());
+            }
+        }
+    }
+
+    // compute coarser levels
+    for (unsigned int level=0; level<hapticField->m_offset.size(); level++)
+    {
+        float* dst = &hapticField->m_data[hapticField->m_offset[level]];
+        int dstW = hapticField->m_width[level];
+        int dstH = hapticField->m_height[level];
+        int dstStride = 4 * (dstW + 1);
+
+        if (level > 0)
+        {
+            const float* src = &hapticField->m_data[hapticField->m_offset[level-1]];
+            int srcW = hapticField->m_width[level-1];
+            int srcH = hapticField->m_height[level-1];
+            int srcStride = 4 * (srcW + 1);
+
+            for (int y=0; y<dstH; y++)
+            {
+                int y0 = cMin(2 * y, srcH - 1);
+                int y1 = cMin(2 * y + 1, srcH - 1);
+                for (int x=0; x<dstW; x++)
+                {
+                    int x0 = cMin(2 * x, srcW - 1);
+                    int x1 = cMin(2 * x + 1, srcW - 1);
+                    for (int c=0; c<4; c++)
+                    {
+                        dst[y * dstStride + 4 * x + c] = 0.25f * (src[y0 * srcStride + 4 * x0 + c] +
+                                                                  src[y0 * srcStride + 4 * x1 + c] +
+                                                                  src[y1 * srcStride + 4 * x0 + c] +
+                                                                  src[y1 * srcStride + 4 * x1 + c]);
+                    }
+                }
+            }
+        }
+
+        // replicate last column and last row into padding
+        for (int y=0; y<dstH; y++)
+        {
+            for (int c=0; c<4; c++)
+            {
+                dst[y * dstStride + 4 * dstW + c] = dst[y * dstStride + 4 * (dstW - 1) + c];
+            }
+        }
+        for (int i=0; i<dstStride; i++)
+        {
+            dst[dstH * dstStride + i] = dst[(dstH - 1) * dstStride + i];
+        }
+    }
+
+    // make the new field visible to the haptic thread
+    publishHapticField(hapticField);
+
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method clears the haptic field. The haptic thread stops sampling it
+    at its next access.
+*/
+//==============================================================================
+void cNormalMap::clearHapticField()
+{
+    publishHapticField(nullptr);
+}
+
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
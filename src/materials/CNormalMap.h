@@ -46,6 +46,12 @@
 #define CMormalMapH
 //------------------------------------------------------------------------------
 #include "materials/CTexture2d.h"
+#include "math/CVector3d.h"
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -64,8 +70,39 @@ namespace chai3d {
 //------------------------------------------------------------------------------
 class cNormalMap;
 typedef std::shared_ptr<cNormalMap> cNormalMapPtr;
+struct cNormalMapHapticField;
+typedef std::shared_ptr<const cNormalMapHapticField> cNormalMapHapticFieldPtr;
 //------------------------------------------------------------------------------
 
+//==============================================================================
+/*!
+    \struct     cNormalMapHapticField
+    \ingroup    materials
+
+    \brief
+    This structure stores the haptic field of a normal map.
+
+    \details
+    A haptic field is built once by \ref cNormalMap and is never modified 
+    afterwards, so that the haptic thread can sample it while the graphics or 
+    loading side prepares a new one.
+*/
+//==============================================================================
+struct cNormalMapHapticField
+{
+    //! Packed haptic field data (gradient X, Y, Z and height per texel) of all mip levels.
+    std::vector<float> m_data;
+
+    //! Offset of each mip level in the haptic field data.
+    std::vector<size_t> m_offset;
+
+    //! Width of each mip level (excluding padding).
+    std::vector<int> m_width;
+
+    //! Height of each mip level (excluding padding).
+    std::vector<int> m_height;
+};
+
 //==============================================================================
 /*!
     \class      cNormalMap
@@ -76,7 +113,21 @@ typedef std::shared_ptr<cNormalMap> cNormalMapPtr;
 
     \details
     This class  implements a normal map which is used for haptic and graphic 
-    bump mapping rendering.
+    bump mapping rendering.\n
+
+    For haptic rendering, the normal map is preprocessed into a haptic field:
+    a packed single precision array storing, for each texel, the decoded 
+    normal map gradient and a height value, together with a chain of 
+    mip levels. Each level is padded by one row and one column so that 
+    bilinear sampling with \ref sampleHapticField() requires neither bounds 
+    checks nor pixel format conversions, keeping the cost of haptic textures 
+    constant regardless of the format of the image.\n
+
+    The haptic field is built on the loading or graphics side, either when 
+    the map is created or loaded, or during the next texture update that 
+    follows a call to \ref markForUpdate(). Each new field is published by 
+    an atomic pointer swap, so the haptic thread only ever reads a complete 
+    field and never allocates memory.
 */
 //==============================================================================
 class cNormalMap : public cTexture2d
@@ -117,6 +168,136 @@ public:
 
     //! This method flips normals along U and/or V axis.
     void flip(const bool a_flipU, const bool a_flipV);
+
+    //! This method loads a normal map image from a file and builds its haptic field.
+    virtual bool loadFromFile(const std::string& a_fileName);
+
+    //! This method marks this texture for GPU update and its haptic field for rebuild.
+    virtual void markForUpdate();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - HAPTIC FIELD:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method builds the haptic field from the normal map image.
+    bool buildHapticField(const unsigned int a_numLevels = 0);
+
+    //! This method clears the haptic field.
+    void clearHapticField();
+
+    //! This method returns __true__ if the haptic field is up to date with the normal map image, __false__ otherwise.
+    bool getHapticFieldValid() const { return ((!m_hapticFieldDirty) && (getHapticField() != nullptr)); }
+
+    //! This method returns the haptic field currently published for haptic rendering.
+    cNormalMapHapticFieldPtr getHapticField() const { return (std::atomic_load(&m_hapticField)); }
+
+    //! This method returns the number of mip levels of the haptic field.
+    unsigned int getNumHapticFieldLevels() const { cNormalMapHapticFieldPtr field = getHapticField(); return ((field == nullptr) ? 0 : (unsigned int)(field->m_offset.size())); }
+
+    //! This method sets the mip level of the haptic field used for haptic rendering.
+    void setHapticFieldLevel(const unsigned int a_level) { m_hapticFieldLevel = a_level; }
+
+    //! This method returns the mip level of the haptic field used for haptic rendering.
+    unsigned int getHapticFieldLevel() const { return (m_hapticFieldLevel); }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method samples the haptic field at a given texture coordinate 
+        using bilinear interpolation. Texture coordinates are clamped 
+        to [0,1]. This method may be called from the haptic thread; it 
+        samples the last published haptic field and never allocates memory.
+
+        \param  a_u         Texture coordinate along U.
+        \param  a_v         Texture coordinate along V.
+        \param  a_gradient  Returned gradient.
+        \param  a_height    Returned height.
+
+        \return __true__ if a haptic field is available, __false__ otherwise.
+    */
+    //--------------------------------------------------------------------------
+    inline bool sampleHapticField(const double a_u, 
+                                  const double a_v, 
+                                  cVector3d& a_gradient, 
+                                  double& a_height) const
+    {
+        cNormalMapHapticFieldPtr hapticField = getHapticField();
+        if ((hapticField == nullptr) || (hapticField->m_offset.empty()))
+        {
+            a_gradient.zero();
+            a_height = 0.0;
+            return (false);
+        }
+
+        const unsigned int level = std::min((unsigned int)m_hapticFieldLevel, (unsigned int)(hapticField->m_offset.size()) - 1);
+        const int w = hapticField->m_width[level];
+        const int h = hapticField->m_height[level];
+        const float* field = &hapticField->m_data[hapticField->m_offset[level]];
+
+        // position in texels (padding row and column make x0+1 and y0+1 always valid)
+        const float x = std::min(std::max((float)a_u, 0.0f), 1.0f) * (float)(w - 1);
+        const float y = std::min(std::max((float)a_v, 0.0f), 1.0f) * (float)(h - 1);
+        const int x0 = (int)x;
+        const int y0 = (int)y;
+        const float fx = x - (float)x0;
+        const float fy = y - (float)y0;
+
+        const int stride = 4 * (w + 1);
+        const float* t00 = field + y0 * stride + 4 * x0;
+        const float* t10 = t00 + 4;
+        const float* t01 = t00 + stride;
+        const float* t11 = t01 + 4;
+
+        const float w00 = (1.0f - fx) * (1.0f - fy);
+        const float w10 = fx * (1.0f - fy);
+        const float w01 = (1.0f - fx) * fy;
+        const float w11 = fx * fy;
+
+        a_gradient.set(w00 * t00[0] + w10 * t10[0] + w01 * t01[0] + w11 * t11[0],
+                       w00 * t00[1] + w10 * t10[1] + w01 * t01[1] + w11 * t11[1],
+                       w00 * t00[2] + w10 * t10[2] + w01 * t01[2] + w11 * t11[2]);
+        a_height = w00 * t00[3] + w10 * t10[3] + w01 * t01[3] + w11 * t11[3];
+
+        return (true);
+    }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method builds the haptic field from the normal map image and an optional height image.
+    bool buildHapticField(cImagePtr a_heightImage, const unsigned int a_numLevels);
+
+    //! This method publishes a new haptic field for haptic rendering.
+    void publishHapticField(cNormalMapHapticFieldPtr a_hapticField);
+
+    //! This method updates this texture to GPU and rebuilds its haptic field if needed.
+    virtual void update(cRenderOptions& a_options);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Haptic field read by the haptic thread (accessed with atomic operations only).
+    cNormalMapHapticFieldPtr m_hapticField;
+
+    //! Previously published haptic field, released on the loading or graphics side.
+    cNormalMapHapticFieldPtr m_retiredHapticField;
+
+    //! Mip level used for haptic rendering.
+    std::atomic<unsigned int> m_hapticFieldLevel;
+
+    //! If __true__ then the normal map image has changed since the haptic field was built.
+    std::atomic<bool> m_hapticFieldDirty;
 };
 
 //------------------------------------------------------------------------------
@@ -125,4 +306,4 @@ public:
 
 //------------------------------------------------------------------------------
 #endif
-//------------------------------------------------------------------------------
\ No newline at end of file
+//------------------------------------------------------------------------------
\ No newline at end of file
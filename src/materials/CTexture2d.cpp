@@ -176,6 +176,16 @@ void cTexture2d::renderInitialize(cRenderOptions& a_options)
     // check image texture
     if (m_image->isInitialized() == 0) return;
 
+    // if the texture was left bound and configured by the previous object,
+    // texturing only needs to be enabled again
+    if ((a_options.m_boundTexture == this) && (!m_updateTextureFlag))
+    {
+        glActiveTexture(m_textureUnit);
+        glEnable(GL_TEXTURE_2D);
+        glColor4f(1.0, 1.0, 1.0, 1.0);
+        return;
+    }
+
     // Only check residency in memory if we weren't going to
     // update the texture anyway...
     if (m_updateTextureFlag == false)
@@ -0,0 +1,267 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.3.0
+*/
+//==============================================================================
+
+
+//------------------------------------------------------------------------------
+#include "system/CAllocationGuard.h"
+//------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Allocation state of each thread.
+static thread_local bool s_threadGuarded = false;
+static thread_local cAllocationGuardMode s_threadMode = C_ALLOCATION_GUARD_COUNT;
+static thread_local unsigned long long s_threadNumAllocations = 0;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cAllocationGuard.
+
+    \param  a_mode  Allocation mode of the guarded scope.
+*/
+//==============================================================================
+cAllocationGuard::cAllocationGuard(const cAllocationGuardMode a_mode)
+{
+    m_previousMode = s_threadMode;
+    m_previousGuarded = s_threadGuarded;
+    m_startNumAllocations = s_threadNumAllocations;
+
+    s_threadMode = a_mode;
+    s_threadGuarded = true;
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cAllocationGuard.
+*/
+//==============================================================================
+cAllocationGuard::~cAllocationGuard()
+{
+    s_threadMode = m_previousMode;
+    s_threadGuarded = m_previousGuarded;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of heap allocations counted on the current 
+    thread since this guard was created.
+
+    \return Number of allocations.
+*/
+//==============================================================================
+unsigned long long cAllocationGuard::getNumAllocations() const
+{
+    return (s_threadNumAllocations - m_startNumAllocations);
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if allocation auditing is compiled into the 
+    library (__C_USE_ALLOCATION_AUDIT__), __false__ otherwise.
+
+    \return __true__ if allocation auditing is available.
+*/
+//==============================================================================
+bool cAllocationGuard::getEnabled()
+{
+#ifdef C_USE_ALLOCATION_AUDIT
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method returns the allocation mode of the current thread.
+
+    \return Allocation mode.
+*/
+//==============================================================================
+cAllocationGuardMode cAllocationGuard::getThreadMode()
+{
+    return (s_threadMode);
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if the current thread is inside a guarded 
+    scope, __false__ otherwise.
+
+    \return __true__ if the thread is guarded.
+*/
+//==============================================================================
+bool cAllocationGuard::getThreadGuarded()
+{
+    return (s_threadGuarded);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the total number of heap allocations counted on the 
+    current thread inside guarded scopes.
+
+    \return Number of allocations.
+*/
+//==============================================================================
+unsigned long long cAllocationGuard::getThreadNumAllocations()
+{
+    return (s_threadNumAllocations);
+}
+
+
+//==============================================================================
+/*!
+    This method resets the number of heap allocations counted on the current 
+    thread.
+*/
+//==============================================================================
+void cAllocationGuard::resetThreadNumAllocations()
+{
+    s_threadNumAllocations = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method reports a heap allocation made by the current thread. It is 
+    called by the global allocation operators when auditing is enabled.
+
+    \param  a_size  Size of the allocation in bytes.
+*/
+//==============================================================================
+void cAllocationGuard::notifyAllocation(const size_t a_size)
+{
+    if ((!s_threadGuarded) || (s_threadMode == C_ALLOCATION_GUARD_SUSPEND))
+    {
+        return;
+    }
+
+    s_threadNumAllocations++;
+
+    if (s_threadMode == C_ALLOCATION_GUARD_ABORT)
+    {
+        // leave guarded scope so that reporting cannot recurse
+        s_threadGuarded = false;
+        fprintf(stderr, "error: heap allocation of %lu bytes inside guarded scope\n", (unsigned long)a_size);
+        abort();
+    }
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------
+#ifdef C_USE_ALLOCATION_AUDIT
+//------------------------------------------------------------------------------
+
+//==============================================================================
+// GLOBAL ALLOCATION OPERATORS
+//==============================================================================
+
+void* operator new(size_t a_size)
+{
+    chai3d::cAllocationGuard::notifyAllocation(a_size);
+    void* ptr = malloc((a_size > 0) ? a_size : 1);
+    if (ptr == NULL) { throw std::bad_alloc(); }
+    return (ptr);
+}
+
+void* operator new[](size_t a_size)
+{
+    chai3d::cAllocationGuard::notifyAllocation(a_size);
+    void* ptr = malloc((a_size > 0) ? a_size : 1);
+    if (ptr == NULL) { throw std::bad_alloc(); }
+    return (ptr);
+}
+
+void* operator new(size_t a_size, const std::nothrow_t&) throw()
+{
+    chai3d::cAllocationGuard::notifyAllocation(a_size);
+    return (malloc((a_size > 0) ? a_size : 1));
+}
+
+void* operator new[](size_t a_size, const std::nothrow_t&) throw()
+{
+    chai3d::cAllocationGuard::notifyAllocation(a_size);
+    return (malloc((a_size > 0) ? a_size : 1));
+}
+
+void operator delete(void* a_ptr) throw()
+{
+    free(a_ptr);
+}
+
+void operator delete[](void* a_ptr) throw()
+{
+    free(a_ptr);
+}
+
+void operator delete(void* a_ptr, const std::nothrow_t&) throw()
+{
+    free(a_ptr);
+}
+
+void operator delete[](void* a_ptr, const std::nothrow_t&) throw()
+{
+    free(a_ptr);
+}
+
+//------------------------------------------------------------------------------
+#endif // C_USE_ALLOCATION_AUDIT
+//------------------------------------------------------------------------------
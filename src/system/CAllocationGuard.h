@@ -0,0 +1,175 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \version   3.3.0
+*/
+//==============================================================================
+
+
+//------------------------------------------------------------------------------
+#ifndef CAllocationGuardH
+#define CAllocationGuardH
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CAllocationGuard.h
+    \ingroup    system
+
+    \brief
+    Implements a scope guard for auditing heap allocations.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/*!
+    \enum   cAllocationGuardMode
+    \brief  Defines how heap allocations are handled inside a guarded scope.
+*/
+//------------------------------------------------------------------------------
+enum cAllocationGuardMode
+{
+    C_ALLOCATION_GUARD_COUNT,
+    C_ALLOCATION_GUARD_ABORT,
+    C_ALLOCATION_GUARD_SUSPEND
+};
+
+
+//==============================================================================
+/*!
+    \class      cAllocationGuard
+    \ingroup    system
+
+    \brief
+    This class implements a scope guard that audits heap allocations performed
+    by the current thread.
+
+    \details
+    A cAllocationGuard marks a scope, typically the body of a haptic loop, 
+    in which heap allocations are not expected. While the guard is alive, 
+    every call to the global allocation operators made by the __same thread__ 
+    is either counted (\ref C_ALLOCATION_GUARD_COUNT) or aborts the application 
+    with a diagnostic message (\ref C_ALLOCATION_GUARD_ABORT). Guards may be 
+    nested; a nested guard in mode \ref C_ALLOCATION_GUARD_SUSPEND temporarily 
+    allows allocations, for instance during lazy initialization. \n\n
+
+    Auditing relies on replacement global __new__ and __delete__ operators 
+    which are only compiled into the library when __C_USE_ALLOCATION_AUDIT__ 
+    is defined in __CGlobals.h__. When the option is disabled, guards have no 
+    effect and \ref getEnabled() returns __false__.
+*/
+//==============================================================================
+class cAllocationGuard
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cAllocationGuard. Opens a guarded scope on the current thread.
+    cAllocationGuard(const cAllocationGuardMode a_mode = C_ALLOCATION_GUARD_COUNT);
+
+    //! Destructor of cAllocationGuard. Closes the guarded scope.
+    virtual ~cAllocationGuard();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the number of heap allocations counted since this guard was created.
+    unsigned long long getNumAllocations() const;
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns __true__ if allocation auditing is compiled into the library, __false__ otherwise.
+    static bool getEnabled();
+
+    //! This method returns the allocation mode of the current thread.
+    static cAllocationGuardMode getThreadMode();
+
+    //! This method returns __true__ if the current thread is inside a guarded scope, __false__ otherwise.
+    static bool getThreadGuarded();
+
+    //! This method returns the total number of heap allocations counted on the current thread.
+    static unsigned long long getThreadNumAllocations();
+
+    //! This method resets the number of heap allocations counted on the current thread.
+    static void resetThreadNumAllocations();
+
+    //! This method reports a heap allocation of a given size made by the current thread.
+    static void notifyAllocation(const size_t a_size);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Allocation mode of the enclosing scope, restored when the guard is destroyed.
+    cAllocationGuardMode m_previousMode;
+
+    //! __true__ if the enclosing scope was guarded.
+    bool m_previousGuarded;
+
+    //! Number of allocations counted on the thread when the guard was created.
+    unsigned long long m_startNumAllocations;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
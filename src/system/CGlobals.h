@@ -75,6 +75,11 @@
     - __C_USE_FILE_GIF__: Enable of disable external support for GIF files.\n
     - __C_USE_FILE_JPG__: Enable of disable external support for JPG files.\n
     - __C_USE_FILE_PNG__: Enable of disable external support for PNG files.\n
+
+    - __C_USE_ALLOCATION_AUDIT__: Enable or disable the replacement global 
+                     allocation operators used by \ref cAllocationGuard to 
+                     count or trap heap allocations in real-time loops.
+                     Disabled by default.
                         
     Disabling one or more features will reduce the overall capabilities of 
     CHAI3D and may affect some of the examples provided with the framework.
@@ -138,6 +143,10 @@
 // Enable of disable external support for PNG files.
 #define C_USE_FILE_PNG 
 
+// ALLOCATION AUDIT
+// Enable or disable auditing of heap allocations inside cAllocationGuard scopes.
+// #define C_USE_ALLOCATION_AUDIT
+
 
 //==============================================================================
 // OPERATING SYSTEM SPECIFIC
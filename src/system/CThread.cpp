@@ -66,6 +66,7 @@ cThread::cThread()
     // default handle
 #if defined(WIN32) | defined(WIN64)
     m_threadId = 0;
+    m_threadHandle = NULL;
 #endif
 #if defined(LINUX) || defined(MACOSX)
     m_handle = 0;
@@ -97,7 +98,7 @@ void cThread::start(void(*a_function)(void), CThreadPriority a_level)
 {
     // create thread
 #if defined(WIN32) | defined(WIN64)
-    CreateThread(
+    m_threadHandle = CreateThread(
           0,
           0,
           (LPTHREAD_START_ROUTINE)(a_function),
@@ -136,7 +137,7 @@ void cThread::start(void(*a_function)(void*), CThreadPriority a_level, void *a_a
 {
     // create thread
 #if defined(WIN32) | defined(WIN64)
-    CreateThread(
+    m_threadHandle = CreateThread(
           0,
           0,
           (LPTHREAD_START_ROUTINE)(a_function),
@@ -178,6 +179,41 @@ void cThread::stop()
 }
 
 
+//==============================================================================
+/*!
+    This method waits for the thread to terminate and releases its resources.
+    It must not be called from the thread itself.
+
+    \return __true__ if the operation succeeds, __false__ if no thread was started.
+*/
+//==============================================================================
+bool cThread::join()
+{
+#if defined(WIN32) | defined(WIN64)
+    if (m_threadHandle == NULL)
+    {
+        return (false);
+    }
+
+    WaitForSingleObject(m_threadHandle, INFINITE);
+    CloseHandle(m_threadHandle);
+    m_threadHandle = NULL;
+#endif
+
+#if defined (LINUX) || defined (MACOSX)
+    if (m_handle == 0)
+    {
+        return (false);
+    }
+
+    pthread_join(m_handle, NULL);
+    m_handle = 0;
+#endif
+
+    return (true);
+}
+
+
 //==============================================================================
 /*!
     This method adjusts the priority level of the thread.
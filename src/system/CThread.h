@@ -127,6 +127,9 @@ public:
     //! This method terminates the thread (not recommended!).
     void stop();
 
+    //! This method waits for the thread to terminate and releases its resources.
+    bool join();
+
     //! This method sets the thread priority level.
     void setPriority(CThreadPriority a_level);
 
@@ -143,6 +146,9 @@ protected:
 #if defined(WIN32) | defined(WIN64)
     //! Thread handle.
     DWORD m_threadId;
+
+    //! Thread object handle, used to wait for the thread to terminate.
+    HANDLE m_threadHandle;
 #endif
 
 #if defined(LINUX) || defined(MACOSX)
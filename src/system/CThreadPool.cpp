@@ -0,0 +1,353 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \author    Sebastien Grange
+    \version   3.3.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "system/CThreadPool.h"
+#include "math/CMaths.h"
+//------------------------------------------------------------------------------
+#include <thread>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cThreadPool.
+
+    \param  a_numThreads  Number of threads (including the calling thread).
+    \param  a_priority    Priority level of worker threads.
+*/
+//==============================================================================
+cThreadPool::cThreadPool(const unsigned int a_numThreads, 
+                         const CThreadPriority a_priority)
+{
+    m_numThreads = 1;
+    m_priority = a_priority;
+    m_busy = false;
+    m_task = NULL;
+    m_numTaskThreads = 0;
+    m_workerBatch = 0;
+    m_workerPending = 0;
+    m_workerRunning = 0;
+    m_workerStop = false;
+
+    setNumThreads(a_numThreads);
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cThreadPool.
+*/
+//==============================================================================
+cThreadPool::~cThreadPool()
+{
+    stopWorkers();
+}
+
+
+//==============================================================================
+/*!
+    This method sets the number of threads, including the calling thread. 
+    A value of 1 disables multithreading. This method must not be called 
+    while a task is being processed.
+
+    \param  a_numThreads  Number of threads.
+*/
+//==============================================================================
+void cThreadPool::setNumThreads(const unsigned int a_numThreads)
+{
+    unsigned int numThreads = cMax(a_numThreads, 1u);
+    if ((numThreads == m_numThreads) && (m_workers.size() == (size_t)(m_numThreads - 1)))
+    {
+        return;
+    }
+
+    stopWorkers();
+    m_numThreads = numThreads;
+    startWorkers();
+}
+
+
+//==============================================================================
+/*!
+    This method runs a task once for each thread index in [0, a_numThreads),
+    and returns once all threads have completed it. The calling thread 
+    processes index 0. If the pool is already processing a task, all indices
+    are processed serially by the calling thread.
+
+    \param  a_task        Task, called with the index of the thread.
+    \param  a_numThreads  Number of threads. If set to 0, all threads of the pool are used.
+*/
+//==============================================================================
+void cThreadPool::run(const function<void(unsigned int)>& a_task, 
+                      const unsigned int a_numThreads)
+{
+    unsigned int numThreads = (a_numThreads == 0) ? m_numThreads : cMin(a_numThreads, m_numThreads);
+
+    // process task on calling thread if a single thread is requested or if the pool is busy
+    bool idle = false;
+    if ((numThreads <= 1) || (!m_busy.compare_exchange_strong(idle, true)))
+    {
+        for (unsigned int i=0; i<numThreads; i++)
+        {
+            a_task(i);
+        }
+        return;
+    }
+
+    // wake workers
+    {
+        lock_guard<mutex> lock(m_workerMutex);
+        m_task = &a_task;
+        m_numTaskThreads = numThreads;
+        m_workerBatch++;
+        m_workerPending = (unsigned int)(m_workers.size());
+        m_workerStart.notify_all();
+    }
+
+    // process share of calling thread
+    a_task(0);
+
+    // wait for workers
+    {
+        unique_lock<mutex> lock(m_workerMutex);
+        while (m_workerPending > 0)
+        {
+            m_workerDone.wait(lock);
+        }
+        m_task = NULL;
+    }
+
+    m_busy = false;
+}
+
+
+//==============================================================================
+/*!
+    This method processes a range of indices [0, a_count) in parallel. The 
+    range is split into one contiguous block per thread, and the method 
+    returns once all blocks have been processed. Blocks smaller than 
+    \p a_minBlockSize are avoided by using fewer threads.
+
+    \param  a_count         Number of indices.
+    \param  a_task          Task processing indices [begin, end).
+    \param  a_minBlockSize  Minimum number of indices per thread.
+*/
+//==============================================================================
+void cThreadPool::parallelFor(const int a_count,
+                              const function<void(int, int)>& a_task,
+                              const int a_minBlockSize)
+{
+    if (a_count <= 0) { return; }
+
+    // compute number of blocks
+    unsigned int numBlocks = (unsigned int)(a_count / cMax(a_minBlockSize, 1));
+    numBlocks = cClamp(numBlocks, 1u, m_numThreads);
+
+    // process small ranges on calling thread
+    if (numBlocks == 1)
+    {
+        a_task(0, a_count);
+        return;
+    }
+
+    // process one block per thread
+    const function<void(int, int)>* task = &a_task;
+    run([task, a_count, numBlocks](unsigned int a_thread)
+    {
+        int begin = (int)(((long long)a_count * a_thread) / numBlocks);
+        int end = (int)(((long long)a_count * (a_thread + 1)) / numBlocks);
+        if (end > begin)
+        {
+            (*task)(begin, end);
+        }
+    }, numBlocks);
+}
+
+
+//==============================================================================
+/*!
+    This method returns a thread pool shared by the library, with one thread
+    per processor. The pool is created on first use.
+
+    \return Shared thread pool.
+*/
+//==============================================================================
+cThreadPool* cThreadPool::getSharedPool()
+{
+    static cThreadPool pool(cMax(thread::hardware_concurrency(), 1u));
+    return (&pool);
+}
+
+
+//==============================================================================
+/*!
+    This method starts one worker thread per thread beyond the calling thread.
+*/
+//==============================================================================
+void cThreadPool::startWorkers()
+{
+    unsigned int numWorkers = m_numThreads - 1;
+
+    m_workerStop = false;
+    m_workerBatch = 0;
+    m_workerRunning = numWorkers;
+    m_workerArgs.resize(numWorkers);
+
+    for (unsigned int i=0; i<numWorkers; i++)
+    {
+        m_workerArgs[i] = make_pair(this, i + 1);
+
+        cThread* thread = new cThread();
+        thread->start(workerThread, m_priority, &m_workerArgs[i]);
+        m_workers.push_back(thread);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method requests all worker threads to terminate and waits for them.
+*/
+//==============================================================================
+void cThreadPool::stopWorkers()
+{
+    {
+        unique_lock<mutex> lock(m_workerMutex);
+        m_workerStop = true;
+        m_workerStart.notify_all();
+        while (m_workerRunning > 0)
+        {
+            m_workerDone.wait(lock);
+        }
+        m_workerStop = false;
+    }
+
+    for (unsigned int i=0; i<m_workers.size(); i++)
+    {
+        m_workers[i]->join();
+        delete m_workers[i];
+    }
+    m_workers.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method runs the loop of a worker thread, which runs the current task
+    each time a new batch is signaled. Completion is signaled while holding 
+    the lock, so that the pool cannot be destroyed before the notification 
+    has been delivered.
+
+    \param  a_thread  Thread index.
+*/
+//==============================================================================
+void cThreadPool::runWorker(const unsigned int a_thread)
+{
+    unsigned int batch = 0;
+
+    while (true)
+    {
+        // wait for next batch
+        const function<void(unsigned int)>* task = NULL;
+        {
+            unique_lock<mutex> lock(m_workerMutex);
+            while (!m_workerStop && (m_workerBatch == batch))
+            {
+                m_workerStart.wait(lock);
+            }
+            if (m_workerStop)
+            {
+                break;
+            }
+            batch = m_workerBatch;
+            if (a_thread < m_numTaskThreads)
+            {
+                task = m_task;
+            }
+        }
+
+        // run task
+        if (task != NULL)
+        {
+            (*task)(a_thread);
+        }
+
+        // signal completion
+        {
+            lock_guard<mutex> lock(m_workerMutex);
+            m_workerPending--;
+            m_workerDone.notify_all();
+        }
+    }
+
+    {
+        lock_guard<mutex> lock(m_workerMutex);
+        m_workerRunning--;
+        m_workerDone.notify_all();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method implements the entry point of worker threads.
+
+    \param  a_arg  Pointer to thread pool and thread index.
+*/
+//==============================================================================
+void cThreadPool::workerThread(void* a_arg)
+{
+    pair<cThreadPool*, unsigned int>* arg = (pair<cThreadPool*, unsigned int>*)a_arg;
+    arg->first->runWorker(arg->second);
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,212 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2024, CHAI3D
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \author    Sebastien Grange
+    \version   3.3.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CThreadPoolH
+#define CThreadPoolH
+//------------------------------------------------------------------------------
+#include "system/CThread.h"
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CThreadPool.h
+    \ingroup    system
+
+    \brief
+    Implements a pool of persistent worker threads.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cThreadPool
+    \ingroup    system
+
+    \brief
+    This class implements a pool of persistent worker threads.
+
+    \details
+    A thread pool runs a task once per thread index, the calling thread 
+    included (index 0), and returns once all threads have completed the 
+    task. Worker threads are created once and wait for the next task, so 
+    that the cost of dispatching work does not include thread creation.\n
+
+    \ref parallelFor() splits a range of indices into contiguous blocks of
+    equal size, one per thread. Because blocks only depend on the size of the
+    range and on the number of threads, results are reproducible from one 
+    call to the next.\n
+
+    A pool processes one task at a time. If a task is submitted while the 
+    pool is busy, for instance from another thread or from within a task, 
+    it is executed serially by the calling thread.
+*/
+//==============================================================================
+class cThreadPool
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cThreadPool.
+    cThreadPool(const unsigned int a_numThreads = 1, 
+                const CThreadPriority a_priority = CTHREAD_PRIORITY_GRAPHICS);
+
+    //! Destructor of cThreadPool.
+    virtual ~cThreadPool();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method sets the number of threads (including the calling thread).
+    void setNumThreads(const unsigned int a_numThreads);
+
+    //! This method returns the number of threads (including the calling thread).
+    unsigned int getNumThreads() const { return (m_numThreads); }
+
+    //! This method runs a task once for each thread index, and waits for all threads to complete it.
+    void run(const std::function<void(unsigned int)>& a_task, 
+             const unsigned int a_numThreads = 0);
+
+    //! This method processes a range of indices in parallel.
+    void parallelFor(const int a_count, 
+                     const std::function<void(int, int)>& a_task,
+                     const int a_minBlockSize = 256);
+
+    //! This method returns a pool shared by the library, with one thread per processor.
+    static cThreadPool* getSharedPool();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method starts the worker threads.
+    void startWorkers();
+
+    //! This method stops the worker threads and waits for them to terminate.
+    void stopWorkers();
+
+    //! This method runs the loop of a worker thread.
+    void runWorker(const unsigned int a_thread);
+
+    //! Entry point of worker threads.
+    static void workerThread(void* a_arg);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Number of threads (including the calling thread).
+    unsigned int m_numThreads;
+
+    //! Priority of worker threads.
+    CThreadPriority m_priority;
+
+    //! If __true__ then the pool is processing a task.
+    std::atomic<bool> m_busy;
+
+    //! Task of current batch.
+    const std::function<void(unsigned int)>* m_task;
+
+    //! Number of threads taking part in the current batch.
+    unsigned int m_numTaskThreads;
+
+    //! Worker threads.
+    std::vector<cThread*> m_workers;
+
+    //! Arguments passed to the worker threads.
+    std::vector<std::pair<cThreadPool*, unsigned int> > m_workerArgs;
+
+    //! Mutex protecting the worker synchronization state.
+    std::mutex m_workerMutex;
+
+    //! Condition signaled when a new batch is ready.
+    std::condition_variable m_workerStart;
+
+    //! Condition signaled when a worker has completed its batch.
+    std::condition_variable m_workerDone;
+
+    //! Batch counter incremented for each batch processed in parallel.
+    unsigned int m_workerBatch;
+
+    //! Number of workers which have not completed the current batch.
+    unsigned int m_workerPending;
+
+    //! Number of workers running.
+    unsigned int m_workerRunning;
+
+    //! If __true__ then workers are requested to terminate.
+    bool m_workerStop;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
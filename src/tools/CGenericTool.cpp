@@ -111,6 +111,10 @@ cGenericTool::cGenericTool(cWorld* a_parentWorld)
 
     // create a mesh for tool display purposes
     m_image = new cMesh();
+
+    // the image is not a child of the tool and is updated at every call to 
+    // updateGlobalPositions()
+    m_useIncrementalGlobalPositions = false;
 }
 
 
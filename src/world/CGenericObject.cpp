@@ -53,6 +53,8 @@
 #include "effects/CEffectVibration.h"
 #include "effects/CEffectViscosity.h"
 #include "shaders/CShaderProgram.h"
+#include "display/CCamera.h"
+#include "display/CRenderQueue.h"
 //------------------------------------------------------------------------------
 #include <float.h>
 #include <vector>
@@ -67,6 +69,7 @@ namespace chai3d {
 //------------------------------------------------------------------------------
 cMaterialPtr cGenericObject::s_defaultMaterial = nullptr;
 cColorf cGenericObject::s_boundaryBoxColor(0.7f, 0.7f, 0.7f);
+std::atomic<unsigned int> cGenericObject::s_interactionGraphVersion(1);
 //------------------------------------------------------------------------------
 
 //==============================================================================
@@ -98,6 +101,14 @@ cGenericObject::cGenericObject()
     m_prevGlobalPos.zero();
     m_prevGlobalRot.identity();
 
+    // global position and rotation are computed at first call
+    m_parentGlobalPos.zero();
+    m_parentGlobalRot.identity();
+    m_localTransformModified = true;
+    m_globalTransformModified = false;
+    m_childTransformModified = false;
+    m_useIncrementalGlobalPositions = true;
+
     // initialize OpenGL matrix with position vector and orientation matrix
     m_frameGL.set(m_globalPos, m_globalRot);
 
@@ -153,6 +164,8 @@ cGenericObject::cGenericObject()
 
     // empty list of haptic effects
     m_effects.clear();
+    m_subtreeHasEffects = false;
+    m_subtreeHasEffectsVersion = 0;
 
     // setup default material
     m_material = s_defaultMaterial;
@@ -173,6 +186,10 @@ cGenericObject::cGenericObject()
     m_boundaryBoxMax.set(0.0, 0.0, 0.0);
     m_boundaryBoxEmpty = true;
 
+    // view frustum culling
+    m_frustumVisible = true;
+    m_frustumVisibleSubtree = true;
+
     // collision detector
     m_collisionDetector = NULL; 
     m_showCollisionDetector = false;
@@ -414,6 +431,13 @@ void cGenericObject::rotateIntrinsicEulerAnglesRad(const double& a_angleRad1,
     If \a a_frameOnly is set to __false__, additional global positions such as
     vertex positions are computed too (which may be time-consuming!). \n
 
+    If \a a_frameOnly is set to __true__, the computation is incremental: the
+    global frame of an object is only computed if its local position or 
+    rotation has been modified (see \ref invalidateGlobalPositions()) or if 
+    the frame of its parent has changed, and only the components and children
+    that have been modified are visited. The previous global position and 
+    rotation of an object that has not moved are equal to its current ones.
+
     \param  a_frameOnly  If __true__ then only the global frame is computed
     \param  a_globalPos  Global position of parent object.
     \param  a_globalRot  Global rotation matrix of parent object.
@@ -426,29 +450,78 @@ void cGenericObject::computeGlobalPositions(const bool a_frameOnly,
     // check if node is a ghost. If yes, then ignore call
     if (m_ghostEnabled) { return; }
 
-    // current values become previous values
-    m_prevGlobalPos = m_globalPos;
-    m_prevGlobalRot = m_globalRot;
+    // check if the global frame of this object needs to be computed
+    bool update = (!a_frameOnly) ||
+                  (!m_useIncrementalGlobalPositions) ||
+                  m_localTransformModified ||
+                  (!a_globalPos.equals(m_parentGlobalPos)) ||
+                  (!a_globalRot.equals(m_parentGlobalRot));
+
+    if (update)
+    {
+        // current values become previous values
+        m_prevGlobalPos = m_globalPos;
+        m_prevGlobalRot = m_globalRot;
+
+        // update global position vector and global rotation matrix
+        m_globalPos = cAdd(a_globalPos, cMul(a_globalRot, m_localPos));
+        m_globalRot = cMul(a_globalRot, m_localRot);
+        m_parentGlobalPos = a_globalPos;
+        m_parentGlobalRot = a_globalRot;
+        m_localTransformModified = false;
+        m_globalTransformModified = !(m_globalPos.equals(m_prevGlobalPos) && m_globalRot.equals(m_prevGlobalRot));
+
+        // update any positions within the current object that need to be
+        // updated (e.g. vertex positions)
+        updateGlobalPositions(a_frameOnly);
+    }
+    else
+    {
+        // object has not moved since last call
+        if (m_globalTransformModified)
+        {
+            m_prevGlobalPos = m_globalPos;
+            m_prevGlobalRot = m_globalRot;
+            m_globalTransformModified = false;
+        }
 
-    // update global position vector and global rotation matrix
-    m_globalPos = cAdd(a_globalPos, cMul(a_globalRot, m_localPos));
-    m_globalRot = cMul(a_globalRot, m_localRot);
+        // nothing to do if no component or child needs to be updated
+        if (!m_childTransformModified) { return; }
+    }
 
-    // update any positions within the current object that need to be
-    // updated (e.g. vertex positions)
-    updateGlobalPositions(a_frameOnly);
+    // if the frame of this object has not changed, only components and 
+    // children which have been modified need to be visited
+    bool visitAll = (!a_frameOnly) || m_globalTransformModified;
+    bool childTransformModified = false;
 
     // propagate this method to components
     vector<cGenericObject*>::iterator it;
     for (it = m_components.begin(); it < m_components.end(); it++)
     {
-        (*it)->computeGlobalPositions(a_frameOnly, m_globalPos, m_globalRot);
+        if (visitAll || (*it)->requiresGlobalPositionsUpdate())
+        {
+            (*it)->computeGlobalPositions(a_frameOnly, m_globalPos, m_globalRot);
+            childTransformModified = childTransformModified || (*it)->requiresGlobalPositionsUpdate();
+        }
     }
 
     // propagate this method to children
     for (it = m_children.begin(); it < m_children.end(); it++)
     {
-        (*it)->computeGlobalPositions(a_frameOnly, m_globalPos, m_globalRot);
+        if (visitAll || (*it)->requiresGlobalPositionsUpdate())
+        {
+            (*it)->computeGlobalPositions(a_frameOnly, m_globalPos, m_globalRot);
+            childTransformModified = childTransformModified || (*it)->requiresGlobalPositionsUpdate();
+        }
+    }
+
+    m_childTransformModified = childTransformModified;
+
+    // objects that have moved are visited again at next call to update their
+    // previous position and rotation
+    if (requiresGlobalPositionsUpdate())
+    {
+        invalidateParentGlobalPositions();
     }
 }
 
@@ -496,6 +569,39 @@ void cGenericObject::computeGlobalPositionsFromRoot(const bool a_frameOnly)
 }
 
 
+//==============================================================================
+/*!
+    This method marks the global position and rotation of this object as out 
+    of date. It is called whenever the local position or rotation of the 
+    object is modified, so that the next call to computeGlobalPositions() 
+    updates this object and its subtree.
+*/
+//==============================================================================
+void cGenericObject::invalidateGlobalPositions()
+{
+    m_localTransformModified = true;
+    invalidateParentGlobalPositions();
+}
+
+
+//==============================================================================
+/*!
+    This method marks all parents of this object as having a component or 
+    child that needs to be visited during the next computation of global 
+    positions. The walk stops at the first parent that is already marked.
+*/
+//==============================================================================
+void cGenericObject::invalidateParentGlobalPositions()
+{
+    cGenericObject* parent = m_parent;
+    while ((parent != NULL) && (!parent->m_childTransformModified))
+    {
+        parent->m_childTransformModified = true;
+        parent = parent->m_parent;
+    }
+}
+
+
 //==============================================================================
 /*!
     This method adds a haptic effect to this object.
@@ -515,6 +621,7 @@ bool cGenericObject::addEffect(cGenericEffect* a_effect)
 
     // add this child to my list of children
     m_effects.push_back(a_effect);
+    invalidateInteractionGraph();
 
     // success
     return (true);
@@ -538,6 +645,7 @@ bool cGenericObject::removeEffect(cGenericEffect* a_effect)
         {
             (*it)->m_parent = NULL;
             m_effects.erase(it);
+            invalidateInteractionGraph();
             return (true);
         }
     }
@@ -560,6 +668,7 @@ void cGenericObject::deleteAllEffects()
         delete (*it);
     }
     m_effects.clear();
+    invalidateInteractionGraph();
 }
 
 
@@ -629,6 +738,7 @@ void cGenericObject::deleteEffectMagnetic(const bool a_affectChildren, const boo
         {
             m_effects.erase(effectIt);
             delete effect;
+            invalidateInteractionGraph();
         }
     }
 
@@ -719,6 +829,7 @@ void cGenericObject::deleteEffectStickSlip(const bool a_affectChildren, const bo
         {
             m_effects.erase(effectIt);
             delete effect;
+            invalidateInteractionGraph();
         }
     }
 
@@ -810,6 +921,7 @@ void cGenericObject::deleteEffectSurface(const bool a_affectChildren, const bool
         {
             m_effects.erase(effectIt);
             delete effect;
+            invalidateInteractionGraph();
         }
     }
 
@@ -901,6 +1013,7 @@ void cGenericObject::deleteEffectVibration(const bool a_affectChildren, const bo
         {
             m_effects.erase(effectIt);
             delete effect;
+            invalidateInteractionGraph();
         }
     }
     // apply effect to components
@@ -991,6 +1104,7 @@ void cGenericObject::deleteEffectViscosity(const bool a_affectChildren, const bo
         {
             m_effects.erase(effectIt);
             delete effect;
+            invalidateInteractionGraph();
         }
     }
     // apply effect to components
@@ -1015,6 +1129,72 @@ void cGenericObject::deleteEffectViscosity(const bool a_affectChildren, const bo
 }
 
 
+//==============================================================================
+/*!
+    This method returns the largest distance from the boundary box of this 
+    object at which its enabled haptic effects may produce a force. 
+    A negative value is returned if haptic rendering is disabled or if
+    no haptic effect is enabled on this object.
+
+    \return Maximum distance of influence.
+*/
+//==============================================================================
+double cGenericObject::getMaxInfluenceDistance()
+{
+    double distance = -1.0;
+
+    if (!m_hapticEnabled) { return (distance); }
+
+    vector<cGenericEffect*>::iterator it;
+    for (it = m_effects.begin(); it < m_effects.end(); it++)
+    {
+        if ((*it)->getEnabled())
+        {
+            distance = cMax(distance, (*it)->getMaxInfluenceDistance());
+        }
+    }
+
+    return (distance);
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if this object or any of its components or
+    children has haptic effects. The result is cached and only recomputed
+    after effects, children or components have been added or removed 
+    somewhere in the scenegraph.
+
+    \return __true__ if haptic effects are found in the subtree, __false__ otherwise.
+*/
+//==============================================================================
+bool cGenericObject::getSubtreeHasEffects()
+{
+    if (m_subtreeHasEffectsVersion == s_interactionGraphVersion)
+    {
+        return (m_subtreeHasEffects);
+    }
+
+    bool result = (m_effects.size() > 0);
+
+    vector<cGenericObject*>::iterator it;
+    for (it = m_components.begin(); it < m_components.end(); it++)
+    {
+        result = (*it)->getSubtreeHasEffects() || result;
+    }
+
+    for (it = m_children.begin(); it < m_children.end(); it++)
+    {
+        result = (*it)->getSubtreeHasEffects() || result;
+    }
+
+    m_subtreeHasEffects = result;
+    m_subtreeHasEffectsVersion = s_interactionGraphVersion;
+
+    return (result);
+}
+
+
 //==============================================================================
 /*!
     This method enables or disables the object to be felt haptically. \n
@@ -2436,6 +2616,8 @@ bool cGenericObject::addChild(cGenericObject* a_object)
     {
         m_children.push_back(a_object);
         a_object->m_parent = this;
+        a_object->invalidateGlobalPositions();
+        invalidateInteractionGraph();
         return (true);
     }
 
@@ -2444,6 +2626,7 @@ bool cGenericObject::addChild(cGenericObject* a_object)
     else if (m_ghostEnabled)
     {
         m_children.push_back(a_object);
+        invalidateInteractionGraph();
         return (true);
     }
 
@@ -2483,6 +2666,7 @@ bool cGenericObject::removeChild(cGenericObject* a_object)
 
             // remove this object from the list of children
             m_children.erase(it);
+            invalidateInteractionGraph();
 
             // return success
             return (true);
@@ -2588,6 +2772,7 @@ void cGenericObject::clearAllChildren()
 
     // clear children list
     m_children.clear();
+    invalidateInteractionGraph();
 }
 
 
@@ -2608,6 +2793,7 @@ void cGenericObject::deleteAllChildren()
 
     // clear list of children
     m_children.clear();
+    invalidateInteractionGraph();
 }
 
 
@@ -2652,10 +2838,12 @@ bool cGenericObject::addComponent(cGenericObject* a_component)
 
     // add component to list
     m_components.push_back(a_component);
+    invalidateInteractionGraph();
 
     // set parent and owner
     a_component->setParent(this);
     a_component->setOwner(this);
+    a_component->invalidateGlobalPositions();
 
     // return success
     return (true);
@@ -2693,6 +2881,7 @@ bool cGenericObject::removeComponent(cGenericObject* a_object)
 
             // remove this object from the list of components
             m_components.erase(it);
+            invalidateInteractionGraph();
 
             // return success
             return (true);
@@ -2752,6 +2941,7 @@ void cGenericObject::clearAllComponents()
 
     // clear component list
     m_components.clear();
+    invalidateInteractionGraph();
 }
 
 
@@ -2772,6 +2962,7 @@ void cGenericObject::deleteAllComponents()
 
     // clear list of components
     m_components.clear();
+    invalidateInteractionGraph();
 }
 
 
@@ -2799,6 +2990,7 @@ void cGenericObject::scale(const double& a_scaleFactor,
         for (it = m_components.begin(); it < m_components.end(); it++)
         {
             (*it)->m_localPos.mul(a_scaleFactor);
+            (*it)->invalidateGlobalPositions();
             (*it)->scale(a_scaleFactor, a_affectChildren, a_affectComponents);
         }
     }
@@ -2810,6 +3002,7 @@ void cGenericObject::scale(const double& a_scaleFactor,
         for (it = m_children.begin(); it < m_children.end(); it++)
         {
             (*it)->m_localPos.mul(a_scaleFactor);
+            (*it)->invalidateGlobalPositions();
             (*it)->scale(a_scaleFactor, a_affectChildren, a_affectComponents);
         }
     }
@@ -2943,6 +3136,7 @@ void cGenericObject::copyGenericObjectProperties(cGenericObject* a_obj,
     a_obj->m_cullingEnabled       = m_cullingEnabled;
     a_obj->m_localPos             = m_localPos;
     a_obj->m_localRot             = m_localRot;
+    a_obj->invalidateGlobalPositions();
 }
 
 
@@ -2966,6 +3160,14 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
 {
 #ifdef C_USE_OPENGL
 
+    // skip objects whose entire subtree is located outside of the view frustum.
+    // when a display reset is requested, the subtree is still traversed so that
+    // display lists and textures are invalidated.
+    if (a_options.m_useFrustumCulling && !m_frustumVisibleSubtree && !a_options.m_markForUpdate)
+    {
+        return;
+    }
+
     /////////////////////////////////////////////////////////////////////////
     // Initialize rendering
     /////////////////////////////////////////////////////////////////////////
@@ -2999,98 +3201,182 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
                 m_texture->markForUpdate();
             }
         }
+    }
 
-        //-----------------------------------------------------------------------
-        // Init
-        //-----------------------------------------------------------------------
+    // render if object is enabled and intersects the view frustum
+    if (m_enabled && (!a_options.m_useFrustumCulling || m_frustumVisible))
+    {
+        renderObject(a_options);
+    }
 
-        glEnable(GL_LIGHTING);
-        glDisable(GL_BLEND);
-        glDepthMask(GL_TRUE);
-        glEnable(GL_DEPTH_TEST);
-        glColorMaterial(GL_FRONT_AND_BACK,GL_AMBIENT_AND_DIFFUSE);
+    // render components
+    for (unsigned int i = 0; i<m_components.size(); i++)
+    {
+        m_components[i]->renderSceneGraph(a_options);
+    }
 
-        //-----------------------------------------------------------------------
-        // Render bounding box, frame, collision detector. (opaque components)
-        //-----------------------------------------------------------------------
-        if (SECTION_RENDER_OPAQUE_PARTS_ONLY(a_options) && (!a_options.m_rendering_shadow))
-        {
-            // disable lighting
-            glDisable(GL_LIGHTING);
+    // render children
+    for (unsigned int i=0; i<m_children.size(); i++)
+    {
+        m_children[i]->renderSceneGraph(a_options);
+    }
 
-            // render boundary box
-            if (m_showBoundaryBox)
-            {
-                // set size on lines
-                glLineWidth(1.0);
+    // pop current matrix
+    glPopMatrix();
+
+#endif
+}
 
-                // set color of boundary box
-                glColor4fv(s_boundaryBoxColor.getData());
 
-                // draw box line
-                cDrawWireBox(m_boundaryBoxMin(0) , m_boundaryBoxMax(0) ,
-                             m_boundaryBoxMin(1) , m_boundaryBoxMax(1) ,
-                             m_boundaryBoxMin(2) , m_boundaryBoxMax(2) );
-            }
+//==============================================================================
+/*!
+    This method renders this object only, excluding its components and 
+    children, according to the rendering pass described by the rendering
+    options. It sets up the OpenGL state required by the current pass, renders
+    the boundary box, reference frame and collision tree if enabled, and calls
+    render() to draw the graphical representation of the object. \n
 
-            // render collision tree
-            if (m_showCollisionDetector && (m_collisionDetector != NULL))
-            {
-                m_collisionDetector->render(a_options);
-            }
+    The modelview matrix must describe the position and orientation of the 
+    object when this method is called. It is called by renderSceneGraph() and 
+    by the render queue of the camera (see \ref cRenderQueue).
 
-            // enable lighting
-            glEnable(GL_LIGHTING);
-        }
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cGenericObject::renderObject(cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+
+    //-----------------------------------------------------------------------
+    // Init
+    //-----------------------------------------------------------------------
 
-        // render frame
-        if (m_showFrame && (a_options.m_single_pass_only || a_options.m_render_opaque_objects_only))
+    glEnable(GL_LIGHTING);
+    glDisable(GL_BLEND);
+    glDepthMask(GL_TRUE);
+    glEnable(GL_DEPTH_TEST);
+    glColorMaterial(GL_FRONT_AND_BACK,GL_AMBIENT_AND_DIFFUSE);
+
+    //-----------------------------------------------------------------------
+    // Render bounding box, frame, collision detector. (opaque components)
+    //-----------------------------------------------------------------------
+    if (SECTION_RENDER_OPAQUE_PARTS_ONLY(a_options) && (!a_options.m_rendering_shadow))
+    {
+        // disable lighting
+        glDisable(GL_LIGHTING);
+
+        // render boundary box
+        if (m_showBoundaryBox)
         {
-            glDisableClientState(GL_COLOR_ARRAY);
-            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-            glDisableClientState(GL_INDEX_ARRAY);
-            glDisableClientState(GL_EDGE_FLAG_ARRAY);
-            glDisable(GL_COLOR_MATERIAL);
+            // set size on lines
+            glLineWidth(1.0);
 
-            glEnable(GL_COLOR_MATERIAL);
-            glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
-            glColor4f(1.0,1.0,1.0,1.0);
+            // set color of boundary box
+            glColor4fv(s_boundaryBoxColor.getData());
 
-            // set rendering properties
-            glPolygonMode(GL_FRONT, GL_FILL);
-                
-            // draw frame
-            cDrawFrame(m_frameSize, m_frameThicknessScale);
+            // draw box line
+            cDrawWireBox(m_boundaryBoxMin(0) , m_boundaryBoxMax(0) ,
+                         m_boundaryBoxMin(1) , m_boundaryBoxMax(1) ,
+                         m_boundaryBoxMin(2) , m_boundaryBoxMax(2) );
         }
 
-        //-----------------------------------------------------------------------
-        // Render graphical representation of object
-        //-----------------------------------------------------------------------
-        if (m_showEnabled)
+        // render collision tree
+        if (m_showCollisionDetector && (m_collisionDetector != NULL))
         {
-            // set polygon and face mode
-            glPolygonMode(GL_FRONT_AND_BACK, m_triangleMode);
+            m_collisionDetector->render(a_options);
+        }
+
+        // enable lighting
+        glEnable(GL_LIGHTING);
+    }
+
+    // render frame
+    if (m_showFrame && (a_options.m_single_pass_only || a_options.m_render_opaque_objects_only))
+    {
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_INDEX_ARRAY);
+        glDisableClientState(GL_EDGE_FLAG_ARRAY);
+        glDisable(GL_COLOR_MATERIAL);
+
+        glEnable(GL_COLOR_MATERIAL);
+        glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+        glColor4f(1.0,1.0,1.0,1.0);
 
-            // initialize line width
-            glLineWidth(1.0f);
+        // set rendering properties
+        glPolygonMode(GL_FRONT, GL_FILL);
+            
+        // draw frame
+        cDrawFrame(m_frameSize, m_frameThicknessScale);
+    }
+
+    //-----------------------------------------------------------------------
+    // Render graphical representation of object
+    //-----------------------------------------------------------------------
+    if (m_showEnabled)
+    {
+        // set polygon and face mode
+        glPolygonMode(GL_FRONT_AND_BACK, m_triangleMode);
+
+        // initialize line width
+        glLineWidth(1.0f);
+
+        /////////////////////////////////////////////////////////////////////
+        // CREATING SHADOW DEPTH MAP
+        /////////////////////////////////////////////////////////////////////
+        if (a_options.m_creating_shadow_map)
+        {
+            glEnable(GL_CULL_FACE);
+            glCullFace(GL_FRONT);
+
+            // render object
+            render(a_options);
+            glDisable(GL_CULL_FACE);
+        }
 
-            /////////////////////////////////////////////////////////////////////
-            // CREATING SHADOW DEPTH MAP
-            /////////////////////////////////////////////////////////////////////
-            if (a_options.m_creating_shadow_map)
+        /////////////////////////////////////////////////////////////////////
+        // SINGLE PASS RENDERING
+        /////////////////////////////////////////////////////////////////////
+        else if (a_options.m_single_pass_only)
+        {
+            if (m_cullingEnabled)
             {
                 glEnable(GL_CULL_FACE);
-                glCullFace(GL_FRONT);
-
-                // render object
-                render(a_options);
+                glCullFace(GL_BACK);
+            }
+            else
+            {
                 glDisable(GL_CULL_FACE);
             }
 
-            /////////////////////////////////////////////////////////////////////
-            // SINGLE PASS RENDERING
-            /////////////////////////////////////////////////////////////////////
-            else if (a_options.m_single_pass_only)
+            if (m_useTransparency)
+            {
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                glDepthMask(GL_FALSE);
+            }
+            else
+            {
+                glDisable(GL_BLEND);
+                glDepthMask(GL_TRUE);
+            }
+
+            // render object
+            render(a_options);
+
+            // disable blending
+            glDisable(GL_BLEND);
+            glDepthMask(GL_TRUE);
+        }
+
+
+        /////////////////////////////////////////////////////////////////////
+        // MULTI PASS RENDERING
+        /////////////////////////////////////////////////////////////////////
+        else
+        {
+            // opaque objects
+            if (a_options.m_render_opaque_objects_only)
             {
                 if (m_cullingEnabled)
                 {
@@ -3102,6 +3388,12 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
                     glDisable(GL_CULL_FACE);
                 }
 
+                render(a_options);
+            }
+
+            // render transparent back triangles
+            if (a_options.m_render_transparent_back_faces_only)
+            {
                 if (m_useTransparency)
                 {
                     glEnable(GL_BLEND);
@@ -3114,7 +3406,9 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
                     glDepthMask(GL_TRUE);
                 }
 
-                // render object
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_FRONT);
+                
                 render(a_options);
 
                 // disable blending
@@ -3122,97 +3416,177 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
                 glDepthMask(GL_TRUE);
             }
 
-
-            /////////////////////////////////////////////////////////////////////
-            // MULTI PASS RENDERING
-            /////////////////////////////////////////////////////////////////////
-            else
+            // render transparent front triangles
+            if (a_options.m_render_transparent_front_faces_only)
             {
-                // opaque objects
-                if (a_options.m_render_opaque_objects_only)
+                if (m_useTransparency)
                 {
-                    if (m_cullingEnabled)
-                    {
-                        glEnable(GL_CULL_FACE);
-                        glCullFace(GL_BACK);
-                    }
-                    else
-                    {
-                        glDisable(GL_CULL_FACE);
-                    }
-
-                    render(a_options);
+                    glEnable(GL_BLEND);
+                    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                    glDepthMask(GL_FALSE);
                 }
-
-                // render transparent back triangles
-                if (a_options.m_render_transparent_back_faces_only)
+                else
                 {
-                    if (m_useTransparency)
-                    {
-                        glEnable(GL_BLEND);
-                        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-                        glDepthMask(GL_FALSE);
-                    }
-                    else
-                    {
-                        glDisable(GL_BLEND);
-                        glDepthMask(GL_TRUE);
-                    }
-
-                    glEnable(GL_CULL_FACE);
-                    glCullFace(GL_FRONT);
-                    
-                    render(a_options);
-
-                    // disable blending
                     glDisable(GL_BLEND);
                     glDepthMask(GL_TRUE);
                 }
 
-                // render transparent front triangles
-                if (a_options.m_render_transparent_front_faces_only)
-                {
-                    if (m_useTransparency)
-                    {
-                        glEnable(GL_BLEND);
-                        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-                        glDepthMask(GL_FALSE);
-                    }
-                    else
-                    {
-                        glDisable(GL_BLEND);
-                        glDepthMask(GL_TRUE);
-                    }
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_BACK);
 
-                    glEnable(GL_CULL_FACE);
-                    glCullFace(GL_BACK);
+                render(a_options);
 
-                    render(a_options);
-    
-                    // disable blending
-                    glDisable(GL_BLEND);
-                    glDepthMask(GL_TRUE);
-                }
+                // disable blending
+                glDisable(GL_BLEND);
+                glDepthMask(GL_TRUE);
             }
         }
     }
 
-    // render components
-    for (unsigned int i = 0; i<m_components.size(); i++)
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method adds this object, its components and its children to a render
+    queue, together with their position and orientation in world coordinates.
+    It performs the same traversal as renderSceneGraph() without rendering, so
+    that the queue can later be rendered once per rendering pass. \n
+
+    Disabled objects and objects located outside of the view frustum (when 
+    frustum culling is enabled) are not added to the queue. Requests to reset
+    display lists and textures are processed during the traversal.
+
+    \param  a_queue        Render queue.
+    \param  a_parentFrame  Position and orientation of parent in world coordinates.
+    \param  a_options      Rendering options.
+*/
+//==============================================================================
+void cGenericObject::enqueueSceneGraph(cRenderQueue& a_queue,
+                                       const cTransform& a_parentFrame,
+                                       cRenderOptions& a_options)
+{
+    // skip objects whose entire subtree is located outside of the view frustum
+    if (a_options.m_useFrustumCulling && !m_frustumVisibleSubtree && !a_options.m_markForUpdate)
     {
-        m_components[i]->renderSceneGraph(a_options);
+        return;
     }
 
-    // render children
+    // convert the position and orientation of the object into a 4x4 matrix 
+    m_frameGL.set(m_localPos, m_localRot);
+
+    // compute position and orientation of object in world coordinates
+    cTransform frame;
+    a_parentFrame.mulr(m_frameGL, frame);
+
+    if (m_enabled)
+    {
+        // request for reset
+        if (a_options.m_markForUpdate)
+        {
+            // invalidate display list 
+            markForUpdate(false, false);
+
+            // invalidate texture
+            if (m_texture != nullptr)
+            {
+                m_texture->markForUpdate();
+            }
+        }
+
+        // add object to queue
+        if (!a_options.m_useFrustumCulling || m_frustumVisible)
+        {
+            a_queue.add(this, frame);
+        }
+    }
+
+    // add components
+    for (unsigned int i=0; i<m_components.size(); i++)
+    {
+        m_components[i]->enqueueSceneGraph(a_queue, frame, a_options);
+    }
+
+    // add children
     for (unsigned int i=0; i<m_children.size(); i++)
     {
-        m_children[i]->renderSceneGraph(a_options);
+        m_children[i]->enqueueSceneGraph(a_queue, frame, a_options);
     }
+}
 
-    // pop current matrix
-    glPopMatrix();
 
-#endif
+//==============================================================================
+/*!
+    This method determines which objects of the scene graph, starting from this
+    object, intersect the view frustum of a camera. The result is stored in 
+    each object and used by renderSceneGraph() to skip objects and subtrees 
+    that are located outside of the view when frustum culling is enabled in the
+    rendering options. 
+
+
+    Each boundary box is transformed into world coordinates and tested 
+    against the frustum planes of the camera (see 
+    \ref cCamera::isBoxInViewFrustum()). Objects with an empty boundary box are 
+    always considered visible. The test relies on up-to-date boundary boxes,
+    which can be updated by calling computeBoundaryBox().
+
+    \param  a_camera     Camera whose view frustum is tested.
+    \param  a_parentPos  Position of parent frame in world coordinates.
+    \param  a_parentRot  Orientation of parent frame in world coordinates.
+
+    \return __true__ if this object or any of its descendants is visible, __false__ otherwise.
+*/
+//==============================================================================
+bool cGenericObject::computeFrustumVisibility(cCamera* a_camera,
+                                              const cVector3d& a_parentPos,
+                                              const cMatrix3d& a_parentRot)
+{
+    // compute position and orientation of object in world coordinates
+    cVector3d pos = a_parentPos + a_parentRot * m_localPos;
+    cMatrix3d rot = a_parentRot * m_localRot;
+
+    // test boundary box against view frustum
+    m_frustumVisible = true;
+    if (!m_boundaryBoxEmpty)
+    {
+        // compute axis-aligned box enclosing the boundary box in world coordinates
+        cVector3d center = pos + rot * (0.5 * (m_boundaryBoxMax + m_boundaryBoxMin));
+        cVector3d extent = 0.5 * (m_boundaryBoxMax - m_boundaryBoxMin);
+        cVector3d halfSize;
+        for (int i=0; i<3; i++)
+        {
+            halfSize(i) = fabs(rot(i,0)) * extent(0) + 
+                          fabs(rot(i,1)) * extent(1) + 
+                          fabs(rot(i,2)) * extent(2);
+        }
+
+        m_frustumVisible = a_camera->isBoxInViewFrustum(center - halfSize, center + halfSize);
+    }
+
+    bool visible = m_frustumVisible;
+
+    // test components
+    for (unsigned int i=0; i<m_components.size(); i++)
+    {
+        if (m_components[i]->computeFrustumVisibility(a_camera, pos, rot))
+        {
+            visible = true;
+        }
+    }
+
+    // test children
+    for (unsigned int i=0; i<m_children.size(); i++)
+    {
+        if (m_children[i]->computeFrustumVisibility(a_camera, pos, rot))
+        {
+            visible = true;
+        }
+    }
+
+    m_frustumVisibleSubtree = visible;
+
+    return (visible);
 }
 
 
@@ -3243,12 +3617,22 @@ void cGenericObject::adjustCollisionSegment(cVector3d& a_segmentPointA,
 //==============================================================================
 /*!
     This method descends through child objects to compute interactions for all
-    cGenericEffect classes defined for each object.
+    cGenericEffect classes defined for each object.\n
+
+    When culling is enabled, objects whose haptic effects cannot produce a 
+    force at the current tool position are skipped. An object is culled when 
+    the tool is located further away from its boundary box than the largest 
+    distance of influence of its enabled effects (see 
+    \ref getMaxInfluenceDistance()), and subtrees that do not contain any 
+    haptic effects are not traversed. Culling relies on up-to-date boundary 
+    boxes and assumes that computeOtherInteractions() is only overridden by 
+    objects that also hold haptic effects.
 
     \param  a_toolPos       Current position of tool.
     \param  a_toolVel       Current position of tool.
     \param  a_IDN           Identification number of the force algorithm.
     \param  a_interactions  List of recorded interactions.
+    \param  a_useCulling    If __true__, then culling of distant objects is enabled.
 
     \return Resulting interaction force.
 */
@@ -3256,8 +3640,15 @@ void cGenericObject::adjustCollisionSegment(cVector3d& a_segmentPointA,
 cVector3d cGenericObject::computeInteractions(const cVector3d& a_toolPos,
                                               const cVector3d& a_toolVel,
                                               const unsigned int a_IDN,
-                                              cInteractionRecorder& a_interactions)
+                                              cInteractionRecorder& a_interactions,
+                                              const bool a_useCulling)
 {
+    // check if node is a ghost. If yes, then ignore call
+    if (m_ghostEnabled) { return (cVector3d(0,0,0)); }
+
+    // skip subtrees that do not hold any haptic effects
+    if (a_useCulling && !getSubtreeHasEffects()) { return (cVector3d(0,0,0)); }
+
     // compute inverse rotation
     cMatrix3d localRotTrans;
     m_localRot.transr(localRotTrans);
@@ -3271,22 +3662,40 @@ cVector3d cGenericObject::computeInteractions(const cVector3d& a_toolPos,
     // compute forces based on the effects programmed for this object
     cVector3d localForce(0,0,0);
 
-    // check if node is a ghost. If yes, then ignore call
-    if (m_ghostEnabled) { return (cVector3d(0,0,0)); }
-
     // process current object if enabled
     if (m_enabled)
     {
-        // compute local interaction with current object
-        computeLocalInteraction(toolPosLocal,
-                                toolVelLocal,
-                                a_IDN);
+        // check if the tool is located within reach of the haptic effects of this object
+        bool evaluateEffects = true;
+        if (a_useCulling)
+        {
+            double distance = getMaxInfluenceDistance();
+            if (distance < 0.0)
+            {
+                evaluateEffects = false;
+            }
+            else if (!m_boundaryBoxEmpty && !m_interactionInside)
+            {
+                double dx = cMax(0.0, cMax(m_boundaryBoxMin(0) - toolPosLocal(0), toolPosLocal(0) - m_boundaryBoxMax(0)));
+                double dy = cMax(0.0, cMax(m_boundaryBoxMin(1) - toolPosLocal(1), toolPosLocal(1) - m_boundaryBoxMax(1)));
+                double dz = cMax(0.0, cMax(m_boundaryBoxMin(2) - toolPosLocal(2), toolPosLocal(2) - m_boundaryBoxMax(2)));
+                evaluateEffects = ((dx * dx + dy * dy + dz * dz) <= (distance * distance));
+            }
+        }
+
+        if (evaluateEffects)
+        {
+            // compute local interaction with current object
+            computeLocalInteraction(toolPosLocal,
+                                    toolVelLocal,
+                                    a_IDN);
+        }
 
         if(m_hapticEnabled)
         {
             // compute each force effect
             bool interactionEvent = false;
-            for (unsigned int i=0; i<m_effects.size(); i++)
+            for (unsigned int i=0; evaluateEffects && (i<m_effects.size()); i++)
             {
                 cGenericEffect *nextEffect = m_effects[i];
 
@@ -3333,7 +3742,8 @@ cVector3d cGenericObject::computeInteractions(const cVector3d& a_toolPos,
         cVector3d force = (*it)->computeInteractions(toolPosLocal,
             toolVelLocal,
             a_IDN,
-            a_interactions);
+            a_interactions,
+            a_useCulling);
         localForce.add(force);
     }
 
@@ -3343,7 +3753,8 @@ cVector3d cGenericObject::computeInteractions(const cVector3d& a_toolPos,
         cVector3d force = (*it)->computeInteractions(toolPosLocal,
                                                      toolVelLocal,
                                                      a_IDN,
-                                                     a_interactions);
+                                                     a_interactions,
+                                                     a_useCulling);
         localForce.add(force);
     }
 
@@ -59,6 +59,7 @@
 #include "math/CTransform.h"
 #include "system/CGenericType.h"
 //------------------------------------------------------------------------------
+#include <atomic>
 #include <vector>
 #include <list>
 //------------------------------------------------------------------------------
@@ -73,6 +74,7 @@ class cGenericForceAlgorithm;
 class cMultiMesh;
 class cShaderProgram;
 class cInteractionRecorder;
+class cRenderQueue;
 //------------------------------------------------------------------------------
 typedef std::shared_ptr<cShaderProgram> cShaderProgramPtr;
 //------------------------------------------------------------------------------
@@ -170,6 +172,7 @@ public:
     virtual void setLocalPos(const cVector3d& a_localPos)
     {
         m_localPos = a_localPos;
+        invalidateGlobalPositions();
     }
 
 #ifdef C_USE_EIGEN
@@ -198,6 +201,7 @@ public:
     virtual void setLocalRot(const cMatrix3d& a_localRot)
     {
         m_localRot = a_localRot;
+        invalidateGlobalPositions();
     }
 
 #ifdef C_USE_EIGEN
@@ -337,6 +341,15 @@ public:
     //! This method computes the global position and rotation of current object only.
     void computeGlobalPositionsFromRoot(const bool a_frameOnly = true);
 
+    //! This method marks the global position and rotation of this object as out of date.
+    void invalidateGlobalPositions();
+
+    //! This method enables or disables the incremental computation of global positions for this object.
+    void setUseIncrementalGlobalPositions(const bool a_enabled) { m_useIncrementalGlobalPositions = a_enabled; invalidateGlobalPositions(); }
+
+    //! This method returns __true__ if global positions of this object are computed incrementally.
+    bool getUseIncrementalGlobalPositions() const { return (m_useIncrementalGlobalPositions); }
+
 
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - HAPTIC EFFECTS:
@@ -383,6 +396,9 @@ public:
     //! This method deletes any current viscous haptic effect.
     void deleteEffectViscosity(const bool a_affectChildren = false, const bool a_affectComponents = true);
 
+    //! This method returns the largest distance from the boundary box of this object at which its enabled haptic effects may produce a force.
+    double getMaxInfluenceDistance();
+
     
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - HAPTIC PROPERTIES:
@@ -453,6 +469,9 @@ public:
     //! This method returns __true__ if transparency is enabled, __false__ otherwise.
     inline bool getUseTransparency() const { return m_useTransparency; }
 
+    //! This method returns __true__ if this object may render parts during the transparent rendering passes, __false__ otherwise.
+    virtual bool hasTransparentParts() const { return (true); }
+
     //! This method sets the transparency level of the object.
     virtual void setTransparencyLevel(const float a_level,
         const bool a_applyToVertices = false,
@@ -730,6 +749,9 @@ public:
     //! This method returns the number of objects from its list of components.
     inline unsigned int getNumComponents() { return ((unsigned int)m_components.size()); }
 
+    //! This method returns a selected component from the list of components.
+    inline cGenericObject* getComponent(const unsigned int a_index) const { return (m_components[a_index]); }
+
 
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - GHOSTING:
@@ -838,6 +860,24 @@ protected:
     //! Previous rotation since last haptic computation.
     cMatrix3d m_prevGlobalRot;
 
+    //! Global position of the parent frame used for the last computation of the global position.
+    cVector3d m_parentGlobalPos;
+
+    //! Global rotation of the parent frame used for the last computation of the global rotation.
+    cMatrix3d m_parentGlobalRot;
+
+    //! If __true__, then the local position or rotation has changed since the last computation of the global position.
+    bool m_localTransformModified;
+
+    //! If __true__, then the global position or rotation has changed during the last computation.
+    bool m_globalTransformModified;
+
+    //! If __true__, then a component or child of this object requires a computation of its global position.
+    bool m_childTransformModified;
+
+    //! If __true__, then global positions are only computed when this object or its parent have moved.
+    bool m_useIncrementalGlobalPositions;
+
 
     //-----------------------------------------------------------------------
     // PROTECTED MEMBERS - BOUNDARY BOX
@@ -942,6 +982,12 @@ protected:
     //! OpenGL matrix describing my position and orientation transformation.
     cTransform m_frameGL;
 
+    //! If __true__, then the boundary box of this object intersects the view frustum of the camera being rendered.
+    bool m_frustumVisible;
+
+    //! If __true__, then this object, one of its components or one of its children intersects the view frustum of the camera being rendered.
+    bool m_frustumVisibleSubtree;
+
 
     //-----------------------------------------------------------------------
     // PROTECTED MEMBERS - COLLISION DETECTION:
@@ -962,6 +1008,28 @@ protected:
     //! List of haptic effects programmed for this object.
     std::vector<cGenericEffect*> m_effects;
 
+    //! Cached flag, __true__ if this object or any of its descendants has haptic effects.
+    bool m_subtreeHasEffects;
+
+    //! Version of the scenegraph structure for which __m_subtreeHasEffects__ was computed.
+    unsigned int m_subtreeHasEffectsVersion;
+
+    //! Version of the scenegraph structure, incremented whenever effects, children or components are added or removed.
+    static std::atomic<unsigned int> s_interactionGraphVersion;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED METHODS - HAPTIC EFFECTS AND INTERACTIONS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! This method invalidates the cached haptic effect information of all objects.
+    static void invalidateInteractionGraph() { s_interactionGraphVersion++; }
+
+    //! This method returns __true__ if this object or any of its descendants has haptic effects.
+    bool getSubtreeHasEffects();
+
 
     //-----------------------------------------------------------------------
     // PROTECTED VIRTUAL METHODS:
@@ -975,6 +1043,15 @@ protected:
     //! This method update the global position information about this object.
     virtual void updateGlobalPositions(const bool a_frameOnly) {};
 
+    //! This method returns __true__ if this object must be visited during the next computation of global positions.
+    inline bool requiresGlobalPositionsUpdate() const
+    {
+        return (m_localTransformModified || m_globalTransformModified || m_childTransformModified || !m_useIncrementalGlobalPositions);
+    }
+
+    //! This method marks the parents of this object as having a component or child that requires a computation of its global position.
+    void invalidateParentGlobalPositions();
+
     //! This method updates the boundary box of this object.
     virtual void updateBoundaryBox() {};
 
@@ -1038,6 +1115,19 @@ public:
     //! This method renders the entire scene graph, starting from this object.
     virtual void renderSceneGraph(cRenderOptions& a_options);
 
+    //! This method renders this object only, excluding its components and children.
+    virtual void renderObject(cRenderOptions& a_options);
+
+    //! This method adds this object, its components and its children to a render queue.
+    virtual void enqueueSceneGraph(cRenderQueue& a_queue,
+        const cTransform& a_parentFrame,
+        cRenderOptions& a_options);
+
+    //! This method determines which objects of the scene graph, starting from this object, are located inside the view frustum of a camera.
+    virtual bool computeFrustumVisibility(cCamera* a_camera,
+        const cVector3d& a_parentPos,
+        const cMatrix3d& a_parentRot);
+
     //! This method adjusts the collision segment to handle objects in motion.
     virtual void adjustCollisionSegment(cVector3d& a_segmentPointA, cVector3d& a_segmentPointAadjusted);
 
@@ -1045,7 +1135,8 @@ public:
     virtual cVector3d computeInteractions(const cVector3d& a_toolPos,
         const cVector3d& a_toolVel,
         const unsigned int a_IDN,
-        cInteractionRecorder& a_interactions);
+        cInteractionRecorder& a_interactions,
+        const bool a_useCulling = false);
 };
 
 //------------------------------------------------------------------------------
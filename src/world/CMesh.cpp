@@ -84,6 +84,9 @@ cMesh::cMesh(cMaterialPtr a_material)
     // should triangles be displayed?
     m_showTriangles = true;
 
+    // render triangles from display lists by default
+    m_useVertexBuffer = false;
+
     // should normals be displayed?
     m_showNormals = false;
 
@@ -237,6 +240,7 @@ void cMesh::copyMeshProperties(cMesh* a_obj,
     a_obj->m_normalsColor = m_normalsColor;
     a_obj->m_normalsLength = m_normalsLength;
     a_obj->m_useVertexColors = m_useVertexColors;
+    a_obj->m_useVertexBuffer = m_useVertexBuffer;
 }
 
 
@@ -497,10 +501,7 @@ void cMesh::computeAllNormals()
     unsigned int numVertices = m_vertices->getNumElements();
 
     // initialize all normals to zero
-    for (unsigned int i=0; i<numVertices; i++)
-    {
-        m_vertices->setNormal(i, 0, 0, 0);
-    }
+    vector<cVector3d> normals(numVertices, cVector3d(0.0, 0.0, 0.0));
 
     // compute the normal of each triangle, add contribution to each vertex
     for (unsigned int i=0; i<numTriangles; i++)
@@ -522,19 +523,20 @@ void cMesh::computeAllNormals()
         if (length > 0.0)
         {
             normal.div(length);
-            m_vertices->m_normal[vertexIndex0].add(normal);
-            m_vertices->m_normal[vertexIndex1].add(normal);
-            m_vertices->m_normal[vertexIndex2].add(normal);
+            normals[vertexIndex0].add(normal);
+            normals[vertexIndex1].add(normal);
+            normals[vertexIndex2].add(normal);
         }
     }
 
     // normalize all triangles
     for (unsigned int i=0; i<numVertices; i++)
     {
-        if (m_vertices->m_normal[i].length() > 0.000000001)
+        if (normals[i].length() > 0.000000001)
         {
-            m_vertices->m_normal[i].normalize();
+            normals[i].normalize();
         }
+        m_vertices->setNormal(i, normals[i]);
     }
 }
 
@@ -568,6 +570,7 @@ void cMesh::scaleXYZ(const double a_scaleX, const double a_scaleY, const double
     {
         m_vertices->m_localPos[i].mul(a_scaleX, a_scaleY, a_scaleZ);
     }
+    m_vertices->markForUpdate();
 
     m_boundaryBoxMax.mul(a_scaleX, a_scaleY, a_scaleZ);
     m_boundaryBoxMin.mul(a_scaleX, a_scaleY, a_scaleZ);
@@ -588,12 +591,7 @@ void cMesh::updateGlobalPositions(const bool a_frameOnly)
 {
     if (a_frameOnly) return;
 
-    int numVertices = m_vertices->getNumElements();
-
-    for (int i=0; i<numVertices; i++)
-    {
-        m_vertices->computeGlobalPosition(i, m_globalPos, m_globalRot);
-    }
+    m_vertices->computeGlobalPositions(m_globalPos, m_globalRot);
 }
 
 
@@ -646,7 +644,9 @@ void cMesh::setTransparencyLevel(const float a_level,
         int numVertices = m_vertices->getNumElements();
         for (int i = 0; i < numVertices; i++)
         {
-            m_vertices->m_color[i].setA(a_level);
+            cColorf color = m_vertices->getColor(i);
+            color.setA(a_level);
+            m_vertices->setColor(i, color);
         }
 
         // mark for update
@@ -695,6 +695,7 @@ void cMesh::offsetVertices(const cVector3d& a_offset,
     {
         m_vertices->m_localPos[i].add(a_offset);
     }
+    m_vertices->markForUpdate();
 
     // update boundary box
     m_boundaryBoxMin+=a_offset;
@@ -729,6 +730,7 @@ void cMesh::rotateVertices(const cMatrix3d& a_rotation,
     {
         m_vertices->m_localPos[i] = a_rotation * m_vertices->m_localPos[i];
     }
+    m_vertices->markForUpdate();
 
     // update boundary box
     m_boundaryBoxMin = a_rotation * m_boundaryBoxMin;
@@ -759,7 +761,9 @@ void cMesh::reverseAllNormals()
 
     for (int i=0; i<numVertices; i++)
     {
-        m_vertices->m_normal[i].negate();
+        cVector3d normal = m_vertices->getNormal(i);
+        normal.negate();
+        m_vertices->setNormal(i, normal);
     }
 }
 
@@ -1491,6 +1495,9 @@ void cMesh::renderMesh(cRenderOptions& a_options)
     if ((m_texture != nullptr) && (m_useTextureMapping) && (a_options.m_render_materials))
     {
         m_texture->renderInitialize(a_options);
+
+        // texture remains bound after rendering if the next mesh shares it
+        a_options.m_boundTexture = a_options.m_keepTextureBound ? m_texture.get() : NULL;
     }
 
 
@@ -1559,8 +1566,11 @@ void cMesh::renderMesh(cRenderOptions& a_options)
     //--------------------------------------------------------------------------
     if ((m_shaderProgram != nullptr) && (!a_options.m_creating_shadow_map))
     {
-        // enable shader
-        m_shaderProgram->use(this, a_options);
+        // enable shader unless still in use by the previous mesh
+        if (a_options.m_boundShaderProgram != m_shaderProgram.get())
+        {
+            m_shaderProgram->use(this, a_options);
+        }
 
         // render normal texture if enabled
         if (m_normalMap != nullptr)
@@ -1583,8 +1593,38 @@ void cMesh::renderMesh(cRenderOptions& a_options)
             m_normalMap->renderFinalize(a_options);
         }
 
-        // disable shader
-        m_shaderProgram->disable();
+        // disable shader unless the next mesh uses it too
+        if (a_options.m_keepShaderProgramBound)
+        {
+            a_options.m_boundShaderProgram = m_shaderProgram.get();
+        }
+        else
+        {
+            m_shaderProgram->disable();
+            a_options.m_boundShaderProgram = NULL;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // RENDER OBJECT (VERTEX AND INDEX BUFFERS)
+    //--------------------------------------------------------------------------
+    else if (m_useVertexBuffer)
+    {
+        // get texture unit
+        GLenum textureUnit = GL_TEXTURE1_ARB;
+        if (m_texture != nullptr)
+        {
+            textureUnit = m_texture->getTextureUnit();
+        }
+
+        // update modified vertices and bind vertex arrays
+        m_vertices->renderInitializeFixedPipeline(m_useTextureMapping, m_useVertexColors, textureUnit);
+
+        // render triangles
+        m_triangles->renderElements();
+
+        // disable vertex arrays
+        m_vertices->renderFinalizeFixedPipeline(textureUnit);
     }
 
     //--------------------------------------------------------------------------
@@ -1606,9 +1646,50 @@ void cMesh::renderMesh(cRenderOptions& a_options)
         // RENDER ALL TRIANGLES
         //-------------------------------------------------------------------
 
+        /////////////////////////////////////////////////////////////////////
+        // RENDER TRIANGLES FROM COMPACT VERTEX DATA
+        /////////////////////////////////////////////////////////////////////
+        if (m_vertices->getLayout().isCompact())
+        {
+            // begin rendering triangles
+            glBegin(GL_TRIANGLES);
+
+            // render all active triangles
+            for (unsigned int i=0; i<numTriangles; i++)
+            {
+                if (m_triangles->m_allocated[i])
+                {
+                    for (unsigned int j=0; j<3; j++)
+                    {
+                        unsigned int index = m_triangles->getVertexIndex(i, j);
+
+                        cVector3d normal = m_vertices->getNormal(index);
+                        glNormal3d(normal(0), normal(1), normal(2));
+
+                        if (m_useVertexColors)
+                        {
+                            glColor4fv(m_vertices->getColor(index).getData());
+                        }
+
+                        if (m_useTextureMapping)
+                        {
+                            cVector3d texCoord = m_vertices->getTexCoord(index);
+                            glMultiTexCoord3d(textureUnit, texCoord(0), texCoord(1), texCoord(2));
+                        }
+
+                        glVertex3dv(&m_vertices->m_localPos[index](0));
+                    }
+                }
+            }
+
+            // finalize rendering list of triangles
+            glEnd();
+        }
+
         /////////////////////////////////////////////////////////////////////
         // RENDER TRIANGLES USING CLASSIC OPENGL COMMANDS
         /////////////////////////////////////////////////////////////////////
+        else
         {
             // begin rendering triangles
             glBegin(GL_TRIANGLES);
@@ -149,6 +149,9 @@ public:
         const bool a_affectChildren = false,
         const bool a_affectComponents = true);
 
+    //! This method returns __true__ if this mesh renders parts during the transparent rendering passes, __false__ otherwise.
+    virtual bool hasTransparentParts() const { return (m_useTransparency); }
+
 
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - DISPLAY LISTS:
@@ -159,6 +162,12 @@ public:
     //! This method invalidates any existing display lists and marks the mesh for update.
     virtual void markForUpdate(const bool a_affectChildren = false, const bool a_affectComponents = true);
 
+    //! This method enables or disables rendering from vertex and index buffer objects.
+    void setUseVertexBuffer(const bool a_useVertexBuffer) { m_useVertexBuffer = a_useVertexBuffer; }
+
+    //! This method returns __true__ if rendering from vertex and index buffer objects is enabled.
+    bool getUseVertexBuffer() const { return (m_useVertexBuffer); }
+
 
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - VERTICES
@@ -377,6 +386,9 @@ protected:
     //! If __true__, then triangles are displayed.
     bool m_showTriangles;
 
+    //! If __true__, then triangles are rendered from vertex and index buffer objects instead of display lists.
+    bool m_useVertexBuffer;
+
     //! If __true__, then normals are displayed.
     bool m_showNormals;
 
@@ -188,6 +188,65 @@ void cMultiMesh::setUseVertexColors(const bool a_useColors,
 }
 
 
+//==============================================================================
+/*!
+    This method enables or disables the storage of the global position of each
+    vertex of all meshes. When disabled, global vertex positions are computed 
+    on demand from the frame of each mesh, which saves memory on large models.
+
+    \param  a_useGlobalPositions  If __true__ then global vertex positions are stored.
+*/
+//==============================================================================
+void cMultiMesh::setUseGlobalVertexPositions(const bool a_useGlobalPositions)
+{
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        (*it)->m_vertices->setUseGlobalPosData(a_useGlobalPositions);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method sets the memory layout of vertex attributes of all meshes.
+    Compact layouts quantize normals, tangents, texture coordinates and colors
+    to reduce memory usage and the amount of data sent to the graphics card.
+
+    \param  a_layout  Memory layout of vertex attributes.
+*/
+//==============================================================================
+void cMultiMesh::setVertexLayout(const cVertexArrayLayout& a_layout)
+{
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        (*it)->m_vertices->setLayout(a_layout);
+        (*it)->markForUpdate(false);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method enables or disables rendering of all meshes from vertex and 
+    index buffer objects. When enabled, only the vertices modified since the
+    last rendering pass are uploaded to the graphics card, which makes 
+    deformable meshes cheap to redraw.
+
+    \param  a_useVertexBuffer  If __true__, then vertex and index buffers are used.
+*/
+//==============================================================================
+void cMultiMesh::setUseVertexBuffer(const bool a_useVertexBuffer)
+{
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        (*it)->setUseVertexBuffer(a_useVertexBuffer);
+    }
+}
+
+
 //==============================================================================
 /*!
     This method scales this mesh by using different scale factors along X, Y, 
@@ -220,6 +279,7 @@ void cMultiMesh::scaleXYZ(const double a_scaleX, const double a_scaleY, const do
 
         // scale position
         (*it)->m_localPos.mul(a_scaleX, a_scaleY, a_scaleZ);
+        (*it)->invalidateGlobalPositions();
 
         // update boundary box
         cVector3d b_BoxMin = (*it)->m_boundaryBoxMin;
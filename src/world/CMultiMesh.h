@@ -173,6 +173,15 @@ public:
     //! This method enables or disables the use of per-vertex colors, optionally propagating the operation to its children.
     virtual void setUseVertexColors(const bool a_useColors, const bool a_affectChildren=true, const bool a_affectComponents=true);
 
+    //! This method enables or disables the storage of the global position of each vertex.
+    void setUseGlobalVertexPositions(const bool a_useGlobalPositions);
+
+    //! This method sets the memory layout of vertex attributes.
+    void setVertexLayout(const cVertexArrayLayout& a_layout);
+
+    //! This method enables or disables rendering from vertex and index buffer objects.
+    void setUseVertexBuffer(const bool a_useVertexBuffer);
+
     //! This method sets the color of each vertex.
     void setVertexColor(const cColorf& a_color);
 
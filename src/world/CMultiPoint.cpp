@@ -411,12 +411,7 @@ void cMultiPoint::updateGlobalPositions(const bool a_frameOnly)
 {
     if (a_frameOnly) return;
 
-    int numVertices = m_vertices->getNumElements();
-
-    for (int i=0; i<numVertices; i++)
-    {
-        m_vertices->computeGlobalPosition(i, m_globalPos, m_globalRot);
-    }
+    m_vertices->computeGlobalPositions(m_globalPos, m_globalRot);
 }
 
 
@@ -466,7 +461,9 @@ void cMultiPoint::setTransparencyLevel(const float a_level,
         int numVertices = m_vertices->getNumElements();
         for (int i = 0; i < numVertices; i++)
         {
-            m_vertices->m_color[i].setA(a_level);
+            cColorf color = m_vertices->getColor(i);
+            color.setA(a_level);
+            m_vertices->setColor(i, color);
         }
 
         // mark for update
@@ -898,7 +895,7 @@ void cMultiPoint::renderPoints(cRenderOptions& a_options)
                     unsigned int index0 = m_points->getVertexIndex0(i);
      
                     // render vertex 0
-                    glColor4fv(m_vertices->m_color[index0].getData());
+                    glColor4fv(m_vertices->getColor(index0).getData());
                     glVertex3dv(&m_vertices->m_localPos[index0](0));
                 }
             }
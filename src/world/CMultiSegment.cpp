@@ -425,12 +425,7 @@ void cMultiSegment::updateGlobalPositions(const bool a_frameOnly)
 {
     if (a_frameOnly) return;
 
-    int numVertices = m_vertices->getNumElements();
-
-    for (int i=0; i<numVertices; i++)
-    {
-        m_vertices->computeGlobalPosition(i, m_globalPos, m_globalRot);
-    }
+    m_vertices->computeGlobalPositions(m_globalPos, m_globalRot);
 }
 
 
@@ -480,7 +475,9 @@ void cMultiSegment::setTransparencyLevel(const float a_level,
         int numVertices = m_vertices->getNumElements();
         for (int i = 0; i < numVertices; i++)
         {
-            m_vertices->m_color[i].setA(a_level);
+            cColorf color = m_vertices->getColor(i);
+            color.setA(a_level);
+            m_vertices->setColor(i, color);
         }
 
         // mark for update
@@ -831,11 +828,11 @@ void cMultiSegment::renderSegments(cRenderOptions& a_options)
                     unsigned int index1 = m_segments->getVertexIndex1(i);
 
                     // render vertex 0
-                    glColor4fv(m_vertices->m_color[index0].getData());
+                    glColor4fv(m_vertices->getColor(index0).getData());
                     glVertex3dv(&m_vertices->m_localPos[index0](0));
 
                     // render vertex 1
-                    glColor4fv(m_vertices->m_color[index1].getData());
+                    glColor4fv(m_vertices->getColor(index1).getData());
                     glVertex3dv(&m_vertices->m_localPos[index1](0));
                 }
             }
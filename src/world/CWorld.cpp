@@ -73,6 +73,9 @@ cWorld::cWorld()
     // use shadow maps
     m_useShadowCasting = true;
 
+    // haptic effects are computed for all objects
+    m_useInteractionCulling = false;
+
     // initialize matrix
     memset(m_worldModelView, 0, sizeof(m_worldModelView));
 }
@@ -167,6 +167,19 @@ public:
                                          const unsigned int a_IDN);
 
 
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - HAPTIC INTERACTIONS:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method enables or disables culling of distant objects when computing haptic effects.
+    void setUseInteractionCulling(const bool a_enabled) { m_useInteractionCulling = a_enabled; }
+
+    //! This method returns __true__ if culling of distant objects is enabled when computing haptic effects, __false__ otherwise.
+    bool getUseInteractionCulling() const { return (m_useInteractionCulling); }
+
+
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - SHADOW CASTING:
     //-----------------------------------------------------------------------
@@ -252,6 +265,9 @@ protected:
 
     //! If __true__ then shadow maps are used.
     bool m_useShadowCasting;
+
+    //! If __true__ then objects located out of reach of their haptic effects are culled.
+    bool m_useInteractionCulling;
 };
 
 //------------------------------------------------------------------------------